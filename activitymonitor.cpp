@@ -0,0 +1,359 @@
+/*
+    activitymonitor.cpp
+    =======================
+    표본 차이 점수(스칼라, SSE2, AVX2, NEON)와 ActivityMonitor 구현
+*/
+#include "activitymonitor.h"
+#include <string.h>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define ACTIVITY_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define ACTIVITY_AVX2 1
+#define ACTIVITY_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ACTIVITY_NEON 1
+#include <arm_neon.h>
+#endif
+
+//=============================================================================
+// FrameDifference: 네 번째 바이트를 양쪽 모두 0으로 가린 뒤 바이트별 절댓값 차이를 더함
+// - SIMD 구현은 처리한 픽셀 수를 돌려주고 나머지는 스칼라가 처리
+//=============================================================================
+static uint64_t DifferenceScalar(const uint8_t* a, const uint8_t* b, size_t begin, size_t end)
+{
+    uint64_t sum = 0;
+    for (size_t i = begin; i < end; i++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            int d = a[i * 4 + c] - b[i * 4 + c];
+            sum += (uint64_t)(d < 0 ? -d : d);
+        }
+    }
+    return sum;
+}
+
+#if ACTIVITY_SSE2
+static size_t DifferenceSse2(const uint8_t* a, const uint8_t* b, size_t pixels, uint64_t* sum)
+{
+    const __m128i mask = _mm_set1_epi32(0x00FFFFFF);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        __m128i x = _mm_and_si128(_mm_loadu_si128((const __m128i*)(a + i * 4)), mask);
+        __m128i y = _mm_and_si128(_mm_loadu_si128((const __m128i*)(b + i * 4)), mask);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(x, y)); // 64비트 합 두 개
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    *sum += lanes[0] + lanes[1];
+    return i;
+}
+#endif
+
+#if ACTIVITY_AVX2
+ACTIVITY_TARGET_AVX2
+static size_t DifferenceAvx2(const uint8_t* a, const uint8_t* b, size_t pixels, uint64_t* sum)
+{
+    const __m256i mask = _mm256_set1_epi32(0x00FFFFFF);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m256i x = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a + i * 4)), mask);
+        __m256i y = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(b + i * 4)), mask);
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(x, y)); // 64비트 합 네 개
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    *sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    return i;
+}
+#endif
+
+#if ACTIVITY_NEON
+static size_t DifferenceNeon(const uint8_t* a, const uint8_t* b, size_t pixels, uint64_t* sum)
+{
+    const uint8x16_t mask = vreinterpretq_u8_u32(vdupq_n_u32(0x00FFFFFF));
+    uint32x4_t acc = vdupq_n_u32(0);
+    size_t i = 0;
+    // 32비트 레인 하나에 반복마다 최대 4 * 255가 더해지므로 표본 크기(수천 픽셀)에서는 넘치지 않음
+    for (; i + 4 <= pixels; i += 4)
+    {
+        uint8x16_t d = vandq_u8(vabdq_u8(vld1q_u8(a + i * 4), vld1q_u8(b + i * 4)), mask);
+        acc = vpadalq_u16(acc, vpaddlq_u8(d));
+    }
+    *sum += (uint64_t)vgetq_lane_u32(acc, 0) + vgetq_lane_u32(acc, 1) + vgetq_lane_u32(acc, 2) + vgetq_lane_u32(acc, 3);
+    return i;
+}
+#endif
+
+uint64_t FrameDifference(const uint8_t* a, const uint8_t* b, size_t pixels, SimdLevel level)
+{
+    uint64_t sum = 0;
+    size_t done = 0;
+    switch (level)
+    {
+#if ACTIVITY_SSE2
+    case SIMD_SSE2: done = DifferenceSse2(a, b, pixels, &sum); break;
+#endif
+#if ACTIVITY_AVX2
+    case SIMD_AVX2: done = DifferenceAvx2(a, b, pixels, &sum); break;
+#endif
+#if ACTIVITY_NEON
+    case SIMD_NEON: done = DifferenceNeon(a, b, pixels, &sum); break;
+#endif
+    default: break;
+    }
+    return sum + DifferenceScalar(a, b, done, pixels);
+}
+
+//=============================================================================
+// ActivityMonitor
+//=============================================================================
+ActivityMonitor::ActivityMonitor(SimdLevel level)
+    : m_level(level), m_config(DefaultConfig()), m_scaler(level), m_scratch(SAMPLE_BYTES, 0), m_credit(0),
+      m_refillTime(0), m_samples(0), m_sampleMicros(0), m_deferred(0), m_intervalMillis(0), m_intervals(0)
+{
+    m_credit = Capacity();
+}
+
+ActivityConfig ActivityMonitor::DefaultConfig()
+{
+    ActivityConfig config;
+    config.sampleMillis = 1000;
+    config.idleMillis = 30000;
+    config.threshold = 128;     // 1080p 창에서 글자 하나(8x16) 정도가 바뀌면 넘는 값
+    config.budgetPermille = 10; // 1%
+    return config;
+}
+
+void ActivityMonitor::SetConfig(const ActivityConfig& config)
+{
+    m_config = config;
+    if (m_config.sampleMillis < 50)
+        m_config.sampleMillis = 50;
+    if (m_config.budgetPermille < 1)
+        m_config.budgetPermille = 1;
+    if (m_credit > Capacity())
+        m_credit = Capacity();
+}
+
+ActivityMonitor::Slot ActivityMonitor::MakeSlot()
+{
+    Slot slot;
+    slot.watch = ACTIVITY_OFF;
+    slot.alert = ALERT_NONE;
+    slot.hasSample = false;
+    slot.nextSample = slot.lastSample = slot.lastChange = slot.alertTime = 0;
+    slot.score = 0;
+    slot.sample.assign(SAMPLE_BYTES, 0);
+    return slot;
+}
+
+void ActivityMonitor::Resize(int slots)
+{
+    m_slots.resize(slots < 0 ? 0 : slots, MakeSlot());
+}
+
+void ActivityMonitor::Insert(int slot)
+{
+    m_slots.insert(m_slots.begin() + slot, MakeSlot());
+}
+
+void ActivityMonitor::Erase(int slot)
+{
+    m_slots.erase(m_slots.begin() + slot);
+}
+
+void ActivityMonitor::Move(int from, int to)
+{
+    // 맞바꾸기로 옮기므로 표본 버퍼는 복사하지 않음
+    if (from < to)
+        std::rotate(m_slots.begin() + from, m_slots.begin() + from + 1, m_slots.begin() + to + 1);
+    else if (to < from)
+        std::rotate(m_slots.begin() + to, m_slots.begin() + from, m_slots.begin() + from + 1);
+}
+
+void ActivityMonitor::SetWatch(int slot, ActivityWatch watch, uint64_t now)
+{
+    Slot& s = m_slots[slot];
+    s.watch = watch;
+    s.alert = ALERT_NONE;
+    s.hasSample = false;
+    s.nextSample = now;
+    s.lastChange = now;
+    s.score = 0;
+}
+
+int ActivityMonitor::WatchedCount() const
+{
+    int count = 0;
+    for (size_t i = 0; i < m_slots.size(); i++)
+        count += m_slots[i].watch != ACTIVITY_OFF ? 1 : 0;
+    return count;
+}
+
+void ActivityMonitor::Refill(uint64_t now)
+{
+    if (now > m_refillTime)
+    {
+        m_credit += (int64_t)(now - m_refillTime) * m_config.budgetPermille;
+        if (m_credit > Capacity())
+            m_credit = Capacity();
+    }
+    m_refillTime = now;
+}
+
+int ActivityMonitor::NextDue(uint64_t now)
+{
+    Refill(now);
+    int due = -1;
+    for (size_t i = 0; i < m_slots.size(); i++)
+    {
+        const Slot& s = m_slots[i];
+        if (s.watch != ACTIVITY_OFF && s.nextSample <= now && (due < 0 || s.nextSample < m_slots[due].nextSample))
+            due = (int)i;
+    }
+    if (due >= 0 && m_credit <= 0)
+    {
+        m_deferred++;
+        return -1;
+    }
+    return due;
+}
+
+bool ActivityMonitor::Submit(int slot, const PixelImage& frame, uint64_t now)
+{
+    Slot& s = m_slots[slot];
+    s.nextSample = now + m_config.sampleMillis;
+    if (frame.width == SAMPLE_WIDTH && frame.height == SAMPLE_HEIGHT)
+    {
+        // 호출 측이 표본 크기로 캡처함: 줄 단위 복사만
+        for (int y = 0; y < SAMPLE_HEIGHT; y++)
+            memcpy(&m_scratch[(size_t)y * SAMPLE_WIDTH * 4], frame.pixels + (size_t)y * frame.stride, SAMPLE_WIDTH * 4);
+    }
+    else
+    {
+        PixelImage sample = { &m_scratch[0], SAMPLE_WIDTH, SAMPLE_HEIGHT, SAMPLE_WIDTH * 4 };
+        m_scaler.Scale(frame, sample);
+    }
+
+    bool changed = false;
+    if (s.hasSample)
+    {
+        const size_t pixels = SAMPLE_WIDTH * SAMPLE_HEIGHT;
+        uint64_t difference = FrameDifference(&m_scratch[0], &s.sample[0], pixels, m_level);
+        uint64_t score = difference * 65536 / (pixels * 3);
+        s.score = score > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)score;
+        changed = difference > 0 && s.score >= m_config.threshold;
+    }
+    if (s.hasSample && now > s.lastSample)
+    {
+        m_intervalMillis += now - s.lastSample;
+        m_intervals++;
+    }
+    s.sample.swap(m_scratch);
+    s.hasSample = true;
+    s.lastSample = now;
+    m_samples++;
+
+    ActivityAlert before = s.alert;
+    if (changed)
+    {
+        s.lastChange = now;
+        if (s.watch == ACTIVITY_CHANGE && s.alert == ALERT_NONE)
+        {
+            s.alert = ALERT_CHANGED;
+            s.alertTime = now;
+        }
+        else if (s.watch == ACTIVITY_IDLE && s.alert == ALERT_IDLE)
+        {
+            s.alert = ALERT_NONE; // 다시 움직이기 시작함
+        }
+    }
+    return s.alert != before;
+}
+
+void ActivityMonitor::Charge(uint64_t micros)
+{
+    m_credit -= (int64_t)micros;
+    m_sampleMicros += micros;
+}
+
+void ActivityMonitor::Skip(int slot, uint64_t now)
+{
+    m_slots[slot].nextSample = now + m_config.sampleMillis;
+}
+
+bool ActivityMonitor::CheckIdle(uint64_t now)
+{
+    bool changed = false;
+    for (size_t i = 0; i < m_slots.size(); i++)
+    {
+        Slot& s = m_slots[i];
+        // 기준 표본이 없으면 (대상이 최소화되어 있는 등) 멈춤인지 알 수 없으므로 판정하지 않음
+        if (s.watch == ACTIVITY_IDLE && s.alert == ALERT_NONE && s.hasSample && now - s.lastChange >= m_config.idleMillis)
+        {
+            s.alert = ALERT_IDLE;
+            s.alertTime = now;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+uint64_t ActivityMonitor::NextWakeup(uint64_t now) const
+{
+    uint64_t next = 0;
+    bool any = false;
+    for (size_t i = 0; i < m_slots.size(); i++)
+    {
+        const Slot& s = m_slots[i];
+        if (s.watch == ACTIVITY_OFF)
+            continue;
+        uint64_t when = s.nextSample;
+        if (m_credit <= 0)
+        {
+            // 예산이 다시 양수가 되는 시각보다 먼저 깨어나도 표본을 뜰 수 없음
+            uint64_t recovered = m_refillTime + (uint64_t)(-m_credit) / m_config.budgetPermille + 1;
+            when = when > recovered ? when : recovered;
+        }
+        if (s.watch == ACTIVITY_IDLE && s.alert == ALERT_NONE && s.hasSample)
+        {
+            uint64_t idle = s.lastChange + m_config.idleMillis;
+            when = when < idle ? when : idle;
+        }
+        if (!any || when < next)
+            next = when;
+        any = true;
+    }
+    if (!any)
+        return 0;
+    return next > now ? next : now;
+}
+
+bool ActivityMonitor::AnyAlert() const
+{
+    for (size_t i = 0; i < m_slots.size(); i++)
+    {
+        if (m_slots[i].alert != ALERT_NONE)
+            return true;
+    }
+    return false;
+}
+
+void ActivityMonitor::Acknowledge(int slot, uint64_t now)
+{
+    Slot& s = m_slots[slot];
+    s.alert = ALERT_NONE;
+    s.lastChange = now;
+}
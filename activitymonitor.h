@@ -0,0 +1,129 @@
+// activitymonitor.h
+// 감시 슬롯 활동 알림. 사용자가 켠 슬롯만 정해진 간격으로 아주 작은 표본(SAMPLE_WIDTH x SAMPLE_HEIGHT)을 떠서
+// 이전 표본과의 SIMD 절댓값 차이 점수를 구하고, 바뀌었을 때(변경 알림) 또는 정해진 시간 동안 바뀌지 않았을 때
+// (멈춤 알림) 슬롯에 알림 상태를 켠다. 표본 캡처/축소에 쓴 시간은 CPU 예산(코어 하나의 천분율)에서 빼며,
+// 예산이 바닥나면 다음 표본을 미뤄 감시 슬롯이 많아도 CPU 사용률은 예산을 넘지 않음 (표본 간격이 늘어남).
+// 캡처는 호출 측이 하고 이 모듈은 받은 이미지만 다룸. 호출 측이 표본 크기로 바로 캡처하면(StretchBlt 등) 축소 없이
+// 복사만 하므로 표본 하나가 수 마이크로초. Win32/X11 헤더에 의존하지 않음.
+#ifndef ACTIVITYMONITOR_H
+#define ACTIVITYMONITOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "downscale.h" // PixelImage, Downscaler, SimdLevel
+
+// 두 이미지(픽셀당 4바이트, 연속 배치)의 채널별 절댓값 차이 합. 네 번째 바이트(알파/패딩)는 비교하지 않음.
+// 모든 구현(스칼라/SSE2/AVX2/NEON)이 같은 값을 냄
+uint64_t FrameDifference(const uint8_t* a, const uint8_t* b, size_t pixels, SimdLevel level);
+
+enum ActivityWatch
+{
+    ACTIVITY_OFF,    // 감시 안 함
+    ACTIVITY_CHANGE, // 내용이 바뀌면 알림 (확인할 때까지 유지)
+    ACTIVITY_IDLE    // 내용이 idleMillis 동안 바뀌지 않으면 알림 (다시 바뀌면 저절로 꺼짐)
+};
+
+enum ActivityAlert
+{
+    ALERT_NONE,
+    ALERT_CHANGED,
+    ALERT_IDLE
+};
+
+struct ActivityConfig
+{
+    uint32_t sampleMillis;   // 슬롯마다 표본 간격
+    uint32_t idleMillis;     // 멈춤으로 볼 시간
+    uint32_t threshold;      // 바뀜으로 볼 최소 점수 (점수 = 채널 평균 절댓값 차이 x 65536)
+    uint32_t budgetPermille; // 표본에 쓸 CPU 예산 (코어 하나의 천분율)
+};
+
+//=============================================================================
+// ActivityMonitor
+// - 슬롯 배열은 SlotTable과 같은 순서로 Resize/Insert/Erase/Move
+// - NextDue: 표본 시각이 지난 감시 슬롯 중 가장 오래 기다린 슬롯 (예산이 바닥나면 -1)
+// - Submit: 호출 측이 캡처한 이미지를 표본 크기로 줄여(이미 표본 크기면 복사만) 이전 표본과 비교.
+//   알림 상태가 바뀌면 true
+// - Charge: 표본 시도 하나에 든 시간(캡처 + Submit, 캡처에 실패해 Skip한 경우도)을 예산에서 뺌
+// - CheckIdle: 표본 없이 시간 경과만으로 멈춤 알림 판정 (예산 때문에 표본이 밀려도 판정은 제때)
+// - 표본 버퍼는 Resize/Insert에서 슬롯마다 미리 할당하므로 표본을 뜰 때는 할당하지 않음
+//=============================================================================
+class ActivityMonitor
+{
+public:
+    enum { SAMPLE_WIDTH = 64, SAMPLE_HEIGHT = 36 }; // 16:9, 2304픽셀
+    enum { SAMPLE_BYTES = SAMPLE_WIDTH * SAMPLE_HEIGHT * 4 };
+
+    explicit ActivityMonitor(SimdLevel level = DetectSimdLevel());
+
+    static ActivityConfig DefaultConfig();
+    void SetConfig(const ActivityConfig& config);
+    const ActivityConfig& Config() const { return m_config; }
+
+    void Resize(int slots);
+    void Insert(int slot);
+    void Erase(int slot);
+    void Move(int from, int to);
+
+    // 감시 방식 설정. 알림과 이전 표본을 지우고 다음 표본을 기준으로 다시 시작 (대상 창이 바뀔 때도 호출)
+    void SetWatch(int slot, ActivityWatch watch, uint64_t now);
+    ActivityWatch Watch(int slot) const { return m_slots[slot].watch; }
+    int WatchedCount() const;
+
+    int NextDue(uint64_t now);
+    bool Submit(int slot, const PixelImage& frame, uint64_t now);
+    void Charge(uint64_t micros);
+    // 표본을 뜰 수 없음 (대상 없음/최소화 등): 이번 차례만 넘김
+    void Skip(int slot, uint64_t now);
+    // 상태가 바뀐 슬롯이 있으면 true
+    bool CheckIdle(uint64_t now);
+    // 다음에 할 일(표본, 멈춤 판정, 예산 회복)이 있는 시각. 감시 슬롯이 없으면 0
+    uint64_t NextWakeup(uint64_t now) const;
+
+    ActivityAlert Alert(int slot) const { return m_slots[slot].alert; }
+    uint64_t AlertTime(int slot) const { return m_slots[slot].alertTime; }
+    bool AnyAlert() const;
+    void Acknowledge(int slot, uint64_t now); // 알림 끄기 (멈춤 감시는 지금부터 다시 셈)
+    uint32_t LastScore(int slot) const { return m_slots[slot].score; }
+
+    // 진단용 통계
+    uint64_t Samples() const { return m_samples; }
+    uint64_t SampleMicros() const { return m_sampleMicros; } // 호출 측 캡처 + 축소 + 비교 누적 시간
+    uint64_t Deferred() const { return m_deferred; }         // 예산 때문에 미룬 횟수
+    // 실제 표본 간격 평균 (같은 슬롯의 연속된 두 표본 사이, ms). 예산 때문에 밀리면 sampleMillis보다 길어짐
+    uint32_t EffectiveIntervalMillis() const { return m_intervals ? (uint32_t)(m_intervalMillis / m_intervals) : 0; }
+
+private:
+    struct Slot
+    {
+        ActivityWatch watch;
+        ActivityAlert alert;
+        bool hasSample;      // 비교할 이전 표본이 있음
+        uint64_t nextSample; // 다음 표본 시각 (ms)
+        uint64_t lastSample; // 마지막 표본 시각 (실제 간격 통계용)
+        uint64_t lastChange; // 마지막으로 바뀐 시각 (멈춤 판정 기준)
+        uint64_t alertTime;  // 알림이 켜진 시각
+        uint32_t score;      // 마지막 점수
+        std::vector<uint8_t> sample; // 이전 표본 (SAMPLE_BYTES, 미리 할당)
+    };
+
+    static Slot MakeSlot();
+    void Refill(uint64_t now);
+    int64_t Capacity() const { return (int64_t)m_config.sampleMillis * m_config.budgetPermille; } // 표본 간격 하나만큼의 예산 (us)
+
+    SimdLevel m_level;
+    ActivityConfig m_config;
+    Downscaler m_scaler;
+    std::vector<Slot> m_slots;
+    std::vector<uint8_t> m_scratch; // 이번 표본 (비교 후 슬롯 표본과 맞바꿈)
+    int64_t m_credit;               // 남은 예산 (us). 음수면 회복될 때까지 표본을 미룸
+    uint64_t m_refillTime;          // 마지막으로 예산을 채운 시각 (ms)
+    uint64_t m_samples;
+    uint64_t m_sampleMicros;
+    uint64_t m_deferred;
+    uint64_t m_intervalMillis; // 실제 표본 간격 합과 개수
+    uint64_t m_intervals;
+};
+
+#endif // ACTIVITYMONITOR_H
@@ -0,0 +1,13 @@
+#!/bin/sh
+# 가상 데스크톱 벤치마크 빌드 (Linux/MinGW 공용, Win32 불필요)
+echo "Compiling benchmark..."
+# sessionstore.cpp는 벤치마크가 쓰지 않지만 Win32 없이 빌드되므로 함께 컴파일하여 경고를 확인
+g++ -std=c++11 -O2 -Wall -Wextra viewerbench.cpp viewermodel.cpp simdesktop.cpp windowtracker.cpp windowregistry.cpp titlestore.cpp layout.cpp searchindex.cpp windowfilter.cpp modelsnapshot.cpp hungwindows.cpp perfcounters.cpp sessionstore.cpp -o viewerbench || {
+    echo "Benchmark compilation failed!"
+    exit 1
+}
+g++ -std=c++11 -O2 -Wall -Wextra scalebench.cpp downscale.cpp framediff.cpp activitymonitor.cpp framerecorder.cpp -o scalebench || {
+    echo "Benchmark compilation failed!"
+    exit 1
+}
+echo "Build successful! Run ./viewerbench (--grid, --ticks N, --windows N, --slots N) or ./scalebench (--ms N, --slots N)"
@@ -7,7 +7,7 @@ if %errorlevel% neq 0 (
 )
 
 echo Compiling and linking main application...
-g++ -std=c++11 -Wall -Wextra -DUNICODE -D_UNICODE winview.cpp resource.o -o MultiWindowViewer.exe -mwindows -luser32 -lgdi32 -lcomctl32 -ldwmapi -luxtheme
+g++ -std=c++11 -Wall -Wextra -DUNICODE -D_UNICODE winview.cpp windowtracker.cpp windowregistry.cpp titlestore.cpp layout.cpp refreshscheduler.cpp perfcounters.cpp searchindex.cpp windowfilter.cpp sessionstore.cpp modelsnapshot.cpp hungwindows.cpp viewermodel.cpp downscale.cpp framediff.cpp activitymonitor.cpp framerecorder.cpp resource.o -o MultiWindowViewer.exe -mwindows -luser32 -lgdi32 -lcomctl32 -ldwmapi -luxtheme
 if %errorlevel% neq 0 (
     echo Application compilation failed!
     goto :eof
@@ -0,0 +1,570 @@
+/*
+    downscale.cpp
+    =======================
+    박스/쌍선형 축소 커널 구현 (스칼라, SSE2, AVX2, NEON)
+*/
+#include "downscale.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define DOWNSCALE_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+// AVX2 함수는 target 속성으로만 AVX2 명령을 쓰므로 -mavx2 없이 빌드하고 실행 시 CPU를 확인해 고름
+#define DOWNSCALE_AVX2 1
+#define DOWNSCALE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DOWNSCALE_NEON 1
+#include <arm_neon.h>
+#endif
+
+//=============================================================================
+// 공통: 좌표 변환과 스칼라 기준 구현
+// - 목적지 i번째 칸의 중심을 원본 좌표로 옮긴 위치 (16.16 고정소수) -> 왼쪽 칸과 오른쪽 칸 가중치 (7비트)
+// - 쌍선형 식 (채널마다, 모든 구현 공통):
+//   t = (p00 * (128 - wx) + p01 * wx + 64) >> 7
+//   u = (p10 * (128 - wx) + p11 * wx + 64) >> 7
+//   out = (t * (128 - wy) + u * wy + 64) >> 7
+//   중간값은 최대 255 * 128 + 64 이므로 16비트 레인에 들어감
+//=============================================================================
+static void MapCoordinate(int i, int srcSize, int dstSize, int32_t* index, int* weight)
+{
+    if (srcSize < 2)
+    {
+        *index = 0;
+        *weight = 0;
+        return;
+    }
+    int64_t step = ((int64_t)srcSize << 16) / dstSize;
+    int64_t pos = (int64_t)i * step + step / 2 - 32768;
+    if (pos < 0)
+        pos = 0;
+    int32_t idx = (int32_t)(pos >> 16);
+    int w = (int)((pos & 0xFFFF) >> 9);
+    if (idx >= srcSize - 1)
+    {
+        // 마지막 칸: 오른쪽 칸(srcSize - 1)에 가중치를 모두 주어 SIMD가 두 칸을 한 번에 읽을 수 있게 함
+        idx = srcSize - 2;
+        w = 128;
+    }
+    *index = idx;
+    *weight = w;
+}
+
+static void BoxHalveRowScalar(const uint8_t* r0, const uint8_t* r1, uint8_t* out, int begin, int end)
+{
+    for (int x = begin; x < end; x++)
+    {
+        const uint8_t* a = r0 + x * 8;
+        const uint8_t* b = r1 + x * 8;
+        for (int c = 0; c < 4; c++)
+            out[x * 4 + c] = (uint8_t)((a[c] + a[c + 4] + b[c] + b[c + 4] + 2) >> 2);
+    }
+}
+
+static void BilinearRowScalar(const uint8_t* r0, const uint8_t* r1, uint8_t* out,
+                              const int32_t* columnX, const uint16_t* columnW, int wy,
+                              int begin, int end, int srcWidth)
+{
+    const int step = srcWidth > 1 ? 4 : 0; // 너비 1이면 오른쪽 칸도 같은 칸
+    for (int x = begin; x < end; x++)
+    {
+        const uint8_t* a = r0 + columnX[x] * 4;
+        const uint8_t* b = r1 + columnX[x] * 4;
+        const int wl = columnW[x * 8];
+        const int wr = columnW[x * 8 + 4];
+        for (int c = 0; c < 4; c++)
+        {
+            int t = (a[c] * wl + a[c + step] * wr + 64) >> 7;
+            int u = (b[c] * wl + b[c + step] * wr + 64) >> 7;
+            out[x * 4 + c] = (uint8_t)((t * (128 - wy) + u * wy + 64) >> 7);
+        }
+    }
+}
+
+//=============================================================================
+// SSE2: 박스는 출력 4픽셀, 쌍선형은 출력 2픽셀씩 (16비트 레인 8개 = 2픽셀 x 4채널)
+//=============================================================================
+#if DOWNSCALE_SSE2
+// 원본 4픽셀(두 줄) -> 출력 2픽셀의 16비트 합 (반올림 전)
+static inline __m128i BoxPairSse2(__m128i top, __m128i bottom)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero)); // p0 p1
+    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero)); // p2 p3
+    __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));       // p0+p1 p2+p3
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+}
+
+static int BoxHalveRowSse2(const uint8_t* r0, const uint8_t* r1, uint8_t* out, int width)
+{
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128i a = BoxPairSse2(_mm_loadu_si128((const __m128i*)(r0 + x * 8)),
+                                _mm_loadu_si128((const __m128i*)(r1 + x * 8)));
+        __m128i b = BoxPairSse2(_mm_loadu_si128((const __m128i*)(r0 + x * 8 + 16)),
+                                _mm_loadu_si128((const __m128i*)(r1 + x * 8 + 16)));
+        _mm_storeu_si128((__m128i*)(out + x * 4), _mm_packus_epi16(a, b));
+    }
+    return x;
+}
+
+// 한 줄의 원본 두 칸(8바이트)에 가로 가중치를 곱해 더한 값 (반올림 전, 하위 4레인)
+static inline __m128i HorizontalSse2(const uint8_t* p, const uint16_t* weights)
+{
+    __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)p), _mm_setzero_si128());
+    v = _mm_mullo_epi16(v, _mm_loadu_si128((const __m128i*)weights));
+    return _mm_add_epi16(v, _mm_srli_si128(v, 8));
+}
+
+static int BilinearRowSse2(const uint8_t* r0, const uint8_t* r1, uint8_t* out,
+                           const int32_t* columnX, const uint16_t* columnW, int wy, int width)
+{
+    const __m128i round = _mm_set1_epi16(64);
+    const __m128i weightTop = _mm_set1_epi16((short)(128 - wy));
+    const __m128i weightBottom = _mm_set1_epi16((short)wy);
+    int x = 0;
+    for (; x + 2 <= width; x += 2)
+    {
+        const uint8_t* a0 = r0 + columnX[x] * 4;
+        const uint8_t* a1 = r0 + columnX[x + 1] * 4;
+        const uint8_t* b0 = r1 + columnX[x] * 4;
+        const uint8_t* b1 = r1 + columnX[x + 1] * 4;
+        const uint16_t* w0 = columnW + x * 8;
+        const uint16_t* w1 = w0 + 8;
+        __m128i t = _mm_unpacklo_epi64(HorizontalSse2(a0, w0), HorizontalSse2(a1, w1));
+        __m128i u = _mm_unpacklo_epi64(HorizontalSse2(b0, w0), HorizontalSse2(b1, w1));
+        t = _mm_srli_epi16(_mm_add_epi16(t, round), 7);
+        u = _mm_srli_epi16(_mm_add_epi16(u, round), 7);
+        __m128i v = _mm_add_epi16(_mm_mullo_epi16(t, weightTop), _mm_mullo_epi16(u, weightBottom));
+        v = _mm_srli_epi16(_mm_add_epi16(v, round), 7);
+        _mm_storel_epi64((__m128i*)(out + x * 4), _mm_packus_epi16(v, v));
+    }
+    return x;
+}
+#endif
+
+//=============================================================================
+// AVX2: 박스는 출력 8픽셀, 쌍선형은 출력 4픽셀씩
+// - 256비트 unpack/pack은 128비트 레인마다 따로 동작하므로 마지막에 64비트 단위로 순서를 맞춤
+//=============================================================================
+#if DOWNSCALE_AVX2
+DOWNSCALE_TARGET_AVX2
+static inline __m256i BoxQuadAvx2(__m256i top, __m256i bottom)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(top, zero), _mm256_unpacklo_epi8(bottom, zero));
+    __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(top, zero), _mm256_unpackhi_epi8(bottom, zero));
+    __m256i sum = _mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi));
+    return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(2)), 2);
+}
+
+DOWNSCALE_TARGET_AVX2
+static int BoxHalveRowAvx2(const uint8_t* r0, const uint8_t* r1, uint8_t* out, int width)
+{
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        __m256i a = BoxQuadAvx2(_mm256_loadu_si256((const __m256i*)(r0 + x * 8)),
+                                _mm256_loadu_si256((const __m256i*)(r1 + x * 8)));
+        __m256i b = BoxQuadAvx2(_mm256_loadu_si256((const __m256i*)(r0 + x * 8 + 32)),
+                                _mm256_loadu_si256((const __m256i*)(r1 + x * 8 + 32)));
+        // 레인별 pack 결과: [0 1 | 4 5] [2 3 | 6 7] 순서의 64비트 묶음 -> 0 1 2 3 4 5 6 7
+        __m256i packed = _mm256_packus_epi16(a, b);
+        _mm256_storeu_si256((__m256i*)(out + x * 4), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    return x;
+}
+
+DOWNSCALE_TARGET_AVX2
+static inline __m256i LoadPairsAvx2(const uint8_t* a, const uint8_t* b, const uint8_t* c, const uint8_t* d)
+{
+    __m128i lo = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)a), _mm_loadl_epi64((const __m128i*)b));
+    __m128i hi = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)c), _mm_loadl_epi64((const __m128i*)d));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+DOWNSCALE_TARGET_AVX2
+static inline __m256i LoadWeightsAvx2(const uint16_t* a, const uint16_t* b)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)a)),
+                                   _mm_loadu_si128((const __m128i*)b), 1);
+}
+
+// 4픽셀(A B | C D) 한 줄의 가로 보간 결과를 [A B | C D] 16비트 레인으로
+DOWNSCALE_TARGET_AVX2
+static inline __m256i HorizontalAvx2(__m256i pairs, __m256i weightsAC, __m256i weightsBD)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i ac = _mm256_mullo_epi16(_mm256_unpacklo_epi8(pairs, zero), weightsAC);
+    __m256i bd = _mm256_mullo_epi16(_mm256_unpackhi_epi8(pairs, zero), weightsBD);
+    ac = _mm256_add_epi16(ac, _mm256_srli_si256(ac, 8));
+    bd = _mm256_add_epi16(bd, _mm256_srli_si256(bd, 8));
+    __m256i sum = _mm256_unpacklo_epi64(ac, bd);
+    return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(64)), 7);
+}
+
+DOWNSCALE_TARGET_AVX2
+static int BilinearRowAvx2(const uint8_t* r0, const uint8_t* r1, uint8_t* out,
+                           const int32_t* columnX, const uint16_t* columnW, int wy, int width)
+{
+    const __m256i round = _mm256_set1_epi16(64);
+    const __m256i weightTop = _mm256_set1_epi16((short)(128 - wy));
+    const __m256i weightBottom = _mm256_set1_epi16((short)wy);
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        const int32_t* cx = columnX + x;
+        const uint16_t* w = columnW + x * 8;
+        __m256i weightsAC = LoadWeightsAvx2(w, w + 16);
+        __m256i weightsBD = LoadWeightsAvx2(w + 8, w + 24);
+        __m256i t = HorizontalAvx2(LoadPairsAvx2(r0 + cx[0] * 4, r0 + cx[1] * 4, r0 + cx[2] * 4, r0 + cx[3] * 4),
+                                   weightsAC, weightsBD);
+        __m256i u = HorizontalAvx2(LoadPairsAvx2(r1 + cx[0] * 4, r1 + cx[1] * 4, r1 + cx[2] * 4, r1 + cx[3] * 4),
+                                   weightsAC, weightsBD);
+        __m256i v = _mm256_add_epi16(_mm256_mullo_epi16(t, weightTop), _mm256_mullo_epi16(u, weightBottom));
+        v = _mm256_srli_epi16(_mm256_add_epi16(v, round), 7);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128((__m128i*)(out + x * 4), _mm256_castsi256_si128(packed));
+    }
+    return x;
+}
+#endif
+
+//=============================================================================
+// NEON: 박스는 출력 4픽셀(vld2로 짝수/홀수 픽셀 분리), 쌍선형은 출력 2픽셀씩
+// - vrshr/vrshrn(반올림 시프트)은 (x + 2^(n-1)) >> n 이므로 스칼라 식과 같음
+//=============================================================================
+#if DOWNSCALE_NEON
+static int BoxHalveRowNeon(const uint8_t* r0, const uint8_t* r1, uint8_t* out, int width)
+{
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        uint32x4x2_t top = vld2q_u32((const uint32_t*)(r0 + x * 8));
+        uint32x4x2_t bottom = vld2q_u32((const uint32_t*)(r1 + x * 8));
+        uint8x16_t te = vreinterpretq_u8_u32(top.val[0]), to = vreinterpretq_u8_u32(top.val[1]);
+        uint8x16_t be = vreinterpretq_u8_u32(bottom.val[0]), bo = vreinterpretq_u8_u32(bottom.val[1]);
+        uint16x8_t lo = vaddq_u16(vaddl_u8(vget_low_u8(te), vget_low_u8(to)),
+                                  vaddl_u8(vget_low_u8(be), vget_low_u8(bo)));
+        uint16x8_t hi = vaddq_u16(vaddl_u8(vget_high_u8(te), vget_high_u8(to)),
+                                  vaddl_u8(vget_high_u8(be), vget_high_u8(bo)));
+        vst1q_u8(out + x * 4, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+    }
+    return x;
+}
+
+static inline uint16x4_t HorizontalNeon(const uint8_t* p, const uint16_t* weights)
+{
+    uint16x8_t v = vmulq_u16(vmovl_u8(vld1_u8(p)), vld1q_u16(weights));
+    return vrshr_n_u16(vadd_u16(vget_low_u16(v), vget_high_u16(v)), 7);
+}
+
+static int BilinearRowNeon(const uint8_t* r0, const uint8_t* r1, uint8_t* out,
+                           const int32_t* columnX, const uint16_t* columnW, int wy, int width)
+{
+    const uint16x8_t weightTop = vdupq_n_u16((uint16_t)(128 - wy));
+    const uint16x8_t weightBottom = vdupq_n_u16((uint16_t)wy);
+    int x = 0;
+    for (; x + 2 <= width; x += 2)
+    {
+        const uint16_t* w0 = columnW + x * 8;
+        const uint16_t* w1 = w0 + 8;
+        uint16x8_t t = vcombine_u16(HorizontalNeon(r0 + columnX[x] * 4, w0), HorizontalNeon(r0 + columnX[x + 1] * 4, w1));
+        uint16x8_t u = vcombine_u16(HorizontalNeon(r1 + columnX[x] * 4, w0), HorizontalNeon(r1 + columnX[x + 1] * 4, w1));
+        uint16x8_t v = vmlaq_u16(vmulq_u16(t, weightTop), u, weightBottom);
+        vst1_u8(out + x * 4, vmovn_u16(vrshrq_n_u16(v, 7)));
+    }
+    return x;
+}
+#endif
+
+//=============================================================================
+// 구현 선택
+//=============================================================================
+bool SimdLevelSupported(SimdLevel level)
+{
+    switch (level)
+    {
+    case SIMD_SCALAR:
+        return true;
+#if DOWNSCALE_SSE2
+    case SIMD_SSE2:
+        return true;
+#endif
+#if DOWNSCALE_AVX2
+    case SIMD_AVX2:
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+#if DOWNSCALE_NEON
+    case SIMD_NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+SimdLevel DetectSimdLevel()
+{
+    static const SimdLevel order[] = { SIMD_AVX2, SIMD_NEON, SIMD_SSE2 };
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++)
+    {
+        if (SimdLevelSupported(order[i]))
+            return order[i];
+    }
+    return SIMD_SCALAR;
+}
+
+const char* SimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SIMD_SCALAR: return "scalar";
+    case SIMD_SSE2: return "sse2";
+    case SIMD_AVX2: return "avx2";
+    case SIMD_NEON: return "neon";
+    default: return "?";
+    }
+}
+
+// dst의 [yBegin, yEnd) 행만 계산
+static void BoxHalveRows(const PixelImage& src, const PixelImage& dst, SimdLevel level, int yBegin, int yEnd)
+{
+    const int width = src.width / 2 < dst.width ? src.width / 2 : dst.width;
+    const int height = src.height / 2 < dst.height ? src.height / 2 : dst.height;
+    if (yEnd > height)
+        yEnd = height;
+    for (int y = yBegin; y < yEnd; y++)
+    {
+        const uint8_t* r0 = src.pixels + (size_t)(y * 2) * src.stride;
+        const uint8_t* r1 = r0 + src.stride;
+        uint8_t* out = dst.pixels + (size_t)y * dst.stride;
+        int done = 0;
+        switch (level)
+        {
+#if DOWNSCALE_SSE2
+        case SIMD_SSE2: done = BoxHalveRowSse2(r0, r1, out, width); break;
+#endif
+#if DOWNSCALE_AVX2
+        case SIMD_AVX2: done = BoxHalveRowAvx2(r0, r1, out, width); break;
+#endif
+#if DOWNSCALE_NEON
+        case SIMD_NEON: done = BoxHalveRowNeon(r0, r1, out, width); break;
+#endif
+        default: break;
+        }
+        BoxHalveRowScalar(r0, r1, out, done, width);
+    }
+}
+
+void BoxHalve(const PixelImage& src, const PixelImage& dst, SimdLevel level)
+{
+    BoxHalveRows(src, dst, level, 0, dst.height);
+}
+
+//=============================================================================
+// Downscaler
+//=============================================================================
+void Downscaler::PrepareColumns(int srcWidth, int dstWidth)
+{
+    if (m_columnSrc == srcWidth && m_columnDst == dstWidth)
+        return;
+    m_columnX.resize(dstWidth);
+    m_columnW.resize((size_t)dstWidth * 8);
+    for (int x = 0; x < dstWidth; x++)
+    {
+        int weight = 0;
+        MapCoordinate(x, srcWidth, dstWidth, &m_columnX[x], &weight);
+        for (int c = 0; c < 4; c++)
+        {
+            m_columnW[x * 8 + c] = (uint16_t)(128 - weight);
+            m_columnW[x * 8 + 4 + c] = (uint16_t)weight;
+        }
+    }
+    m_columnSrc = srcWidth;
+    m_columnDst = dstWidth;
+}
+
+void Downscaler::Bilinear(const PixelImage& src, const PixelImage& dst)
+{
+    if (src.width <= 0 || src.height <= 0 || dst.width <= 0 || dst.height <= 0)
+        return;
+    BilinearRows(src, dst, 0, dst.height);
+}
+
+void Downscaler::BilinearRows(const PixelImage& src, const PixelImage& dst, int yBegin, int yEnd)
+{
+    PrepareColumns(src.width, dst.width);
+    // 원본 너비가 1이면 두 칸을 한 번에 읽을 수 없으므로 스칼라만 사용
+    const SimdLevel level = src.width > 1 ? m_level : SIMD_SCALAR;
+    for (int y = yBegin; y < yEnd; y++)
+    {
+        int32_t row = 0;
+        int wy = 0;
+        MapCoordinate(y, src.height, dst.height, &row, &wy);
+        const uint8_t* r0 = src.pixels + (size_t)row * src.stride;
+        const uint8_t* r1 = src.height > 1 ? r0 + src.stride : r0;
+        uint8_t* out = dst.pixels + (size_t)y * dst.stride;
+        int done = 0;
+        switch (level)
+        {
+#if DOWNSCALE_SSE2
+        case SIMD_SSE2: done = BilinearRowSse2(r0, r1, out, &m_columnX[0], &m_columnW[0], wy, dst.width); break;
+#endif
+#if DOWNSCALE_AVX2
+        case SIMD_AVX2: done = BilinearRowAvx2(r0, r1, out, &m_columnX[0], &m_columnW[0], wy, dst.width); break;
+#endif
+#if DOWNSCALE_NEON
+        case SIMD_NEON: done = BilinearRowNeon(r0, r1, out, &m_columnX[0], &m_columnW[0], wy, dst.width); break;
+#endif
+        default: break;
+        }
+        BilinearRowScalar(r0, r1, out, &m_columnX[0], &m_columnW[0], wy, done, dst.width, src.width);
+    }
+}
+
+void Downscaler::Reserve(int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+{
+    if (srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0)
+        return;
+    // ScaleRows와 같은 단계 구분: 단계 k의 결과는 m_half[(k - 1) & 1]. 원본이 작으면 단계마다 크기도 작으므로
+    // 가장 큰 원본의 두 단계 크기로 잡으면 충분
+    int width = srcWidth, height = srcHeight;
+    for (int k = 1; width >= dstWidth * 2 && height >= dstHeight * 2; k++)
+    {
+        width /= 2;
+        height /= 2;
+        std::vector<uint8_t>& buffer = m_half[(k - 1) & 1];
+        if (buffer.size() < (size_t)width * height * 4)
+            buffer.resize((size_t)width * height * 4);
+    }
+    m_columnX.reserve(dstWidth);
+    m_columnW.reserve((size_t)dstWidth * 8);
+}
+
+void Downscaler::Scale(const PixelImage& src, const PixelImage& dst)
+{
+    int dstTop, dstBottom;
+    ScaleRows(src, dst, 0, src.height, &dstTop, &dstBottom);
+}
+
+//-----------------------------------------------------------------------------
+// ScaleRows: 원본 [srcTop, srcBottom) 행이 바뀌었을 때 그 행을 읽는 목적지 행만 다시 계산
+// 1. 박스 단계마다 크기와 바뀐 행 범위를 앞으로 전파 (행 r은 이전 단계의 2r, 2r+1 행을 읽음)
+// 2. 마지막 단계의 바뀐 행을 읽는 목적지 행 범위와, 그 행들을 계산하는 데 필요한 마지막 단계 행 범위를 구함
+// 3. 필요한 행을 단계마다 거꾸로 두 배씩 넓혀 원본까지 내려간 뒤, 위로 올라오며 그 행만 박스 축소
+//    (중간 버퍼의 다른 행은 읽지 않으므로 여러 슬롯이 같은 Downscaler를 써도 결과가 전체 축소와 같음)
+//-----------------------------------------------------------------------------
+void Downscaler::ScaleRows(const PixelImage& src, const PixelImage& dst, int srcTop, int srcBottom,
+                           int* dstTop, int* dstBottom)
+{
+    *dstTop = *dstBottom = 0;
+    if (src.width <= 0 || src.height <= 0 || dst.width <= 0 || dst.height <= 0)
+        return;
+    if (srcTop < 0)
+        srcTop = 0;
+    if (srcBottom > src.height)
+        srcBottom = src.height;
+    if (srcTop >= srcBottom)
+        return;
+
+    // 1. 박스 단계 (원본 크기가 int 범위이므로 31단계를 넘지 않음)
+    const int kMaxLevels = 32;
+    int widths[kMaxLevels], heights[kMaxLevels], tops[kMaxLevels], bottoms[kMaxLevels];
+    int levels = 0;
+    widths[0] = src.width;
+    heights[0] = src.height;
+    tops[0] = srcTop;
+    bottoms[0] = srcBottom;
+    while (levels + 1 < kMaxLevels && widths[levels] >= dst.width * 2 && heights[levels] >= dst.height * 2)
+    {
+        int k = levels + 1;
+        widths[k] = widths[levels] / 2;
+        heights[k] = heights[levels] / 2;
+        tops[k] = tops[levels] / 2;
+        bottoms[k] = (bottoms[levels] + 1) / 2 < heights[k] ? (bottoms[levels] + 1) / 2 : heights[k];
+        levels = k;
+    }
+    if (tops[levels] >= bottoms[levels])
+        return; // 바뀐 행이 박스 축소에서 버려지는 마지막 홀수 행뿐
+
+    // 2. 목적지 행 범위와 마지막 단계에서 필요한 행
+    const bool copy = widths[levels] == dst.width && heights[levels] == dst.height;
+    int first = -1, last = -1;
+    int needTop = 0, needBottom = 0;
+    if (copy)
+    {
+        first = tops[levels];
+        last = bottoms[levels] - 1;
+        needTop = first;
+        needBottom = last + 1;
+    }
+    else
+    {
+        const int height = heights[levels];
+        for (int y = 0; y < dst.height; y++)
+        {
+            int32_t row = 0;
+            int weight = 0;
+            MapCoordinate(y, height, dst.height, &row, &weight);
+            int next = height > 1 ? row + 1 : row;
+            if (row < bottoms[levels] && next >= tops[levels])
+            {
+                if (first < 0)
+                {
+                    first = y;
+                    needTop = row;
+                }
+                last = y;
+                needBottom = next + 1;
+            }
+        }
+        if (first < 0)
+            return;
+    }
+
+    // 3. 필요한 행만 단계별로 박스 축소
+    int needTops[kMaxLevels], needBottoms[kMaxLevels];
+    needTops[levels] = needTop;
+    needBottoms[levels] = needBottom;
+    for (int k = levels; k > 0; k--)
+    {
+        needTops[k - 1] = needTops[k] * 2;
+        needBottoms[k - 1] = needBottoms[k] * 2 < heights[k - 1] ? needBottoms[k] * 2 : heights[k - 1];
+    }
+    PixelImage current = src;
+    for (int k = 1; k <= levels; k++)
+    {
+        PixelImage half;
+        half.width = widths[k];
+        half.height = heights[k];
+        half.stride = half.width * 4;
+        std::vector<uint8_t>& buffer = m_half[(k - 1) & 1];
+        if (buffer.size() < (size_t)half.stride * half.height)
+            buffer.resize((size_t)half.stride * half.height);
+        half.pixels = &buffer[0];
+        BoxHalveRows(current, half, m_level, needTops[k], needBottoms[k]);
+        current = half;
+    }
+
+    if (copy)
+    {
+        if (current.pixels != dst.pixels)
+        {
+            for (int y = first; y <= last; y++)
+                memcpy(dst.pixels + (size_t)y * dst.stride, current.pixels + (size_t)y * current.stride, (size_t)dst.width * 4);
+        }
+    }
+    else
+    {
+        BilinearRows(current, dst, first, last + 1);
+    }
+    *dstTop = first;
+    *dstBottom = last + 1;
+}
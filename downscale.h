@@ -0,0 +1,75 @@
+// downscale.h
+// 캡처한 창 이미지(픽셀당 4바이트, BGRA/BGRX)를 슬롯 크기로 줄이는 축소 커널.
+// - 박스 커널: 정확히 1/2로 줄임 (2x2 평균). 큰 배율은 박스로 여러 번 반으로 줄여 계단 현상을 막음
+// - 쌍선형 커널: 남은 임의 배율을 처리 (7비트 고정소수 가중치)
+// - 구현: 스칼라(기준), SSE2, AVX2, NEON. 모든 구현은 같은 정수 식을 쓰므로 결과가 비트 단위로 같음
+// Win32/X11 헤더에 의존하지 않음.
+#ifndef DOWNSCALE_H
+#define DOWNSCALE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+enum SimdLevel
+{
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_NEON,
+    SIMD_LEVEL_COUNT
+};
+
+// 이 CPU에서 쓸 수 있는 가장 빠른 구현 (AVX2는 실행 시 CPUID로 확인)
+SimdLevel DetectSimdLevel();
+bool SimdLevelSupported(SimdLevel level);
+const char* SimdLevelName(SimdLevel level);
+
+// 픽셀당 4바이트 이미지. stride는 한 줄의 바이트 수 (위에서 아래 순서)
+struct PixelImage
+{
+    uint8_t* pixels;
+    int width;
+    int height;
+    int stride;
+};
+
+// src를 정확히 절반 크기(width/2 x height/2, 나머지 줄/열은 버림)의 dst로 줄임 (2x2 평균, 반올림)
+void BoxHalve(const PixelImage& src, const PixelImage& dst, SimdLevel level);
+
+//=============================================================================
+// Downscaler
+// - Scale: src를 dst 크기로 줄임. 두 방향 모두 2배 이상 크면 박스 커널로 반씩 줄인 뒤 쌍선형으로 마무리
+// - 중간 버퍼와 열 가중치 표는 재사용하므로 같은 크기를 반복해서 줄일 때 메모리를 할당하지 않음
+// - 스레드마다 하나씩 사용 (상태를 가짐)
+//=============================================================================
+class Downscaler
+{
+public:
+    explicit Downscaler(SimdLevel level = DetectSimdLevel()) : m_level(level), m_columnSrc(0), m_columnDst(0) {}
+
+    SimdLevel Level() const { return m_level; }
+    void SetLevel(SimdLevel level) { m_level = level; }
+
+    void Scale(const PixelImage& src, const PixelImage& dst);
+    // 원본의 [srcTop, srcBottom) 행만 바뀌었을 때: 그 행을 읽는 dst 행만 다시 계산하고 나머지 dst 행은 그대로 둠.
+    // 다시 계산한 dst 행 범위를 dstTop/dstBottom에 돌려줌 (없으면 둘 다 0). 결과는 Scale 전체와 같음
+    void ScaleRows(const PixelImage& src, const PixelImage& dst, int srcTop, int srcBottom, int* dstTop, int* dstBottom);
+    // 박스 축소 없이 쌍선형만 (확대도 가능)
+    void Bilinear(const PixelImage& src, const PixelImage& dst);
+    // srcWidth x srcHeight 이하 원본을 dstWidth x dstHeight로 줄일 때 쓰는 중간 버퍼와 열 표를 미리 할당
+    // (이후 그 범위의 Scale/ScaleRows는 할당하지 않음)
+    void Reserve(int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+
+private:
+    void PrepareColumns(int srcWidth, int dstWidth);
+    void BilinearRows(const PixelImage& src, const PixelImage& dst, int yBegin, int yEnd);
+
+    SimdLevel m_level;
+    std::vector<uint8_t> m_half[2];   // 박스 축소 중간 결과 (번갈아 사용)
+    std::vector<int32_t> m_columnX;   // 목적지 열마다 왼쪽 원본 열
+    std::vector<uint16_t> m_columnW;  // 목적지 열마다 가중치 8개: 왼쪽 열 x4, 오른쪽 열 x4 (합 128, SIMD가 그대로 읽음)
+    int m_columnSrc, m_columnDst;     // 표를 만든 원본/목적지 너비
+};
+
+#endif // DOWNSCALE_H
@@ -0,0 +1,81 @@
+// framecommit.h
+// 배치 한 번에 대한 썸네일 속성/콤보박스 위치 변경을 모아 "실제로 바뀐 것"만 골라내는 단계.
+// 마지막으로 적용한 값을 기억하고 있다가 달라진 슬롯 목록만 돌려주며, 적용(Win32 호출)은 호출 측이 한 번에 수행.
+// Win32 헤더에 의존하지 않음.
+#ifndef FRAMECOMMIT_H
+#define FRAMECOMMIT_H
+
+#include <stddef.h>
+#include <vector>
+#include "layout.h" // LayoutRect
+
+class FrameCommitter
+{
+public:
+    struct SlotFrame
+    {
+        LayoutRect thumbnail; // 썸네일 목적지 사각형
+        LayoutRect picker;    // 콤보박스 사각형
+        bool hasThumbnail;    // 썸네일이 등록되어 있는지
+        bool applied;         // 한 번이라도 적용되었는지 (false면 다음 커밋에서 무조건 적용)
+    };
+
+    FrameCommitter() {}
+
+    // 새 프레임 시작: 슬롯 개수 맞추고 변경 목록 비움
+    void Begin(int slotCount)
+    {
+        SlotFrame empty = {};
+        m_committed.resize(slotCount, empty);
+        m_pending.assign(slotCount, empty);
+        m_thumbnailUpdates.clear();
+        m_pickerUpdates.clear();
+    }
+
+    // 슬롯의 이번 프레임 값 기록. forceThumbnail은 썸네일이 새로 등록되어 속성을 반드시 다시 보내야 할 때 사용
+    void SetSlot(int slot, const LayoutRect& thumbnail, const LayoutRect& picker, bool hasThumbnail, bool forceThumbnail)
+    {
+        const SlotFrame& prev = m_committed[slot];
+        SlotFrame& next = m_pending[slot];
+        next.thumbnail = thumbnail;
+        next.picker = picker;
+        next.hasThumbnail = hasThumbnail;
+        next.applied = true;
+
+        if (hasThumbnail && (forceThumbnail || !prev.applied || !prev.hasThumbnail || prev.thumbnail != thumbnail))
+            m_thumbnailUpdates.push_back(slot);
+        if (!prev.applied || prev.picker != picker)
+            m_pickerUpdates.push_back(slot);
+    }
+
+    // 이번 프레임에서 속성을 다시 보내야 하는 썸네일 / 옮겨야 하는 콤보박스의 슬롯 목록
+    const std::vector<int>& ThumbnailUpdates() const { return m_thumbnailUpdates; }
+    const std::vector<int>& PickerUpdates() const { return m_pickerUpdates; }
+
+    // 마지막으로 적용된 값 (커밋 전) / 이번 프레임 값
+    const SlotFrame& Committed(int slot) const { return m_committed[slot]; }
+    const SlotFrame& Pending(int slot) const { return m_pending[slot]; }
+
+    // 적용 완료: 이번 프레임 값을 마지막 적용 값으로 확정
+    void Commit() { m_committed.swap(m_pending); }
+
+    // 슬롯 상태를 잊어 다음 프레임에서 다시 적용하도록 함 (선택 변경, 콤보박스 재생성 등)
+    void InvalidateSlot(int slot)
+    {
+        if (slot >= 0 && slot < (int)m_committed.size())
+            m_committed[slot].applied = false;
+    }
+    void InvalidateAll()
+    {
+        for (size_t i = 0; i < m_committed.size(); i++)
+            m_committed[i].applied = false;
+    }
+
+private:
+    std::vector<SlotFrame> m_committed;
+    std::vector<SlotFrame> m_pending;
+    std::vector<int> m_thumbnailUpdates;
+    std::vector<int> m_pickerUpdates;
+};
+
+#endif // FRAMECOMMIT_H
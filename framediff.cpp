@@ -0,0 +1,344 @@
+/*
+    framediff.cpp
+    =======================
+    타일 해시(스칼라, SSE2, AVX2, NEON)와 FrameChangeDetector 구현
+*/
+#include "framediff.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define FRAMEDIFF_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define FRAMEDIFF_AVX2 1
+#define FRAMEDIFF_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FRAMEDIFF_NEON 1
+#include <arm_neon.h>
+#endif
+
+//=============================================================================
+// 해시 정의 (모든 구현 공통)
+// - 상태: 32비트 레인 8개의 합(sum)과 곱셈-xorshift 사슬(mix). 한 줄의 i번째 픽셀은 레인 i % 8, 사슬 y % 4에 들어감
+//   sum[l] += w;  m = (mix[y % 4][l] ^ w) * kMixMul;  mix[y % 4][l] = m ^ (m >> 15)
+// - 1단계: 줄마다 8픽셀 묶음 전체, 2단계: 줄마다 남은 픽셀 (SIMD는 1단계만 처리하고 2단계는 스칼라)
+// - 픽셀 하나만 바뀌어도 합이 반드시 달라지고, 같은 내용이 자리만 옮긴 변경(배경 위 한 줄이 몇 줄 내려감 등)은
+//   mix가 잡음. 곱셈과 xorshift는 회전/xor와 달리 주기가 없어 픽셀의 기여가 사슬 안 순서마다 다름
+// - 사슬을 줄 위상 4개로 나눈 것은 곱셈 지연이 줄 전체에 이어지지 않게 하려는 것 (사슬끼리는 독립)
+//=============================================================================
+static const uint32_t kMixSeed = 0x9E3779B9u;
+static const uint32_t kMixMul = 0x85EBCA6Bu; // 홀수 (곱셈이 전단사)
+
+enum { HASH_CHAINS = 4 };
+
+struct HashState
+{
+    uint32_t sum[8];
+    uint32_t mix[HASH_CHAINS][8];
+};
+
+static inline uint32_t MixStep(uint32_t mix, uint32_t w)
+{
+    uint32_t m = (mix ^ w) * kMixMul;
+    return m ^ (m >> 15);
+}
+
+static void HashChunksScalar(HashState& state, const uint8_t* pixels, int stride, int chunks, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* row = pixels + (size_t)y * stride;
+        uint32_t* mix = state.mix[y % HASH_CHAINS];
+        for (int c = 0; c < chunks; c++)
+        {
+            for (int l = 0; l < 8; l++)
+            {
+                uint32_t w;
+                memcpy(&w, row + (c * 8 + l) * 4, 4);
+                state.sum[l] += w;
+                mix[l] = MixStep(mix[l], w);
+            }
+        }
+    }
+}
+
+#if FRAMEDIFF_SSE2
+// SSE2에는 32비트 곱셈 하위 절반 명령이 없으므로 짝수/홀수 레인을 64비트 곱셈 두 번으로 구함
+static inline __m128i MulLo32Sse2(__m128i a, __m128i b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline __m128i MixStepSse2(__m128i mix, __m128i w, __m128i mul)
+{
+    __m128i m = MulLo32Sse2(_mm_xor_si128(mix, w), mul);
+    return _mm_xor_si128(m, _mm_srli_epi32(m, 15));
+}
+
+static void HashChunksSse2(HashState& state, const uint8_t* pixels, int stride, int chunks, int height)
+{
+    const __m128i mul = _mm_set1_epi32((int)kMixMul);
+    __m128i sumA = _mm_loadu_si128((const __m128i*)state.sum);
+    __m128i sumB = _mm_loadu_si128((const __m128i*)(state.sum + 4));
+    __m128i mixA[HASH_CHAINS], mixB[HASH_CHAINS];
+    for (int k = 0; k < HASH_CHAINS; k++)
+    {
+        mixA[k] = _mm_loadu_si128((const __m128i*)state.mix[k]);
+        mixB[k] = _mm_loadu_si128((const __m128i*)(state.mix[k] + 4));
+    }
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* row = pixels + (size_t)y * stride;
+        __m128i ma = mixA[y % HASH_CHAINS], mb = mixB[y % HASH_CHAINS];
+        for (int c = 0; c < chunks; c++)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*)(row + c * 32));
+            __m128i b = _mm_loadu_si128((const __m128i*)(row + c * 32 + 16));
+            sumA = _mm_add_epi32(sumA, a);
+            sumB = _mm_add_epi32(sumB, b);
+            ma = MixStepSse2(ma, a, mul);
+            mb = MixStepSse2(mb, b, mul);
+        }
+        mixA[y % HASH_CHAINS] = ma;
+        mixB[y % HASH_CHAINS] = mb;
+    }
+    _mm_storeu_si128((__m128i*)state.sum, sumA);
+    _mm_storeu_si128((__m128i*)(state.sum + 4), sumB);
+    for (int k = 0; k < HASH_CHAINS; k++)
+    {
+        _mm_storeu_si128((__m128i*)state.mix[k], mixA[k]);
+        _mm_storeu_si128((__m128i*)(state.mix[k] + 4), mixB[k]);
+    }
+}
+#endif
+
+#if FRAMEDIFF_AVX2
+FRAMEDIFF_TARGET_AVX2
+static void HashChunksAvx2(HashState& state, const uint8_t* pixels, int stride, int chunks, int height)
+{
+    const __m256i mul = _mm256_set1_epi32((int)kMixMul);
+    __m256i sum = _mm256_loadu_si256((const __m256i*)state.sum);
+    __m256i mix[HASH_CHAINS];
+    for (int k = 0; k < HASH_CHAINS; k++)
+        mix[k] = _mm256_loadu_si256((const __m256i*)state.mix[k]);
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* row = pixels + (size_t)y * stride;
+        __m256i m = mix[y % HASH_CHAINS];
+        for (int c = 0; c < chunks; c++)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(row + c * 32));
+            sum = _mm256_add_epi32(sum, v);
+            m = _mm256_mullo_epi32(_mm256_xor_si256(m, v), mul);
+            m = _mm256_xor_si256(m, _mm256_srli_epi32(m, 15));
+        }
+        mix[y % HASH_CHAINS] = m;
+    }
+    _mm256_storeu_si256((__m256i*)state.sum, sum);
+    for (int k = 0; k < HASH_CHAINS; k++)
+        _mm256_storeu_si256((__m256i*)state.mix[k], mix[k]);
+}
+#endif
+
+#if FRAMEDIFF_NEON
+static void HashChunksNeon(HashState& state, const uint8_t* pixels, int stride, int chunks, int height)
+{
+    const uint32x4_t mul = vdupq_n_u32(kMixMul);
+    uint32x4_t sumA = vld1q_u32(state.sum), sumB = vld1q_u32(state.sum + 4);
+    uint32x4_t mixA[HASH_CHAINS], mixB[HASH_CHAINS];
+    for (int k = 0; k < HASH_CHAINS; k++)
+    {
+        mixA[k] = vld1q_u32(state.mix[k]);
+        mixB[k] = vld1q_u32(state.mix[k] + 4);
+    }
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* row = pixels + (size_t)y * stride;
+        uint32x4_t ma = mixA[y % HASH_CHAINS], mb = mixB[y % HASH_CHAINS];
+        for (int c = 0; c < chunks; c++)
+        {
+            uint32x4_t a = vreinterpretq_u32_u8(vld1q_u8(row + c * 32));
+            uint32x4_t b = vreinterpretq_u32_u8(vld1q_u8(row + c * 32 + 16));
+            sumA = vaddq_u32(sumA, a);
+            sumB = vaddq_u32(sumB, b);
+            ma = vmulq_u32(veorq_u32(ma, a), mul);
+            mb = vmulq_u32(veorq_u32(mb, b), mul);
+            ma = veorq_u32(ma, vshrq_n_u32(ma, 15));
+            mb = veorq_u32(mb, vshrq_n_u32(mb, 15));
+        }
+        mixA[y % HASH_CHAINS] = ma;
+        mixB[y % HASH_CHAINS] = mb;
+    }
+    vst1q_u32(state.sum, sumA);
+    vst1q_u32(state.sum + 4, sumB);
+    for (int k = 0; k < HASH_CHAINS; k++)
+    {
+        vst1q_u32(state.mix[k], mixA[k]);
+        vst1q_u32(state.mix[k] + 4, mixB[k]);
+    }
+}
+#endif
+
+uint64_t HashPixels(const uint8_t* pixels, int stride, int width, int height, SimdLevel level)
+{
+    HashState state;
+    for (int l = 0; l < 8; l++)
+    {
+        state.sum[l] = 0;
+        for (int k = 0; k < HASH_CHAINS; k++)
+            state.mix[k][l] = kMixSeed * (uint32_t)(k * 8 + l + 1);
+    }
+
+    const int chunks = width / 8;
+    switch (level)
+    {
+#if FRAMEDIFF_SSE2
+    case SIMD_SSE2: HashChunksSse2(state, pixels, stride, chunks, height); break;
+#endif
+#if FRAMEDIFF_AVX2
+    case SIMD_AVX2: HashChunksAvx2(state, pixels, stride, chunks, height); break;
+#endif
+#if FRAMEDIFF_NEON
+    case SIMD_NEON: HashChunksNeon(state, pixels, stride, chunks, height); break;
+#endif
+    default: HashChunksScalar(state, pixels, stride, chunks, height); break;
+    }
+
+    // 2단계: 8픽셀 묶음에 들지 않은 줄 끝 픽셀
+    for (int y = 0; y < height && chunks * 8 < width; y++)
+    {
+        const uint8_t* row = pixels + (size_t)y * stride;
+        for (int i = chunks * 8; i < width; i++)
+        {
+            uint32_t w;
+            memcpy(&w, row + i * 4, 4);
+            state.sum[i % 8] += w;
+            state.mix[y % HASH_CHAINS][i % 8] = MixStep(state.mix[y % HASH_CHAINS][i % 8], w);
+        }
+    }
+
+    uint64_t hash = 0xCBF29CE484222325ull; // FNV-1a 방식으로 레인을 접음
+    for (int l = 0; l < 8; l++)
+    {
+        hash = (hash ^ state.sum[l]) * 0x100000001B3ull;
+        for (int k = 0; k < HASH_CHAINS; k++)
+            hash = (hash ^ state.mix[k][l]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+//=============================================================================
+// FrameChangeDetector
+//=============================================================================
+bool FrameChangeDetector::Update(const PixelImage& frame)
+{
+    if (frame.width != m_width || frame.height != m_height)
+    {
+        m_width = frame.width;
+        m_height = frame.height;
+        m_columns = (frame.width + TILE_WIDTH - 1) / TILE_WIDTH;
+        m_rows = (frame.height + TILE_HEIGHT - 1) / TILE_HEIGHT;
+        m_hashes.assign((size_t)m_columns * m_rows, 0);
+        m_dirty.assign((size_t)m_columns * m_rows, 0);
+        m_reset = true;
+    }
+
+    m_dirtyCount = 0;
+    for (int row = 0; row < m_rows; row++)
+    {
+        int top = row * TILE_HEIGHT;
+        int height = frame.height - top < TILE_HEIGHT ? frame.height - top : TILE_HEIGHT;
+        for (int column = 0; column < m_columns; column++)
+        {
+            int left = column * TILE_WIDTH;
+            int width = frame.width - left < TILE_WIDTH ? frame.width - left : TILE_WIDTH;
+            uint64_t hash = HashPixels(frame.pixels + (size_t)top * frame.stride + (size_t)left * 4, frame.stride,
+                                       width, height, m_level);
+            size_t index = (size_t)row * m_columns + column;
+            bool dirty = m_reset || hash != m_hashes[index];
+            m_hashes[index] = hash;
+            m_dirty[index] = dirty ? 1 : 0;
+            m_dirtyCount += dirty ? 1 : 0;
+        }
+    }
+    m_reset = false;
+
+    if (m_dirtyCount == 0)
+    {
+        m_framesSkipped++;
+        return false;
+    }
+    m_framesChanged++;
+    m_tilesChanged += m_dirtyCount;
+    return true;
+}
+
+bool FrameChangeDetector::DirtyRows(int* top, int* bottom) const
+{
+    int first = -1, last = -1;
+    for (int row = 0; row < m_rows && m_dirtyCount > 0; row++)
+    {
+        for (int column = 0; column < m_columns; column++)
+        {
+            if (Dirty(column, row))
+            {
+                if (first < 0)
+                    first = row;
+                last = row;
+                break;
+            }
+        }
+    }
+    if (first < 0)
+    {
+        *top = *bottom = 0;
+        return false;
+    }
+    *top = first * TILE_HEIGHT;
+    *bottom = (last + 1) * TILE_HEIGHT < m_height ? (last + 1) * TILE_HEIGHT : m_height;
+    return true;
+}
+
+void FrameChangeDetector::DirtyRects(int scaledWidth, int scaledHeight, std::vector<LayoutRect>& out) const
+{
+    out.clear();
+    if (m_dirtyCount == 0 || m_width <= 0 || m_height <= 0)
+        return;
+    const int marginX = (scaledWidth + m_width - 1) / m_width + 1;
+    const int marginY = (scaledHeight + m_height - 1) / m_height + 1;
+    for (int row = 0; row < m_rows; row++)
+    {
+        int column = 0;
+        while (column < m_columns)
+        {
+            if (!Dirty(column, row))
+            {
+                column++;
+                continue;
+            }
+            int first = column;
+            while (column < m_columns && Dirty(column, row))
+                column++;
+            // 원본 타일 -> 축소 좌표. 필터가 이웃 원본 픽셀을 섞으므로 원본 한 픽셀이 차지하는 폭(확대일 때 1보다 큼)에
+            // 1픽셀을 더한 만큼 넓힘
+            LayoutRect rc;
+            rc.left = (int)((int64_t)first * TILE_WIDTH * scaledWidth / m_width) - marginX;
+            rc.right = (int)(((int64_t)column * TILE_WIDTH * scaledWidth + m_width - 1) / m_width) + marginX;
+            rc.top = (int)((int64_t)row * TILE_HEIGHT * scaledHeight / m_height) - marginY;
+            rc.bottom = (int)(((int64_t)(row + 1) * TILE_HEIGHT * scaledHeight + m_height - 1) / m_height) + marginY;
+            rc.left = rc.left < 0 ? 0 : rc.left;
+            rc.top = rc.top < 0 ? 0 : rc.top;
+            rc.right = rc.right > scaledWidth ? scaledWidth : rc.right;
+            rc.bottom = rc.bottom > scaledHeight ? scaledHeight : rc.bottom;
+            if (rc.right > rc.left && rc.bottom > rc.top)
+                out.push_back(rc);
+        }
+    }
+}
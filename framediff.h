@@ -0,0 +1,64 @@
+// framediff.h
+// 캡처 대체 경로에서 연속된 프레임의 바뀐 부분만 찾는 타일 변경 감지기.
+// 프레임을 TILE_WIDTH x TILE_HEIGHT 타일로 나눠 타일마다 SIMD 해시를 구하고 이전 프레임의 해시와 비교한다.
+// 바뀐 타일이 없으면 축소/그리기를 통째로 건너뛰고, 있으면 그 행 범위만 다시 줄이고(Downscaler::ScaleRows)
+// 바뀐 타일 자리만 다시 그린다. 이전 프레임 자체는 보관하지 않음 (슬롯당 타일 해시 표만).
+// Win32/X11 헤더에 의존하지 않음.
+#ifndef FRAMEDIFF_H
+#define FRAMEDIFF_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "downscale.h" // PixelImage, SimdLevel
+#include "layout.h"    // LayoutRect
+
+// 사각형 영역(픽셀당 4바이트)의 해시. 모든 구현(스칼라/SSE2/AVX2/NEON)이 같은 값을 냄
+uint64_t HashPixels(const uint8_t* pixels, int stride, int width, int height, SimdLevel level);
+
+//=============================================================================
+// FrameChangeDetector
+// - Update: 새 프레임의 타일 해시를 이전 것과 비교. 첫 프레임, 크기 변경, Reset 직후에는 모든 타일이 바뀐 것으로 봄
+// - DirtyRows: 바뀐 타일을 덮는 원본 행 범위 (ScaleRows에 그대로 넘김)
+// - DirtyRects: 바뀐 타일을 축소된 이미지 좌표로 옮긴 사각형 (같은 행의 이웃 타일은 하나로 합침)
+// - 바뀐/건너뛴 프레임 수와 바뀐 타일 수를 셈 (슬롯별 통계)
+//=============================================================================
+class FrameChangeDetector
+{
+public:
+    enum { TILE_WIDTH = 64, TILE_HEIGHT = 32 }; // 원본 픽셀 기준
+
+    explicit FrameChangeDetector(SimdLevel level = DetectSimdLevel())
+        : m_level(level), m_width(0), m_height(0), m_columns(0), m_rows(0), m_dirtyCount(0), m_reset(true),
+          m_framesChanged(0), m_framesSkipped(0), m_tilesChanged(0) {}
+
+    // 바뀐 타일이 있으면 true
+    bool Update(const PixelImage& frame);
+    // 다음 Update에서 모든 타일을 바뀐 것으로 봄 (축소 결과를 잃었을 때)
+    void Reset() { m_reset = true; }
+
+    int Columns() const { return m_columns; }
+    int Rows() const { return m_rows; }
+    bool Dirty(int column, int row) const { return m_dirty[(size_t)row * m_columns + column] != 0; }
+    int DirtyCount() const { return m_dirtyCount; }
+    bool DirtyRows(int* top, int* bottom) const;
+    void DirtyRects(int scaledWidth, int scaledHeight, std::vector<LayoutRect>& out) const;
+
+    uint64_t FramesChanged() const { return m_framesChanged; }
+    uint64_t FramesSkipped() const { return m_framesSkipped; }
+    uint64_t TilesChanged() const { return m_tilesChanged; }
+
+private:
+    SimdLevel m_level;
+    int m_width, m_height;      // 마지막 프레임 크기
+    int m_columns, m_rows;      // 타일 수
+    std::vector<uint64_t> m_hashes;
+    std::vector<uint8_t> m_dirty;
+    int m_dirtyCount;
+    bool m_reset;
+    uint64_t m_framesChanged;
+    uint64_t m_framesSkipped;
+    uint64_t m_tilesChanged;
+};
+
+#endif // FRAMEDIFF_H
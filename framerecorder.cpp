@@ -0,0 +1,503 @@
+/*
+    framerecorder.cpp
+    =======================
+    프레임 차이 부호화/복원, RecordingReader, FrameRecorder 구현
+*/
+#include "framerecorder.h"
+#include <string.h>
+#include <algorithm>
+
+static const uint32_t kMaxRun = 0x3FFF; // 연산 하나의 최대 픽셀 수
+
+static inline uint32_t PixelColor(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+}
+
+static inline void PutU16(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void PutU32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t GetU16(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static inline uint32_t GetU32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+//=============================================================================
+// 프레임 차이
+// - 최악은 바뀐 픽셀과 그대로인 픽셀이 번갈아 나올 때: 두 픽셀마다 머리 2개 + 3바이트 = 픽셀당 3.5바이트
+//=============================================================================
+size_t MaxFrameDeltaSize(size_t pixels)
+{
+    return pixels * 4 + 4;
+}
+
+size_t EncodeFrameDelta(const uint8_t* previous, const uint8_t* current, size_t pixels, uint8_t* out)
+{
+    // previous가 NULL이면 검은 프레임과 비교
+    uint8_t* p = out;
+    size_t i = 0;
+    while (i < pixels)
+    {
+        uint32_t color = PixelColor(current + i * 4);
+        size_t run = 0;
+        if (previous && PixelColor(previous + i * 4) == color)
+        {
+            while (i + run < pixels && run < kMaxRun && PixelColor(previous + (i + run) * 4) == PixelColor(current + (i + run) * 4))
+                run++;
+            PutU16(p, (RECORD_SKIP << 14) | (uint32_t)run);
+            p += 2;
+            i += run;
+            continue;
+        }
+        if (!previous && color == 0)
+        {
+            while (i + run < pixels && run < kMaxRun && PixelColor(current + (i + run) * 4) == 0)
+                run++;
+            PutU16(p, (RECORD_SKIP << 14) | (uint32_t)run);
+            p += 2;
+            i += run;
+            continue;
+        }
+
+        // 같은 색이 3픽셀 이상 이어지면 채우기 (머리 2 + 3바이트로 리터럴 9바이트 이상을 대신함)
+        while (i + run < pixels && run < kMaxRun && PixelColor(current + (i + run) * 4) == color)
+            run++;
+        if (run >= 3)
+        {
+            PutU16(p, (RECORD_FILL << 14) | (uint32_t)run);
+            p[2] = current[i * 4];
+            p[3] = current[i * 4 + 1];
+            p[4] = current[i * 4 + 2];
+            p += 5;
+            i += run;
+            continue;
+        }
+
+        // 리터럴: 그대로인 픽셀이나 채우기로 쓸 구간이 나오기 전까지
+        size_t end = i + 1;
+        while (end < pixels && end - i < kMaxRun)
+        {
+            uint32_t c = PixelColor(current + end * 4);
+            uint32_t before = previous ? PixelColor(previous + end * 4) : 0;
+            if (c == before)
+                break;
+            if (end + 2 < pixels && PixelColor(current + (end + 1) * 4) == c && PixelColor(current + (end + 2) * 4) == c)
+                break;
+            end++;
+        }
+        PutU16(p, (RECORD_LITERAL << 14) | (uint32_t)(end - i));
+        p += 2;
+        for (size_t k = i; k < end; k++)
+        {
+            p[0] = current[k * 4];
+            p[1] = current[k * 4 + 1];
+            p[2] = current[k * 4 + 2];
+            p += 3;
+        }
+        i = end;
+    }
+    return (size_t)(p - out);
+}
+
+bool ApplyFrameDelta(uint8_t* frame, size_t pixels, const uint8_t* data, size_t size)
+{
+    size_t i = 0, at = 0;
+    while (at < size)
+    {
+        if (size - at < 2)
+            return false;
+        uint32_t op = GetU16(data + at) >> 14;
+        size_t run = GetU16(data + at) & kMaxRun;
+        at += 2;
+        if (run == 0 || run > pixels - i)
+            return false;
+        if (op == RECORD_SKIP)
+        {
+            i += run;
+        }
+        else if (op == RECORD_LITERAL)
+        {
+            if (size - at < run * 3)
+                return false;
+            for (size_t k = 0; k < run; k++, i++, at += 3)
+            {
+                frame[i * 4] = data[at];
+                frame[i * 4 + 1] = data[at + 1];
+                frame[i * 4 + 2] = data[at + 2];
+                frame[i * 4 + 3] = 0xFF;
+            }
+        }
+        else if (op == RECORD_FILL)
+        {
+            if (size - at < 3)
+                return false;
+            for (size_t k = 0; k < run; k++, i++)
+            {
+                frame[i * 4] = data[at];
+                frame[i * 4 + 1] = data[at + 1];
+                frame[i * 4 + 2] = data[at + 2];
+                frame[i * 4 + 3] = 0xFF;
+            }
+            at += 3;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return i == pixels;
+}
+
+//=============================================================================
+// RecordingReader
+//=============================================================================
+static const size_t kHeaderSize = 4 + 2 + 2 + 2 + 2 + 8 + 4; // 머리 (기준 프레임 앞까지)
+
+bool RecordingReader::Open(const uint8_t* data, size_t size)
+{
+    m_data = NULL;
+    m_frames = 0;
+    if (size < kHeaderSize + 4 || memcmp(data, "MWVR", 4) != 0 || GetU16(data + 4) != RECORDING_VERSION)
+        return false;
+    int width = (int)GetU16(data + 6);
+    int height = (int)GetU16(data + 8);
+    uint64_t start = GetU32(data + 12) | ((uint64_t)GetU32(data + 16) << 32);
+    uint32_t frames = GetU32(data + 20);
+    if (width <= 0 || height <= 0)
+        return false;
+
+    // 기준 프레임과 모든 프레임 레코드가 파일 안에 들어 있는지 먼저 확인
+    size_t at = kHeaderSize;
+    uint32_t baseSize = GetU32(data + at);
+    if (baseSize > size - at - 4)
+        return false;
+    at += 4 + baseSize;
+    for (uint32_t f = 0; f < frames; f++)
+    {
+        if (size - at < 8)
+            return false;
+        uint32_t frameSize = GetU32(data + at + 4);
+        if (frameSize > size - at - 8)
+            return false;
+        at += 8 + frameSize;
+    }
+
+    const size_t pixels = (size_t)width * height;
+    m_frame.assign(pixels * 4, 0);
+    for (size_t i = 0; i < pixels; i++)
+        m_frame[i * 4 + 3] = 0xFF;
+    if (!ApplyFrameDelta(&m_frame[0], pixels, data + kHeaderSize + 4, baseSize))
+        return false;
+    m_data = data;
+    m_size = size;
+    m_width = width;
+    m_height = height;
+    m_frames = frames;
+    m_startWallMillis = start;
+    m_index = 0;
+    m_offset = kHeaderSize + 4 + baseSize;
+    return true;
+}
+
+bool RecordingReader::Next(uint32_t* offsetMillis)
+{
+    if (!m_data || m_index >= m_frames)
+        return false;
+    uint32_t frameSize = GetU32(m_data + m_offset + 4);
+    if (offsetMillis)
+        *offsetMillis = GetU32(m_data + m_offset);
+    if (!ApplyFrameDelta(&m_frame[0], (size_t)m_width * m_height, m_data + m_offset + 8, frameSize))
+    {
+        m_data = NULL; // 이후 프레임은 복원할 수 없음
+        return false;
+    }
+    m_offset += 8 + frameSize;
+    m_index++;
+    return true;
+}
+
+//=============================================================================
+// FrameRecorder
+// - 링: 레코드는 링 안에 이어 붙이고, 끝에 자리가 모자라면 0부터 씀 (끝의 남은 자리는 비워 둠)
+// - 가장 오래된 레코드부터 tail까지가 사용 중. first 레코드 위치 == tail이고 레코드가 있으면 가득 참
+//=============================================================================
+FrameRecorder::FrameRecorder(SimdLevel level)
+    : m_config(DefaultConfig()), m_scaler(level), m_frame(RECORD_PIXELS * 4, 0),
+      m_encoded(MaxFrameDeltaSize(RECORD_PIXELS), 0), m_frames(0), m_encodedBytes(0), m_evicted(0)
+{
+}
+
+RecordConfig FrameRecorder::DefaultConfig()
+{
+    RecordConfig config;
+    config.intervalMillis = 1000;
+    config.keepMillis = 5 * 60 * 1000; // 5분
+    config.ringBytes = 4 << 20;        // 슬롯마다 4MB: 전체가 바뀌는 프레임(약 40KB)만 와도 1분 40초는 남음
+    return config;
+}
+
+void FrameRecorder::SetConfig(const RecordConfig& config)
+{
+    m_config = config;
+    if (m_config.intervalMillis < 100)
+        m_config.intervalMillis = 100;
+    if (m_config.keepMillis < m_config.intervalMillis)
+        m_config.keepMillis = m_config.intervalMillis;
+    // 최악의 프레임 하나는 반드시 들어가야 함
+    if (m_config.ringBytes < MaxFrameDeltaSize(RECORD_PIXELS))
+        m_config.ringBytes = (uint32_t)MaxFrameDeltaSize(RECORD_PIXELS);
+}
+
+FrameRecorder::Slot FrameRecorder::MakeSlot()
+{
+    Slot slot;
+    slot.on = false;
+    slot.nextFrame = 0;
+    slot.first = slot.count = slot.tail = 0;
+    return slot;
+}
+
+uint32_t FrameRecorder::MaxRecords() const
+{
+    return m_config.keepMillis / m_config.intervalMillis + 2;
+}
+
+void FrameRecorder::Resize(int slots)
+{
+    m_slots.resize(slots < 0 ? 0 : slots, MakeSlot());
+}
+
+void FrameRecorder::Insert(int slot)
+{
+    m_slots.insert(m_slots.begin() + slot, MakeSlot());
+}
+
+void FrameRecorder::Erase(int slot)
+{
+    m_slots.erase(m_slots.begin() + slot);
+}
+
+void FrameRecorder::Move(int from, int to)
+{
+    // 맞바꾸기로 옮기므로 링은 복사하지 않음
+    if (from < to)
+        std::rotate(m_slots.begin() + from, m_slots.begin() + from + 1, m_slots.begin() + to + 1);
+    else if (to < from)
+        std::rotate(m_slots.begin() + to, m_slots.begin() + from, m_slots.begin() + from + 1);
+}
+
+void FrameRecorder::SetRecording(int slot, bool on, uint64_t now)
+{
+    Slot& s = m_slots[slot];
+    s.on = on;
+    s.first = s.count = s.tail = 0;
+    s.nextFrame = now;
+    if (on)
+    {
+        s.ring.assign(m_config.ringBytes, 0);
+        s.records.assign(MaxRecords(), Record());
+        s.base.assign(RECORD_PIXELS * 4, 0);
+        s.last.assign(RECORD_PIXELS * 4, 0);
+    }
+    else
+    {
+        std::vector<uint8_t>().swap(s.ring); // 기록을 끄면 링 메모리를 돌려줌
+        std::vector<Record>().swap(s.records);
+        std::vector<uint8_t>().swap(s.base);
+        std::vector<uint8_t>().swap(s.last);
+    }
+}
+
+int FrameRecorder::RecordingCount() const
+{
+    int count = 0;
+    for (size_t i = 0; i < m_slots.size(); i++)
+        count += m_slots[i].on ? 1 : 0;
+    return count;
+}
+
+int FrameRecorder::NextDue(uint64_t now) const
+{
+    int due = -1;
+    for (size_t i = 0; i < m_slots.size(); i++)
+    {
+        const Slot& s = m_slots[i];
+        if (s.on && s.nextFrame <= now && (due < 0 || s.nextFrame < m_slots[due].nextFrame))
+            due = (int)i;
+    }
+    return due;
+}
+
+void FrameRecorder::EvictOldest(Slot& s)
+{
+    // 가장 오래된 차이를 기준 프레임에 합침 (이후 레코드는 이 기준에서 이어짐)
+    const Record& r = s.records[s.first];
+    ApplyFrameDelta(&s.base[0], RECORD_PIXELS, &s.ring[r.offset], r.size);
+    s.first = (s.first + 1) % (uint32_t)s.records.size();
+    s.count--;
+    if (s.count == 0)
+        s.tail = 0;
+    m_evicted++;
+}
+
+bool FrameRecorder::Reserve(Slot& s, uint32_t size, uint32_t* offset)
+{
+    const uint32_t capacity = (uint32_t)s.ring.size();
+    if (size > capacity)
+        return false;
+    if (s.count == (uint32_t)s.records.size())
+        EvictOldest(s);
+    for (;;)
+    {
+        if (s.count == 0)
+        {
+            *offset = 0;
+            return true;
+        }
+        uint32_t head = s.records[s.first].offset;
+        if (s.tail > head)
+        {
+            // 사용 중 구간이 [head, tail): 뒤쪽 남은 자리, 안 되면 앞쪽 [0, head)
+            if (size <= capacity - s.tail)
+            {
+                *offset = s.tail;
+                return true;
+            }
+            if (size <= head)
+            {
+                *offset = 0;
+                return true;
+            }
+        }
+        else if (s.tail < head && size <= head - s.tail)
+        {
+            // 사용 중 구간이 감겨 있음: [tail, head)만 빔
+            *offset = s.tail;
+            return true;
+        }
+        EvictOldest(s);
+    }
+}
+
+void FrameRecorder::Submit(int slot, const PixelImage& frame, uint64_t now)
+{
+    Slot& s = m_slots[slot];
+    s.nextFrame = now + m_config.intervalMillis;
+    PixelImage small = { &m_frame[0], RECORD_WIDTH, RECORD_HEIGHT, RECORD_WIDTH * 4 };
+    m_scaler.Scale(frame, small);
+    uint32_t size = (uint32_t)EncodeFrameDelta(&s.last[0], &m_frame[0], RECORD_PIXELS, &m_encoded[0]);
+
+    // 남길 기간이 지난 프레임 밀어냄
+    while (s.count > 0 && now - s.records[s.first].time > m_config.keepMillis)
+        EvictOldest(s);
+
+    uint32_t offset;
+    if (!Reserve(s, size, &offset))
+        return;
+    memcpy(&s.ring[offset], &m_encoded[0], size);
+    Record& r = s.records[(s.first + s.count) % (uint32_t)s.records.size()];
+    r.offset = offset;
+    r.size = size;
+    r.time = now;
+    s.count++;
+    s.tail = offset + size;
+    s.last.swap(m_frame);
+    m_frames++;
+    m_encodedBytes += size;
+}
+
+void FrameRecorder::Skip(int slot, uint64_t now)
+{
+    m_slots[slot].nextFrame = now + m_config.intervalMillis;
+}
+
+uint64_t FrameRecorder::NextWakeup(uint64_t now) const
+{
+    uint64_t next = 0;
+    bool any = false;
+    for (size_t i = 0; i < m_slots.size(); i++)
+    {
+        const Slot& s = m_slots[i];
+        if (!s.on)
+            continue;
+        if (!any || s.nextFrame < next)
+            next = s.nextFrame;
+        any = true;
+    }
+    if (!any)
+        return 0;
+    return next > now ? next : now;
+}
+
+uint64_t FrameRecorder::RecordedMillis(int slot) const
+{
+    const Slot& s = m_slots[slot];
+    if (s.count == 0)
+        return 0;
+    const Record& oldest = s.records[s.first];
+    const Record& newest = s.records[(s.first + s.count - 1) % (uint32_t)s.records.size()];
+    return newest.time - oldest.time;
+}
+
+size_t FrameRecorder::UsedBytes(int slot) const
+{
+    const Slot& s = m_slots[slot];
+    size_t used = 0;
+    for (uint32_t k = 0; k < s.count; k++)
+        used += s.records[(s.first + k) % (uint32_t)s.records.size()].size;
+    return used;
+}
+
+bool FrameRecorder::Export(int slot, uint64_t now, uint64_t wallNow, std::vector<uint8_t>& out) const
+{
+    const Slot& s = m_slots[slot];
+    if (!s.on || s.count == 0)
+        return false;
+    const uint32_t recordCount = (uint32_t)s.records.size();
+    const uint64_t startTime = s.records[s.first].time;
+
+    // 머리 + 기준 프레임(최대 크기로 잡고 실제 크기로 줄임) + 레코드마다 8바이트 + 차이
+    size_t size = kHeaderSize + 4 + MaxFrameDeltaSize(RECORD_PIXELS) + UsedBytes(slot) + (size_t)s.count * 8;
+    out.resize(size);
+    uint8_t* p = &out[0];
+    memcpy(p, "MWVR", 4);
+    PutU16(p + 4, RECORDING_VERSION);
+    PutU16(p + 6, RECORD_WIDTH);
+    PutU16(p + 8, RECORD_HEIGHT);
+    PutU16(p + 10, 0);
+    uint64_t startWall = wallNow > now - startTime ? wallNow - (now - startTime) : 0;
+    PutU32(p + 12, (uint32_t)startWall);
+    PutU32(p + 16, (uint32_t)(startWall >> 32));
+    PutU32(p + 20, s.count);
+    p += kHeaderSize;
+
+    uint32_t baseSize = (uint32_t)EncodeFrameDelta(NULL, &s.base[0], RECORD_PIXELS, p + 4);
+    PutU32(p, baseSize);
+    p += 4 + baseSize;
+    for (uint32_t k = 0; k < s.count; k++)
+    {
+        const Record& r = s.records[(s.first + k) % recordCount];
+        PutU32(p, (uint32_t)(r.time - startTime));
+        PutU32(p + 4, r.size);
+        memcpy(p + 8, &s.ring[r.offset], r.size);
+        p += 8 + r.size;
+    }
+    out.resize((size_t)(p - &out[0]));
+    return true;
+}
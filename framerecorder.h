@@ -0,0 +1,164 @@
+// framerecorder.h
+// 슬롯 화면 기록. 기록을 켠 슬롯만 정해진 간격으로 캡처를 작은 프레임(RECORD_WIDTH x RECORD_HEIGHT)으로 줄여
+// 슬롯마다 고정 크기 링 버퍼에 직전 프레임과의 차이(delta/RLE)로 쌓는다. 링에는 "기준 프레임 + 그 뒤 차이들"이
+// 들어 있고, 가장 오래된 차이를 밀어낼 때 그 차이를 기준 프레임에 적용하므로 남은 기록은 항상 처음부터 복원 가능.
+// Export는 링을 파일 형식 그대로 한 버퍼에 복사하므로 파일 쓰기는 호출 측이 다른 스레드에서 할 수 있다.
+// 캡처와 파일 입출력은 호출 측이 하고 이 모듈은 받은 이미지만 다룸. Win32/X11 헤더에 의존하지 않음.
+#ifndef FRAMERECORDER_H
+#define FRAMERECORDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "downscale.h" // PixelImage, Downscaler
+
+// 프레임 차이 형식: 연산을 차례로 적용. 연산마다 머리(u16, 리틀 엔디언) = 종류(상위 2비트) | 픽셀 수(하위 14비트, 1..16383)
+//   RECORD_SKIP: 이전 프레임 픽셀 유지
+//   RECORD_LITERAL: 뒤따르는 픽셀 수 x 3바이트(B, G, R)로 덮어씀
+//   RECORD_FILL: 뒤따르는 3바이트 한 색으로 덮어씀
+// 픽셀은 4바이트(BGRX)이며 네 번째 바이트는 비교/저장하지 않음 (복원하면 0xFF)
+enum RecordOp
+{
+    RECORD_SKIP = 0,
+    RECORD_LITERAL = 1,
+    RECORD_FILL = 2
+};
+
+// pixels개 픽셀 프레임의 차이가 가질 수 있는 최대 바이트 수
+size_t MaxFrameDeltaSize(size_t pixels);
+// previous -> current 차이를 out(MaxFrameDeltaSize(pixels) 바이트 이상)에 씀. previous가 NULL이면 검은 프레임 기준.
+// 쓴 바이트 수를 돌려줌
+size_t EncodeFrameDelta(const uint8_t* previous, const uint8_t* current, size_t pixels, uint8_t* out);
+// frame에 차이를 적용. 형식이 잘못되었거나 픽셀 수가 맞지 않으면 false (frame은 일부만 바뀌었을 수 있음)
+bool ApplyFrameDelta(uint8_t* frame, size_t pixels, const uint8_t* data, size_t size);
+
+struct RecordConfig
+{
+    uint32_t intervalMillis; // 슬롯마다 프레임 간격
+    uint32_t keepMillis;     // 남길 기록 길이
+    uint32_t ringBytes;      // 슬롯마다 링 버퍼 크기 (차이 크기 합이 넘치면 keepMillis보다 짧게 남음)
+};
+
+// 기록 파일 형식 (리틀 엔디언):
+//   "MWVR" | 버전(u16) | 너비(u16) | 높이(u16) | 예약(u16) | 첫 프레임 시각(u64, 1970년 기준 ms, 모르면 0) |
+//   프레임 수(u32) | 기준 프레임 [크기(u32) + 검은 프레임에서의 차이] |
+//   프레임마다 [첫 프레임 이후 ms(u32) + 크기(u32) + 직전 프레임에서의 차이]
+// 첫 번째 차이는 기준 프레임에 적용함
+enum { RECORDING_VERSION = 1 };
+
+//=============================================================================
+// RecordingReader: 기록 파일(메모리에 읽은 내용)을 처음부터 한 프레임씩 복원
+// - Open에서 머리와 모든 프레임 경계를 검사하므로 Next는 차이 적용만 실패할 수 있음
+//=============================================================================
+class RecordingReader
+{
+public:
+    RecordingReader() : m_data(NULL), m_size(0), m_width(0), m_height(0), m_frames(0), m_index(0), m_offset(0), m_startWallMillis(0) {}
+
+    bool Open(const uint8_t* data, size_t size);
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+    uint32_t FrameCount() const { return m_frames; }
+    uint64_t StartWallMillis() const { return m_startWallMillis; }
+    // 다음 프레임을 Frame()에 복원. 남은 프레임이 없거나 손상되었으면 false
+    bool Next(uint32_t* offsetMillis);
+    const uint8_t* Frame() const { return m_frame.empty() ? NULL : &m_frame[0]; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    int m_width, m_height;
+    uint32_t m_frames;
+    uint32_t m_index;   // 다음에 복원할 프레임
+    size_t m_offset;    // 다음 프레임 레코드 위치
+    uint64_t m_startWallMillis;
+    std::vector<uint8_t> m_frame;
+};
+
+//=============================================================================
+// FrameRecorder
+// - 슬롯 배열은 SlotTable과 같은 순서로 Resize/Insert/Erase/Move
+// - SetRecording(true)에서 그 슬롯의 링과 프레임 버퍼를 할당하고, false에서 해제. 기록 중에는 할당하지 않음
+//   (축소 중간 버퍼는 Reserve로 미리 맞춘 크기 안의 원본이면 늘어나지 않음. 표본 크기 프레임은 축소 없이 복사)
+// - NextDue/Submit/Skip/NextWakeup: ActivityMonitor와 같은 방식으로 호출 측 타이머가 구동
+// - Submit: 링이 모자라거나 keepMillis보다 오래된 프레임은 가장 오래된 것부터 기준 프레임에 합쳐 밀어냄
+//=============================================================================
+class FrameRecorder
+{
+public:
+    enum { RECORD_WIDTH = 160, RECORD_HEIGHT = 90 }; // 16:9, 14400픽셀
+    enum { RECORD_PIXELS = RECORD_WIDTH * RECORD_HEIGHT };
+
+    explicit FrameRecorder(SimdLevel level = DetectSimdLevel());
+
+    static RecordConfig DefaultConfig();
+    // 이미 기록 중인 슬롯은 다음에 기록을 켤 때부터 새 링 크기를 씀
+    void SetConfig(const RecordConfig& config);
+    const RecordConfig& Config() const { return m_config; }
+
+    void Resize(int slots);
+    void Insert(int slot);
+    void Erase(int slot);
+    void Move(int from, int to);
+
+    // 기록 켜기/끄기. 켤 때마다 빈 기록으로 다시 시작 (대상 창이 바뀔 때도 호출)
+    void SetRecording(int slot, bool on, uint64_t now);
+    // srcWidth x srcHeight 이하 원본을 축소할 중간 버퍼를 미리 할당 (기록을 켤 때 호출 측이 캡처 상한으로)
+    void Reserve(int srcWidth, int srcHeight) { m_scaler.Reserve(srcWidth, srcHeight, RECORD_WIDTH, RECORD_HEIGHT); }
+    bool Recording(int slot) const { return m_slots[slot].on; }
+    int RecordingCount() const;
+
+    int NextDue(uint64_t now) const;
+    void Submit(int slot, const PixelImage& frame, uint64_t now);
+    void Skip(int slot, uint64_t now);
+    uint64_t NextWakeup(uint64_t now) const; // 기록 중인 슬롯이 없으면 0
+
+    uint32_t FrameCount(int slot) const { return m_slots[slot].count; }
+    uint64_t RecordedMillis(int slot) const; // 남아 있는 가장 오래된 프레임부터 마지막 프레임까지
+    size_t UsedBytes(int slot) const;        // 링에서 차이가 차지한 바이트
+
+    // 슬롯 기록을 파일 형식으로 out에 씀 (out의 용량은 재사용). wallNow는 now에 해당하는 1970년 기준 ms (모르면 0)
+    bool Export(int slot, uint64_t now, uint64_t wallNow, std::vector<uint8_t>& out) const;
+
+    // 진단용 통계
+    uint64_t Frames() const { return m_frames; }             // 기록한 프레임 수
+    uint64_t EncodedBytes() const { return m_encodedBytes; } // 차이 크기 합
+    uint64_t Evicted() const { return m_evicted; }           // 밀어낸 프레임 수
+
+private:
+    struct Record
+    {
+        uint32_t offset; // 링 안 위치
+        uint32_t size;
+        uint64_t time;
+    };
+
+    struct Slot
+    {
+        bool on;
+        uint64_t nextFrame;
+        std::vector<uint8_t> ring;    // 차이들 (ringBytes)
+        std::vector<Record> records;  // 차이 위치 (원형 색인, 프레임 최대 개수만큼)
+        uint32_t first;               // 가장 오래된 레코드 색인
+        uint32_t count;
+        uint32_t tail;                // 다음 차이를 쓸 링 위치
+        std::vector<uint8_t> base;    // 가장 오래된 차이를 적용할 기준 프레임
+        std::vector<uint8_t> last;    // 마지막으로 기록한 프레임 (다음 차이의 기준)
+    };
+
+    static Slot MakeSlot();
+    void EvictOldest(Slot& s);
+    bool Reserve(Slot& s, uint32_t size, uint32_t* offset);
+    uint32_t MaxRecords() const;
+
+    RecordConfig m_config;
+    Downscaler m_scaler;
+    std::vector<Slot> m_slots;
+    std::vector<uint8_t> m_frame;   // 이번 프레임 (축소 결과)
+    std::vector<uint8_t> m_encoded; // 이번 차이 (최대 크기로 미리 할당)
+    uint64_t m_frames;
+    uint64_t m_encodedBytes;
+    uint64_t m_evicted;
+};
+
+#endif // FRAMERECORDER_H
@@ -0,0 +1,81 @@
+/*
+    hungwindows.cpp
+    =======================
+    HungWindowList 구현
+*/
+#include "hungwindows.h"
+
+bool HungWindowList::ShouldProbe(WindowId id, uint64_t now) const
+{
+    if (m_entries.empty())
+        return true;
+    std::unordered_map<WindowId, Entry>::const_iterator it = m_entries.find(id);
+    return it == m_entries.end() || now >= it->second.nextProbe;
+}
+
+bool HungWindowList::ReportTimeout(WindowId id, uint64_t now)
+{
+    m_timeouts++;
+    std::unordered_map<WindowId, Entry>::iterator it = m_entries.find(id);
+    if (it == m_entries.end())
+    {
+        Entry entry = { now + m_firstDelay, m_firstDelay };
+        m_entries[id] = entry;
+        m_changed.insert(id);
+        return true;
+    }
+    // 다시 확인에서도 응답 없음: 간격을 늘림
+    Entry& entry = it->second;
+    entry.delay = entry.delay > m_maxDelay / 2 ? m_maxDelay : entry.delay * 2;
+    entry.nextProbe = now + entry.delay;
+    return false;
+}
+
+bool HungWindowList::ReportResponsive(WindowId id)
+{
+    if (m_entries.empty() || m_entries.erase(id) == 0)
+        return false;
+    m_changed.insert(id);
+    return true;
+}
+
+void HungWindowList::Forget(WindowId id)
+{
+    if (m_entries.erase(id))
+        m_changed.erase(id);
+}
+
+void HungWindowList::DueProbes(uint64_t now, std::vector<WindowId>& out) const
+{
+    out.clear();
+    for (std::unordered_map<WindowId, Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (now >= it->second.nextProbe)
+            out.push_back(it->first);
+    }
+}
+
+uint64_t HungWindowList::NextProbe() const
+{
+    uint64_t next = 0;
+    for (std::unordered_map<WindowId, Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (next == 0 || it->second.nextProbe < next)
+            next = it->second.nextProbe;
+    }
+    return next;
+}
+
+void HungWindowList::TakeChanges(std::vector<WindowId>& hung, std::vector<WindowId>& recovered)
+{
+    hung.clear();
+    recovered.clear();
+    for (std::unordered_set<WindowId>::const_iterator it = m_changed.begin(); it != m_changed.end(); ++it)
+    {
+        if (m_entries.find(*it) != m_entries.end())
+            hung.push_back(*it);
+        else
+            recovered.push_back(*it);
+    }
+    m_changed.clear();
+}
@@ -0,0 +1,64 @@
+// hungwindows.h
+// 응답 없는 창 격리 목록. 제목 질의가 시간 초과된 창을 격리하여 그동안은 질의하지 않고 마지막으로 알려진 제목을
+// 그대로 쓰게 하고, 다시 확인(probe)은 지수적으로 늘어나는 간격으로만 허용한다.
+// 응답 없는 프로세스 하나가 열거 한 번마다 시간 제한만큼 지연을 더하는 일을 막기 위한 것.
+// 시간은 호출 측이 넘겨주는 ms 단위 단조 증가 값을 사용하며 Win32 헤더에 의존하지 않음.
+#ifndef HUNGWINDOWS_H
+#define HUNGWINDOWS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "windowtracker.h" // WindowId
+
+//=============================================================================
+// HungWindowList
+// - ReportTimeout: 처음이면 격리하고 firstDelay 뒤에 다시 확인, 이미 격리 중이면 간격을 2배로 (maxDelay까지)
+// - ReportResponsive: 격리 해제 (간격도 초기화)
+// - ShouldProbe: 격리되지 않았거나 다시 확인할 시각이 지난 창만 true. 격리된 창이 없으면 해시 조회도 하지 않음
+// - 격리/해제가 바뀐 창은 TakeChanges로 한 번씩 가져감 (UI에 표시를 붙이거나 떼는 데 사용)
+//=============================================================================
+class HungWindowList
+{
+public:
+    HungWindowList(uint32_t firstDelay, uint32_t maxDelay)
+        : m_firstDelay(firstDelay), m_maxDelay(maxDelay < firstDelay ? firstDelay : maxDelay), m_timeouts(0) {}
+
+    bool Empty() const { return m_entries.empty(); }
+    size_t Count() const { return m_entries.size(); }
+    bool IsHung(WindowId id) const { return !m_entries.empty() && m_entries.find(id) != m_entries.end(); }
+    bool ShouldProbe(WindowId id, uint64_t now) const;
+
+    // 질의 결과 보고. 반환값: 격리 상태가 바뀌었는지 (새로 격리 / 격리 해제)
+    bool ReportTimeout(WindowId id, uint64_t now);
+    bool ReportResponsive(WindowId id);
+    // 사라진 창을 목록에서 지움 (해제로 알리지는 않음: UI는 창 제거와 함께 표시를 지움)
+    void Forget(WindowId id);
+
+    // 다시 확인할 시각이 지난 격리 창 (out은 먼저 비움)
+    void DueProbes(uint64_t now, std::vector<WindowId>& out) const;
+    // 가장 이른 다시 확인 시각. 격리된 창이 없으면 0
+    uint64_t NextProbe() const;
+
+    // 지난 TakeChanges 이후 새로 격리된 창 / 격리 해제된 창 (둘 다 먼저 비움)
+    void TakeChanges(std::vector<WindowId>& hung, std::vector<WindowId>& recovered);
+
+    uint64_t TimeoutCount() const { return m_timeouts; } // 진단용: 시간 초과 누적 횟수
+
+private:
+    struct Entry
+    {
+        uint64_t nextProbe;     // 이 시각 이후에만 다시 질의
+        uint32_t delay;         // 현재 다시 확인 간격
+    };
+
+    uint32_t m_firstDelay;
+    uint32_t m_maxDelay;
+    std::unordered_map<WindowId, Entry> m_entries;
+    std::unordered_set<WindowId> m_changed;     // 격리 상태가 바뀐 창 (TakeChanges 전까지)
+    uint64_t m_timeouts;
+};
+
+#endif // HUNGWINDOWS_H
@@ -0,0 +1,276 @@
+/*
+    layout.cpp
+    =======================
+    LayoutEngine 구현
+*/
+#include "layout.h"
+#include <algorithm>
+#include <cmath>
+
+LayoutEngine::LayoutEngine()
+    : m_rowHeight(0), m_totalWidth(0), m_pickerHeight(25), m_previewHeight(300), m_aspectNum(4), m_aspectDen(3),
+      m_gridWidth(0), m_gridHeight(0), m_dirty(true), m_revision(0)
+{
+    m_rowFirst.push_back(0);
+}
+
+void LayoutEngine::SetSlotCount(int count)
+{
+    if (count < 0) count = 0;
+    if ((int)m_sources.size() == count)
+        return;
+    SourceSize unknown = { 0, 0 };
+    m_sources.resize(count, unknown);
+    m_dirty = true;
+}
+
+void LayoutEngine::SetPickerHeight(int height)
+{
+    if (m_pickerHeight == height)
+        return;
+    m_pickerHeight = height;
+    m_dirty = true;
+}
+
+void LayoutEngine::SetPreviewHeight(int height)
+{
+    if (m_previewHeight == height)
+        return;
+    m_previewHeight = height;
+    m_dirty = true;
+}
+
+void LayoutEngine::SetDefaultAspect(int numerator, int denominator)
+{
+    if (numerator <= 0 || denominator <= 0)
+        return;
+    if (m_aspectNum == numerator && m_aspectDen == denominator)
+        return;
+    m_aspectNum = numerator;
+    m_aspectDen = denominator;
+    m_dirty = true;
+}
+
+void LayoutEngine::SetGridArea(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        width = height = 0;
+    if (m_gridWidth == width && m_gridHeight == height)
+        return;
+    m_gridWidth = width;
+    m_gridHeight = height;
+    m_dirty = true;
+}
+
+void LayoutEngine::SetSourceSize(int slot, int cx, int cy)
+{
+    if (slot < 0 || slot >= (int)m_sources.size())
+        return;
+    if (cx <= 0 || cy <= 0)
+        cx = cy = 0;
+    SourceSize& src = m_sources[slot];
+    if (src.cx == cx && src.cy == cy)
+        return;
+    src.cx = cx;
+    src.cy = cy;
+    m_dirty = true;
+}
+
+bool LayoutEngine::Update()
+{
+    if (!m_dirty)
+        return false;
+    m_dirty = false;
+
+    std::vector<SlotGeometry> slots(m_sources.size());
+    m_slotRight.resize(m_sources.size());
+    if (IsGrid())
+        BuildGrid(slots);
+    else
+        BuildRow(slots);
+
+    m_totalWidth = 0;
+    for (size_t r = 0; r < m_rowWidth.size(); r++)
+        m_totalWidth = std::max(m_totalWidth, m_rowWidth[r]);
+
+    bool changed = slots.size() != m_slots.size();
+    for (size_t i = 0; !changed && i < slots.size(); i++)
+        changed = slots[i].picker != m_slots[i].picker || slots[i].thumbnail != m_slots[i].thumbnail;
+    m_slots.swap(slots);
+    m_revision++;
+    return changed;
+}
+
+double LayoutEngine::Aspect(size_t slot) const
+{
+    const SourceSize& src = m_sources[slot];
+    if (src.cy > 0)
+        return (double)src.cx / src.cy;
+    return (double)m_aspectNum / m_aspectDen;
+}
+
+// 가로 한 줄 배치 (슬롯 개수가 0이어도 빈 줄 하나를 유지하여 높이는 그대로)
+void LayoutEngine::BuildRow(std::vector<SlotGeometry>& slots)
+{
+    size_t count = m_sources.size();
+    m_rowHeight = m_pickerHeight + m_previewHeight;
+    m_rowFirst.assign(1, 0);
+    m_rowFirst.push_back((int)count);
+
+    int x = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const SourceSize& src = m_sources[i];
+        int width, height;
+        if (src.cy > 0)
+        {
+            if (src.cy <= m_previewHeight)
+            {
+                width = src.cx;   // 미리보기 높이보다 작으면 원본 크기 그대로
+                height = src.cy;
+            }
+            else
+            {
+                double scale = (double)m_previewHeight / src.cy;
+                width = (int)std::round(src.cx * scale);
+                height = m_previewHeight;
+            }
+        }
+        else // 원본 크기를 모름 (선택 없음, 최소화 등): 기본 비율
+        {
+            width = DefaultSlotWidth();
+            height = m_previewHeight;
+        }
+
+        SlotGeometry& g = slots[i];
+        g.picker.left = x;
+        g.picker.top = 0;
+        g.picker.right = x + width;
+        g.picker.bottom = m_pickerHeight;
+        g.thumbnail.left = x;
+        g.thumbnail.top = m_pickerHeight;
+        g.thumbnail.right = x + width;
+        g.thumbnail.bottom = m_pickerHeight + height;
+
+        x += width;
+        m_slotRight[i] = x;
+    }
+    m_rowWidth.assign(1, x);
+}
+
+double LayoutEngine::SplitRows(int rows, std::vector<int>& first) const
+{
+    int count = (int)m_aspectPrefix.size() - 1;
+    double total = m_aspectPrefix[count];
+    first.resize(rows + 1);
+    first[0] = 0;
+    for (int k = 1; k < rows; k++)
+    {
+        // 누적 비율이 k/rows 지점에 가장 가까운 경계 (각 줄에 최소 한 슬롯)
+        double target = total * k / rows;
+        int lo = first[k - 1] + 1;
+        int hi = count - (rows - k);
+        int j = (int)(std::lower_bound(m_aspectPrefix.begin() + lo, m_aspectPrefix.begin() + hi, target) -
+                      m_aspectPrefix.begin());
+        if (j > lo && target - m_aspectPrefix[j - 1] < m_aspectPrefix[j] - target)
+            j--;
+        first[k] = j;
+    }
+    first[rows] = count;
+
+    double widest = 0.0;
+    for (int k = 0; k < rows; k++)
+        widest = std::max(widest, m_aspectPrefix[first[k + 1]] - m_aspectPrefix[first[k]]);
+    return widest;
+}
+
+// 격자 배치: 목표 영역에 들어가는 썸네일 높이가 가장 큰 줄 수를 선택
+void LayoutEngine::BuildGrid(std::vector<SlotGeometry>& slots)
+{
+    size_t count = m_sources.size();
+    if (count == 0)
+    {
+        m_rowHeight = m_pickerHeight + m_previewHeight;
+        m_rowFirst.assign(2, 0);
+        m_rowWidth.assign(1, 0);
+        return;
+    }
+
+    m_aspectPrefix.resize(count + 1);
+    m_aspectPrefix[0] = 0.0;
+    for (size_t i = 0; i < count; i++)
+        m_aspectPrefix[i + 1] = m_aspectPrefix[i] + Aspect(i);
+
+    // 줄 높이를 h라 하면 너비 제약은 h <= W / (가장 넓은 줄의 비율 합), 높이 제약은 h <= H / r - 콤보박스 높이.
+    // 두 제약이 만나는 r은 대략 sqrt(비율 합 * H / W)이므로 그 근처까지만 평가
+    double total = m_aspectPrefix[count];
+    int maxRows = (int)std::ceil(std::sqrt(total * m_gridHeight / m_gridWidth)) + 2;
+    if (maxRows > (int)count) maxRows = (int)count;
+    if (maxRows < 1) maxRows = 1;
+
+    std::vector<int> first;
+    int bestRows = 1;
+    double bestHeight = -1.0;
+    for (int rows = 1; rows <= maxRows; rows++)
+    {
+        double widest = SplitRows(rows, first);
+        double height = std::min((double)m_gridHeight / rows - m_pickerHeight, m_gridWidth / widest);
+        if (height > bestHeight + 0.5) // 거의 같으면 줄 수가 적은 쪽 유지
+        {
+            bestHeight = height;
+            bestRows = rows;
+        }
+        if (height >= m_previewHeight)
+            break; // 미리보기 높이 상한에 도달 (줄을 늘려도 커지지 않음)
+    }
+
+    int thumbHeight = (int)std::min(bestHeight, (double)m_previewHeight);
+    if (thumbHeight < 1) thumbHeight = 1; // 목표 영역에 담을 수 없을 만큼 많으면 최소 크기로 넘침
+    m_rowHeight = m_pickerHeight + thumbHeight;
+    SplitRows(bestRows, m_rowFirst);
+    m_rowWidth.assign(bestRows, 0);
+
+    for (int r = 0; r < bestRows; r++)
+    {
+        int top = r * m_rowHeight;
+        int x = 0;
+        for (int i = m_rowFirst[r]; i < m_rowFirst[r + 1]; i++)
+        {
+            int width = (int)std::round(Aspect(i) * thumbHeight);
+            if (width < 1) width = 1;
+
+            SlotGeometry& g = slots[i];
+            g.picker.left = x;
+            g.picker.top = top;
+            g.picker.right = x + width;
+            g.picker.bottom = top + m_pickerHeight;
+            g.thumbnail.left = x;
+            g.thumbnail.top = top + m_pickerHeight;
+            g.thumbnail.right = x + width;
+            g.thumbnail.bottom = top + m_rowHeight;
+
+            x += width;
+            m_slotRight[i] = x;
+        }
+        m_rowWidth[r] = x;
+    }
+}
+
+int LayoutEngine::HitTest(int x, int y) const
+{
+    if (x < 0 || y < 0 || m_rowHeight <= 0 || m_slots.empty())
+        return -1;
+    // 줄 높이가 모두 같으므로 줄은 나눗셈으로 바로 계산
+    int row = y / m_rowHeight;
+    if (row >= RowCount())
+        return -1;
+    // 미리보기 영역(콤보박스 아래) 밖이면 -1
+    if (y - row * m_rowHeight < m_pickerHeight)
+        return -1;
+    if (x >= m_rowWidth[row])
+        return -1;
+    // 줄 안에서 오른쪽 x가 x보다 큰 첫 슬롯
+    std::vector<int>::const_iterator begin = m_slotRight.begin() + m_rowFirst[row];
+    std::vector<int>::const_iterator end = m_slotRight.begin() + m_rowFirst[row + 1];
+    return (int)(std::upper_bound(begin, end, x) - m_slotRight.begin());
+}
@@ -0,0 +1,98 @@
+// layout.h
+// 미리보기 슬롯 배치 계산기. 슬롯별 콤보박스/썸네일 사각형을 보관하고
+// 입력(원본 크기, 슬롯 개수, 미리보기 높이, 기본 비율, 격자 목표 영역)이 바뀐 경우에만 다시 계산한다.
+// Win32 헤더에 의존하지 않음.
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+struct LayoutRect
+{
+    int left, top, right, bottom;
+
+    int Width() const { return right - left; }
+    int Height() const { return bottom - top; }
+    bool operator==(const LayoutRect& o) const { return left == o.left && top == o.top && right == o.right && bottom == o.bottom; }
+    bool operator!=(const LayoutRect& o) const { return !(*this == o); }
+};
+
+// 슬롯 하나의 배치 결과
+struct SlotGeometry
+{
+    LayoutRect picker;    // 콤보박스 영역 (슬롯 위쪽)
+    LayoutRect thumbnail; // 썸네일 목적지 사각형
+};
+
+//=============================================================================
+// LayoutEngine
+// - 가로 한 줄 배치(기본): 각 슬롯 너비는 원본 비율을 유지한 채 미리보기 높이에 맞춰 축소한 너비
+//   (원본이 미리보기 높이보다 작으면 원본 크기 그대로, 원본 크기를 모르면 기본 비율)
+// - 격자 배치(SetGridArea): 슬롯을 순서대로 여러 줄에 나누어 목표 영역에 담음. 모든 줄은 같은
+//   썸네일 높이를 쓰며, 높이는 목표 영역에 들어가는 최대값(미리보기 높이 이하). 슬롯 너비는 원본 비율 유지
+//   줄 수는 비율 누적합에서 이진 탐색으로 균등 분할하여 후보마다 O(r log n)에 평가
+// - 줄마다 슬롯 오른쪽 x좌표를 보관하여 HitTest는 줄 계산 O(1) + 줄 안에서 이진 탐색 O(log n)
+//=============================================================================
+class LayoutEngine
+{
+public:
+    LayoutEngine();
+
+    // 입력 설정. 값이 바뀐 경우에만 재계산 표시
+    void SetSlotCount(int count);
+    void SetPickerHeight(int height);
+    void SetPreviewHeight(int height);
+    void SetDefaultAspect(int numerator, int denominator);
+    // 격자 배치 목표 영역 (클라이언트 좌표 크기). 0 이하이면 가로 한 줄 배치
+    void SetGridArea(int width, int height);
+    bool IsGrid() const { return m_gridWidth > 0 && m_gridHeight > 0; }
+    // 슬롯의 원본(대상 창) 크기. cx/cy가 0 이하이면 "알 수 없음"으로 보고 기본 비율 사용
+    void SetSourceSize(int slot, int cx, int cy);
+
+    // 필요하면 재계산. 배치가 실제로 바뀌었으면 true
+    bool Update();
+
+    int SlotCount() const { return (int)m_sources.size(); }
+    const SlotGeometry& Slot(int slot) const { return m_slots[slot]; }
+    int TotalWidth() const { return m_totalWidth; }
+    int TotalHeight() const { return RowCount() * m_rowHeight; }
+    int RowCount() const { return (int)m_rowFirst.size() - 1; }
+    // 한 줄의 높이 (콤보박스 + 썸네일 영역)
+    int RowHeight() const { return m_rowHeight; }
+    int DefaultSlotWidth() const { return m_previewHeight * m_aspectNum / m_aspectDen; }
+    // 재계산 횟수 (진단용)
+    uint32_t Revision() const { return m_revision; }
+
+    // 클라이언트 좌표가 속한 슬롯 인덱스, 미리보기 영역 밖이면 -1
+    int HitTest(int x, int y) const;
+
+private:
+    struct SourceSize { int cx, cy; };
+
+    void BuildRow(std::vector<SlotGeometry>& slots);
+    void BuildGrid(std::vector<SlotGeometry>& slots);
+    double Aspect(size_t slot) const; // 슬롯의 가로/세로 비율 (원본 크기를 모르면 기본 비율)
+    // 비율 누적합을 rows 줄로 균등 분할하여 first에 각 줄의 첫 슬롯 인덱스를 채우고 가장 넓은 줄의 비율 합을 반환
+    double SplitRows(int rows, std::vector<int>& first) const;
+
+    std::vector<SourceSize> m_sources;
+    std::vector<SlotGeometry> m_slots;
+    std::vector<double> m_aspectPrefix; // m_aspectPrefix[i] = 슬롯 0..i-1의 비율 합 (격자 분할용)
+    std::vector<int> m_slotRight; // 슬롯 i의 오른쪽 x (줄 안에서 증가)
+    std::vector<int> m_rowFirst;  // 줄 r의 첫 슬롯 인덱스, m_rowFirst[rows] = 슬롯 개수
+    std::vector<int> m_rowWidth;  // 줄 r의 너비
+    int m_rowHeight;
+    int m_totalWidth;
+    int m_pickerHeight;
+    int m_previewHeight;
+    int m_aspectNum;
+    int m_aspectDen;
+    int m_gridWidth;
+    int m_gridHeight;
+    bool m_dirty;
+    uint32_t m_revision;
+};
+
+#endif // LAYOUT_H
@@ -0,0 +1,265 @@
+/*
+    modelsnapshot.cpp
+    =======================
+    WindowSnapshot, MergeSnapshot, ApplySnapshot, SnapshotExchange 구현
+*/
+#include "modelsnapshot.h"
+#include <unordered_map>
+#include <unordered_set>
+
+//-----------------------------------------------------------------------------
+// WindowSnapshot
+//-----------------------------------------------------------------------------
+void WindowSnapshot::Clear()
+{
+    diff.Clear();
+    addedTitles.clear();
+    changedTitles.clear();
+    text.clear();
+    locationChanged.clear();
+    listChanged = false;
+    foundChanges = 0;
+    hung.clear();
+    recovered.clear();
+    passes = 0;
+    enumerateMicros = 0;
+    titleMicros = 0;
+    enumVisits = 0;
+}
+
+WindowSnapshot::TitleRef WindowSnapshot::Store(const wchar_t* title, size_t length)
+{
+    TitleRef ref = { (uint32_t)text.size(), (uint32_t)length };
+    text.append(title, length);
+    return ref;
+}
+
+const wchar_t* WindowSnapshot::Resolve(const TitleRef& ref, size_t* length) const
+{
+    *length = ref.length;
+    return text.data() + ref.offset;
+}
+
+void WindowSnapshot::Record(const WindowRegistry& model, const WindowDiff& changes)
+{
+    diff.removed.insert(diff.removed.end(), changes.removed.begin(), changes.removed.end());
+    for (size_t k = 0; k < changes.added.size(); k++)
+    {
+        const WindowRegistry::Entry* entry = model.Find(changes.added[k]);
+        if (!entry)
+            continue;
+        size_t length;
+        const wchar_t* title = model.Title(*entry, &length);
+        diff.added.push_back(changes.added[k]);
+        addedTitles.push_back(Store(title, length));
+    }
+    for (size_t k = 0; k < changes.changed.size(); k++)
+    {
+        const WindowRegistry::Entry* entry = model.Find(changes.changed[k]);
+        if (!entry)
+            continue;
+        size_t length;
+        const wchar_t* title = model.Title(*entry, &length);
+        diff.changed.push_back(changes.changed[k]);
+        changedTitles.push_back(Store(title, length));
+    }
+}
+
+void WindowSnapshot::AddLocation(WindowId id)
+{
+    for (size_t k = 0; k < locationChanged.size(); k++)
+    {
+        if (locationChanged[k] == id)
+            return; // 감시 대상(미리보기 중인 창)만 들어오므로 선형 검색
+    }
+    locationChanged.push_back(id);
+}
+
+void WindowSnapshot::SetHung(WindowId id, bool isHung)
+{
+    // 격리/해제는 드물게 일어나므로 선형 검색
+    std::vector<WindowId>& from = isHung ? recovered : hung;
+    std::vector<WindowId>& to = isHung ? hung : recovered;
+    for (size_t k = 0; k < from.size(); k++)
+    {
+        if (from[k] == id)
+        {
+            from.erase(from.begin() + k);
+            break;
+        }
+    }
+    for (size_t k = 0; k < to.size(); k++)
+    {
+        if (to[k] == id)
+            return;
+    }
+    to.push_back(id);
+}
+
+//-----------------------------------------------------------------------------
+// MergeSnapshot: UI가 바쁠 때만 일어나므로 임시 해시 집합을 그때그때 만듦
+//-----------------------------------------------------------------------------
+void MergeSnapshot(WindowSnapshot& older, const WindowSnapshot& newer)
+{
+    // 1. newer에서 제거된 창: older에서 추가된 창이면 추가를 취소, 아니면 제거 목록에 더함. 제목 변경은 버림
+    if (!newer.diff.removed.empty())
+    {
+        std::unordered_set<WindowId> gone(newer.diff.removed.begin(), newer.diff.removed.end());
+        std::unordered_set<WindowId> known(older.diff.removed.begin(), older.diff.removed.end());
+        size_t write = 0;
+        for (size_t read = 0; read < older.diff.added.size(); read++)
+        {
+            WindowId id = older.diff.added[read];
+            if (gone.count(id))
+            {
+                known.insert(id); // 사본에는 없거나 older.removed가 이미 지움
+                continue;
+            }
+            older.diff.added[write] = id;
+            older.addedTitles[write] = older.addedTitles[read];
+            write++;
+        }
+        older.diff.added.resize(write);
+        older.addedTitles.resize(write);
+
+        write = 0;
+        for (size_t read = 0; read < older.diff.changed.size(); read++)
+        {
+            if (gone.count(older.diff.changed[read]))
+                continue;
+            older.diff.changed[write] = older.diff.changed[read];
+            older.changedTitles[write] = older.changedTitles[read];
+            write++;
+        }
+        older.diff.changed.resize(write);
+        older.changedTitles.resize(write);
+
+        for (size_t k = 0; k < newer.diff.removed.size(); k++)
+        {
+            if (known.insert(newer.diff.removed[k]).second)
+                older.diff.removed.push_back(newer.diff.removed[k]);
+        }
+    }
+
+    // 2. newer에서 추가된 창은 끝에 붙임 (older에서 제거된 창이 다시 나타났으면 제거 + 추가로 남음)
+    for (size_t k = 0; k < newer.diff.added.size(); k++)
+    {
+        size_t length;
+        const wchar_t* title = newer.AddedTitle(k, &length);
+        older.diff.added.push_back(newer.diff.added[k]);
+        older.addedTitles.push_back(older.Store(title, length));
+    }
+
+    // 3. 제목 변경: 이미 older에 있는 창이면 제목만 바꿈 (마지막 제목만 남김)
+    if (!newer.diff.changed.empty())
+    {
+        std::unordered_map<WindowId, size_t> addedAt;
+        std::unordered_map<WindowId, size_t> changedAt;
+        for (size_t k = 0; k < older.diff.added.size(); k++)
+            addedAt[older.diff.added[k]] = k;
+        for (size_t k = 0; k < older.diff.changed.size(); k++)
+            changedAt[older.diff.changed[k]] = k;
+        for (size_t k = 0; k < newer.diff.changed.size(); k++)
+        {
+            WindowId id = newer.diff.changed[k];
+            size_t length;
+            const wchar_t* title = newer.ChangedTitle(k, &length);
+            WindowSnapshot::TitleRef ref = older.Store(title, length);
+            std::unordered_map<WindowId, size_t>::iterator it = addedAt.find(id);
+            if (it != addedAt.end())
+            {
+                older.addedTitles[it->second] = ref; // 사본에는 새 제목으로 바로 추가됨
+                continue;
+            }
+            it = changedAt.find(id);
+            if (it != changedAt.end())
+            {
+                older.changedTitles[it->second] = ref;
+                continue;
+            }
+            changedAt[id] = older.diff.changed.size();
+            older.diff.changed.push_back(id);
+            older.changedTitles.push_back(ref);
+        }
+    }
+
+    for (size_t k = 0; k < newer.locationChanged.size(); k++)
+        older.AddLocation(newer.locationChanged[k]);
+    for (size_t k = 0; k < newer.hung.size(); k++)
+        older.SetHung(newer.hung[k], true);
+    for (size_t k = 0; k < newer.recovered.size(); k++)
+        older.SetHung(newer.recovered[k], false);
+    older.listChanged = older.listChanged || newer.listChanged;
+    older.foundChanges |= newer.foundChanges;
+    older.passes += newer.passes;
+    older.enumerateMicros += newer.enumerateMicros;
+    older.titleMicros += newer.titleMicros;
+    older.enumVisits += newer.enumVisits;
+}
+
+void ApplySnapshot(const WindowSnapshot& snapshot, WindowRegistry& replica, WindowDiff& applied)
+{
+    replica.Remove(snapshot.diff.removed, applied);
+    for (size_t k = 0; k < snapshot.diff.added.size(); k++)
+    {
+        size_t length;
+        const wchar_t* title = snapshot.AddedTitle(k, &length);
+        replica.Add(snapshot.diff.added[k], title, length, applied);
+    }
+    for (size_t k = 0; k < snapshot.diff.changed.size(); k++)
+    {
+        size_t length;
+        const wchar_t* title = snapshot.ChangedTitle(k, &length);
+        replica.UpdateTitle(snapshot.diff.changed[k], title, length, applied);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// SnapshotExchange
+// 알림 표시(m_signaled)와 게시 칸(m_ready)의 순서가 중요하므로 모두 기본(seq_cst) 순서 사용:
+// Publish는 게시 칸에 쓴 뒤 알림 표시를, Take는 알림 표시를 지운 뒤 게시 칸을 읽음
+//-----------------------------------------------------------------------------
+SnapshotExchange::~SnapshotExchange()
+{
+    delete m_ready.exchange(NULL);
+    delete m_spare.exchange(NULL);
+}
+
+WindowSnapshot* SnapshotExchange::Acquire()
+{
+    WindowSnapshot* snapshot = m_spare.exchange(NULL);
+    return snapshot ? snapshot : new WindowSnapshot();
+}
+
+bool SnapshotExchange::Publish(WindowSnapshot* snapshot)
+{
+    WindowSnapshot* pending = m_ready.exchange(NULL);
+    if (pending)
+    {
+        // UI가 아직 가져가지 않음: 기존 스냅숏에 합치고 새 스냅숏은 재사용 칸으로
+        MergeSnapshot(*pending, *snapshot);
+        Recycle(snapshot);
+        snapshot = pending;
+        m_merges.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_ready.store(snapshot);
+    return !m_signaled.exchange(true);
+}
+
+WindowSnapshot* SnapshotExchange::Take()
+{
+    m_signaled.store(false);
+    return m_ready.exchange(NULL);
+}
+
+void SnapshotExchange::Release(WindowSnapshot* snapshot)
+{
+    if (snapshot)
+        Recycle(snapshot);
+}
+
+void SnapshotExchange::Recycle(WindowSnapshot* snapshot)
+{
+    snapshot->Clear();
+    delete m_spare.exchange(snapshot); // 재사용 칸이 이미 찼으면 (Acquire 전에 양쪽에서 반납) 하나는 버림
+}
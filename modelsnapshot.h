@@ -0,0 +1,117 @@
+// modelsnapshot.h
+// 창 목록 열거/제목 읽기/필터 판정을 작업 스레드로 옮기기 위한 전달 계층.
+// 작업 스레드는 자신의 레지스트리(원본)로 한 번의 갱신 결과를 변경분 스냅숏으로 만들어 게시하고,
+// UI 스레드는 메시지 하나를 받아 스냅숏을 가져가 자신의 레지스트리(사본)에 변경분만 적용한다.
+// 게시/가져가기는 잠금 없이 원자적 포인터 교환만 사용하므로 UI 스레드는 열거가 끝나기를 기다리지 않는다.
+// Win32 헤더에 의존하지 않음: 스레드 생성과 메시지 게시는 호출 측이 처리.
+#ifndef MODELSNAPSHOT_H
+#define MODELSNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "windowregistry.h"
+
+//=============================================================================
+// WindowSnapshot: 작업 스레드의 갱신 한 번(또는 UI가 가져가기 전까지 합쳐진 여러 번)의 결과
+// - 게시된 뒤에는 UI 스레드만 읽음 (작업 스레드는 게시 후 건드리지 않음)
+// - 제목은 한 문자열(text)에 이어 붙여 보관하고 항목마다 위치/길이만 가짐 (창마다 할당하지 않음)
+// - Clear는 용량을 유지하므로 재사용하는 스냅숏은 보통 할당이 일어나지 않음
+//=============================================================================
+struct WindowSnapshot
+{
+    struct TitleRef
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    WindowDiff diff;                        // added/removed/changed (removedPositions는 쓰지 않음)
+    std::vector<TitleRef> addedTitles;      // diff.added와 같은 순서
+    std::vector<TitleRef> changedTitles;    // diff.changed와 같은 순서
+    std::wstring text;                      // 제목 글자 모음
+    std::vector<WindowId> locationChanged;  // 크기/위치가 바뀐 감시 대상 창 (중복 없음)
+    bool listChanged;                       // 목록을 다시 열거했음 (배치 갱신 필요)
+    unsigned foundChanges;                  // 변경을 찾은 주기 점검 작업 비트 (1 << RefreshTask)
+    std::vector<WindowId> hung;             // 새로 응답 없음으로 격리된 창 (마지막 제목 유지)
+    std::vector<WindowId> recovered;        // 격리가 풀린 창 (hung과 겹치지 않음)
+
+    // 작업 스레드 계측 (UI 스레드가 받아서 성능 통계에 기록)
+    uint32_t passes;                        // 합쳐진 갱신 횟수
+    uint64_t enumerateMicros;               // 재열거 소요 시간 합
+    uint64_t titleMicros;                   // 제목 다시 읽기 소요 시간 합
+    uint64_t enumVisits;                    // EnumWindows 콜백 호출 수 합
+
+    WindowSnapshot() { Clear(); }
+    void Clear();
+    bool Empty() const
+    {
+        return diff.Empty() && locationChanged.empty() && !listChanged && hung.empty() && recovered.empty();
+    }
+
+    // 원본 레지스트리의 변경분을 제목과 함께 기록 (diff의 창들은 model에 있거나 막 제거된 창)
+    void Record(const WindowRegistry& model, const WindowDiff& changes);
+    void AddLocation(WindowId id);
+    // 격리 상태 기록. 같은 창의 이전 기록(반대 목록 포함)은 마지막 상태로 바뀜
+    void SetHung(WindowId id, bool isHung);
+
+    const wchar_t* AddedTitle(size_t k, size_t* length) const { return Resolve(addedTitles[k], length); }
+    const wchar_t* ChangedTitle(size_t k, size_t* length) const { return Resolve(changedTitles[k], length); }
+
+private:
+    TitleRef Store(const wchar_t* title, size_t length);
+    const wchar_t* Resolve(const TitleRef& ref, size_t* length) const;
+
+    friend void MergeSnapshot(WindowSnapshot& older, const WindowSnapshot& newer);
+};
+
+// UI가 older를 가져가기 전에 newer가 게시되면 둘을 합침: older 다음 newer를 적용한 것과 같은 결과
+// - older에서 추가된 창이 newer에서 제거되면 둘 다 지움 (사본에는 나타나지 않음)
+// - 제거 후 다시 나타난 창은 제거 + 추가로 남김 (사본에서도 목록 끝으로 옮겨져 원본 순서와 같음)
+// - 같은 창의 제목 변경은 마지막 제목만 남김
+void MergeSnapshot(WindowSnapshot& older, const WindowSnapshot& newer);
+
+// 스냅숏을 UI 쪽 레지스트리 사본에 적용하고 실제로 바뀐 것을 applied에 기록 (제거 -> 추가 -> 제목 순)
+// 원본에서 추가된 순서대로 끝에 붙이므로 사본의 목록 순서는 원본과 같음
+void ApplySnapshot(const WindowSnapshot& snapshot, WindowRegistry& replica, WindowDiff& applied);
+
+//=============================================================================
+// SnapshotExchange: 작업 스레드 -> UI 스레드 스냅숏 전달 (생산자 1, 소비자 1)
+// - 게시 칸(ready)과 재사용 칸(spare) 두 개의 원자적 포인터로 이중 버퍼링. 잠금 없음
+// - Publish: 게시 칸에 UI가 아직 가져가지 않은 스냅숏이 있으면 그것을 꺼내 새 스냅숏을 합친 뒤 다시 게시
+//   (UI가 바쁜 동안의 갱신 여러 번이 하나로 합쳐지고 메시지도 한 번만 보냄)
+// - 반환값이 true일 때만 호출 측이 UI 스레드에 메시지를 게시. UI가 Take로 알림 표시를 지운 뒤 게시 칸을
+//   비우므로, 게시 칸이 찼는데 처리할 메시지가 없는 상태는 생기지 않음 (빈 Take는 생길 수 있음)
+// - Acquire/Release: 다 쓴 스냅숏은 재사용 칸에 두었다가 다음 갱신에 다시 씀 (용량 유지, 보통 할당 없음)
+//=============================================================================
+class SnapshotExchange
+{
+public:
+    SnapshotExchange() : m_ready(NULL), m_spare(NULL), m_signaled(false), m_merges(0) {}
+    ~SnapshotExchange();
+
+    // 작업 스레드
+    WindowSnapshot* Acquire();                  // 비어 있는 스냅숏 (재사용 칸이 비었으면 새로 만듦)
+    bool Publish(WindowSnapshot* snapshot);     // 게시. true이면 호출 측이 알림 메시지를 한 번 보냄
+
+    // UI 스레드
+    WindowSnapshot* Take();                     // 게시된 스냅숏을 가져감 (없으면 NULL)
+    void Release(WindowSnapshot* snapshot);     // 다 쓴 스냅숏 반납
+
+    uint64_t Merges() const { return m_merges.load(std::memory_order_relaxed); } // 진단용: 합쳐진 게시 횟수
+
+private:
+    SnapshotExchange(const SnapshotExchange&);
+    SnapshotExchange& operator=(const SnapshotExchange&);
+
+    void Recycle(WindowSnapshot* snapshot);
+
+    std::atomic<WindowSnapshot*> m_ready;
+    std::atomic<WindowSnapshot*> m_spare;
+    std::atomic<bool> m_signaled;               // 알림 메시지를 보냈고 UI가 아직 Take하지 않음
+    std::atomic<uint64_t> m_merges;
+};
+
+#endif // MODELSNAPSHOT_H
@@ -0,0 +1,127 @@
+/*
+    perfcounters.cpp
+    =======================
+    PerfHistogram / PerfCounters 구현
+*/
+#include "perfcounters.h"
+#include <stdio.h>
+
+//=============================================================================
+// PerfHistogram
+//=============================================================================
+void PerfHistogram::Record(uint64_t micros)
+{
+    int bucket = 0;
+    while (bucket < BUCKETS - 1 && micros >= ((uint64_t)1 << bucket))
+        bucket++;
+    m_buckets[bucket]++;
+    m_count++;
+    m_total += micros;
+    if (micros > m_max)
+        m_max = micros;
+}
+
+void PerfHistogram::Reset()
+{
+    for (int i = 0; i < BUCKETS; i++)
+        m_buckets[i] = 0;
+    m_count = 0;
+    m_total = 0;
+    m_max = 0;
+}
+
+uint64_t PerfHistogram::Percentile(int percent) const
+{
+    if (m_count == 0)
+        return 0;
+    // 순위 = ceil(count * percent / 100), 최소 1
+    uint64_t rank = (m_count * (uint64_t)percent + 99) / 100;
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++)
+    {
+        seen += m_buckets[i];
+        if (seen >= rank)
+        {
+            uint64_t upper = (uint64_t)1 << i; // 구간 상한
+            return upper < m_max ? upper : m_max;
+        }
+    }
+    return m_max;
+}
+
+//=============================================================================
+// PerfCounters
+//=============================================================================
+PerfCounters::PerfCounters() : m_clock(NULL)
+{
+    Reset();
+}
+
+void PerfCounters::Reset()
+{
+    for (int i = 0; i < PERF_PHASE_COUNT; i++)
+        m_phases[i].Reset();
+    for (int i = 0; i < PERF_COUNT_COUNT; i++)
+        m_counters[i] = 0;
+}
+
+const char* PerfCounters::PhaseName(PerfPhase phase)
+{
+    switch (phase)
+    {
+        case PERF_PHASE_EVENTS:    return "events";
+        case PERF_PHASE_REFRESH:   return "refresh";
+        case PERF_PHASE_ENUMERATE: return "enumerate";
+        case PERF_PHASE_TITLES:    return "titles";
+        case PERF_PHASE_LAYOUT:    return "layout";
+        case PERF_PHASE_COMMIT:    return "commit";
+        case PERF_PHASE_RECREATE:  return "recreate";
+        case PERF_PHASE_PAINT:     return "paint";
+        case PERF_PHASE_SEARCH:    return "search";
+        default:                   return "?";
+    }
+}
+
+const char* PerfCounters::CounterName(PerfCounter counter)
+{
+    switch (counter)
+    {
+        case PERF_COUNT_TICKS:       return "ticks";
+        case PERF_COUNT_SENDMESSAGE: return "SendMessage";
+        case PERF_COUNT_DWM:         return "DWM calls";
+        case PERF_COUNT_DEFERPOS:    return "DeferWindowPos";
+        case PERF_COUNT_ENUMVISITS:  return "EnumWindows visits";
+        default:                     return "?";
+    }
+}
+
+void PerfCounters::Format(std::string& out) const
+{
+    char line[160];
+    out.clear();
+    snprintf(line, sizeof(line), "%-10s %8s %8s %8s %8s %8s\n", "phase(us)", "count", "avg", "p50", "p99", "max");
+    out += line;
+    for (int i = 0; i < PERF_PHASE_COUNT; i++)
+    {
+        const PerfHistogram& h = m_phases[i];
+        unsigned long long avg = h.Count() ? (unsigned long long)(h.Total() / h.Count()) : 0;
+        snprintf(line, sizeof(line), "%-10s %8llu %8llu %8llu %8llu %8llu\n", PhaseName((PerfPhase)i),
+                 (unsigned long long)h.Count(), avg, (unsigned long long)h.Percentile(50),
+                 (unsigned long long)h.Percentile(99), (unsigned long long)h.Max());
+        out += line;
+    }
+
+    uint64_t ticks = m_counters[PERF_COUNT_TICKS];
+    snprintf(line, sizeof(line), "%-20s %10s %10s\n", "counter", "total", "per tick");
+    out += line;
+    for (int i = 0; i < PERF_COUNT_COUNT; i++)
+    {
+        uint64_t total = m_counters[i];
+        // 틱당 평균은 소수 둘째 자리까지 정수 연산으로 표시
+        uint64_t per100 = ticks ? total * 100 / ticks : 0;
+        snprintf(line, sizeof(line), "%-20s %10llu %7llu.%02llu\n", CounterName((PerfCounter)i),
+                 (unsigned long long)total, (unsigned long long)(per100 / 100), (unsigned long long)(per100 % 100));
+        out += line;
+    }
+}
@@ -0,0 +1,114 @@
+// perfcounters.h
+// 단계별 소요 시간 히스토그램과 호출 횟수 카운터. UI 스레드 한 곳에서만 기록한다고 가정하며 잠금 없음.
+// 시간은 SetClock으로 넘겨준 마이크로초 시계로 재므로 Win32 헤더에 의존하지 않음.
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+// 시간을 재는 단계
+enum PerfPhase
+{
+    PERF_PHASE_EVENTS,    // 작업 스레드 스냅숏 적용 (WM_APP_SNAPSHOT)
+    PERF_PHASE_REFRESH,   // 갱신 스케줄러 작업 실행 (WM_TIMER)
+    PERF_PHASE_ENUMERATE, // EnumWindows 전체 재열거 (작업 스레드, 스냅숏 하나당 한 번 기록)
+    PERF_PHASE_TITLES,    // 제목 다시 읽기 (작업 스레드)
+    PERF_PHASE_LAYOUT,    // UpdatePreviewLayout 전체 (썸네일 등록 + 배치 계산 + 적용)
+    PERF_PHASE_COMMIT,    // 배치 적용 (DeferWindowPos + DWM 속성 갱신)
+    PERF_PHASE_RECREATE,  // RecreatePreviews
+    PERF_PHASE_PAINT,     // WM_PAINT
+    PERF_PHASE_SEARCH,    // 드롭다운 검색 (입력 한 번의 색인 조회 + 목록 채우기)
+    PERF_PHASE_COUNT
+};
+
+// 호출 횟수를 세는 항목
+enum PerfCounter
+{
+    PERF_COUNT_TICKS,        // 처리한 틱 수 (WM_TIMER + WM_APP_SNAPSHOT)
+    PERF_COUNT_SENDMESSAGE,  // 콤보박스 등에 보낸 SendMessage
+    PERF_COUNT_DWM,          // DWM 썸네일 API 호출
+    PERF_COUNT_DEFERPOS,     // DeferWindowPos로 옮긴 콤보박스
+    PERF_COUNT_ENUMVISITS,   // EnumWindows 콜백 호출
+    PERF_COUNT_COUNT
+};
+
+//=============================================================================
+// PerfHistogram: 2의 거듭제곱 마이크로초 구간 히스토그램 (구간 i = [2^(i-1), 2^i) us, 구간 0 = 1us 미만)
+//=============================================================================
+class PerfHistogram
+{
+public:
+    enum { BUCKETS = 24 }; // 마지막 구간은 약 4초 이상 전부
+
+    PerfHistogram() { Reset(); }
+
+    void Record(uint64_t micros);
+    void Reset();
+
+    uint64_t Count() const { return m_count; }
+    uint64_t Total() const { return m_total; }
+    uint64_t Max() const { return m_max; }
+    uint64_t Bucket(int i) const { return m_buckets[i]; }
+    // 백분위(0~100) 추정값: 해당 백분위가 속한 구간의 상한 (us)
+    uint64_t Percentile(int percent) const;
+
+private:
+    uint64_t m_buckets[BUCKETS];
+    uint64_t m_count;
+    uint64_t m_total;
+    uint64_t m_max;
+};
+
+//=============================================================================
+// PerfCounters: 단계별 히스토그램과 카운터 모음
+//=============================================================================
+class PerfCounters
+{
+public:
+    typedef uint64_t (*ClockFn)(); // 단조 증가 마이크로초
+
+    PerfCounters();
+
+    void SetClock(ClockFn clock) { m_clock = clock; }
+    uint64_t Now() const { return m_clock ? m_clock() : 0; }
+
+    void Record(PerfPhase phase, uint64_t micros) { m_phases[phase].Record(micros); }
+    void Add(PerfCounter counter, uint64_t n = 1) { m_counters[counter] += n; }
+
+    const PerfHistogram& Phase(PerfPhase phase) const { return m_phases[phase]; }
+    uint64_t Counter(PerfCounter counter) const { return m_counters[counter]; }
+
+    void Reset();
+
+    // 사람이 읽을 수 있는 요약 (단계별 횟수/평균/p50/p99/최대, 카운터 합계와 틱당 평균). ASCII만 사용
+    void Format(std::string& out) const;
+
+    static const char* PhaseName(PerfPhase phase);
+    static const char* CounterName(PerfCounter counter);
+
+private:
+    PerfHistogram m_phases[PERF_PHASE_COUNT];
+    uint64_t m_counters[PERF_COUNT_COUNT];
+    ClockFn m_clock;
+};
+
+// 블록의 소요 시간을 단계에 기록
+class PerfScope
+{
+public:
+    PerfScope(PerfCounters& counters, PerfPhase phase)
+        : m_counters(counters), m_phase(phase), m_start(counters.Now()) {}
+    ~PerfScope() { m_counters.Record(m_phase, m_counters.Now() - m_start); }
+
+private:
+    PerfScope(const PerfScope&);
+    PerfScope& operator=(const PerfScope&);
+
+    PerfCounters& m_counters;
+    PerfPhase m_phase;
+    uint64_t m_start;
+};
+
+#endif // PERFCOUNTERS_H
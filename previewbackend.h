@@ -0,0 +1,145 @@
+// previewbackend.h
+// 미리보기 백엔드 인터페이스. 창 열거/제목 읽기와 라이브 썸네일 등록/배치를 플랫폼별 구현 뒤에 두어
+// 같은 슬롯/배치 엔진(slottable.h, layout.h, framecommit.h)이 Windows(DWM)와 Linux(X11) 양쪽에서
+// 미리보기를 구동하게 한다. Win32/X11 헤더에 의존하지 않음.
+#ifndef PREVIEWBACKEND_H
+#define PREVIEWBACKEND_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include "windowtracker.h" // WindowId
+#include "layout.h"        // LayoutRect
+
+// 백엔드가 발급하는 썸네일 핸들. 0은 "없음"
+typedef uintptr_t PreviewHandle;
+
+//=============================================================================
+// PreviewBackend
+// - EnumerateWindows: 최상위 창을 화면 순서대로 visit에 넘김 (visit이 false면 중단).
+//   호출 측은 IsCandidate로 후보만 고른 뒤 제목/필터 판정을 함 (viewermodel.h)
+// - IsCandidate: 미리보기 후보인지 (보이는 창이고 호스트 창/이 프로세스의 창이 아님)
+// - ReadTitle: 제목을 길이 제한 없이 읽음. 응답 없는 창이어서 읽지 못했으면 false (title은 비움)
+// - ReadCaption: ReadTitle이 실패한 창의 제목을 대상 창에 메시지를 보내지 않고 읽음 (없으면 빈 문자열)
+// - ReadClass/ReadProcess/ReadTraits: 필터 규칙 판정과 검색 색인용 창 정보 (처음 보는 창만). 읽지 못한 값은 비움/false
+// - Register/Unregister: 대상 창의 라이브 썸네일 등록/해제. 등록 실패 시 0
+// - Update: 썸네일 목적지(호스트 창 클라이언트 좌표)와 표시 여부. 실제 반영은 Commit에서 한 번에
+// - Commit: 이번 프레임의 변경을 합성기에 보냄. 내용이 바뀐 썸네일만 다시 그리는 백엔드는 여기서 그림
+// - 열거/제목 읽기는 작업 스레드에서도 호출되므로 상태를 갖지 않아야 하며, 썸네일 함수는 UI 스레드 전용
+//=============================================================================
+class PreviewBackend
+{
+public:
+    typedef bool (*WindowVisitor)(void* context, WindowId id);
+
+    virtual ~PreviewBackend() {}
+
+    virtual void EnumerateWindows(WindowVisitor visit, void* context) = 0;
+    virtual bool IsCandidate(WindowId id) = 0;
+    virtual bool ReadTitle(WindowId id, std::wstring& title) = 0;
+    virtual bool IsAlive(WindowId id) = 0;
+    virtual void ReadCaption(WindowId id, std::wstring& caption) { (void)id; caption.clear(); }
+    virtual void ReadClass(WindowId id, std::wstring& className) { (void)id; className.clear(); }
+    virtual void ReadProcess(WindowId id, std::wstring& process) { (void)id; process.clear(); }
+    virtual void ReadTraits(WindowId id, bool* owned, bool* toolWindow) { (void)id; *owned = *toolWindow = false; }
+
+    virtual PreviewHandle Register(WindowId source) = 0;
+    virtual void Unregister(PreviewHandle thumbnail) = 0;
+    // 원본 크기. 알 수 없으면 (예: 최소화) false이며 cx/cy는 0
+    virtual bool QuerySourceSize(PreviewHandle thumbnail, int* cx, int* cy) = 0;
+    virtual void Update(PreviewHandle thumbnail, const LayoutRect& destination, bool visible) = 0;
+    virtual void Commit() {}
+    // 보낸 변경이 화면에 합성될 때까지 기다림 (시작 시간 측정용)
+    virtual void Flush() {}
+};
+
+//=============================================================================
+// FallbackPreviewBackend
+// - 창 열거/제목은 primary에 맡기고, 썸네일 등록은 primary가 실패하면 fallback으로 다시 시도
+//   (예: DWM 합성이 없는 원격/헤드리스 세션에서 화면 캡처로 대체)
+// - 발급하는 핸들은 어느 백엔드의 핸들인지 기억하는 작은 항목이므로 호출 측은 구분할 필요 없음
+// - SetForceFallback(true)면 primary 등록을 건너뜀 (대체 경로 시험용)
+//=============================================================================
+class FallbackPreviewBackend : public PreviewBackend
+{
+public:
+    FallbackPreviewBackend(PreviewBackend* primary, PreviewBackend* fallback)
+        : m_primary(primary), m_fallback(fallback), m_forceFallback(false), m_fallbackCount(0) {}
+
+    void SetForceFallback(bool force) { m_forceFallback = force; }
+    // 지금 대체 경로로 등록된 썸네일 수
+    size_t FallbackCount() const { return m_fallbackCount; }
+    // 대체 경로로 등록된 썸네일이면 fallback이 발급한 핸들, 아니면 0 (대체 백엔드의 슬롯별 통계 조회용)
+    PreviewHandle FallbackHandle(PreviewHandle thumbnail) const
+    {
+        const Entry* entry = (const Entry*)thumbnail;
+        return entry && entry->owner == m_fallback ? entry->inner : 0;
+    }
+
+    virtual void EnumerateWindows(WindowVisitor visit, void* context) { m_primary->EnumerateWindows(visit, context); }
+    virtual bool IsCandidate(WindowId id) { return m_primary->IsCandidate(id); }
+    virtual bool ReadTitle(WindowId id, std::wstring& title) { return m_primary->ReadTitle(id, title); }
+    virtual bool IsAlive(WindowId id) { return m_primary->IsAlive(id); }
+    virtual void ReadCaption(WindowId id, std::wstring& caption) { m_primary->ReadCaption(id, caption); }
+    virtual void ReadClass(WindowId id, std::wstring& className) { m_primary->ReadClass(id, className); }
+    virtual void ReadProcess(WindowId id, std::wstring& process) { m_primary->ReadProcess(id, process); }
+    virtual void ReadTraits(WindowId id, bool* owned, bool* toolWindow) { m_primary->ReadTraits(id, owned, toolWindow); }
+
+    virtual PreviewHandle Register(WindowId source)
+    {
+        PreviewBackend* owner = m_primary;
+        PreviewHandle inner = m_forceFallback ? 0 : m_primary->Register(source);
+        if (!inner && m_fallback)
+        {
+            owner = m_fallback;
+            inner = m_fallback->Register(source);
+        }
+        if (!inner)
+            return 0;
+        if (owner == m_fallback)
+            m_fallbackCount++;
+        Entry* entry = new Entry;
+        entry->owner = owner;
+        entry->inner = inner;
+        return (PreviewHandle)entry;
+    }
+    virtual void Unregister(PreviewHandle thumbnail)
+    {
+        Entry* entry = (Entry*)thumbnail;
+        entry->owner->Unregister(entry->inner);
+        if (entry->owner == m_fallback)
+            m_fallbackCount--;
+        delete entry;
+    }
+    virtual bool QuerySourceSize(PreviewHandle thumbnail, int* cx, int* cy)
+    {
+        const Entry* entry = (const Entry*)thumbnail;
+        return entry->owner->QuerySourceSize(entry->inner, cx, cy);
+    }
+    virtual void Update(PreviewHandle thumbnail, const LayoutRect& destination, bool visible)
+    {
+        const Entry* entry = (const Entry*)thumbnail;
+        entry->owner->Update(entry->inner, destination, visible);
+    }
+    virtual void Commit()
+    {
+        m_primary->Commit();
+        if (m_fallback)
+            m_fallback->Commit();
+    }
+    virtual void Flush() { m_primary->Flush(); }
+
+private:
+    struct Entry
+    {
+        PreviewBackend* owner;
+        PreviewHandle inner;
+    };
+
+    PreviewBackend* m_primary;
+    PreviewBackend* m_fallback;
+    bool m_forceFallback;
+    size_t m_fallbackCount;
+};
+
+#endif // PREVIEWBACKEND_H
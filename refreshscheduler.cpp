@@ -0,0 +1,166 @@
+/*
+    refreshscheduler.cpp
+    =======================
+    RefreshScheduler 구현
+*/
+#include "refreshscheduler.h"
+
+RefreshScheduler::RefreshScheduler()
+    : m_throttle(THROTTLE_NONE), m_boostUntil(0), m_startTime(0), m_wakeups(0),
+      m_windowStart(0), m_windowWakeups(0), m_lastWindowWakeups(0), m_haveLastWindow(false)
+{
+    for (int i = 0; i < REFRESH_TASK_COUNT; i++)
+    {
+        TaskState& t = m_tasks[i];
+        t.minMs = 1000;
+        t.baseMs = 5000;
+        t.maxMs = 60000;
+        t.current = t.baseMs;
+        t.lastRun = 0;
+        t.due = t.baseMs;
+    }
+}
+
+void RefreshScheduler::SetInterval(RefreshTask task, uint32_t minMs, uint32_t baseMs, uint32_t maxMs)
+{
+    if (minMs == 0) minMs = 1;
+    if (baseMs < minMs) baseMs = minMs;
+    if (maxMs < baseMs) maxMs = baseMs;
+    TaskState& t = m_tasks[task];
+    t.minMs = minMs;
+    t.baseMs = baseMs;
+    t.maxMs = maxMs;
+    t.current = baseMs;
+    t.due = t.lastRun + EffectiveInterval(t, t.lastRun);
+}
+
+void RefreshScheduler::Start(uint64_t now)
+{
+    m_startTime = now;
+    m_windowStart = now;
+    m_windowWakeups = 0;
+    m_haveLastWindow = false;
+    m_wakeups = 0;
+    for (int i = 0; i < REFRESH_TASK_COUNT; i++)
+    {
+        TaskState& t = m_tasks[i];
+        t.current = t.baseMs;
+        t.lastRun = now;
+        t.due = now + EffectiveInterval(t, now);
+    }
+}
+
+void RefreshScheduler::NoteInteraction(uint64_t now)
+{
+    m_boostUntil = now + BOOST_DURATION;
+    for (int i = 0; i < REFRESH_TASK_COUNT; i++)
+    {
+        TaskState& t = m_tasks[i];
+        t.current = t.baseMs;
+        uint64_t due = now + EffectiveInterval(t, now);
+        if (due < t.due)
+            t.due = due; // 앞당기기만 함 (이미 가까운 작업은 그대로)
+    }
+}
+
+bool RefreshScheduler::SetThrottle(unsigned flags, uint64_t now)
+{
+    if (m_throttle == flags)
+        return false;
+    m_throttle = flags;
+    // 마지막 실행 시각 기준으로 다음 시각을 다시 계산 (제한이 풀리면 바로 당겨짐)
+    for (int i = 0; i < REFRESH_TASK_COUNT; i++)
+    {
+        TaskState& t = m_tasks[i];
+        t.due = t.lastRun + EffectiveInterval(t, now);
+    }
+    return true;
+}
+
+void RefreshScheduler::Completed(RefreshTask task, bool changed, uint64_t now)
+{
+    TaskState& t = m_tasks[task];
+    if (changed)
+    {
+        t.current = t.baseMs;
+    }
+    else if (t.current < t.maxMs)
+    {
+        // 변경이 없으면 지수적으로 늘림 (최대 간격까지)
+        t.current = (t.current > t.maxMs / 2) ? t.maxMs : t.current * 2;
+    }
+    t.lastRun = now;
+    t.due = now + EffectiveInterval(t, now);
+}
+
+uint32_t RefreshScheduler::NextDelay(uint64_t now) const
+{
+    uint64_t earliest = m_tasks[0].due;
+    for (int i = 1; i < REFRESH_TASK_COUNT; i++)
+    {
+        if (m_tasks[i].due < earliest)
+            earliest = m_tasks[i].due;
+    }
+    if (earliest <= now)
+        return 0;
+    uint64_t delay = earliest - now;
+    return delay > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)delay;
+}
+
+uint64_t RefreshScheduler::EffectiveInterval(const TaskState& task, uint64_t now) const
+{
+    uint64_t interval = (now < m_boostUntil) ? task.minMs : task.current;
+    return interval * ThrottleFactor();
+}
+
+uint32_t RefreshScheduler::ThrottleFactor() const
+{
+    uint32_t factor = 1;
+    if (m_throttle & THROTTLE_MINIMIZED)  factor *= 8;
+    if (m_throttle & THROTTLE_OCCLUDED)   factor *= 4;
+    if (m_throttle & THROTTLE_BATTERY)    factor *= 2;
+    if (m_throttle & THROTTLE_POWERSAVER) factor *= 4;
+    return factor > MAX_THROTTLE_FACTOR ? (uint32_t)MAX_THROTTLE_FACTOR : factor;
+}
+
+//-----------------------------------------------------------------------------
+// 깨어남 빈도 측정
+//-----------------------------------------------------------------------------
+void RefreshScheduler::RollRateWindow(uint64_t now)
+{
+    uint64_t elapsed = now - m_windowStart;
+    if (elapsed < RATE_WINDOW)
+        return;
+    // 한 구간 이상 지났으면 직전 구간을 확정 (두 구간 이상 비어 있었으면 직전 구간은 0회)
+    m_lastWindowWakeups = (elapsed < 2 * (uint64_t)RATE_WINDOW) ? m_windowWakeups : 0;
+    m_haveLastWindow = true;
+    m_windowStart = now - elapsed % RATE_WINDOW;
+    m_windowWakeups = 0;
+}
+
+void RefreshScheduler::NoteWakeup(uint64_t now)
+{
+    RollRateWindow(now);
+    m_wakeups++;
+    m_windowWakeups++;
+}
+
+uint32_t RefreshScheduler::AverageWakeupsPer100Sec(uint64_t now) const
+{
+    uint64_t elapsed = now - m_startTime;
+    if (elapsed == 0)
+        return 0;
+    return (uint32_t)(m_wakeups * 100000 / elapsed);
+}
+
+uint32_t RefreshScheduler::RecentWakeupsPer100Sec(uint64_t now) const
+{
+    uint64_t elapsed = now - m_windowStart;
+    if (elapsed >= 2 * (uint64_t)RATE_WINDOW)
+        return 0; // 마지막 깨어남 이후 한 구간 넘게 조용했음
+    if (elapsed >= RATE_WINDOW)
+        return (uint32_t)(m_windowWakeups * 100000 / RATE_WINDOW); // 현재 구간이 이미 끝남
+    if (m_haveLastWindow)
+        return (uint32_t)(m_lastWindowWakeups * 100000 / RATE_WINDOW);
+    return elapsed ? (uint32_t)(m_windowWakeups * 100000 / elapsed) : 0; // 첫 구간은 경과 시간 기준
+}
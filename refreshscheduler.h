@@ -0,0 +1,104 @@
+// refreshscheduler.h
+// 주기 작업(창 목록 안전 점검, 제목 재확인)의 실행 시각을 정하는 스케줄러.
+// 작업별 간격을 두고 변경이 없으면 지수적으로 늘리며, 사용자 조작 직후에는 잠시 짧게,
+// 메인 윈도우가 최소화/가려짐 상태이거나 배터리/절전 모드이면 길게 잡는다.
+// 타이머 하나로 가장 이른 작업 시각에만 깨어나도록 다음 대기 시간을 알려 주고, 깨어난 횟수를 집계한다.
+// 시간은 호출 측이 넘겨주는 ms 단위 단조 증가 값을 사용하며 Win32 헤더에 의존하지 않음.
+#ifndef REFRESHSCHEDULER_H
+#define REFRESHSCHEDULER_H
+
+#include <stdint.h>
+
+enum RefreshTask
+{
+    REFRESH_WINDOWLIST, // 창 목록 전체 재열거 (WinEvent 누락 대비)
+    REFRESH_TITLES,     // 미리보기 중인 창의 제목 재확인 (제목 변경 이벤트를 보내지 않는 창 대비)
+    REFRESH_TASK_COUNT
+};
+
+// 간격을 늘리는 조건 (비트 조합)
+enum RefreshThrottle
+{
+    THROTTLE_NONE       = 0,
+    THROTTLE_MINIMIZED  = 1 << 0, // 메인 윈도우 최소화
+    THROTTLE_OCCLUDED   = 1 << 1, // 메인 윈도우가 완전히 가려짐 (다른 가상 데스크톱 포함)
+    THROTTLE_BATTERY    = 1 << 2, // 배터리 전원
+    THROTTLE_POWERSAVER = 1 << 3  // 절전 모드
+};
+
+//=============================================================================
+// RefreshScheduler
+// - 작업마다 최소(조작 직후)/기본/최대 간격을 가짐. 실행 결과 변경이 없으면 간격을 2배로(최대까지),
+//   변경이 있으면 기본 간격으로 되돌림
+// - 조작(NoteInteraction) 후 BOOST_DURATION 동안은 최소 간격 사용
+// - 제한 조건마다 배율을 곱함 (최대 MAX_THROTTLE_FACTOR배)
+// - 깨어남(NoteWakeup) 횟수를 전체 평균과 최근 1분 구간 평균으로 제공
+//=============================================================================
+class RefreshScheduler
+{
+public:
+    enum
+    {
+        BOOST_DURATION = 10000,     // 조작 후 짧은 간격을 유지하는 시간(ms)
+        MAX_THROTTLE_FACTOR = 16,   // 제한 배율 상한
+        RATE_WINDOW = 60000         // 최근 깨어남 빈도 측정 구간(ms)
+    };
+
+    RefreshScheduler();
+
+    // 작업 간격 설정 (ms). minMs <= baseMs <= maxMs로 보정됨
+    void SetInterval(RefreshTask task, uint32_t minMs, uint32_t baseMs, uint32_t maxMs);
+
+    // 측정과 일정을 now 기준으로 시작 (모든 작업이 기본 간격 뒤에 실행됨)
+    void Start(uint64_t now);
+
+    // 사용자 조작: 모든 작업을 기본 간격으로 되돌리고 잠시 최소 간격으로 당김
+    void NoteInteraction(uint64_t now);
+
+    // 제한 조건 갱신. 바뀌었으면 true (호출 측은 타이머를 다시 설정해야 함)
+    bool SetThrottle(unsigned flags, uint64_t now);
+    unsigned Throttle() const { return m_throttle; }
+
+    // now 시점에 실행할 작업인지 (실행 후에는 반드시 Completed 호출)
+    bool IsDue(RefreshTask task, uint64_t now) const { return now >= m_tasks[task].due; }
+    // 작업 실행 결과 보고. changed가 false이면 간격을 늘림
+    void Completed(RefreshTask task, bool changed, uint64_t now);
+
+    // 가장 이른 작업까지 남은 시간(ms). 이미 지났으면 0
+    uint32_t NextDelay(uint64_t now) const;
+
+    // 현재 작업 간격 (제한/조작 반영 전, 진단용)
+    uint32_t CurrentInterval(RefreshTask task) const { return m_tasks[task].current; }
+
+    // UI 스레드가 깨어날 때마다 호출 (타이머, 창 이벤트 메시지 등)
+    void NoteWakeup(uint64_t now);
+    uint64_t WakeupCount() const { return m_wakeups; }
+    // 시작 이후 평균 / 최근 측정 구간의 초당 깨어남 횟수 (x100, 정수 출력용)
+    uint32_t AverageWakeupsPer100Sec(uint64_t now) const;
+    uint32_t RecentWakeupsPer100Sec(uint64_t now) const;
+
+private:
+    struct TaskState
+    {
+        uint32_t minMs, baseMs, maxMs;
+        uint32_t current; // 현재 유휴 간격 (baseMs ~ maxMs)
+        uint64_t lastRun; // 마지막 실행 시각 (제한 조건 변경 시 다음 시각 재계산용)
+        uint64_t due;     // 다음 실행 시각
+    };
+
+    uint64_t EffectiveInterval(const TaskState& task, uint64_t now) const;
+    uint32_t ThrottleFactor() const;
+    void RollRateWindow(uint64_t now);
+
+    TaskState m_tasks[REFRESH_TASK_COUNT];
+    unsigned m_throttle;
+    uint64_t m_boostUntil;
+    uint64_t m_startTime;
+    uint64_t m_wakeups;
+    uint64_t m_windowStart;     // 현재 측정 구간 시작 시각
+    uint64_t m_windowWakeups;   // 현재 측정 구간의 깨어남 횟수
+    uint64_t m_lastWindowWakeups; // 직전 측정 구간의 깨어남 횟수
+    bool m_haveLastWindow;
+};
+
+#endif // REFRESHSCHEDULER_H
@@ -0,0 +1,498 @@
+/*
+    scalebench.cpp
+    =======================
+    캡처 대체 경로의 축소 커널(downscale.h) 처리량을 원본 메가픽셀/초로 재는 벤치마크.
+    Win32 없이 Linux에서 빌드/실행 가능 (benchbuild.sh).
+
+    - box: 원본을 반으로 한 번 줄임 (BoxHalve)
+    - bilinear: 원본에서 슬롯 크기로 바로 쌍선형 축소
+    - scale: 실제 캡처 경로와 같은 박스 반복 + 쌍선형 마무리 (Downscaler::Scale)
+    - 이 CPU가 지원하는 구현(scalar/sse2/avx2/neon)마다 한 줄씩 출력하고, 결과가 스칼라 기준과
+      비트 단위로 같은지(exact) 확인. 다르면 종료 코드 1
+    - 마지막에 슬롯 32개를 모두 캡처 경로로 갱신할 때 한 번에 드는 시간 (1080p 원본 -> 기본 슬롯 크기)
+    - hash: 캡처 변경 감지(framediff.h)의 타일 해시 처리량과 구현별 해시가 스칼라와 같은지, 균일한 배경 위 한 줄/막대/점이
+      자리만 옮겼을 때 모두 바뀐 것으로 보는지(shifted), 그리고 슬롯 32개가 모두 그대로일 때(감지만)와 타일 하나만
+      바뀔 때(감지 + 그 행만 축소) 한 번 갱신하는 시간
+    - diff: 활동 감시(activitymonitor.h)의 표본 차이 처리량과 구현별 값이 스칼라와 같은지, 그리고 슬롯 32개를 모두
+      감시할 때 표본 한 차례에 드는 시간과 기본 표본 간격에서의 코어 점유율. 1080p 프레임을 넘겨 모듈이 줄이는 경우와
+      winview.cpp처럼 표본 크기로 캡처해 넘기는 경우(presized, 비교만. StretchBlt 시간은 제외)를 따로 잼
+    - record: 화면 기록(framerecorder.h) 프레임 하나(1080p -> 160x90 축소 + 차이 부호화)의 시간과 차이 크기
+      (그대로 / 일부 바뀜 / 전체 바뀜), 그리고 파일로 내보낸 기록을 복원한 결과가 기록한 프레임과 같은지
+
+    사용법: scalebench [--ms N] [--slots N]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "downscale.h"
+#include "framediff.h"
+#include "activitymonitor.h"
+#include "framerecorder.h"
+
+// 기본 슬롯 미리보기 크기 (winview.cpp PREVIEW_HEIGHT 300, 4:3 슬롯 안에 16:9 원본)
+const int SLOT_WIDTH = 400;
+const int SLOT_HEIGHT = 225;
+
+struct OwnedImage
+{
+    std::vector<uint8_t> bytes;
+    PixelImage view;
+
+    OwnedImage(int width, int height)
+    {
+        // 줄 끝에 여유를 두어 stride != width * 4 인 캡처 버퍼(DIB/XImage 패딩)와 같은 조건으로 잼
+        int stride = width * 4 + 64;
+        bytes.assign((size_t)stride * height, 0);
+        view.pixels = &bytes[0];
+        view.width = width;
+        view.height = height;
+        view.stride = stride;
+    }
+};
+
+static void FillRandom(OwnedImage& image, uint32_t seed)
+{
+    uint32_t state = seed ? seed : 1;
+    for (size_t i = 0; i < image.bytes.size(); i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        image.bytes[i] = (uint8_t)state;
+    }
+}
+
+static bool SameImage(const PixelImage& a, const PixelImage& b)
+{
+    for (int y = 0; y < a.height; y++)
+    {
+        if (memcmp(a.pixels + (size_t)y * a.stride, b.pixels + (size_t)y * b.stride, (size_t)a.width * 4) != 0)
+            return false;
+    }
+    return true;
+}
+
+enum Kernel
+{
+    KERNEL_BOX,
+    KERNEL_BILINEAR,
+    KERNEL_SCALE,
+    KERNEL_COUNT
+};
+
+static const char* const kKernelNames[KERNEL_COUNT] = { "box", "bilinear", "scale" };
+
+static void RunKernel(Kernel kernel, Downscaler& scaler, const PixelImage& src, const PixelImage& dst)
+{
+    switch (kernel)
+    {
+    case KERNEL_BOX: BoxHalve(src, dst, scaler.Level()); break;
+    case KERNEL_BILINEAR: scaler.Bilinear(src, dst); break;
+    default: scaler.Scale(src, dst); break;
+    }
+}
+
+// 최소 minMillis 동안 반복해서 원본 메가픽셀/초
+static double Measure(Kernel kernel, Downscaler& scaler, const PixelImage& src, const PixelImage& dst, int minMillis)
+{
+    typedef std::chrono::steady_clock Clock;
+    RunKernel(kernel, scaler, src, dst); // 표/버퍼 준비
+    uint64_t runs = 0;
+    Clock::time_point start = Clock::now();
+    double elapsed = 0;
+    do
+    {
+        for (int i = 0; i < 4; i++)
+            RunKernel(kernel, scaler, src, dst);
+        runs += 4;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed * 1000 < minMillis);
+    return (double)src.width * src.height * runs / elapsed / 1e6;
+}
+
+// 균일한 배경 타일 위에서 같은 내용이 자리만 옮긴 경우를 해시가 구별하는지 셈. 구별하지 못한 경우 수를 돌려줌
+// - 한 줄(밑줄/한 줄 글자), 짧은 막대(진행 막대)가 세로로 옮김: 모든 두 위치 쌍
+// - 짧은 막대가 가로로 8픽셀 단위로 옮김, 점 하나가 타일 안 모든 위치로 옮김
+static int CountShiftMisses(SimdLevel level, int* cases)
+{
+    const int width = FrameChangeDetector::TILE_WIDTH, height = FrameChangeDetector::TILE_HEIGHT;
+    const uint32_t background = 0xFF202020u, ink = 0xFFE0E0E0u;
+    std::vector<uint32_t> tile((size_t)width * height);
+    struct Shape { int left, right, top, bottom; };
+    // 모양을 그리고 해시
+    struct Draw
+    {
+        static uint64_t Hash(std::vector<uint32_t>& tile, int width, int height, const Shape& shape,
+                             uint32_t background, uint32_t ink, SimdLevel level)
+        {
+            for (size_t i = 0; i < tile.size(); i++)
+                tile[i] = background;
+            for (int y = shape.top; y < shape.bottom; y++)
+                for (int x = shape.left; x < shape.right; x++)
+                    tile[(size_t)y * width + x] = ink;
+            return HashPixels((const uint8_t*)&tile[0], width * 4, width, height, level);
+        }
+    };
+
+    std::vector<Shape> moves[4];
+    for (int y = 0; y < height; y++)
+    {
+        Shape line = { 0, width, y, y + 1 };
+        Shape bar = { 4, 44, y, y + 1 };
+        moves[0].push_back(line);
+        moves[1].push_back(bar);
+    }
+    for (int x = 0; x + 40 <= width; x += 8)
+    {
+        Shape bar = { x, x + 16, 10, 14 };
+        moves[2].push_back(bar);
+    }
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            Shape dot = { x, x + 1, y, y + 1 };
+            moves[3].push_back(dot);
+        }
+    }
+
+    int misses = 0;
+    *cases = 0;
+    for (int m = 0; m < 4; m++)
+    {
+        std::vector<uint64_t> hashes;
+        for (size_t i = 0; i < moves[m].size(); i++)
+            hashes.push_back(Draw::Hash(tile, width, height, moves[m][i], background, ink, level));
+        if (m < 3)
+        {
+            for (size_t i = 0; i < hashes.size(); i++)
+                for (size_t j = i + 1; j < hashes.size(); j++, (*cases)++)
+                    misses += hashes[i] == hashes[j] ? 1 : 0;
+        }
+        else
+        {
+            for (size_t i = 1; i < hashes.size(); i++, (*cases)++)
+                misses += hashes[i] == hashes[0] ? 1 : 0;
+        }
+    }
+
+    // 감지기 경로: 5번째 줄의 한 줄이 9번째 줄로 옮김
+    FrameChangeDetector detector(level);
+    Shape before = { 0, width, 5, 6 }, after = { 0, width, 9, 10 };
+    PixelImage view = { (uint8_t*)&tile[0], width, height, width * 4 };
+    Draw::Hash(tile, width, height, before, background, ink, level);
+    detector.Update(view);
+    Draw::Hash(tile, width, height, after, background, ink, level);
+    misses += detector.Update(view) ? 0 : 1;
+    (*cases)++;
+    return misses;
+}
+
+// 기록기가 링에 넣었을 프레임(원본을 기록 크기로 줄인 것)을 줄 여유 없이 frames 끝에 추가
+static void AppendRecordedFrame(std::vector<std::vector<uint8_t> >& frames, Downscaler& scaler, const PixelImage& src,
+                                OwnedImage& small)
+{
+    scaler.Scale(src, small.view);
+    frames.push_back(std::vector<uint8_t>((size_t)small.view.width * small.view.height * 4));
+    for (int y = 0; y < small.view.height; y++)
+        memcpy(&frames.back()[(size_t)y * small.view.width * 4], small.view.pixels + (size_t)y * small.view.stride,
+               (size_t)small.view.width * 4);
+}
+
+int main(int argc, char** argv)
+{
+    int minMillis = 200;
+    int slots = 32;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--ms") && i + 1 < argc)
+            minMillis = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--slots") && i + 1 < argc)
+            slots = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [--ms N] [--slots N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    static const int kSources[][2] = { { 1280, 720 }, { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 }, { 1021, 767 } };
+
+    bool allExact = true;
+    printf("best=%s\n", SimdLevelName(DetectSimdLevel()));
+    printf("%-9s %-11s %-9s %-7s %10s %8s %6s\n", "kernel", "source", "dest", "impl", "MP/s", "speedup", "exact");
+    for (size_t s = 0; s < sizeof(kSources) / sizeof(kSources[0]); s++)
+    {
+        OwnedImage src(kSources[s][0], kSources[s][1]);
+        FillRandom(src, (uint32_t)(s + 1));
+        for (int k = 0; k < KERNEL_COUNT; k++)
+        {
+            Kernel kernel = (Kernel)k;
+            int dstWidth = kernel == KERNEL_BOX ? src.view.width / 2 : SLOT_WIDTH;
+            int dstHeight = kernel == KERNEL_BOX ? src.view.height / 2 : SLOT_HEIGHT;
+            OwnedImage reference(dstWidth, dstHeight);
+            Downscaler referenceScaler(SIMD_SCALAR);
+            RunKernel(kernel, referenceScaler, src.view, reference.view);
+
+            double scalarRate = 0;
+            for (int l = 0; l < SIMD_LEVEL_COUNT; l++)
+            {
+                SimdLevel level = (SimdLevel)l;
+                if (!SimdLevelSupported(level))
+                    continue;
+                Downscaler scaler(level);
+                OwnedImage dst(dstWidth, dstHeight);
+                RunKernel(kernel, scaler, src.view, dst.view);
+                bool exact = SameImage(reference.view, dst.view);
+                allExact = allExact && exact;
+                double rate = Measure(kernel, scaler, src.view, dst.view, minMillis);
+                if (level == SIMD_SCALAR)
+                    scalarRate = rate;
+                char source[32], dest[32];
+                snprintf(source, sizeof(source), "%dx%d", src.view.width, src.view.height);
+                snprintf(dest, sizeof(dest), "%dx%d", dstWidth, dstHeight);
+                printf("%-9s %-11s %-9s %-7s %10.1f %7.2fx %6s\n", kKernelNames[k], source, dest, SimdLevelName(level),
+                       rate, scalarRate > 0 ? rate / scalarRate : 0.0, exact ? "yes" : "NO");
+            }
+        }
+    }
+
+    // 슬롯 전체 갱신 비용: 1080p 캡처 slots개를 기본 슬롯 크기로
+    OwnedImage capture(1920, 1080);
+    FillRandom(capture, 7);
+    OwnedImage slot(SLOT_WIDTH, SLOT_HEIGHT);
+    for (int l = 0; l < SIMD_LEVEL_COUNT; l++)
+    {
+        SimdLevel level = (SimdLevel)l;
+        if (!SimdLevelSupported(level))
+            continue;
+        Downscaler scaler(level);
+        double rate = Measure(KERNEL_SCALE, scaler, capture.view, slot.view, minMillis);
+        double millis = 1920.0 * 1080.0 * slots / (rate * 1e6) * 1000;
+        printf("%d slots 1920x1080 -> %dx%d %-7s %8.2f ms/refresh\n", slots, SLOT_WIDTH, SLOT_HEIGHT,
+               SimdLevelName(level), millis);
+    }
+
+    // 변경 감지: 1080p 프레임 전체 타일 해시
+    printf("%-9s %-11s %-9s %-7s %10s %8s %6s\n", "kernel", "source", "tiles", "impl", "MP/s", "speedup", "exact");
+    double scalarHashRate = 0;
+    for (int l = 0; l < SIMD_LEVEL_COUNT; l++)
+    {
+        typedef std::chrono::steady_clock Clock;
+        SimdLevel level = (SimdLevel)l;
+        if (!SimdLevelSupported(level))
+            continue;
+        // 너비가 8의 배수가 아닌 영역(줄 끝 스칼라 처리)도 비교
+        bool exact = HashPixels(capture.view.pixels, capture.view.stride, 1917, 1080, level) ==
+                     HashPixels(capture.view.pixels, capture.view.stride, 1917, 1080, SIMD_SCALAR);
+        allExact = allExact && exact;
+        FrameChangeDetector detector(level);
+        detector.Update(capture.view);
+        uint64_t runs = 0;
+        Clock::time_point start = Clock::now();
+        double elapsed = 0;
+        do
+        {
+            detector.Update(capture.view);
+            runs++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed * 1000 < minMillis);
+        double rate = 1920.0 * 1080.0 * runs / elapsed / 1e6;
+        if (level == SIMD_SCALAR)
+            scalarHashRate = rate;
+        char tiles[32];
+        snprintf(tiles, sizeof(tiles), "%dx%d", detector.Columns(), detector.Rows());
+        printf("%-9s %-11s %-9s %-7s %10.1f %7.2fx %6s\n", "hash", "1920x1080", tiles, SimdLevelName(level), rate,
+               scalarHashRate > 0 ? rate / scalarHashRate : 0.0, exact ? "yes" : "NO");
+    }
+
+    // 변경 감지: 자리만 옮긴 내용 (이전 해시는 4줄 주기로 같은 값이 되어 놓쳤음)
+    for (int l = 0; l < SIMD_LEVEL_COUNT; l++)
+    {
+        SimdLevel level = (SimdLevel)l;
+        if (!SimdLevelSupported(level))
+            continue;
+        int cases = 0;
+        int misses = CountShiftMisses(level, &cases);
+        allExact = allExact && misses == 0;
+        printf("%-9s %-11s %-9s %-7s %6d cases %d missed %6s\n", "hash", "shifted", "64x32", SimdLevelName(level),
+               cases, misses, misses == 0 ? "yes" : "NO");
+    }
+
+    // 변경 감지를 거친 슬롯 갱신: 모두 그대로 / 타일 하나만 바뀜
+    {
+        typedef std::chrono::steady_clock Clock;
+        Downscaler scaler;
+        FrameChangeDetector detector;
+        detector.Update(capture.view);
+        scaler.Scale(capture.view, slot.view);
+        const int rounds = 16;
+        double unchanged = 0, oneTile = 0;
+        for (int r = 0; r < rounds; r++)
+        {
+            Clock::time_point start = Clock::now();
+            detector.Update(capture.view);
+            unchanged += std::chrono::duration<double>(Clock::now() - start).count();
+
+            capture.view.pixels[(size_t)(r * 61 % 1080) * capture.view.stride + (r * 397 % 1920) * 4] ^= 0x5A;
+            start = Clock::now();
+            if (detector.Update(capture.view))
+            {
+                int srcTop, srcBottom, dstTop, dstBottom;
+                detector.DirtyRows(&srcTop, &srcBottom);
+                scaler.ScaleRows(capture.view, slot.view, srcTop, srcBottom, &dstTop, &dstBottom);
+            }
+            oneTile += std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        printf("%d slots 1920x1080 -> %dx%d %-7s %8.2f ms/refresh unchanged, %.2f ms/refresh one tile changed\n",
+               slots, SLOT_WIDTH, SLOT_HEIGHT, SimdLevelName(scaler.Level()), unchanged / rounds * slots * 1000,
+               oneTile / rounds * slots * 1000);
+    }
+
+    // 활동 감시: 표본 크기 이미지의 차이 (픽셀 수가 SIMD 폭의 배수가 아닌 경우도 비교)
+    printf("%-9s %-11s %-9s %-7s %10s %8s %6s\n", "kernel", "source", "pixels", "impl", "MP/s", "speedup", "exact");
+    {
+        typedef std::chrono::steady_clock Clock;
+        OwnedImage a(ActivityMonitor::SAMPLE_WIDTH, ActivityMonitor::SAMPLE_HEIGHT);
+        OwnedImage b(ActivityMonitor::SAMPLE_WIDTH, ActivityMonitor::SAMPLE_HEIGHT);
+        FillRandom(a, 11);
+        FillRandom(b, 12);
+        const size_t pixels = (size_t)a.view.width * a.view.height;
+        const uint64_t reference = FrameDifference(a.view.pixels + 4, b.view.pixels, pixels - 3, SIMD_SCALAR);
+        double scalarDiffRate = 0;
+        for (int l = 0; l < SIMD_LEVEL_COUNT; l++)
+        {
+            SimdLevel level = (SimdLevel)l;
+            if (!SimdLevelSupported(level))
+                continue;
+            bool exact = FrameDifference(a.view.pixels + 4, b.view.pixels, pixels - 3, level) == reference;
+            allExact = allExact && exact;
+            uint64_t runs = 0;
+            volatile uint64_t sink = 0; // 결과를 써서 측정 루프가 최적화로 지워지지 않게 함
+            Clock::time_point start = Clock::now();
+            double elapsed = 0;
+            do
+            {
+                for (int i = 0; i < 64; i++)
+                    sink = sink + FrameDifference(a.view.pixels, b.view.pixels, pixels, level);
+                runs += 64;
+                elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            } while (elapsed * 1000 < minMillis);
+            double rate = (double)pixels * runs / elapsed / 1e6;
+            if (level == SIMD_SCALAR)
+                scalarDiffRate = rate;
+            char source[32], count[32];
+            snprintf(source, sizeof(source), "%dx%d", a.view.width, a.view.height);
+            snprintf(count, sizeof(count), "%u", (unsigned)pixels);
+            printf("%-9s %-11s %-9s %-7s %10.1f %7.2fx %6s\n", "diff", source, count, SimdLevelName(level), rate,
+                   scalarDiffRate > 0 ? rate / scalarDiffRate : 0.0, exact ? "yes" : "NO");
+        }
+    }
+
+    // 활동 감시: slots개 슬롯을 모두 감시할 때 표본 한 차례 (캡처 시간 제외).
+    // 1080p 프레임을 넘길 때와 표본 크기로 캡처한 프레임을 넘길 때 (winview.cpp의 CaptureSample)
+    {
+        typedef std::chrono::steady_clock Clock;
+        OwnedImage presized(ActivityMonitor::SAMPLE_WIDTH, ActivityMonitor::SAMPLE_HEIGHT);
+        for (int pass = 0; pass < 2; pass++)
+        {
+            OwnedImage& frame = pass == 0 ? capture : presized;
+            ActivityMonitor monitor;
+            ActivityConfig config = ActivityMonitor::DefaultConfig();
+            config.budgetPermille = 1000; // 측정 중에는 예산으로 미루지 않음
+            monitor.SetConfig(config);
+            monitor.Resize(slots);
+            for (int i = 0; i < slots; i++)
+                monitor.SetWatch(i, ACTIVITY_CHANGE, 0);
+            const int rounds = 16;
+            double elapsed = 0;
+            for (int r = 0; r < rounds; r++)
+            {
+                uint64_t now = (uint64_t)(r + 1) * config.sampleMillis;
+                frame.view.pixels[(size_t)(r * 61 % frame.view.height) * frame.view.stride + (r * 397 % frame.view.width) * 4] ^= 0x5A;
+                Clock::time_point start = Clock::now();
+                for (int slot = monitor.NextDue(now); slot >= 0; slot = monitor.NextDue(now))
+                    monitor.Submit(slot, frame.view, now);
+                elapsed += std::chrono::duration<double>(Clock::now() - start).count();
+            }
+            double millis = elapsed / rounds * 1000;
+            char source[32];
+            snprintf(source, sizeof(source), "%dx%d", frame.view.width, frame.view.height);
+            printf("%d slots activity sample %-9s -> %dx%d %-7s %8.3f ms/round, %.3f%% of a core at %u ms (budget %u.%u%%)\n",
+                   slots, source, (int)ActivityMonitor::SAMPLE_WIDTH, (int)ActivityMonitor::SAMPLE_HEIGHT,
+                   SimdLevelName(DetectSimdLevel()), millis, millis / config.sampleMillis * 100, config.sampleMillis,
+                   ActivityMonitor::DefaultConfig().budgetPermille / 10, ActivityMonitor::DefaultConfig().budgetPermille % 10);
+        }
+    }
+
+    // 화면 기록: 그대로 / 일부(400x300 영역) 바뀜 / 전체 바뀜 프레임 하나의 시간과 차이 크기, 내보낸 기록 복원 확인
+    {
+        typedef std::chrono::steady_clock Clock;
+        FrameRecorder recorder;
+        recorder.Resize(1);
+        recorder.SetRecording(0, true, 0);
+        const int kinds = 3;
+        const char* kKindNames[kinds] = { "unchanged", "partial", "full" };
+        double seconds[kinds] = { 0, 0, 0 };
+        uint64_t bytes[kinds] = { 0, 0, 0 };
+        const int rounds = 16;
+        uint64_t now = 0;
+        std::vector<std::vector<uint8_t> > expected;
+        Downscaler check;
+        OwnedImage small(FrameRecorder::RECORD_WIDTH, FrameRecorder::RECORD_HEIGHT);
+        recorder.Submit(0, capture.view, now); // 첫 프레임은 검은 프레임과의 차이이므로 측정에서 뺌
+        AppendRecordedFrame(expected, check, capture.view, small);
+        for (int r = 0; r < rounds; r++)
+        {
+            for (int k = 0; k < kinds; k++)
+            {
+                if (k == 1)
+                {
+                    for (int y = 300; y < 600; y++)
+                        for (int x = 0; x < 400 * 4; x++)
+                            capture.view.pixels[(size_t)y * capture.view.stride + (r * 97 % 1000) * 4 + x] += (uint8_t)(r + 1);
+                }
+                else if (k == 2)
+                {
+                    FillRandom(capture, (uint32_t)(100 + r));
+                }
+                now += recorder.Config().intervalMillis;
+                uint64_t before = recorder.EncodedBytes();
+                Clock::time_point start = Clock::now();
+                recorder.Submit(0, capture.view, now);
+                seconds[k] += std::chrono::duration<double>(Clock::now() - start).count();
+                bytes[k] += recorder.EncodedBytes() - before;
+                AppendRecordedFrame(expected, check, capture.view, small);
+            }
+        }
+        for (int k = 0; k < kinds; k++)
+            printf("record %-9s 1920x1080 -> %dx%d %8.3f ms/frame, %6u bytes/frame (raw %d)\n", kKindNames[k],
+                   (int)FrameRecorder::RECORD_WIDTH, (int)FrameRecorder::RECORD_HEIGHT, seconds[k] / rounds * 1000,
+                   (unsigned)(bytes[k] / rounds), (int)FrameRecorder::RECORD_PIXELS * 3);
+
+        std::vector<uint8_t> file;
+        RecordingReader reader;
+        bool exact = recorder.Export(0, now, 0, file) && reader.Open(&file[0], file.size()) &&
+                     reader.FrameCount() <= expected.size();
+        size_t first = exact ? expected.size() - reader.FrameCount() : 0;
+        for (uint32_t f = 0; exact && f < reader.FrameCount(); f++)
+        {
+            exact = reader.Next(NULL);
+            for (int i = 0; exact && i < FrameRecorder::RECORD_PIXELS; i++)
+                exact = memcmp(reader.Frame() + i * 4, &expected[first + f][i * 4], 3) == 0;
+        }
+        allExact = allExact && exact;
+        printf("record export %u frames, %u bytes, replay %s\n", reader.FrameCount(), (unsigned)file.size(),
+               exact ? "exact" : "DIFFERS");
+    }
+
+    if (!allExact)
+    {
+        printf("FAILED: SIMD output differs from scalar reference\n");
+        return 1;
+    }
+    return 0;
+}
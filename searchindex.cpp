@@ -0,0 +1,486 @@
+/*
+    searchindex.cpp
+    =======================
+    SearchIndex 구현
+*/
+#include "searchindex.h"
+#include <wchar.h>
+#include <wctype.h>
+#include <algorithm>
+#include <iterator> // std::back_inserter
+
+// 켜진 가장 낮은 비트의 위치 (word != 0)
+static inline unsigned CountTrailingZeros(uint64_t word)
+{
+#if defined(__GNUC__)
+    return (unsigned)__builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (unsigned)index;
+#else
+    unsigned n = 0;
+    while (!(word & 1)) { word >>= 1; n++; }
+    return n;
+#endif
+}
+
+wchar_t SearchIndex::Fold(wchar_t c)
+{
+    if (c >= L'A' && c <= L'Z')
+        return (wchar_t)(c + (L'a' - L'A'));
+    if (c < 0x80)
+        return c;
+    return (wchar_t)towlower((wint_t)c);
+}
+
+void SearchIndex::FoldInto(const wchar_t* text, size_t length, std::wstring& out)
+{
+    out.resize(length); // 용량이 충분하면 재할당 없음
+    for (size_t i = 0; i < length; i++)
+        out[i] = Fold(text[i]);
+}
+
+uint64_t SearchIndex::Gram(wchar_t a, wchar_t b, wchar_t c)
+{
+    // wchar_t는 최대 21비트(UTF-32) 또는 16비트(UTF-16). 1/2글자 조각은 앞을 0으로 채움 (제목에 NUL은 없음)
+    return ((uint64_t)(uint32_t)a << 42) | ((uint64_t)(uint32_t)b << 21) | (uint64_t)(uint32_t)c;
+}
+
+uint64_t SearchIndex::GramAt(const std::wstring& text, size_t position, size_t length)
+{
+    if (length == 1)
+        return Gram(0, 0, text[position]);
+    if (length == 2)
+        return Gram(0, text[position], text[position + 1]);
+    return Gram(text[position], text[position + 1], text[position + 2]);
+}
+
+void SearchIndex::CollectGrams(const std::wstring& text, size_t begin, size_t end, std::vector<uint64_t>& grams)
+{
+    // [begin, end)와 겹치는 조각. 구간이 비어 있으면 그 자리를 가로지르는 조각 (삽입/삭제 지점)
+    for (size_t length = 1; length <= 3; length++)
+    {
+        for (size_t i = begin >= length - 1 ? begin - (length - 1) : 0; i < end && i + length <= text.size(); i++)
+            grams.push_back(GramAt(text, i, length));
+    }
+}
+
+//-----------------------------------------------------------------------------
+// posting 관리
+//-----------------------------------------------------------------------------
+bool SearchIndex::Posting::Has(uint32_t doc) const
+{
+    if (Dense())
+        return (doc >> 6) < bits.size() && (bits[doc >> 6] >> (doc & 63) & 1) != 0;
+    return std::binary_search(docs.begin(), docs.end(), doc);
+}
+
+// 배열이 비트맵보다 커지면 비트맵으로, 비트맵의 절반보다 작아지면 배열로 (사이 구간에서는 그대로 두어 오가지 않음)
+void SearchIndex::MakeDense(Posting& posting)
+{
+    posting.bits.assign((m_docs.size() + 63) / 64, 0);
+    for (size_t i = 0; i < posting.docs.size(); i++)
+        posting.bits[posting.docs[i] >> 6] |= (uint64_t)1 << (posting.docs[i] & 63);
+    std::vector<uint32_t>().swap(posting.docs);
+}
+
+void SearchIndex::MakeSparse(Posting& posting)
+{
+    posting.docs.clear();
+    for (size_t w = 0; w < posting.bits.size(); w++)
+    {
+        for (uint64_t word = posting.bits[w]; word; word &= word - 1)
+            posting.docs.push_back((uint32_t)(w * 64 + CountTrailingZeros(word)));
+    }
+    std::vector<uint64_t>().swap(posting.bits);
+}
+
+void SearchIndex::AddPosting(uint64_t gram, uint32_t doc)
+{
+    Posting& posting = m_postings[gram];
+    if (posting.Dense())
+    {
+        if ((doc >> 6) >= posting.bits.size())
+            posting.bits.resize((doc >> 6) + 1, 0);
+        uint64_t mask = (uint64_t)1 << (doc & 63);
+        if (!(posting.bits[doc >> 6] & mask))
+        {
+            posting.bits[doc >> 6] |= mask;
+            posting.count++;
+        }
+        return;
+    }
+    std::vector<uint32_t>::iterator it = std::lower_bound(posting.docs.begin(), posting.docs.end(), doc);
+    if (it != posting.docs.end() && *it == doc)
+        return;
+    posting.docs.insert(it, doc);
+    posting.count++;
+    if (posting.count > 2 * ((m_docs.size() + 63) / 64))
+        MakeDense(posting);
+}
+
+void SearchIndex::RemovePosting(uint64_t gram, uint32_t doc)
+{
+    std::unordered_map<uint64_t, Posting>::iterator found = m_postings.find(gram);
+    if (found == m_postings.end())
+        return;
+    Posting& posting = found->second;
+    if (posting.Dense())
+    {
+        uint64_t mask = (uint64_t)1 << (doc & 63);
+        if ((doc >> 6) < posting.bits.size() && (posting.bits[doc >> 6] & mask))
+        {
+            posting.bits[doc >> 6] &= ~mask;
+            posting.count--;
+            if (posting.count < posting.bits.size())
+                MakeSparse(posting);
+        }
+    }
+    else
+    {
+        std::vector<uint32_t>::iterator it = std::lower_bound(posting.docs.begin(), posting.docs.end(), doc);
+        if (it != posting.docs.end() && *it == doc)
+        {
+            posting.docs.erase(it);
+            posting.count--;
+        }
+    }
+    // 빈 목록은 바로 지움. 시계처럼 숫자만 바뀌는 제목은 같은 조각이 곧 다시 쓰이지만
+    // 조각 종류가 무한히 쌓이는 것보다 작은 배열을 다시 만드는 편이 나음
+    if (posting.count == 0)
+        m_postings.erase(found);
+}
+
+bool SearchIndex::GramBefore(const GramCount& entry, uint64_t gram)
+{
+    return entry.gram < gram;
+}
+
+void SearchIndex::Reindex(uint32_t docNumber)
+{
+    Doc& doc = m_docs[docNumber];
+    m_newGrams.clear();
+    for (int f = 0; f < FIELD_COUNT; f++)
+        CollectGrams(doc.fields[f], 0, doc.fields[f].size(), m_newGrams);
+    std::sort(m_newGrams.begin(), m_newGrams.end());
+    m_newCounts.clear();
+    for (size_t k = 0; k < m_newGrams.size(); k++)
+    {
+        if (!m_newCounts.empty() && m_newCounts.back().gram == m_newGrams[k])
+            m_newCounts.back().count++;
+        else
+        {
+            GramCount entry = { m_newGrams[k], 1 };
+            m_newCounts.push_back(entry);
+        }
+    }
+
+    // 이전 조각과 병합하며 빠진 것/새로 생긴 것만 posting에 반영
+    const std::vector<GramCount>& oldGrams = doc.grams;
+    size_t i = 0, j = 0;
+    while (i < oldGrams.size() || j < m_newCounts.size())
+    {
+        if (j == m_newCounts.size() || (i < oldGrams.size() && oldGrams[i].gram < m_newCounts[j].gram))
+            RemovePosting(oldGrams[i++].gram, docNumber);
+        else if (i == oldGrams.size() || m_newCounts[j].gram < oldGrams[i].gram)
+            AddPosting(m_newCounts[j++].gram, docNumber);
+        else
+        {
+            i++;
+            j++;
+        }
+    }
+    doc.grams.swap(m_newCounts); // 이전 배열은 다음 계산의 버퍼로 재사용
+    doc.dirty = false;
+}
+
+void SearchIndex::ApplyPendingTitle(uint32_t docNumber)
+{
+    Doc& doc = m_docs[docNumber];
+    const std::wstring& oldTitle = doc.fields[FIELD_TITLE];
+    const std::wstring& newTitle = doc.pendingTitle;
+
+    // 공통 앞/뒤 부분을 뺀 바뀐 구간 (숫자만 바뀌는 제목이면 몇 글자)
+    size_t shorter = std::min(oldTitle.size(), newTitle.size());
+    size_t prefix = 0;
+    while (prefix < shorter && oldTitle[prefix] == newTitle[prefix])
+        prefix++;
+    size_t suffix = 0;
+    while (suffix < shorter - prefix &&
+           oldTitle[oldTitle.size() - 1 - suffix] == newTitle[newTitle.size() - 1 - suffix])
+        suffix++;
+
+    m_newGrams.clear();
+    m_oldGrams.clear();
+    CollectGrams(newTitle, prefix, newTitle.size() - suffix, m_newGrams);
+    CollectGrams(oldTitle, prefix, oldTitle.size() - suffix, m_oldGrams);
+
+    // 더하기를 먼저 하여 같은 조각이 빠졌다 다시 생길 때 posting을 지웠다 넣지 않도록 함
+    std::vector<GramCount>& grams = doc.grams;
+    for (size_t k = 0; k < m_newGrams.size(); k++)
+    {
+        std::vector<GramCount>::iterator it = std::lower_bound(grams.begin(), grams.end(), m_newGrams[k], GramBefore);
+        if (it != grams.end() && it->gram == m_newGrams[k])
+            it->count++;
+        else
+        {
+            GramCount entry = { m_newGrams[k], 1 };
+            grams.insert(it, entry);
+            AddPosting(m_newGrams[k], docNumber);
+        }
+    }
+    for (size_t k = 0; k < m_oldGrams.size(); k++)
+    {
+        std::vector<GramCount>::iterator it = std::lower_bound(grams.begin(), grams.end(), m_oldGrams[k], GramBefore);
+        if (it == grams.end() || it->gram != m_oldGrams[k])
+            continue; // 있을 수 없지만 색인을 망가뜨리지 않도록 무시
+        if (--it->count == 0)
+        {
+            grams.erase(it);
+            RemovePosting(m_oldGrams[k], docNumber);
+        }
+    }
+    doc.fields[FIELD_TITLE].swap(doc.pendingTitle);
+    doc.dirty = false;
+}
+
+uint32_t SearchIndex::AllocDoc(WindowId id)
+{
+    uint32_t number;
+    if (!m_freeDocs.empty())
+    {
+        number = m_freeDocs.back();
+        m_freeDocs.pop_back();
+    }
+    else
+    {
+        number = (uint32_t)m_docs.size();
+        m_docs.push_back(Doc());
+    }
+    m_docs[number].id = id;
+    m_docs[number].dirty = false;
+    m_index[id] = number;
+    m_docCount++;
+    return number;
+}
+
+//-----------------------------------------------------------------------------
+// 문서 추가/갱신/제거
+//-----------------------------------------------------------------------------
+void SearchIndex::Set(WindowId id, const wchar_t* title, size_t titleLength, const wchar_t* process, const wchar_t* className)
+{
+    std::unordered_map<WindowId, uint32_t>::iterator it = m_index.find(id);
+    uint32_t number = (it == m_index.end()) ? AllocDoc(id) : it->second;
+    Doc& doc = m_docs[number];
+    FoldInto(title, titleLength, doc.fields[FIELD_TITLE]);
+    FoldInto(process ? process : L"", process ? wcslen(process) : 0, doc.fields[FIELD_PROCESS]);
+    FoldInto(className ? className : L"", className ? wcslen(className) : 0, doc.fields[FIELD_CLASS]);
+    Reindex(number);
+}
+
+bool SearchIndex::SetTitle(WindowId id, const wchar_t* title, size_t length)
+{
+    std::unordered_map<WindowId, uint32_t>::iterator it = m_index.find(id);
+    if (it == m_index.end())
+        return false;
+    Doc& doc = m_docs[it->second];
+    FoldInto(title, length, doc.pendingTitle);
+    if (!doc.dirty)
+    {
+        doc.dirty = true;
+        m_dirtyDocs.push_back(it->second);
+        if (m_dirtyDocs.size() > 2 * m_docs.size())
+            CompactDirty(); // 검색 없이 창이 계속 생겼다 사라지면 제거된 번호가 쌓이므로 정리
+    }
+    return true;
+}
+
+void SearchIndex::Remove(WindowId id)
+{
+    std::unordered_map<WindowId, uint32_t>::iterator it = m_index.find(id);
+    if (it == m_index.end())
+        return;
+    uint32_t number = it->second;
+    Doc& doc = m_docs[number];
+    for (size_t i = 0; i < doc.grams.size(); i++)
+        RemovePosting(doc.grams[i].gram, number);
+    doc.grams.clear();
+    for (int f = 0; f < FIELD_COUNT; f++)
+        doc.fields[f].clear();
+    doc.pendingTitle.clear();
+    doc.id = 0;
+    doc.dirty = false; // m_dirtyDocs에 남은 번호는 Flush에서 건너뜀
+    m_index.erase(it);
+    m_freeDocs.push_back(number);
+    m_docCount--;
+}
+
+void SearchIndex::Clear()
+{
+    m_docs.clear();
+    m_freeDocs.clear();
+    m_dirtyDocs.clear();
+    m_index.clear();
+    m_postings.clear();
+    m_docCount = 0;
+}
+
+size_t SearchIndex::PostingEntries() const
+{
+    size_t total = 0;
+    for (std::unordered_map<uint64_t, Posting>::const_iterator it = m_postings.begin();
+         it != m_postings.end(); ++it)
+        total += it->second.count;
+    return total;
+}
+
+//-----------------------------------------------------------------------------
+// 검색
+//-----------------------------------------------------------------------------
+bool SearchIndex::DocMatches(const Doc& doc, const std::wstring& term) const
+{
+    for (int f = 0; f < FIELD_COUNT; f++)
+    {
+        if (doc.fields[f].find(term) != std::wstring::npos)
+            return true;
+    }
+    return false;
+}
+
+// 문서가 적은 목록부터. 같은 목록이 여러 번 나오면 붙어 있도록 주소로 한 번 더 정렬
+bool SearchIndex::PostingOrder(const Posting* a, const Posting* b)
+{
+    return a->count != b->count ? a->count < b->count : a < b;
+}
+
+void SearchIndex::CompactDirty()
+{
+    size_t write = 0;
+    for (size_t i = 0; i < m_dirtyDocs.size(); i++)
+    {
+        if (m_docs[m_dirtyDocs[i]].dirty)
+            m_dirtyDocs[write++] = m_dirtyDocs[i];
+    }
+    m_dirtyDocs.resize(write);
+    std::sort(m_dirtyDocs.begin(), m_dirtyDocs.end());
+    m_dirtyDocs.erase(std::unique(m_dirtyDocs.begin(), m_dirtyDocs.end()), m_dirtyDocs.end());
+}
+
+void SearchIndex::Flush()
+{
+    for (size_t i = 0; i < m_dirtyDocs.size(); i++)
+    {
+        if (m_docs[m_dirtyDocs[i]].dirty)
+            ApplyPendingTitle(m_dirtyDocs[i]);
+    }
+    m_dirtyDocs.clear();
+}
+
+bool SearchIndex::Search(const wchar_t* query, size_t length, std::vector<WindowId>& out)
+{
+    out.clear();
+    Flush();
+
+    // 1. 소문자로 바꾸고 공백으로 단어 분리 (단어 버퍼는 재사용)
+    FoldInto(query, length, m_query);
+    size_t termCount = 0;
+    size_t pos = 0;
+    while (pos < m_query.size())
+    {
+        while (pos < m_query.size() && iswspace((wint_t)m_query[pos]))
+            pos++;
+        size_t end = pos;
+        while (end < m_query.size() && !iswspace((wint_t)m_query[end]))
+            end++;
+        if (end > pos)
+        {
+            if (termCount == m_terms.size())
+                m_terms.push_back(std::wstring());
+            m_terms[termCount++].assign(m_query, pos, end - pos);
+        }
+        pos = end;
+    }
+    if (termCount == 0)
+        return false;
+
+    // 2. 단어마다 조각의 posting을 모음. 3글자 이하 단어는 조각 하나가 곧 정답이고,
+    //    더 긴 단어는 3글자 조각 전부를 모은 뒤 나중에 확인. 없는 조각이 하나라도 있으면 결과 없음
+    m_lists.clear();
+    bool verify = false;
+    for (size_t t = 0; t < termCount; t++)
+    {
+        const std::wstring& term = m_terms[t];
+        size_t grams = term.size() <= 3 ? 1 : term.size() - 2;
+        verify = verify || term.size() > 3;
+        for (size_t i = 0; i < grams; i++)
+        {
+            uint64_t gram = GramAt(term, i, std::min<size_t>(term.size(), 3));
+            std::unordered_map<uint64_t, Posting>::const_iterator it = m_postings.find(gram);
+            if (it == m_postings.end())
+                return true;
+            m_lists.push_back(&it->second);
+        }
+    }
+
+    // 3. 가장 짧은 목록부터 교집합. 첫 목록이 비트맵이면 비트맵끼리 워드 AND로 먼저 좁힘
+    std::sort(m_lists.begin(), m_lists.end(), PostingOrder);
+    const Posting& first = *m_lists[0];
+    if (first.Dense())
+    {
+        m_bits.assign(first.bits.begin(), first.bits.end());
+        for (size_t k = 1; k < m_lists.size(); k++)
+        {
+            const Posting& list = *m_lists[k];
+            if (!list.Dense() || &list == m_lists[k - 1])
+                continue;
+            size_t words = std::min(m_bits.size(), list.bits.size());
+            for (size_t w = 0; w < words; w++)
+                m_bits[w] &= list.bits[w];
+            m_bits.resize(words);
+        }
+        m_candidates.clear();
+        for (size_t w = 0; w < m_bits.size(); w++)
+        {
+            for (uint64_t word = m_bits[w]; word; word &= word - 1)
+                m_candidates.push_back((uint32_t)(w * 64 + CountTrailingZeros(word)));
+        }
+    }
+    else
+    {
+        m_candidates.assign(first.docs.begin(), first.docs.end());
+    }
+    for (size_t k = 1; k < m_lists.size() && !m_candidates.empty(); k++)
+    {
+        const Posting& list = *m_lists[k];
+        if (&list == m_lists[k - 1] || (first.Dense() && list.Dense()))
+            continue; // 같은 조각이 여러 번 나온 경우, 또는 이미 AND한 비트맵
+        m_scratch.clear();
+        if (list.Dense())
+        {
+            for (size_t c = 0; c < m_candidates.size(); c++)
+            {
+                if (list.Has(m_candidates[c]))
+                    m_scratch.push_back(m_candidates[c]);
+            }
+        }
+        else
+        {
+            std::set_intersection(m_candidates.begin(), m_candidates.end(),
+                                  list.docs.begin(), list.docs.end(), std::back_inserter(m_scratch));
+        }
+        m_candidates.swap(m_scratch);
+    }
+
+    // 4. 4글자 이상 단어는 조각이 모두 있어도 연속된 부분 문자열이 아닐 수 있으므로 실제로 확인
+    for (size_t c = 0; c < m_candidates.size(); c++)
+    {
+        const Doc& doc = m_docs[m_candidates[c]];
+        bool matches = true;
+        for (size_t t = 0; t < termCount && matches && verify; t++)
+            matches = m_terms[t].size() <= 3 || DocMatches(doc, m_terms[t]);
+        if (matches)
+            out.push_back(doc.id);
+    }
+    return true;
+}
@@ -0,0 +1,125 @@
+// searchindex.h
+// 창 목록 검색용 n-gram(1~3글자 조각) 색인. 창마다 제목/프로세스 이름/클래스 이름을 소문자로 바꿔 보관하고
+// 1~3글자 조각 -> 창 목록(posting)을 유지한다. 제목이 바뀌면 그 창만 표시해 두었다가 다음 검색 때 이전 제목과
+// 달라진 구간의 조각만 고치므로, 시계처럼 계속 바뀌는 제목도 검색하지 않는 동안에는 비용이 거의 없고 색인 전체를
+// 다시 만들지 않는다.
+// 검색은 가장 짧은 목록부터 교집합을 구한 뒤 실제 부분 문자열인지 확인한다.
+// Win32 헤더에 의존하지 않음.
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "windowtracker.h" // WindowId
+
+//=============================================================================
+// SearchIndex
+// - 검색어는 공백으로 나눈 단어들이며 모든 단어가 (제목, 프로세스, 클래스 중 어디든) 포함된 창만 찾음
+// - 대소문자 구분 없음. 3글자 이하 단어는 해당 조각의 posting이 곧 결과이고, 더 긴 단어는 3글자 조각들의
+//   교집합으로 후보를 좁힌 뒤 실제 부분 문자열인지 확인
+// - 조각은 필드 경계를 넘지 않음 (제목 끝과 프로세스 이름 앞을 이어 붙인 검색어는 찾지 않음)
+// - posting은 창이 적은 조각이면 문서 번호 오름차순 배열(추가/제거는 이진 탐색), 흔한 조각(숫자, 모음 등)이면
+//   문서 번호 비트맵: 큰 배열 중간 삽입/삭제 없이 비트 하나만 바꾸고, 교집합은 비트 검사/워드 AND
+// - SetTitle은 제목만 보관하고 표시(dirty)만 남김. 조각 계산은 다음 Search에서 표시된 창만 한 번씩
+//   (같은 창의 제목이 검색 사이에 여러 번 바뀌어도 한 번만 계산)
+// - 문서마다 조각별 등장 횟수를 보관: 제목의 공통 앞/뒤 부분을 뺀 바뀐 구간에 걸친 조각만 더하고 빼며,
+//   횟수가 0 <-> 1로 바뀐 조각만 posting을 수정
+// - 검색 결과 순서는 문서 번호 순 (호출 측에서 목록 순서로 정렬)
+// - 검색 중 사용하는 임시 버퍼는 재사용하므로 입력마다 할당이 거의 없음
+//=============================================================================
+class SearchIndex
+{
+public:
+    SearchIndex() : m_docCount(0) {}
+
+    // 창 추가 또는 전체 갱신. process/className은 NUL 종료 문자열 (NULL이면 빈 문자열)
+    void Set(WindowId id, const wchar_t* title, size_t titleLength, const wchar_t* process, const wchar_t* className);
+    // 제목만 갱신 (프로세스/클래스는 유지, 조각 계산은 다음 Search까지 미룸). 색인에 없는 창이면 false
+    bool SetTitle(WindowId id, const wchar_t* title, size_t length);
+    void Remove(WindowId id);
+    void Clear();
+
+    bool Contains(WindowId id) const { return m_index.find(id) != m_index.end(); }
+    size_t Size() const { return m_docCount; }
+
+    // 미뤄 둔 제목 변경을 색인에 반영 (Search가 먼저 호출함)
+    void Flush();
+    // query에 맞는 창을 out에 채움 (out은 먼저 비움). 검색어가 비어 있으면 false (out은 빈 상태)
+    bool Search(const wchar_t* query, size_t length, std::vector<WindowId>& out);
+
+    // 진단용: 서로 다른 조각 수, posting 항목 총합
+    size_t TrigramCount() const { return m_postings.size(); }
+    size_t PostingEntries() const;
+
+private:
+    enum { FIELD_TITLE, FIELD_PROCESS, FIELD_CLASS, FIELD_COUNT };
+
+    // 조각 하나의 문서 목록. bits가 비어 있으면 docs(정렬 배열), 아니면 bits(비트맵)를 사용
+    struct Posting
+    {
+        std::vector<uint32_t> docs;
+        std::vector<uint64_t> bits;
+        size_t count;
+
+        Posting() : count(0) {}
+        bool Dense() const { return !bits.empty(); }
+        bool Has(uint32_t doc) const;
+    };
+
+    struct GramCount
+    {
+        uint64_t gram;
+        uint32_t count;                 // 이 문서의 모든 필드에서 등장한 횟수 (0인 항목은 없음)
+    };
+
+    struct Doc
+    {
+        WindowId id;                    // 0이면 빈 자리 (재사용 대기)
+        std::wstring fields[FIELD_COUNT]; // 소문자로 바꾼 필드 (색인에 반영된 상태)
+        std::wstring pendingTitle;      // dirty일 때 아직 반영하지 않은 새 제목
+        std::vector<GramCount> grams;   // 이 문서의 조각 (조각 값 오름차순)
+        bool dirty;                     // 제목이 바뀌었으나 아직 조각을 다시 계산하지 않음
+    };
+
+    static wchar_t Fold(wchar_t c);
+    static void FoldInto(const wchar_t* text, size_t length, std::wstring& out);
+    static uint64_t Gram(wchar_t a, wchar_t b, wchar_t c);
+    static bool PostingOrder(const Posting* a, const Posting* b); // 교집합 순서 (문서 적은 목록부터)
+    static bool GramBefore(const GramCount& entry, uint64_t gram); // lower_bound용
+    static uint64_t GramAt(const std::wstring& text, size_t position, size_t length);
+    // text에서 [first, end) 위치에서 시작하는 1~3글자 조각 (end를 넘어 끝나는 조각 포함, 문자열 밖은 제외)
+    static void CollectGrams(const std::wstring& text, size_t first, size_t end, std::vector<uint64_t>& grams);
+
+    void Reindex(uint32_t doc);                 // 문서 조각 전체를 다시 계산 후 달라진 posting만 수정
+    void ApplyPendingTitle(uint32_t doc);       // 바뀐 제목 구간의 조각만 더하고 뺌
+    void AddPosting(uint64_t gram, uint32_t doc);
+    void RemovePosting(uint64_t gram, uint32_t doc);
+    void MakeDense(Posting& posting);
+    void MakeSparse(Posting& posting);
+    bool DocMatches(const Doc& doc, const std::wstring& term) const;
+    uint32_t AllocDoc(WindowId id);
+    void CompactDirty();                        // 재계산 대기 목록에서 제거된/중복 번호 정리
+
+    std::vector<Doc> m_docs;
+    std::vector<uint32_t> m_freeDocs;
+    std::vector<uint32_t> m_dirtyDocs;              // 조각 재계산 대기 (제거/재사용된 번호가 남아 있을 수 있음, dirty로 확인)
+    std::unordered_map<WindowId, uint32_t> m_index;  // WindowId -> 문서 번호
+    std::unordered_map<uint64_t, Posting> m_postings; // 조각 -> 문서 목록
+    size_t m_docCount;
+
+    // 재사용 버퍼
+    std::vector<uint64_t> m_newGrams;
+    std::vector<uint64_t> m_oldGrams;
+    std::vector<GramCount> m_newCounts;
+    std::wstring m_query;
+    std::vector<std::wstring> m_terms;
+    std::vector<const Posting*> m_lists;
+    std::vector<uint32_t> m_candidates;
+    std::vector<uint32_t> m_scratch;
+    std::vector<uint64_t> m_bits;
+};
+
+#endif // SEARCHINDEX_H
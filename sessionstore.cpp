@@ -0,0 +1,260 @@
+/*
+    sessionstore.cpp
+    =======================
+    슬롯 연결 저장 형식, SessionMatcher, SaveDebouncer 구현
+*/
+#include "sessionstore.h"
+#include <algorithm>
+#include <wchar.h>
+#include <wctype.h>
+
+static const uint8_t kSessionMagic[4] = { 'M', 'W', 'V', 'S' };
+static const uint16_t kSessionVersion = 1;
+
+static wchar_t FoldChar(wchar_t c)
+{
+    if (c >= L'A' && c <= L'Z')
+        return (wchar_t)(c + (L'a' - L'A'));
+    if (c < 0x80)
+        return c;
+    return (wchar_t)towlower((wint_t)c);
+}
+
+void MakeTitlePattern(const wchar_t* title, size_t length, std::wstring& out)
+{
+    out.clear();
+    for (size_t i = 0; i < length && out.size() < SESSION_MAX_PATTERN; i++)
+    {
+        wchar_t c = title[i];
+        if (c >= L'0' && c <= L'9')
+        {
+            if (out.empty() || out[out.size() - 1] != L'#')
+                out.push_back(L'#');
+            continue;
+        }
+        out.push_back(c);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// 직렬화
+//-----------------------------------------------------------------------------
+static uint32_t Crc32(const uint8_t* data, size_t size)
+{
+    // 파일이 작고 저장이 드물어 표 없이 비트 단위로 계산
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+static void PutU16(std::vector<uint8_t>& out, uint16_t value)
+{
+    out.push_back((uint8_t)(value & 0xFF));
+    out.push_back((uint8_t)(value >> 8));
+}
+
+static uint16_t GetU16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void PutString(std::vector<uint8_t>& out, const std::wstring& text)
+{
+    size_t length = text.size() < 0xFFFF ? text.size() : 0xFFFF;
+    PutU16(out, (uint16_t)length);
+    for (size_t i = 0; i < length; i++)
+        PutU16(out, (uint16_t)text[i]); // Windows의 wchar_t는 UTF-16 한 단위
+}
+
+static bool GetString(const uint8_t*& p, const uint8_t* end, std::wstring& text)
+{
+    if (end - p < 2)
+        return false;
+    size_t length = GetU16(p);
+    p += 2;
+    if ((size_t)(end - p) < length * 2)
+        return false;
+    text.resize(length);
+    for (size_t i = 0; i < length; i++, p += 2)
+        text[i] = (wchar_t)GetU16(p);
+    return true;
+}
+
+void EncodeSession(const std::vector<SlotBinding>& bindings, std::vector<uint8_t>& out)
+{
+    out.clear();
+    for (size_t i = 0; i < sizeof(kSessionMagic); i++)
+        out.push_back(kSessionMagic[i]);
+    PutU16(out, kSessionVersion);
+    size_t count = bindings.size() < 0xFFFF ? bindings.size() : 0xFFFF;
+    PutU16(out, (uint16_t)count);
+    for (size_t i = 0; i < count; i++)
+    {
+        PutString(out, bindings[i].process);
+        PutString(out, bindings[i].className);
+        PutString(out, bindings[i].titlePattern);
+    }
+    uint32_t crc = Crc32(out.empty() ? NULL : &out[0], out.size());
+    PutU16(out, (uint16_t)(crc & 0xFFFF));
+    PutU16(out, (uint16_t)(crc >> 16));
+}
+
+bool DecodeSession(const uint8_t* data, size_t size, std::vector<SlotBinding>& out)
+{
+    out.clear();
+    if (!data || size < 4 + 2 + 2 + 4)
+        return false;
+    const uint8_t* end = data + size - 4;
+    uint32_t crc = (uint32_t)GetU16(end) | ((uint32_t)GetU16(end + 2) << 16);
+    if (crc != Crc32(data, size - 4))
+        return false; // 쓰다 만 파일이나 손상된 파일
+    if (!std::equal(kSessionMagic, kSessionMagic + 4, data) || GetU16(data + 4) != kSessionVersion)
+        return false;
+
+    size_t count = GetU16(data + 6);
+    const uint8_t* p = data + 8;
+    out.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!GetString(p, end, out[i].process) ||
+            !GetString(p, end, out[i].className) ||
+            !GetString(p, end, out[i].titlePattern))
+        {
+            out.clear();
+            return false;
+        }
+    }
+    return p == end;
+}
+
+//-----------------------------------------------------------------------------
+// SessionMatcher
+//-----------------------------------------------------------------------------
+void SessionMatcher::Begin(const std::vector<SlotBinding>& bindings)
+{
+    m_bindings = bindings;
+    m_candidates.clear();
+    m_offers = 0;
+    bool any = false;
+    for (size_t i = 0; i < m_bindings.size(); i++)
+    {
+        std::wstring& process = m_bindings[i].process;
+        for (size_t k = 0; k < process.size(); k++)
+            process[k] = FoldChar(process[k]);
+        any = any || !m_bindings[i].Empty();
+    }
+    if (!any)
+        m_bindings.clear(); // 복원할 슬롯이 없으면 Offer를 받지 않음
+}
+
+bool SessionMatcher::WantsClass(const wchar_t* className) const
+{
+    for (size_t slot = 0; slot < m_bindings.size(); slot++)
+    {
+        if (!m_bindings[slot].Empty() && m_bindings[slot].className == className)
+            return true;
+    }
+    return false;
+}
+
+bool SessionMatcher::SameFolded(const std::wstring& folded, const wchar_t* text)
+{
+    size_t i = 0;
+    for (; i < folded.size(); i++)
+    {
+        if (!text[i] || FoldChar(text[i]) != folded[i])
+            return false;
+    }
+    return text[i] == 0;
+}
+
+void SessionMatcher::Offer(WindowId id, const wchar_t* process, const wchar_t* className,
+                           const wchar_t* title, size_t titleLength)
+{
+    if (m_bindings.empty())
+        return;
+    if (!process) process = L"";
+    if (!className) className = L"";
+    uint32_t order = m_offers++;
+    bool patternReady = false;
+    for (size_t slot = 0; slot < m_bindings.size(); slot++)
+    {
+        const SlotBinding& binding = m_bindings[slot];
+        if (binding.Empty() || binding.className != className || !SameFolded(binding.process, process))
+            continue;
+        if (!patternReady)
+        {
+            // 같은 앱의 창일 때만 제목 패턴을 계산
+            MakeTitlePattern(title, titleLength, m_pattern);
+            patternReady = true;
+        }
+        const std::wstring& saved = binding.titlePattern;
+        uint32_t score;
+        if (saved == m_pattern)
+        {
+            score = 0x10000; // 공통 부분 점수(최대 SESSION_MAX_PATTERN + 1)보다 항상 큼
+        }
+        else
+        {
+            size_t shorter = std::min(saved.size(), m_pattern.size());
+            size_t prefix = 0;
+            while (prefix < shorter && saved[prefix] == m_pattern[prefix])
+                prefix++;
+            size_t suffix = 0;
+            while (suffix < shorter - prefix &&
+                   saved[saved.size() - 1 - suffix] == m_pattern[m_pattern.size() - 1 - suffix])
+                suffix++;
+            score = (uint32_t)(prefix + suffix + 1);
+        }
+        Candidate candidate = { score, (uint32_t)slot, order, id };
+        m_candidates.push_back(candidate);
+    }
+}
+
+bool SessionMatcher::Better(const Candidate& a, const Candidate& b)
+{
+    if (a.score != b.score)
+        return a.score > b.score;
+    if (a.slot != b.slot)
+        return a.slot < b.slot;
+    return a.order < b.order;
+}
+
+void SessionMatcher::Finish(std::vector<WindowId>& assigned)
+{
+    assigned.assign(m_bindings.size(), 0);
+    std::sort(m_candidates.begin(), m_candidates.end(), Better);
+    std::vector<WindowId> used; // 배정된 창 (슬롯 수 이하이므로 선형 검색)
+    for (size_t i = 0; i < m_candidates.size() && used.size() < assigned.size(); i++)
+    {
+        const Candidate& candidate = m_candidates[i];
+        if (assigned[candidate.slot] != 0 ||
+            std::find(used.begin(), used.end(), candidate.window) != used.end())
+            continue;
+        assigned[candidate.slot] = candidate.window;
+        used.push_back(candidate.window);
+    }
+    m_bindings.clear();
+    m_candidates.clear();
+}
+
+//-----------------------------------------------------------------------------
+// SaveDebouncer
+//-----------------------------------------------------------------------------
+uint64_t SaveDebouncer::Touch(uint64_t now)
+{
+    if (!m_pending)
+    {
+        m_pending = true;
+        m_first = now;
+    }
+    uint64_t due = now + m_quiet;
+    uint64_t latest = m_first + m_maxWait;
+    m_due = due < latest ? due : latest;
+    return m_due;
+}
@@ -0,0 +1,103 @@
+// sessionstore.h
+// 슬롯 연결 상태(슬롯마다 어떤 창을 미리보기 중이었는지)를 재시작 뒤에도 복원하기 위한 저장 형식과 매칭.
+// 창 핸들은 재시작하면 의미가 없으므로 창을 식별 정보(실행 파일 이름, 클래스 이름, 제목 패턴)로 기록하고,
+// 시작 시 첫 열거에서 보이는 창을 한 번씩 대조하여 슬롯마다 가장 잘 맞는 창을 고른다.
+// 저장은 변경이 잠잠해진 뒤 한 번에 모아 쓰도록(write-behind) 시각 계산만 제공한다.
+// Win32 헤더에 의존하지 않음: 파일 읽기/쓰기(임시 파일에 쓴 뒤 교체)와 타이머는 호출 측이 처리.
+#ifndef SESSIONSTORE_H
+#define SESSIONSTORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "windowtracker.h" // WindowId
+
+// 슬롯 하나에 연결된 창의 식별 정보. 빈 슬롯이면 세 필드 모두 비어 있음
+struct SlotBinding
+{
+    std::wstring process;       // 실행 파일 이름 (경로 제외, 업데이트로 설치 경로가 바뀌어도 일치)
+    std::wstring className;     // 창 클래스 이름
+    std::wstring titlePattern;  // MakeTitlePattern으로 만든 제목 패턴
+
+    bool Empty() const { return process.empty() && className.empty() && titlePattern.empty(); }
+    void Clear() { process.clear(); className.clear(); titlePattern.clear(); }
+};
+
+// 제목 패턴: 연속한 숫자를 '#' 하나로 바꾸고 최대 SESSION_MAX_PATTERN 글자까지만 보관
+// (시계, 카운터, 문서 번호처럼 계속 바뀌는 부분이 달라도 같은 창으로 보고, 저장도 그때마다 하지 않음)
+enum { SESSION_MAX_PATTERN = 256 };
+void MakeTitlePattern(const wchar_t* title, size_t length, std::wstring& out);
+
+// 세션 파일 형식 (리틀 엔디언):
+//   "MWVS" | 버전(u16) | 슬롯 수(u16) | 슬롯마다 [길이(u16) + UTF-16 글자] x 3 | CRC-32(u32, 앞부분 전체)
+// 잘리거나 손상된 파일은 Decode가 거부하므로 시작 시 빈 슬롯으로 시작함
+void EncodeSession(const std::vector<SlotBinding>& bindings, std::vector<uint8_t>& out);
+bool DecodeSession(const uint8_t* data, size_t size, std::vector<SlotBinding>& out);
+
+//=============================================================================
+// SessionMatcher: 저장된 슬롯 연결을 현재 창들과 대조
+// - Begin 후 열거에서 보이는 창마다 Offer를 한 번씩 호출하고 Finish로 슬롯별 창을 받음
+// - 실행 파일 이름(대소문자 무시)과 클래스 이름이 같은 창만 후보. 제목 패턴이 같으면 가장 높은 점수,
+//   다르면 패턴의 공통 앞/뒤 부분 길이가 긴 창을 우선 (브라우저 탭처럼 제목이 바뀐 창도 같은 앱이면 연결)
+// - 점수가 높은 (슬롯, 창) 쌍부터 배정하며 한 창은 한 슬롯에만 배정. 점수가 같으면 앞쪽 슬롯, 먼저 본 창 순
+//=============================================================================
+class SessionMatcher
+{
+public:
+    SessionMatcher() : m_offers(0) {}
+
+    void Begin(const std::vector<SlotBinding>& bindings);
+    bool Active() const { return !m_bindings.empty(); }
+    // 이 클래스 이름의 창이 후보가 될 수 있는지 (아니면 호출 측은 프로세스 이름을 읽지 않고 건너뜀)
+    bool WantsClass(const wchar_t* className) const;
+    void Offer(WindowId id, const wchar_t* process, const wchar_t* className,
+               const wchar_t* title, size_t titleLength);
+    // assigned[i]: 슬롯 i에 배정된 창 (없으면 0). 이후 Active()는 false
+    void Finish(std::vector<WindowId>& assigned);
+
+private:
+    struct Candidate
+    {
+        uint32_t score;
+        uint32_t slot;
+        uint32_t order;         // Offer 순서 (같은 점수일 때 먼저 본 창 우선)
+        WindowId window;
+    };
+
+    static bool Better(const Candidate& a, const Candidate& b);
+    static bool SameFolded(const std::wstring& folded, const wchar_t* text);
+
+    std::vector<SlotBinding> m_bindings;    // 실행 파일 이름은 소문자로 바꿔 보관
+    std::vector<Candidate> m_candidates;
+    std::wstring m_pattern;                 // 재사용 버퍼
+    uint32_t m_offers;
+};
+
+//=============================================================================
+// SaveDebouncer: 저장 시각 계산 (write-behind)
+// - Touch: 변경 알림. 마지막 변경 후 quiet 동안 조용하면 저장하되, 처음 변경 후 maxWait가 지나면
+//   변경이 계속되어도 저장 (계속 바뀌는 상태가 저장을 무한히 미루지 않도록)
+// - 반환값/DueTime: 다음 저장 시각. 호출 측은 그 시각에 타이머를 맞추고, Due이면 저장 후 Done
+//=============================================================================
+class SaveDebouncer
+{
+public:
+    SaveDebouncer(uint64_t quiet, uint64_t maxWait)
+        : m_quiet(quiet), m_maxWait(maxWait), m_pending(false), m_first(0), m_due(0) {}
+
+    uint64_t Touch(uint64_t now);
+    bool Pending() const { return m_pending; }
+    bool Due(uint64_t now) const { return m_pending && now >= m_due; }
+    uint64_t DueTime() const { return m_due; }
+    void Done() { m_pending = false; }
+
+private:
+    uint64_t m_quiet;
+    uint64_t m_maxWait;
+    bool m_pending;
+    uint64_t m_first;           // 저장 대기 중 첫 변경 시각
+    uint64_t m_due;
+};
+
+#endif // SESSIONSTORE_H
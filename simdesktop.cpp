@@ -0,0 +1,198 @@
+/*
+    simdesktop.cpp
+    =======================
+    SimulatedDesktop 구현
+*/
+#include "simdesktop.h"
+#include <wchar.h>
+#include <utility> // std::swap
+
+namespace
+{
+    // 창 종류별 (클래스, 프로세스, 제목 형식). 제목 형식의 %u는 창 번호, 두 번째 %u는 바뀌는 값
+    struct SimKind
+    {
+        const wchar_t* className;
+        const wchar_t* process;
+        const wchar_t* format;
+    };
+
+    const SimKind kKinds[] =
+    {
+        { L"Notepad",                 L"notepad.exe",   L"문서 %u - 메모장 (%u)" },
+        { L"Chrome_WidgetWin_1",      L"chrome.exe",    L"Search results page %u, tab %u - Google Chrome" },
+        { L"CASCADIA_HOSTING_WINDOW", L"wt.exe",        L"build-%u: [%u/4096] Compiling object files" },
+        { L"XLMAIN",                  L"excel.exe",     L"Quarterly report %u.xlsx - Excel (%u)" },
+        { L"MozillaWindowClass",      L"firefox.exe",   L"Issue #%u: layout glitch on resize (%u comments) - Mozilla Firefox" },
+        { L"ConsoleWindowClass",      L"cmd.exe",       L"관리자: 명령 프롬프트 %u - ping -t %u" },
+        { L"CabinetWClass",           L"explorer.exe",  L"C:\\Users\\user\\Projects\\viewer-%u\\build\\%u" },
+        { L"Qt5QWindowIcon",          L"obs64.exe",     L"OBS %u - Profile: Stream - Scenes: %u" },
+    };
+    const size_t kKindCount = sizeof(kKinds) / sizeof(kKinds[0]);
+}
+
+SimulatedDesktop::SimulatedDesktop(uint32_t seed)
+    : m_sink(NULL), m_nextId(0x10000), m_state(seed ? seed : 1), m_events(0)
+{
+    // 처음 몇 개의 난수는 시드와 상관이 커서 버림
+    for (int i = 0; i < 8; i++)
+        Random(2);
+}
+
+uint32_t SimulatedDesktop::Random(uint32_t bound)
+{
+    // xorshift64*
+    m_state ^= m_state >> 12;
+    m_state ^= m_state << 25;
+    m_state ^= m_state >> 27;
+    uint64_t value = m_state * 0x2545F4914F6CDD1DULL;
+    return bound ? (uint32_t)((value >> 32) % bound) : 0;
+}
+
+void SimulatedDesktop::Emit(WindowEventKind kind, WindowId id)
+{
+    m_events++;
+    if (m_sink)
+    {
+        WindowEvent ev;
+        ev.kind = kind;
+        ev.window = id;
+        m_sink->OnWindowEvent(ev);
+    }
+}
+
+void SimulatedDesktop::SetTitle(Window& w)
+{
+    // 창 번호는 고정, 두 번째 값만 바뀜 (대부분 같은 길이로 덮어쓰는 경우)
+    const SimKind& kind = kKinds[(w.id >> 4) % kKindCount];
+    wchar_t buffer[160];
+    swprintf(buffer, sizeof(buffer) / sizeof(buffer[0]), kind.format,
+             (unsigned)(w.id & 0xFFFF), (unsigned)Random(10000));
+    w.title.assign(buffer);
+}
+
+void SimulatedDesktop::AddWindow(bool notify)
+{
+    Window w;
+    w.id = m_nextId;
+    m_nextId += 0x10; // 실제 핸들처럼 띄엄띄엄
+    const SimKind& kind = kKinds[(w.id >> 4) % kKindCount];
+    w.className = kind.className;
+    w.process = kind.process;
+    w.cx = 320 + (int)Random(1600);
+    w.cy = 240 + (int)Random(1000);
+    w.visible = Random(10) != 0;   // 10%는 숨김
+    w.owned = Random(8) == 0;      // 12.5%는 소유 창
+    w.minimized = false;
+    SetTitle(w);
+
+    m_index[w.id] = m_windows.size();
+    m_windows.push_back(w);
+    if (notify)
+    {
+        Emit(WINDOW_EVENT_CREATE, w.id);
+        if (w.visible)
+            Emit(WINDOW_EVENT_SHOW, w.id);
+    }
+}
+
+void SimulatedDesktop::DestroyAt(size_t position)
+{
+    WindowId id = m_windows[position].id;
+    size_t last = m_windows.size() - 1;
+    if (position != last)
+    {
+        std::swap(m_windows[position], m_windows[last]);
+        m_index[m_windows[position].id] = position;
+    }
+    m_windows.pop_back();
+    m_index.erase(id);
+    Emit(WINDOW_EVENT_DESTROY, id);
+}
+
+void SimulatedDesktop::Populate(size_t count)
+{
+    m_windows.reserve(count);
+    while (m_windows.size() < count)
+        AddWindow(false);
+}
+
+void SimulatedDesktop::Step(const SimChurn& churn)
+{
+    for (size_t i = 0; i < churn.destroys && !m_windows.empty(); i++)
+        DestroyAt(Random((uint32_t)m_windows.size()));
+    for (size_t i = 0; i < churn.creates; i++)
+        AddWindow(true);
+    if (m_windows.empty())
+        return;
+
+    for (size_t i = 0; i < churn.toggles; i++)
+    {
+        Window& w = m_windows[Random((uint32_t)m_windows.size())];
+        w.visible = !w.visible;
+        Emit(w.visible ? WINDOW_EVENT_SHOW : WINDOW_EVENT_HIDE, w.id);
+    }
+    for (size_t i = 0; i < churn.titles; i++)
+    {
+        Window& w = m_windows[Random((uint32_t)m_windows.size())];
+        SetTitle(w);
+        Emit(WINDOW_EVENT_NAMECHANGE, w.id);
+    }
+    for (size_t i = 0; i < churn.resizes; i++)
+    {
+        Window& w = m_windows[Random((uint32_t)m_windows.size())];
+        if (Random(4) == 0)
+        {
+            w.minimized = !w.minimized; // 최소화/복원
+        }
+        else
+        {
+            w.cx = 320 + (int)Random(1600);
+            w.cy = 240 + (int)Random(1000);
+        }
+        Emit(WINDOW_EVENT_LOCATIONCHANGE, w.id);
+    }
+}
+
+const SimulatedDesktop::Window* SimulatedDesktop::Find(WindowId id) const
+{
+    std::unordered_map<WindowId, size_t>::const_iterator it = m_index.find(id);
+    return it == m_index.end() ? NULL : &m_windows[it->second];
+}
+
+bool SimulatedDesktop::ReadTitle(WindowId id, std::wstring& buffer) const
+{
+    const Window* w = Find(id);
+    if (!w)
+    {
+        buffer.clear();
+        return false;
+    }
+    buffer.assign(w->title); // 용량이 충분하면 재할당 없음 (GetWindowText로 재사용 버퍼에 읽는 것과 같음)
+    return true;
+}
+
+bool SimulatedDesktop::QuerySize(WindowId id, int* cx, int* cy) const
+{
+    const Window* w = Find(id);
+    if (!w || w->minimized)
+    {
+        *cx = *cy = 0;
+        return false;
+    }
+    *cx = w->cx;
+    *cy = w->cy;
+    return true;
+}
+
+WindowId SimulatedDesktop::RandomVisibleWindow()
+{
+    // 대부분 보이는 창이므로 몇 번만 뽑아 봄
+    for (int attempt = 0; attempt < 16 && !m_windows.empty(); attempt++)
+    {
+        const Window& w = m_windows[Random((uint32_t)m_windows.size())];
+        if (w.visible && !w.owned)
+            return w.id;
+    }
+    return 0;
+}
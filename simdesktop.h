@@ -0,0 +1,87 @@
+// simdesktop.h
+// 실제 데스크톱 없이 창 관리자를 흉내 내는 가상 데스크톱. 수천 개의 창을 만들고 생성/파괴/표시/숨김/
+// 제목 변경/크기 변경을 난수로 일으켜 WinEvent 훅처럼 이벤트를 전달하며, EnumWindows/GetWindowText/
+// 원본 크기 질의에 해당하는 조회를 제공한다. 같은 시드면 같은 순서로 재현됨.
+// Win32 헤더에 의존하지 않으므로 벤치마크(viewerbench.cpp)와 함께 Linux에서 빌드/실행 가능.
+#ifndef SIMDESKTOP_H
+#define SIMDESKTOP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "windowtracker.h" // WindowId, WindowEventSource
+
+// 한 번의 Step()에서 일으킬 변경 횟수
+struct SimChurn
+{
+    size_t creates;      // 새 창 생성
+    size_t destroys;     // 창 파괴
+    size_t toggles;      // 표시/숨김 전환
+    size_t titles;       // 제목 변경 (시계/진행률처럼 계속 바뀌는 제목)
+    size_t resizes;      // 크기 변경 (최소화/복원 포함)
+};
+
+//=============================================================================
+// SimulatedDesktop
+// - 창은 Z-순서대로 연속 배열에 보관. 파괴는 마지막 창과 자리를 바꿔 O(1)
+//   (Z-순서가 바뀌는 것은 실제 데스크톱에서도 흔한 일이므로 열거 결과의 순서도 그대로 바뀜)
+// - 일부 창은 소유 창(owned)이거나 숨겨진 상태로 만들어 열거 필터가 실제처럼 동작하도록 함
+// - 이벤트는 변경 즉시 sink로 전달 (WinEvent 훅 콜백과 같은 스레드 가정)
+// - WindowId는 0이 아닌 증가값이라 파괴된 창의 값이 재사용되지 않음
+//=============================================================================
+class SimulatedDesktop : public WindowEventSource
+{
+public:
+    struct Window
+    {
+        WindowId id;
+        std::wstring title;
+        std::wstring className;
+        std::wstring process;
+        int cx, cy;      // 원본 크기 (최소화 상태면 0x0으로 보고)
+        bool visible;
+        bool owned;      // 소유자가 있는 창 (대화 상자 등)
+        bool minimized;
+    };
+
+    explicit SimulatedDesktop(uint32_t seed = 1);
+
+    bool Start(WindowEventSink* sink) { m_sink = sink; return true; }
+    void Stop() { m_sink = NULL; }
+
+    // count개가 될 때까지 창 생성 (이벤트 없이, 시작 시점의 데스크톱 상태)
+    void Populate(size_t count);
+    // 난수로 고른 창에 churn만큼 변경을 일으키고 이벤트 전달
+    void Step(const SimChurn& churn);
+
+    // 조회 (EnumWindows / IsWindow / GetWindowText / DwmQueryThumbnailSourceSize 대응)
+    size_t Count() const { return m_windows.size(); }
+    const Window& At(size_t zOrder) const { return m_windows[zOrder]; }
+    const Window* Find(WindowId id) const;
+    bool IsWindow(WindowId id) const { return m_index.find(id) != m_index.end(); }
+    bool ReadTitle(WindowId id, std::wstring& buffer) const;
+    bool QuerySize(WindowId id, int* cx, int* cy) const;
+
+    // 난수로 고른 보이는 창 (없으면 0). 슬롯 선택을 흉내 낼 때 사용
+    WindowId RandomVisibleWindow();
+    uint32_t Random(uint32_t bound); // [0, bound)
+
+    uint64_t EventCount() const { return m_events; }
+
+private:
+    void AddWindow(bool notify);
+    void DestroyAt(size_t position);
+    void SetTitle(Window& w);
+    void Emit(WindowEventKind kind, WindowId id);
+
+    std::vector<Window> m_windows;
+    std::unordered_map<WindowId, size_t> m_index; // WindowId -> Z-순서 위치
+    WindowEventSink* m_sink;
+    WindowId m_nextId;
+    uint64_t m_state; // xorshift64 난수 상태
+    uint64_t m_events;
+};
+
+#endif // SIMDESKTOP_H
@@ -0,0 +1,97 @@
+// sizecache.h
+// 슬롯별 썸네일 원본 크기 캐시. 대상 창의 크기 변경/최소화/복원 이벤트가 올 때만 무효화되어
+// 배치 계산과 클릭 판별이 매번 DWM에 질의하지 않도록 한다. Win32 헤더에 의존하지 않음.
+#ifndef SIZECACHE_H
+#define SIZECACHE_H
+
+#include <stdint.h>
+#include <vector>
+#include "windowtracker.h" // WindowId
+
+class SourceSizeCache
+{
+public:
+    SourceSizeCache() : m_queries(0) {}
+
+    void Resize(int slots)
+    {
+        Entry empty = { 0, 0, 0, false };
+        m_entries.resize(slots < 0 ? 0 : slots, empty);
+    }
+
+    // 슬롯에 표시할 창을 지정. 대상이 바뀌면 캐시 무효화
+    void Bind(int slot, WindowId target)
+    {
+        Entry& e = m_entries[slot];
+        if (e.target != target) {
+            e.target = target;
+            e.valid = false;
+        }
+    }
+
+    void InvalidateSlot(int slot) { m_entries[slot].valid = false; }
+
+    // 슬롯 삽입/제거/이동 시 캐시도 같은 순서로 옮김 (옮겨진 슬롯은 다시 질의하지 않음)
+    void Insert(int slot)
+    {
+        Entry empty = { 0, 0, 0, false };
+        m_entries.insert(m_entries.begin() + slot, empty);
+    }
+    void Erase(int slot) { m_entries.erase(m_entries.begin() + slot); }
+    void Move(int from, int to)
+    {
+        Entry moved = m_entries[from];
+        m_entries.erase(m_entries.begin() + from);
+        m_entries.insert(m_entries.begin() + to, moved);
+    }
+
+    // 해당 창을 표시 중인 모든 슬롯 무효화 (같은 창을 여러 슬롯에 띄울 수 있음)
+    int InvalidateWindow(WindowId target)
+    {
+        int count = 0;
+        for (size_t i = 0; i < m_entries.size(); i++) {
+            if (m_entries[i].target == target && m_entries[i].valid) {
+                m_entries[i].valid = false;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // 캐시된 크기가 있으면 true (0x0은 "크기를 알 수 없음"이 캐시된 상태)
+    bool Get(int slot, int* cx, int* cy) const
+    {
+        const Entry& e = m_entries[slot];
+        if (!e.valid)
+            return false;
+        *cx = e.cx;
+        *cy = e.cy;
+        return true;
+    }
+
+    // DWM 질의 결과 저장
+    void Store(int slot, int cx, int cy)
+    {
+        Entry& e = m_entries[slot];
+        e.cx = cx;
+        e.cy = cy;
+        e.valid = true;
+        m_queries++;
+    }
+
+    // 지금까지 저장(=원본 크기 질의)한 횟수 (진단용)
+    uint64_t QueryCount() const { return m_queries; }
+
+private:
+    struct Entry
+    {
+        WindowId target;
+        int cx, cy;
+        bool valid;
+    };
+
+    std::vector<Entry> m_entries;
+    uint64_t m_queries;
+};
+
+#endif // SIZECACHE_H
@@ -0,0 +1,71 @@
+// slottable.h
+// 미리보기 슬롯 상태 저장소. 슬롯마다 자주 읽는 필드(Hot)와 가끔 쓰는 필드(Cold)를 별도의 연속 배열에 두어
+// 배치/갱신 루프가 Hot 배열만 순서대로 훑도록 한다. 개수 제한 없이 늘어나며 삽입/삭제/순서 변경은
+// 두 배열을 같은 방식으로 옮기는 것만으로 끝남 (필드는 복사 가능한 단순 값이어야 함).
+// Win32 헤더에 의존하지 않음.
+#ifndef SLOTTABLE_H
+#define SLOTTABLE_H
+
+#include <algorithm>
+#include <vector>
+
+template <class HotFields, class ColdFields>
+class SlotTable
+{
+public:
+    SlotTable() {}
+
+    int Count() const { return (int)m_hot.size(); }
+
+    HotFields& Hot(int slot) { return m_hot[slot]; }
+    const HotFields& Hot(int slot) const { return m_hot[slot]; }
+    ColdFields& Cold(int slot) { return m_cold[slot]; }
+    const ColdFields& Cold(int slot) const { return m_cold[slot]; }
+    // Hot 배열 전체 (슬롯 순서, Count()개). 슬롯이 없으면 NULL일 수 있음
+    HotFields* HotData() { return m_hot.data(); }
+    const HotFields* HotData() const { return m_hot.data(); }
+
+    // 개수 변경. 새 슬롯은 값 초기화(0)된 상태
+    void Resize(int count)
+    {
+        if (count < 0) count = 0;
+        m_hot.resize(count, HotFields());
+        m_cold.resize(count, ColdFields());
+    }
+
+    // index 위치에 빈 슬롯 삽입 (뒤쪽 슬롯은 한 칸씩 밀림)
+    void Insert(int index)
+    {
+        m_hot.insert(m_hot.begin() + index, HotFields());
+        m_cold.insert(m_cold.begin() + index, ColdFields());
+    }
+
+    // index 위치의 슬롯 제거 (뒤쪽 슬롯은 한 칸씩 당겨짐)
+    void Erase(int index)
+    {
+        m_hot.erase(m_hot.begin() + index);
+        m_cold.erase(m_cold.begin() + index);
+    }
+
+    // from 위치의 슬롯을 to 위치로 옮김 (사이의 슬롯들은 한 칸씩 이동)
+    void Move(int from, int to)
+    {
+        Rotate(m_hot, from, to);
+        Rotate(m_cold, from, to);
+    }
+
+private:
+    template <class T>
+    static void Rotate(std::vector<T>& v, int from, int to)
+    {
+        if (from < to)
+            std::rotate(v.begin() + from, v.begin() + from + 1, v.begin() + to + 1);
+        else if (to < from)
+            std::rotate(v.begin() + to, v.begin() + from, v.begin() + from + 1);
+    }
+
+    std::vector<HotFields> m_hot;
+    std::vector<ColdFields> m_cold;
+};
+
+#endif // SLOTTABLE_H
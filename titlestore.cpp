@@ -0,0 +1,103 @@
+/*
+    titlestore.cpp
+    =======================
+    TitleStore 구현
+*/
+#include "titlestore.h"
+#include <string.h>
+
+TitleStore::Handle TitleStore::Alloc()
+{
+    Handle handle;
+    if (m_freeHead != NO_HANDLE) {
+        handle = m_freeHead;
+        m_freeHead = m_slots[handle].nextFree;
+    } else {
+        handle = (Handle)m_slots.size();
+        m_slots.push_back(Slot());
+    }
+    Slot& slot = m_slots[handle];
+    slot.offset = 0;
+    slot.length = 0;
+    slot.capacity = 0;
+    slot.version = 0;
+    slot.nextFree = NO_HANDLE;
+    slot.inUse = true;
+    return handle;
+}
+
+void TitleStore::Free(Handle handle)
+{
+    Slot& slot = m_slots[handle];
+    if (!slot.inUse)
+        return;
+    m_garbage += slot.capacity;
+    slot.capacity = 0;
+    slot.length = 0;
+    slot.inUse = false;
+    slot.nextFree = m_freeHead;
+    m_freeHead = handle;
+}
+
+bool TitleStore::Set(Handle handle, const wchar_t* text, size_t length)
+{
+    Slot& slot = m_slots[handle];
+    if (slot.length == length &&
+        (length == 0 || memcmp(&m_arena[slot.offset], text, length * sizeof(wchar_t)) == 0))
+        return false; // 변경 없음: 버전 유지
+
+    if (length <= slot.capacity) {
+        // 기존 공간에 덮어씀
+        if (length > 0)
+            memcpy(&m_arena[slot.offset], text, length * sizeof(wchar_t));
+    } else {
+        // 버퍼 끝에 새로 기록. 조금씩 길어지는 제목을 위해 여유 공간을 둠
+        m_garbage += slot.capacity;
+        uint32_t capacity = (uint32_t)(length + length / 4 + 8);
+        slot.offset = (uint32_t)m_arena.size();
+        slot.capacity = capacity;
+        m_arena.resize(m_arena.size() + capacity);
+        memcpy(&m_arena[slot.offset], text, length * sizeof(wchar_t));
+    }
+    slot.length = (uint32_t)length;
+    slot.version++;
+
+    if (m_garbage > 4096 && m_garbage * 2 > m_arena.size())
+        Compact();
+    return true;
+}
+
+const wchar_t* TitleStore::Get(Handle handle, size_t* length) const
+{
+    const Slot& slot = m_slots[handle];
+    if (length)
+        *length = slot.length;
+    return slot.length ? &m_arena[slot.offset] : L"";
+}
+
+size_t TitleStore::LiveCount() const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < m_slots.size(); i++) {
+        if (m_slots[i].inUse)
+            count++;
+    }
+    return count;
+}
+
+// 살아 있는 항목만 새 버퍼로 옮겨 버려진 공간을 회수
+void TitleStore::Compact()
+{
+    std::vector<wchar_t> arena;
+    arena.reserve(m_arena.size() - m_garbage);
+    for (size_t i = 0; i < m_slots.size(); i++) {
+        Slot& slot = m_slots[i];
+        if (!slot.inUse || slot.capacity == 0)
+            continue;
+        uint32_t offset = (uint32_t)arena.size();
+        arena.insert(arena.end(), m_arena.begin() + slot.offset, m_arena.begin() + slot.offset + slot.capacity);
+        slot.offset = offset;
+    }
+    m_arena.swap(arena);
+    m_garbage = 0;
+}
@@ -0,0 +1,60 @@
+// titlestore.h
+// 창 제목을 하나의 연속 버퍼(arena)에 보관하는 저장소.
+// 항목마다 버전 카운터를 두어 UI가 실제로 바뀐 항목만 다시 그릴 수 있게 한다.
+#ifndef TITLESTORE_H
+#define TITLESTORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+//=============================================================================
+// TitleStore
+// - 제목 길이 제한 없음. 항목은 Alloc()이 돌려준 핸들로 접근
+// - 새 제목이 기존 용량 안에 들어가면 제자리에 덮어씀 (시계처럼 계속 바뀌는 제목은 재할당 없음)
+// - 들어가지 않으면 버퍼 끝에 새로 기록하고, 버려진 공간이 절반을 넘으면 압축
+// - Get()이 돌려준 포인터는 다음 Set()/Alloc() 호출 전까지만 유효
+//=============================================================================
+class TitleStore
+{
+public:
+    typedef uint32_t Handle;
+
+    TitleStore() : m_garbage(0), m_freeHead(NO_HANDLE) {}
+
+    Handle Alloc();
+    void Free(Handle handle);
+
+    // 제목 저장. 내용이 바뀐 경우에만 버전을 올리고 true 반환
+    bool Set(Handle handle, const wchar_t* text, size_t length);
+    // 제목 조회 (NUL 종료 보장 안 됨, length로 길이 반환)
+    const wchar_t* Get(Handle handle, size_t* length) const;
+    uint32_t Version(Handle handle) const { return m_slots[handle].version; }
+
+    // 진단용
+    size_t ArenaSize() const { return m_arena.size(); }
+    size_t GarbageSize() const { return m_garbage; }
+    size_t LiveCount() const;
+
+private:
+    static const Handle NO_HANDLE = 0xFFFFFFFFu;
+
+    struct Slot
+    {
+        uint32_t offset;   // m_arena 내 시작 위치
+        uint32_t length;   // 현재 제목 길이 (wchar_t 단위)
+        uint32_t capacity; // 이 항목이 차지한 공간
+        uint32_t version;  // 제목이 바뀔 때마다 증가
+        Handle nextFree;   // 해제된 슬롯 연결 (사용 중이면 NO_HANDLE)
+        bool inUse;
+    };
+
+    void Compact();
+
+    std::vector<wchar_t> m_arena;
+    std::vector<Slot> m_slots;
+    size_t m_garbage;  // 더 이상 쓰이지 않는 arena 공간
+    Handle m_freeHead; // 재사용 가능한 슬롯 목록의 머리
+};
+
+#endif // TITLESTORE_H
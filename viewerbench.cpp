@@ -0,0 +1,600 @@
+/*
+    viewerbench.cpp
+    =======================
+    가상 데스크톱(SimulatedDesktop) 위에서 창 목록/제목 추적/슬롯 관리/배치 처리를 돌려
+    틱당 지연 시간과 메모리 할당 횟수를 재는 벤치마크. Win32 없이 Linux에서 빌드/실행 가능 (benchbuild.sh).
+
+    - 한 틱 = 가상 데스크톱 변경 한 묶음 + 추적기가 모은 변경 처리 (WM_APP_WINDOWEVENTS 한 번에 해당)
+    - 처리 순서는 winview.cpp와 같음: 목록 변경 시 재열거(EnumWindowsProc 필터) -> 제목 갱신 -> 스냅숏 게시 ->
+      (UI) 스냅숏을 사본 레지스트리에 적용 -> 콤보박스 반영(ApplyWindowDiff) -> 원본 크기 캐시 무효화 ->
+      배치 계산(UpdatePreviewLayout) -> 변경분 선별
+    - 작업 스레드와 UI 스레드의 처리를 한 스레드에서 이어서 실행하므로 지연 시간은 두 쪽을 합친 값
+    - 처리 코드는 winview.cpp와 같은 viewermodel.cpp(WindowListUpdater/SlotPresenter)를 SimulatedBackend로 실행
+    - Win32 호출(DWM, DeferWindowPos, SendMessage)은 하지 않고 호출했을 횟수만 셈
+    - 창 개수 10/100/1000/5000 x 슬롯 개수 1/8/32/128 조합마다 결과 한 줄 출력
+    - 측정 전에 ScriptedEventSource로 추적기(windowtracker.h)에 정해진 이벤트를 흘려 깨우기 합치기/중복 제거/
+      감시 창 필터/부분 전달/제목만 가져가기를 확인 (tracker check). 틀리면 종료 코드 1
+
+    사용법: viewerbench [--ticks N] [--seed N] [--grid] [--windows N] [--slots N]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "simdesktop.h"
+#include "slottable.h"
+#include "viewermodel.h"
+
+//=============================================================================
+// 할당 횟수 집계 (전역 operator new/delete 교체)
+//=============================================================================
+static uint64_t g_allocCount = 0;
+static uint64_t g_allocBytes = 0;
+
+void* operator new(size_t size)
+{
+    g_allocCount++;
+    g_allocBytes += size;
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+//=============================================================================
+// winview.cpp와 같은 배치 상수 (100% DPI)
+//=============================================================================
+const int DROP_HEIGHT = 25;
+const int PREVIEW_HEIGHT = 300;
+const int ASPECT_NUMERATOR = 4;
+const int ASPECT_DENOMINATOR = 3;
+const int GRID_WIDTH = 1920;             // --grid일 때 목표 영역 (작업 표시줄을 뺀 FHD 모니터)
+const int GRID_HEIGHT = 1040;
+
+//=============================================================================
+// SimulatedBackend: 가상 데스크톱을 PreviewBackend로 보여 줌 (winview.cpp의 DwmPreviewBackend 자리)
+// - 썸네일 핸들은 대상 창 ID를 그대로 쓰고 합성은 하지 않음. DWM/GetWindowText에 해당하는 호출 횟수만 셈
+//=============================================================================
+class SimulatedBackend : public PreviewBackend
+{
+public:
+    struct Stats
+    {
+        uint64_t titleReads;      // GetWindowText
+        uint64_t sizeQueries;     // DwmQueryThumbnailSourceSize
+        uint64_t thumbnailCalls;  // DwmRegister/Unregister/UpdateThumbnailProperties
+    };
+
+    explicit SimulatedBackend(SimulatedDesktop& desktop) : m_desktop(desktop) { memset(&m_stats, 0, sizeof(m_stats)); }
+
+    const Stats& GetStats() const { return m_stats; }
+
+    virtual void EnumerateWindows(WindowVisitor visit, void* context)
+    {
+        for (size_t z = 0; z < m_desktop.Count(); z++)
+        {
+            if (!visit(context, m_desktop.At(z).id))
+                break;
+        }
+    }
+    virtual bool IsCandidate(WindowId id)
+    {
+        const SimulatedDesktop::Window* w = m_desktop.Find(id);
+        return w && w->visible;
+    }
+    virtual bool ReadTitle(WindowId id, std::wstring& title)
+    {
+        m_stats.titleReads++;
+        if (!m_desktop.ReadTitle(id, title))
+            title.clear(); // 그 사이 파괴된 창은 빈 제목 (응답 없는 창은 없음)
+        return true;
+    }
+    virtual bool IsAlive(WindowId id) { return m_desktop.IsWindow(id); }
+    virtual void ReadClass(WindowId id, std::wstring& className)
+    {
+        const SimulatedDesktop::Window* w = m_desktop.Find(id);
+        if (w)
+            className = w->className;
+        else
+            className.clear();
+    }
+    virtual void ReadProcess(WindowId id, std::wstring& process)
+    {
+        const SimulatedDesktop::Window* w = m_desktop.Find(id);
+        if (w)
+            process = w->process;
+        else
+            process.clear();
+    }
+    virtual void ReadTraits(WindowId id, bool* owned, bool* toolWindow)
+    {
+        const SimulatedDesktop::Window* w = m_desktop.Find(id);
+        *owned = w && w->owned;
+        *toolWindow = false;
+    }
+
+    virtual PreviewHandle Register(WindowId source)
+    {
+        m_stats.thumbnailCalls++;
+        return m_desktop.IsWindow(source) ? (PreviewHandle)source : 0;
+    }
+    virtual void Unregister(PreviewHandle thumbnail)
+    {
+        (void)thumbnail;
+        m_stats.thumbnailCalls++;
+    }
+    virtual bool QuerySourceSize(PreviewHandle thumbnail, int* cx, int* cy)
+    {
+        m_stats.sizeQueries++;
+        if (m_desktop.QuerySize((WindowId)thumbnail, cx, cy) && *cx > 0 && *cy > 0)
+            return true;
+        *cx = *cy = 0;
+        return false;
+    }
+    virtual void Update(PreviewHandle thumbnail, const LayoutRect& destination, bool visible)
+    {
+        (void)thumbnail;
+        (void)destination;
+        (void)visible;
+        m_stats.thumbnailCalls++;
+    }
+
+private:
+    SimulatedDesktop& m_desktop;
+    Stats m_stats;
+};
+
+//=============================================================================
+// BenchViewer: winview.cpp의 작업 스레드(EnumerationWorker::Process)와 UI 스레드(ProcessSnapshot,
+// UpdatePreviewLayout)가 부르는 viewermodel.h 처리를 한 스레드에서 차례로 실행. 콤보박스/메인 윈도우 조작은
+// 하지 않고 횟수만 셈
+//=============================================================================
+class BenchViewer
+{
+public:
+    struct Stats
+    {
+        uint64_t enumVisits;      // EnumWindowsProc 호출
+        uint64_t pickerMoves;     // DeferWindowPos
+        uint64_t pickerRedraws;   // 콤보박스 본체 다시 그리기 / 축소
+    };
+
+    BenchViewer(SimulatedDesktop& desktop, int slotCount, bool grid)
+        : m_desktop(desktop), m_backend(desktop), m_tracker(Wake, NULL), m_hung(HUNG_PROBE_MIN, HUNG_PROBE_MAX),
+          m_updater(&m_backend, m_model, m_filter, m_hung, m_tracker),
+          m_presenter(&m_backend, m_registry, m_search, m_sizeCache, m_layout, m_frame)
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+        m_updater.SetClock(ClockMicros);
+        m_layout.SetPickerHeight(DROP_HEIGHT);
+        m_layout.SetPreviewHeight(PREVIEW_HEIGHT);
+        m_layout.SetDefaultAspect(ASPECT_NUMERATOR, ASPECT_DENOMINATOR);
+        if (grid)
+            m_layout.SetGridArea(GRID_WIDTH, GRID_HEIGHT);
+        m_slots.Resize(slotCount);
+        AddDefaultFilterRules(m_filter);
+        m_filter.Compile();
+        m_desktop.Start(&m_tracker);
+
+        // 시작 시 한 번 열거하고 슬롯마다 보이는 창 하나씩 선택
+        m_changes.listChanged = true;
+        ProcessWindowChanges(m_changes);
+        for (int i = 0; i < slotCount; i++)
+            m_slots.Hot(i).selected = m_desktop.RandomVisibleWindow();
+        UpdateLayout();
+    }
+
+    ~BenchViewer() { m_desktop.Stop(); }
+
+    WindowTracker& Tracker() { return m_tracker; }
+    const Stats& GetStats() const { return m_stats; }
+    const SimulatedBackend::Stats& BackendStats() const { return m_backend.GetStats(); }
+    const LayoutEngine& Layout() const { return m_layout; }
+    int SlotCount() const { return m_slots.Count(); }
+
+    // WM_WORKER_EVENTS -> WM_APP_SNAPSHOT
+    void OnWindowEvents()
+    {
+        m_tracker.TakeChanges(m_changes);
+        ProcessWindowChanges(m_changes);
+    }
+
+    // CBN_SELCHANGE: 슬롯의 선택 창 변경
+    void Select(int slot, WindowId window)
+    {
+        PreviewSlot& hot = m_slots.Hot(slot);
+        if (hot.thumbnail)
+        {
+            m_backend.Unregister(hot.thumbnail);
+            hot.thumbnail = 0;
+        }
+        hot.selected = window;
+        m_frame.InvalidateSlot(slot);
+        UpdateLayout();
+    }
+
+    // 슬롯 순서 변경 메뉴 (MoveSlot)
+    void Move(int from, int to)
+    {
+        m_slots.Move(from, to);
+        m_sizeCache.Move(from, to);
+        m_frame.InvalidateAll();
+        UpdateLayout();
+    }
+
+    // GetSegmentIndexAtPoint
+    int HitTest(int x, int y) const { return m_layout.HitTest(x, y); }
+
+    // 지난 검색 뒤 바뀐 제목을 색인에 반영 (FillPicker에서는 Search가 먼저 수행)
+    void FlushSearch() { m_search.Flush(); }
+
+    // 드롭다운 검색 입력 한 번 (FillPicker의 색인 조회 + 목록 순서 맞추기). 결과 개수 반환
+    size_t Search(const std::wstring& query)
+    {
+        if (!m_presenter.Search(query, m_pickerRows))
+            return m_registry.Size();
+        return m_pickerRows.size();
+    }
+
+private:
+    struct SlotCold {}; // 콤보박스가 없으므로 Cold 필드는 없음
+
+    static void Wake(void*) {}
+    static uint64_t ClockMicros()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // EnumerationWorker::Process + ProcessSnapshot
+    void ProcessWindowChanges(const WindowChanges& changes)
+    {
+        // 작업 스레드: 원본 레지스트리 갱신 후 변경이 있으면 게시
+        WindowSnapshot* snapshot = m_exchange.Acquire();
+        m_updater.Process(changes, 0, ++m_now, *snapshot);
+        m_stats.enumVisits += snapshot->enumVisits;
+        if (snapshot->Empty())
+        {
+            m_exchange.Release(snapshot);
+            return;
+        }
+        m_exchange.Publish(snapshot);
+
+        // UI 스레드: 스냅숏을 가져가 사본에 적용한 변경분만 반영
+        snapshot = m_exchange.Take();
+        m_diff.Clear();
+        bool relayout = m_presenter.ApplySnapshot(*snapshot, m_diff);
+        if (!m_diff.Empty())
+        {
+            m_presenter.ApplyWindowDiff(m_diff, m_slots.HotData(), m_slots.Count(), m_removedSlots, m_retitledSlots);
+            m_stats.pickerRedraws += m_removedSlots.size() + m_retitledSlots.size(); // CollapsePicker, InvalidateRect
+        }
+        if (relayout)
+            UpdateLayout();
+        m_exchange.Release(snapshot);
+    }
+
+    // UpdatePreviewLayout (DeferWindowPos는 횟수만 셈)
+    void UpdateLayout()
+    {
+        m_presenter.BuildFrame(m_slots.HotData(), m_slots.Count());
+        m_stats.pickerMoves += m_frame.PickerUpdates().size();
+        m_presenter.Commit(m_slots.HotData());
+        SlotPresenter::CollectWatched(m_slots.HotData(), m_slots.Count(), m_watched);
+        m_tracker.SetWatched(m_watched);
+    }
+
+    enum { HUNG_PROBE_MIN = 2000, HUNG_PROBE_MAX = 60000 }; // winview.cpp와 같은 값 (가상 데스크톱에는 응답 없는 창이 없음)
+
+    SimulatedDesktop& m_desktop;
+    SimulatedBackend m_backend;
+    WindowTracker m_tracker;
+    WindowRegistry m_model;     // 원본 (winview.cpp의 g_model, 작업 스레드)
+    WindowFilter m_filter;
+    HungWindowList m_hung;
+    WindowListUpdater m_updater;
+    SnapshotExchange m_exchange;
+    WindowRegistry m_registry;  // 사본 (g_registry, UI 스레드)
+    SearchIndex m_search;
+    SourceSizeCache m_sizeCache;
+    LayoutEngine m_layout;
+    FrameCommitter m_frame;
+    SlotPresenter m_presenter;
+    SlotTable<PreviewSlot, SlotCold> m_slots;
+    // 틱마다 재사용하는 작업 버퍼
+    std::vector<WindowId> m_watched;
+    WindowChanges m_changes;
+    WindowDiff m_diff;
+    std::vector<int> m_removedSlots;
+    std::vector<int> m_retitledSlots;
+    std::vector<WindowId> m_pickerRows;
+    uint64_t m_now = 0;         // 응답 없는 창 판정용 시각 (ms, 틱마다 1씩)
+    Stats m_stats;
+};
+
+//=============================================================================
+// 추적기 확인: ScriptedEventSource로 정해진 이벤트를 흘려 WindowTracker가 합친 결과를 비교
+//=============================================================================
+static void CountWake(void* context)
+{
+    (*(int*)context)++;
+}
+
+static bool Contains(const std::vector<WindowId>& windows, WindowId id)
+{
+    return std::find(windows.begin(), windows.end(), id) != windows.end();
+}
+
+static bool CheckTracker()
+{
+    int failures = 0;
+#define TRACKER_EXPECT(cond) \
+    do { if (!(cond)) { printf("tracker check failed: %s (line %d)\n", #cond, __LINE__); failures++; } } while (0)
+
+    int wakes = 0;
+    WindowTracker tracker(CountWake, &wakes);
+    ScriptedEventSource source;
+    TRACKER_EXPECT(source.Start(&tracker));
+    std::vector<WindowId> watched(1, 100);
+    tracker.SetWatched(watched);
+
+    // 1. 제목 변경 중복 제거, 감시하지 않는 창의 위치 변경 무시, 깨우기는 가져갈 때까지 한 번
+    source.Push(WINDOW_EVENT_NAMECHANGE, 100);
+    source.Push(WINDOW_EVENT_NAMECHANGE, 100);
+    source.Push(WINDOW_EVENT_NAMECHANGE, 200);
+    source.Push(WINDOW_EVENT_LOCATIONCHANGE, 300);
+    source.Push(WINDOW_EVENT_LOCATIONCHANGE, 100);
+    source.Push(WINDOW_EVENT_LOCATIONCHANGE, 100);
+    TRACKER_EXPECT(source.Pump() == 6 && source.Pending() == 0);
+    TRACKER_EXPECT(wakes == 1 && tracker.WakeCount() == 1 && tracker.EventCount() == 6);
+    WindowChanges changes;
+    tracker.TakeChanges(changes);
+    TRACKER_EXPECT(!changes.listChanged);
+    TRACKER_EXPECT(changes.titleChanged.size() == 2 && Contains(changes.titleChanged, 100) && Contains(changes.titleChanged, 200));
+    TRACKER_EXPECT(changes.locationChanged.size() == 1 && changes.locationChanged[0] == 100);
+    TRACKER_EXPECT(!tracker.HasPending());
+
+    // 2. 감시하지 않는 창의 위치 변경만으로는 깨우지 않음
+    source.Push(WINDOW_EVENT_LOCATIONCHANGE, 300);
+    source.Pump();
+    TRACKER_EXPECT(wakes == 1 && !tracker.HasPending());
+
+    // 3. 부분 전달: 남은 이벤트는 다음 Pump까지 대기. 목록 변경은 가져간 뒤 다시 깨움
+    source.Push(WINDOW_EVENT_CREATE, 400);
+    source.Push(WINDOW_EVENT_SHOW, 400);
+    source.Push(WINDOW_EVENT_HIDE, 500);
+    TRACKER_EXPECT(source.Pump(1) == 1 && source.Pending() == 2);
+    TRACKER_EXPECT(wakes == 2 && tracker.HasPending());
+    tracker.TakeChanges(changes);
+    TRACKER_EXPECT(changes.listChanged && changes.titleChanged.empty() && changes.locationChanged.empty());
+    TRACKER_EXPECT(source.Pump() == 2 && source.Pending() == 0);
+    TRACKER_EXPECT(wakes == 3);
+    tracker.TakeChanges(changes);
+    TRACKER_EXPECT(changes.listChanged);
+
+    // 4. 드롭다운이 열려 있는 동안: 제목만 가져가고 목록 변경은 남김. 이후 제목 변경은 다시 깨움
+    source.Push(WINDOW_EVENT_DESTROY, 400);
+    source.Push(WINDOW_EVENT_NAMECHANGE, 100);
+    source.Pump();
+    std::vector<WindowId> titles;
+    tracker.TakeTitleChanges(titles);
+    TRACKER_EXPECT(titles.size() == 1 && titles[0] == 100);
+    TRACKER_EXPECT(tracker.HasPending());
+    source.Push(WINDOW_EVENT_NAMECHANGE, 200);
+    source.Pump();
+    TRACKER_EXPECT(wakes == 5);
+    tracker.TakeChanges(changes);
+    TRACKER_EXPECT(changes.listChanged && changes.titleChanged.size() == 1 && changes.titleChanged[0] == 200);
+
+    // 5. 안전 점검 요청은 이벤트 없이 목록 변경, 감시 목록을 바꾸면 이전 창의 위치 변경은 무시
+    tracker.RequestSweep();
+    TRACKER_EXPECT(wakes == 6);
+    watched[0] = 300;
+    tracker.SetWatched(watched);
+    source.Push(WINDOW_EVENT_LOCATIONCHANGE, 100);
+    source.Push(WINDOW_EVENT_LOCATIONCHANGE, 300);
+    source.Pump();
+    tracker.TakeChanges(changes);
+    TRACKER_EXPECT(changes.listChanged && changes.locationChanged.size() == 1 && changes.locationChanged[0] == 300);
+
+    // 6. 멈춘 소스는 이벤트를 전달하지 않고 버림
+    source.Stop();
+    source.Push(WINDOW_EVENT_CREATE, 600);
+    TRACKER_EXPECT(source.Pump() == 1 && !tracker.HasPending() && wakes == 6);
+
+#undef TRACKER_EXPECT
+    printf("tracker check (ScriptedEventSource): %s\n", failures ? "FAILED" : "ok");
+    return failures == 0;
+}
+
+//=============================================================================
+// 실행
+//=============================================================================
+struct BenchResult
+{
+    double avg, p50, p99, max; // us
+    double allocsPerTick;
+    double bytesPerTick;
+    double eventsPerTick;
+    double enumVisitsPerTick;
+    double layoutCallsPerTick; // DWM + DeferWindowPos
+    double reindexAvg;           // 입력 직전 바뀐 제목 반영 (us, 한 틱 분량의 제목 변경)
+    double searchAvg, searchMax; // 드롭다운 검색 입력 한 번의 조회 (us)
+};
+
+// 틱마다 일으킬 변경: 제목은 창 50개당 1개, 크기 변경은 미리보기 중인 창 위주로, 생성/파괴/표시 전환은 가끔
+static void MakeChurn(uint64_t tick, size_t windows, SimChurn& churn)
+{
+    churn.titles = windows / 50 ? windows / 50 : 1;
+    churn.resizes = 1;
+    churn.toggles = (tick % 8 == 0) ? 1 : 0;
+    churn.creates = (tick % 4 == 0) ? 1 : 0;
+    churn.destroys = (tick % 4 == 2) ? 1 : 0;
+}
+
+static BenchResult RunBench(size_t windows, int slots, uint64_t ticks, uint32_t seed, bool grid)
+{
+    const uint64_t SWEEP_EVERY = 50;    // 안전 점검 재열거 주기 (틱)
+    const uint64_t SELECT_EVERY = 25;   // 슬롯 선택 변경 주기
+    const uint64_t MOVE_EVERY = 100;    // 슬롯 순서 변경 주기
+    const uint64_t WARMUP = 100;        // 버퍼 용량이 자리 잡을 때까지 측정 제외
+
+    SimulatedDesktop desktop(seed);
+    desktop.Populate(windows);
+    BenchViewer model(desktop, slots, grid);
+
+    std::vector<double> samples;
+    samples.reserve((size_t)ticks);
+    double reindexTotal = 0, searchTotal = 0, searchMax = 0;
+    std::wstring query;
+    volatile size_t searchSink = 0;
+    SimChurn churn;
+    uint64_t allocStart = 0, bytesStart = 0, eventsStart = 0, visitsStart = 0, layoutStart = 0;
+    volatile int hitSink = 0;
+
+    for (uint64_t tick = 0; tick < WARMUP + ticks; tick++)
+    {
+        if (tick == WARMUP)
+        {
+            allocStart = g_allocCount;
+            bytesStart = g_allocBytes;
+            eventsStart = desktop.EventCount();
+            visitsStart = model.GetStats().enumVisits;
+            layoutStart = model.BackendStats().thumbnailCalls + model.GetStats().pickerMoves;
+        }
+
+        // 변경은 측정 밖에서 일으키고 (실제로는 다른 프로세스의 일), 처리만 잼
+        MakeChurn(tick, windows, churn);
+        desktop.Step(churn);
+        if (tick % SWEEP_EVERY == 0)
+            model.Tracker().RequestSweep();
+        WindowId pick = (tick % SELECT_EVERY == 0) ? desktop.RandomVisibleWindow() : 0;
+        int hx = (int)desktop.Random(model.Layout().TotalWidth() > 0 ? (uint32_t)model.Layout().TotalWidth() : 1);
+        int hy = (int)desktop.Random(model.Layout().TotalHeight() > 0 ? (uint32_t)model.Layout().TotalHeight() : 1);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (model.Tracker().HasPending())
+            model.OnWindowEvents();
+        if (pick)
+            model.Select((int)(tick / SELECT_EVERY % (uint64_t)slots), pick);
+        if (slots > 1 && tick % MOVE_EVERY == 0)
+            model.Move(0, slots - 1);
+        hitSink += model.HitTest(hx, hy);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        if (tick >= WARMUP)
+            samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+
+        // 드롭다운 검색: 임의 창 제목의 일부를 한 글자씩 입력하는 것처럼 검색어 길이를 1~8로 바꿔 가며 잼 (틱 시간과 별도).
+        // 바뀐 제목 반영(이번 틱의 제목 변경분)과 조회를 따로 잼
+        const SimulatedDesktop::Window* source = desktop.Find(desktop.RandomVisibleWindow());
+        if (source && !source->title.empty())
+        {
+            size_t length = std::min<size_t>((size_t)(tick % 8) + 1, source->title.size());
+            query.assign(source->title, (size_t)desktop.Random((uint32_t)(source->title.size() - length + 1)), length);
+            std::chrono::steady_clock::time_point flushStart = std::chrono::steady_clock::now();
+            model.FlushSearch();
+            std::chrono::steady_clock::time_point searchStart = std::chrono::steady_clock::now();
+            searchSink += model.Search(query);
+            std::chrono::steady_clock::time_point searchEnd = std::chrono::steady_clock::now();
+            double us = std::chrono::duration<double, std::micro>(searchEnd - searchStart).count();
+            if (tick >= WARMUP)
+            {
+                reindexTotal += std::chrono::duration<double, std::micro>(searchStart - flushStart).count();
+                searchTotal += us;
+                searchMax = std::max(searchMax, us);
+            }
+        }
+    }
+
+    BenchResult r;
+    uint64_t allocs = g_allocCount - allocStart;
+    uint64_t bytes = g_allocBytes - bytesStart;
+    double total = 0;
+    for (size_t i = 0; i < samples.size(); i++)
+        total += samples[i];
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    r.avg = n ? total / n : 0;
+    r.p50 = n ? samples[n / 2] : 0;
+    r.p99 = n ? samples[std::min(n - 1, n * 99 / 100)] : 0;
+    r.max = n ? samples[n - 1] : 0;
+    r.allocsPerTick = ticks ? (double)allocs / ticks : 0;
+    r.bytesPerTick = ticks ? (double)bytes / ticks : 0;
+    r.eventsPerTick = ticks ? (double)(desktop.EventCount() - eventsStart) / ticks : 0;
+    r.enumVisitsPerTick = ticks ? (double)(model.GetStats().enumVisits - visitsStart) / ticks : 0;
+    r.layoutCallsPerTick = ticks ? (double)(model.BackendStats().thumbnailCalls + model.GetStats().pickerMoves - layoutStart) / ticks : 0;
+    r.reindexAvg = ticks ? reindexTotal / ticks : 0;
+    r.searchAvg = ticks ? searchTotal / ticks : 0;
+    r.searchMax = searchMax;
+    return r;
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t ticks = 2000;
+    uint32_t seed = 1;
+    bool grid = false;
+    size_t onlyWindows = 0;
+    int onlySlots = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--ticks") && i + 1 < argc)
+            ticks = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+            seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--windows") && i + 1 < argc)
+            onlyWindows = (size_t)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--slots") && i + 1 < argc)
+            onlySlots = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--grid"))
+            grid = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [--ticks N] [--seed N] [--grid] [--windows N] [--slots N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (!CheckTracker())
+        return 1;
+
+    static const size_t kWindows[] = { 10, 100, 1000, 5000 };
+    static const int kSlots[] = { 1, 8, 32, 128 };
+
+    printf("layout=%s ticks=%llu seed=%u\n", grid ? "grid" : "row", (unsigned long long)ticks, seed);
+    printf("%7s %5s %9s %9s %9s %9s %10s %11s %8s %9s %8s %9s %9s %9s\n", "windows", "slots", "avg(us)", "p50(us)",
+           "p99(us)", "max(us)", "allocs/t", "bytes/t", "events/t", "visits/t", "calls/t", "reidx(us)", "srch(us)", "srchmax");
+    for (size_t w = 0; w < sizeof(kWindows) / sizeof(kWindows[0]); w++)
+    {
+        if (onlyWindows && kWindows[w] != onlyWindows)
+            continue;
+        for (size_t s = 0; s < sizeof(kSlots) / sizeof(kSlots[0]); s++)
+        {
+            if (onlySlots && kSlots[s] != onlySlots)
+                continue;
+            BenchResult r = RunBench(kWindows[w], kSlots[s], ticks, seed, grid);
+            printf("%7u %5d %9.2f %9.2f %9.2f %9.2f %10.2f %11.1f %8.2f %9.1f %8.2f %9.2f %9.2f %9.2f\n",
+                   (unsigned)kWindows[w], kSlots[s], r.avg, r.p50, r.p99, r.max,
+                   r.allocsPerTick, r.bytesPerTick, r.eventsPerTick, r.enumVisitsPerTick, r.layoutCallsPerTick,
+                   r.reindexAvg, r.searchAvg, r.searchMax);
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,374 @@
+// viewermodel.cpp
+// 창 목록 갱신(작업 스레드)과 슬롯 반영(UI 스레드) 구현 (viewermodel.h)
+#include "viewermodel.h"
+#include <wchar.h>
+
+static const wchar_t* const kDefaultFilterRules[] = { L"-title:설정", L"-title:Windows 입력", L"-title:팝업 호스트",
+                                                      L"-title:GeForce Overlay", L"-title:위젯", L"-title:작업 전환" };
+
+void AddDefaultFilterRules(WindowFilter& filter)
+{
+    for (size_t i = 0; i < sizeof(kDefaultFilterRules) / sizeof(kDefaultFilterRules[0]); i++)
+        filter.AddRule(kDefaultFilterRules[i], wcslen(kDefaultFilterRules[i]));
+}
+
+//=============================================================================
+// WindowListUpdater
+//=============================================================================
+void WindowListUpdater::Process(const WindowChanges& changes, unsigned task, uint64_t now, WindowSnapshot& snapshot)
+{
+    m_diff.Clear();
+
+    // 1. 목록 변경 시 한 번 열거하여 추가/제거/제목 변경을 계산
+    if (changes.listChanged)
+    {
+        uint64_t start = Now();
+        Enumerate(now, m_diff, &snapshot.enumVisits);
+        snapshot.enumerateMicros += Now() - start;
+    }
+
+    // 2. 제목 변경 이벤트가 온 창만 제목을 다시 읽음
+    if (!changes.titleChanged.empty())
+    {
+        uint64_t start = Now();
+        RefreshTitles(changes.titleChanged, now, m_diff);
+        snapshot.titleMicros += Now() - start;
+    }
+    snapshot.passes++;
+
+    // 3. 변경분을 제목과 함께 기록 (크기가 바뀐 감시 대상 창 포함)
+    snapshot.Record(m_model, m_diff);
+    if (!m_diff.added.empty() || !m_diff.removed.empty())
+        snapshot.listChanged = true;
+    if (!m_diff.Empty())
+        snapshot.foundChanges |= task;
+    for (size_t i = 0; i < changes.locationChanged.size(); i++)
+        snapshot.AddLocation(changes.locationChanged[i]);
+
+    // 4. 격리 상태가 바뀐 창 (UI가 표시를 붙이거나 뗌)
+    m_hung.TakeChanges(m_hungChanged, m_hungRecovered);
+    for (size_t i = 0; i < m_hungChanged.size(); i++)
+        snapshot.SetHung(m_hungChanged[i], true);
+    for (size_t i = 0; i < m_hungRecovered.size(); i++)
+        snapshot.SetHung(m_hungRecovered[i], false);
+}
+
+void WindowListUpdater::CollectDueProbes(uint64_t now, WindowChanges& changes)
+{
+    m_hung.DueProbes(now, changes.titleChanged);
+    size_t write = 0;
+    for (size_t i = 0; i < changes.titleChanged.size(); i++)
+    {
+        WindowId id = changes.titleChanged[i];
+        if (!m_backend->IsAlive(id)) {
+            m_hung.Forget(id); // 응답 없는 채로 닫힌 창 (목록에서는 다음 열거가 제거)
+            continue;
+        }
+        changes.titleChanged[write++] = id;
+    }
+    changes.titleChanged.resize(write);
+    changes.listChanged = false;
+    changes.locationChanged.clear();
+}
+
+// 열거 한 번을 원본 레지스트리의 한 세대로 처리하여 변경분 계산
+void WindowListUpdater::Enumerate(uint64_t now, WindowDiff& diff, uint64_t* visits)
+{
+    Pass pass = { this, &diff, visits, now };
+    m_model.BeginPass();
+    m_filter.BeginPass();
+    m_backend->EnumerateWindows(Visit, &pass);
+    m_filter.EndPass(); // 이번 열거에서 보이지 않은 창의 판정 캐시 제거
+    m_model.EndPass(diff);
+    for (size_t k = 0; k < diff.removed.size(); k++)
+        m_hung.Forget(diff.removed[k]); // 목록에서 빠진 창은 격리 목록에서도 지움 (UI는 제거와 함께 표시를 지움)
+}
+
+bool WindowListUpdater::Visit(void* context, WindowId id)
+{
+    Pass* pass = (Pass*)context;
+    WindowListUpdater* self = pass->self;
+    (*pass->visits)++;
+    if (!self->m_backend->IsCandidate(id))
+        return true;
+
+    std::wstring& title = self->m_title;
+    if (!self->ProbeTitle(id, pass->now))
+    {
+        // 응답 없는 창: 이미 목록에 있으면 마지막 제목으로 유지 (빈 제목 보고는 제목을 바꾸지 않음),
+        // 처음 보는 창이면 메시지 없이 읽히는 캡션으로 판정
+        if (self->m_model.Find(id))
+        {
+            self->m_model.Observe(id, NULL, 0, *pass->diff);
+            return true;
+        }
+        self->m_backend->ReadCaption(id, title);
+    }
+
+    // 제목이 없는 (빈 문자열) 창은 건너뜀
+    if (title.empty())
+        return true;
+
+    // 필터 규칙 판정: 캐시에 있으면 제목이 바뀐 경우만 제목을 다시 훑고,
+    // 처음 보는 창만 클래스/프로세스 이름과 소유자/도구 창 여부를 읽어 판정
+    bool accepted;
+    if (!self->m_filter.Lookup(id, title.data(), title.size(), &accepted))
+    {
+        // 규칙에 쓰이는 이름만 읽음 (기본 규칙은 제목 규칙뿐이므로 프로세스 핸들을 열지 않음)
+        if (self->m_filter.UsesClass())
+            self->m_backend->ReadClass(id, self->m_originClass);
+        else
+            self->m_originClass.clear();
+        if (self->m_filter.UsesProcess())
+            self->m_backend->ReadProcess(id, self->m_originProcess);
+        else
+            self->m_originProcess.clear();
+        WindowOrigin origin;
+        origin.className = self->m_originClass.c_str();
+        origin.process = self->m_originProcess.c_str();
+        self->m_backend->ReadTraits(id, &origin.owned, &origin.toolWindow);
+        accepted = self->m_filter.Evaluate(id, title.data(), title.size(), origin);
+    }
+    if (!accepted)
+        return true;
+
+    // 원본 레지스트리에 보고 (해시 인덱스로 중복 확인, 새 창/제목 변경은 diff에 기록)
+    self->m_model.Observe(id, title.data(), title.size(), *pass->diff);
+    return true;
+}
+
+void WindowListUpdater::RefreshTitles(const std::vector<WindowId>& windows, uint64_t now, WindowDiff& diff)
+{
+    for (size_t i = 0; i < windows.size(); i++)
+    {
+        if (!m_backend->IsAlive(windows[i]))
+            continue;
+        bool wasHung = m_hung.IsHung(windows[i]);
+        if (!ProbeTitle(windows[i], now))
+            continue; // 응답 없는 창은 마지막으로 알려진 제목 유지
+        // 격리 중 목록에 넣지 못했던 창이 응답하면 다음 열거에서 판정
+        if (wasHung && !m_model.Find(windows[i]))
+            m_tracker.RequestSweep();
+        // 제목이 바뀌어 필터 판정이 달라진 창은 다음 열거에서 목록에 넣거나 뺌 (열거에서 본 적 없는 창은 판정 보류)
+        bool accepted = true;
+        if (m_filter.Lookup(windows[i], m_title.data(), m_title.size(), &accepted) &&
+            accepted != (m_model.Find(windows[i]) != NULL))
+            m_tracker.RequestSweep();
+        if (!accepted)
+            continue;
+        m_model.UpdateTitle(windows[i], m_title.data(), m_title.size(), diff);
+    }
+}
+
+bool WindowListUpdater::ProbeTitle(WindowId id, uint64_t now)
+{
+    if (!m_hung.ShouldProbe(id, now)) {
+        m_title.clear();
+        return false;
+    }
+    if (!m_backend->ReadTitle(id, m_title)) {
+        m_hung.ReportTimeout(id, now);
+        return false;
+    }
+    m_hung.ReportResponsive(id);
+    return true;
+}
+
+//=============================================================================
+// SlotPresenter
+//=============================================================================
+bool SlotPresenter::ApplySnapshot(const WindowSnapshot& snapshot, WindowDiff& applied)
+{
+    ::ApplySnapshot(snapshot, m_registry, applied);
+    if (!applied.Empty())
+        UpdateSearchIndex(applied);
+    // 크기가 바뀐 창을 표시 중인 슬롯의 원본 크기 캐시 무효화
+    for (size_t i = 0; i < snapshot.locationChanged.size(); i++)
+        m_sizeCache.InvalidateWindow(snapshot.locationChanged[i]);
+    return snapshot.listChanged || !snapshot.locationChanged.empty();
+}
+
+// 닫힌 콤보박스는 선택된 창 하나만 가지므로 그 창이 사라졌거나 제목 버전이 바뀐 슬롯만 처리
+void SlotPresenter::ApplyWindowDiff(const WindowDiff& diff, PreviewSlot* slots, int count,
+                                    std::vector<int>& removed, std::vector<int>& retitled)
+{
+    removed.clear();
+    retitled.clear();
+    for (int i = 0; i < count; i++)
+    {
+        WindowId selected = slots[i].selected;
+        if (!selected)
+            continue;
+        for (size_t k = 0; k < diff.removed.size(); k++)
+        {
+            if (diff.removed[k] == selected)
+            {
+                removed.push_back(i);
+                break;
+            }
+        }
+        const WindowRegistry::Entry* entry = m_registry.Find(selected);
+        if (entry && m_registry.TitleVersion(*entry) != slots[i].titleVersion)
+        {
+            slots[i].titleVersion = m_registry.TitleVersion(*entry);
+            retitled.push_back(i);
+        }
+    }
+}
+
+void SlotPresenter::UpdateSearchIndex(const WindowDiff& diff)
+{
+    if (!m_searchReady)
+        return;
+    for (size_t k = 0; k < diff.removed.size(); k++)
+        m_search.Remove(diff.removed[k]);
+
+    for (size_t k = 0; k < diff.added.size(); k++)
+    {
+        const WindowRegistry::Entry* entry = m_registry.Find(diff.added[k]);
+        if (!entry) continue;
+        size_t length;
+        const wchar_t* title = m_registry.Title(*entry, &length);
+        m_backend->ReadClass(diff.added[k], m_originClass);
+        m_backend->ReadProcess(diff.added[k], m_originProcess);
+        m_search.Set(diff.added[k], title, length, m_originProcess.c_str(), m_originClass.c_str());
+    }
+
+    for (size_t k = 0; k < diff.changed.size(); k++)
+    {
+        const WindowRegistry::Entry* entry = m_registry.Find(diff.changed[k]);
+        if (!entry) continue;
+        size_t length;
+        const wchar_t* title = m_registry.Title(*entry, &length);
+        m_search.SetTitle(diff.changed[k], title, length);
+    }
+}
+
+void SlotPresenter::EnsureSearchIndex()
+{
+    if (m_searchReady)
+        return;
+    m_searchReady = true;
+    WindowDiff all;
+    all.added.reserve(m_registry.Size());
+    for (size_t i = 0; i < m_registry.Size(); i++)
+        all.added.push_back(m_registry.At(i).id);
+    UpdateSearchIndex(all);
+}
+
+bool SlotPresenter::Search(const std::wstring& query, std::vector<WindowId>& rows)
+{
+    if (!query.empty())
+        EnsureSearchIndex();
+    if (!m_search.Search(query.data(), query.size(), rows))
+        return false;
+    // 색인 결과는 문서 번호 순이므로 목록(사본) 위치에 한 번씩 놓아 순서를 맞춤 (비교 정렬 없이 O(n)).
+    // 색인에만 남은 창은 제외
+    m_searchOrder.assign(m_registry.Size(), 0);
+    for (size_t k = 0; k < rows.size(); k++) {
+        int row = m_registry.IndexOf(rows[k]);
+        if (row >= 0)
+            m_searchOrder[row] = rows[k];
+    }
+    rows.clear();
+    for (size_t k = 0; k < m_searchOrder.size(); k++) {
+        if (m_searchOrder[k])
+            rows.push_back(m_searchOrder[k]);
+    }
+    return true;
+}
+
+void SlotPresenter::BuildFrame(PreviewSlot* slots, int count)
+{
+    m_registered.assign(count, 0);
+
+    // 1. 각 슬롯의 썸네일 등록 및 원본 크기를 배치 계산기에 전달
+    m_layout.SetSlotCount(count);
+    m_sizeCache.Resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        int sourceWidth = 0, sourceHeight = 0; // 0이면 기본 비율 사용
+        PreviewSlot& slot = slots[i];
+
+        if (slot.selected && m_backend->IsAlive(slot.selected))
+        {
+            // 썸네일이 아직 등록되지 않았다면 등록 시도
+            if (!slot.thumbnail)
+            {
+                slot.thumbnail = m_backend->Register(slot.selected);
+                Count();
+                if (slot.thumbnail)
+                    m_registered[i] = 1;
+                else
+                    slot.selected = 0; // 등록 실패 (예: 대상 창이 갑자기 유효하지 않게 됨), 선택되지 않은 상태로 처리
+            }
+
+            if (slot.thumbnail)
+            {
+                m_sizeCache.Bind(i, slot.selected); // 대상이 바뀌었으면 캐시 무효화
+                if (m_registered[i])
+                    m_sizeCache.InvalidateSlot(i);
+                // 캐시가 무효화된 경우(선택 변경, 크기 변경/최소화/복원 이벤트)에만 질의. 실패하면 0x0 (기본 비율)
+                if (!m_sizeCache.Get(i, &sourceWidth, &sourceHeight))
+                {
+                    m_backend->QuerySourceSize(slot.thumbnail, &sourceWidth, &sourceHeight);
+                    Count();
+                    m_sizeCache.Store(i, sourceWidth, sourceHeight);
+                }
+            }
+        }
+        else
+        {
+            // 선택된 창이 없거나 사라졌으면 기존 썸네일 해제
+            if (slot.thumbnail) {
+                m_backend->Unregister(slot.thumbnail);
+                slot.thumbnail = 0;
+                Count();
+            }
+            m_sizeCache.Bind(i, 0);
+        }
+        m_layout.SetSourceSize(i, sourceWidth, sourceHeight);
+    }
+    m_layout.Update(); // 입력이 바뀐 경우에만 재계산
+
+    // 2. 이번 프레임의 배치를 모아 마지막으로 적용한 값과 비교 (바뀐 것만 적용 대상)
+    m_frame.Begin(count);
+    for (int i = 0; i < count; i++)
+    {
+        const SlotGeometry& geometry = m_layout.Slot(i);
+        LayoutRect rcThumb = geometry.thumbnail;
+        int inset = m_inset ? m_inset(m_insetContext, i) : 0;
+        if (inset > 0)
+        {
+            rcThumb.left += inset;
+            rcThumb.top += inset;
+            rcThumb.right -= inset;
+            rcThumb.bottom -= inset;
+        }
+        m_frame.SetSlot(i, rcThumb, geometry.picker, slots[i].thumbnail != 0, m_registered[i] != 0);
+    }
+}
+
+// 목적지가 바뀐 썸네일 속성을 연달아 보내 같은 합성 프레임에 반영되도록 함 (슬롯당 1회)
+void SlotPresenter::Commit(const PreviewSlot* slots)
+{
+    const std::vector<int>& updates = m_frame.ThumbnailUpdates();
+    for (size_t k = 0; k < updates.size(); k++)
+    {
+        int i = updates[k];
+        m_backend->Update(slots[i].thumbnail, m_frame.Pending(i).thumbnail, true);
+    }
+    Count(updates.size());
+    m_backend->Commit();
+    m_frame.Commit();
+}
+
+void SlotPresenter::CollectWatched(const PreviewSlot* slots, int count, std::vector<WindowId>& watched)
+{
+    watched.clear();
+    for (int i = 0; i < count; i++)
+    {
+        if (slots[i].selected)
+            watched.push_back(slots[i].selected);
+    }
+}
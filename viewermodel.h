@@ -0,0 +1,154 @@
+// viewermodel.h
+// 창 목록 갱신과 슬롯 반영의 플랫폼 독립 부분. 작업 스레드의 목록 갱신(열거 결과 후보/필터 판정, 제목 다시 읽기,
+// 스냅숏 기록)과 UI 스레드의 반영(스냅숏 적용, 슬롯별 썸네일 등록/원본 크기/배치 계산)을 PreviewBackend 호출만으로
+// 수행하여, winview.cpp(DWM)와 viewerbench.cpp(가상 데스크톱)가 같은 처리 코드를 실행하게 한다.
+// 스레드 생성, 메시지 게시, 콤보박스/메인 윈도우 조작은 호출 측이 처리. Win32 헤더에 의존하지 않음.
+#ifndef VIEWERMODEL_H
+#define VIEWERMODEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "previewbackend.h"
+#include "windowtracker.h"
+#include "windowregistry.h"
+#include "windowfilter.h"
+#include "hungwindows.h"
+#include "modelsnapshot.h"
+#include "searchindex.h"
+#include "sizecache.h"
+#include "layout.h"
+#include "framecommit.h"
+#include "perfcounters.h"
+
+// 기본 필터 규칙 추가 (Compile은 호출 측): 목록에 보일 필요가 없는 시스템 UI 창 제목.
+// 소유자 창은 기본적으로 포함 ("-owned"로 제외 가능)
+void AddDefaultFilterRules(WindowFilter& filter);
+
+//=============================================================================
+// WindowListUpdater: 원본 창 목록 레지스트리 갱신 (작업 스레드 전용)
+// - Process: 목록 변경이면 한 번 열거하고 제목 변경 이벤트가 온 창만 제목을 다시 읽어 원본에 반영한 뒤,
+//   변경분(제목 포함)/감시 창 크기 변경/격리 상태 변경/소요 시간을 snapshot에 기록 (게시는 호출 측)
+// - 열거: IsCandidate인 창의 제목을 격리 목록을 반영해 읽고, 응답 없는 창은 목록에 있으면 마지막 제목 유지,
+//   처음 보는 창이면 ReadCaption으로 판정. 필터 판정 캐시에 없는 창만 규칙에 쓰이는 창 정보를 읽음
+// - 제목 다시 읽기로 필터 판정이 달라진 창이나 격리 중 목록에 넣지 못했던 창이 응답하면 추적기에 재열거 요청
+// - now는 응답 없는 창 다시 확인 판정용 ms 시각. 소요 시간은 SetClock의 마이크로초 시계로 잼 (없으면 0)
+//=============================================================================
+class WindowListUpdater
+{
+public:
+    typedef uint64_t (*ClockFn)(); // 단조 증가 마이크로초
+
+    WindowListUpdater(PreviewBackend* backend, WindowRegistry& model, WindowFilter& filter, HungWindowList& hung,
+                      WindowTracker& tracker)
+        : m_backend(backend), m_model(model), m_filter(filter), m_hung(hung), m_tracker(tracker), m_clock(NULL) {}
+
+    void SetClock(ClockFn clock) { m_clock = clock; }
+
+    // task: 이 처리를 요청한 주기 점검 작업 비트 (변경을 찾으면 snapshot.foundChanges에 표시)
+    void Process(const WindowChanges& changes, unsigned task, uint64_t now, WindowSnapshot& snapshot);
+    // 다시 확인할 때가 된 격리 창을 제목 다시 읽기 대상으로 채움 (응답 없는 채로 닫힌 창은 격리 목록에서 지움)
+    void CollectDueProbes(uint64_t now, WindowChanges& changes);
+
+private:
+    struct Pass
+    {
+        WindowListUpdater* self;
+        WindowDiff* diff;  // 변경분 누적 대상
+        uint64_t* visits;  // 열거 콜백 호출 수
+        uint64_t now;
+    };
+
+    static bool Visit(void* context, WindowId id);
+    void Enumerate(uint64_t now, WindowDiff& diff, uint64_t* visits);
+    void RefreshTitles(const std::vector<WindowId>& windows, uint64_t now, WindowDiff& diff);
+    // 격리 목록을 반영한 제목 읽기. 격리 중이고 다시 확인할 때가 아니면 질의하지 않고 false,
+    // 질의가 시간 초과되면 격리하고 false. 응답하면 격리를 풀고 true
+    bool ProbeTitle(WindowId id, uint64_t now);
+    uint64_t Now() const { return m_clock ? m_clock() : 0; }
+
+    PreviewBackend* m_backend;
+    WindowRegistry& m_model;
+    WindowFilter& m_filter;
+    HungWindowList& m_hung;
+    WindowTracker& m_tracker;
+    ClockFn m_clock;
+    // 호출마다 할당하지 않도록 재사용하는 작업 버퍼
+    std::wstring m_title;
+    std::wstring m_originClass;
+    std::wstring m_originProcess;
+    WindowDiff m_diff;
+    std::vector<WindowId> m_hungChanged;
+    std::vector<WindowId> m_hungRecovered;
+};
+
+// 미리보기 슬롯마다 배치/갱신 루프에서 읽는 필드 (SlotTable의 Hot 배열로 씀)
+struct PreviewSlot
+{
+    WindowId selected;       // 슬롯에서 선택된 대상 창 (0이면 없음)
+    PreviewHandle thumbnail; // 선택된 창의 썸네일 핸들 (백엔드가 발급)
+    uint32_t titleVersion;   // 선택된 창 제목을 마지막으로 표시했을 때의 버전 (바뀐 경우에만 다시 그림)
+};
+
+//=============================================================================
+// SlotPresenter: 스냅숏과 슬롯 상태를 사본 레지스트리/검색 색인/썸네일/배치에 반영 (UI 스레드 전용)
+// - ApplySnapshot: 변경분을 사본에 적용하고 실제로 바뀐 것을 검색 색인과 원본 크기 캐시에 반영
+// - ApplyWindowDiff: 선택된 창이 목록에서 사라진 슬롯과 제목 버전이 바뀐 슬롯만 골라냄 (표시는 호출 측)
+// - BuildFrame: 슬롯별 썸네일 등록/해제, 원본 크기(캐시가 무효화된 경우만 질의)로 배치를 계산하고
+//   마지막으로 적용한 배치와 비교 (바뀐 콤보박스/썸네일은 FrameCommitter에). 등록에 실패한 슬롯은 선택 해제
+// - Commit: 목적지가 바뀐 썸네일만 백엔드에 보내고 이번 프레임을 적용한 것으로 기록
+// - 백엔드 호출(썸네일 등록/해제/크기 질의/속성 갱신)은 perf가 있으면 PERF_COUNT_DWM으로 셈
+//=============================================================================
+class SlotPresenter
+{
+public:
+    typedef int (*InsetFn)(void* context, int slot); // 썸네일을 안쪽으로 줄일 픽셀 수 (슬롯 테두리 자리)
+
+    SlotPresenter(PreviewBackend* backend, WindowRegistry& registry, SearchIndex& search, SourceSizeCache& sizeCache,
+                  LayoutEngine& layout, FrameCommitter& frame)
+        : m_backend(backend), m_registry(registry), m_search(search), m_sizeCache(sizeCache), m_layout(layout),
+          m_frame(frame), m_perf(NULL), m_inset(NULL), m_insetContext(NULL), m_searchReady(false) {}
+
+    void SetPerf(PerfCounters* perf) { m_perf = perf; }
+    void SetInset(InsetFn inset, void* context) { m_inset = inset; m_insetContext = context; }
+
+    // 배치를 다시 계산해야 하면 (목록을 다시 열거했거나 감시 창 크기가 바뀜) true
+    bool ApplySnapshot(const WindowSnapshot& snapshot, WindowDiff& applied);
+    void ApplyWindowDiff(const WindowDiff& diff, PreviewSlot* slots, int count,
+                         std::vector<int>& removed, std::vector<int>& retitled);
+
+    // 검색 색인은 처음 검색할 때 사본 전체로 만들고 (창마다 프로세스 이름을 읽어야 하므로 시작 시에는 하지 않음)
+    // 이후 변경분으로 갱신. 새 창은 프로세스/클래스 이름까지 한 번만 읽고, 이후에는 제목만 갱신
+    void UpdateSearchIndex(const WindowDiff& diff);
+    void EnsureSearchIndex();
+    // 검색어에 맞는 창을 목록(사본) 순서로 rows에 채움. 검색어가 없으면 false (목록 전체)
+    bool Search(const std::wstring& query, std::vector<WindowId>& rows);
+
+    void BuildFrame(PreviewSlot* slots, int count);
+    void Commit(const PreviewSlot* slots);
+
+    // 미리보기 중인 창 (크기/제목 변경 추적 대상, 슬롯 순서)
+    static void CollectWatched(const PreviewSlot* slots, int count, std::vector<WindowId>& watched);
+
+private:
+    void Count(uint64_t n = 1) { if (m_perf) m_perf->Add(PERF_COUNT_DWM, n); }
+
+    PreviewBackend* m_backend;
+    WindowRegistry& m_registry;
+    SearchIndex& m_search;
+    SourceSizeCache& m_sizeCache;
+    LayoutEngine& m_layout;
+    FrameCommitter& m_frame;
+    PerfCounters* m_perf;
+    InsetFn m_inset;
+    void* m_insetContext;
+    bool m_searchReady;
+    // 호출마다 할당하지 않도록 재사용하는 작업 버퍼
+    std::vector<char> m_registered;
+    std::vector<WindowId> m_searchOrder;
+    std::wstring m_originProcess;
+    std::wstring m_originClass;
+};
+
+#endif // VIEWERMODEL_H
@@ -0,0 +1,319 @@
+/*
+    windowfilter.cpp
+    =======================
+    PatternMatcher, WindowFilter 구현
+*/
+#include "windowfilter.h"
+#include <wchar.h>
+#include <wctype.h>
+
+//-----------------------------------------------------------------------------
+// PatternMatcher
+//-----------------------------------------------------------------------------
+wchar_t PatternMatcher::Fold(wchar_t c)
+{
+    if (c >= L'A' && c <= L'Z')
+        return (wchar_t)(c + (L'a' - L'A'));
+    if (c < 0x80)
+        return c;
+    return (wchar_t)towlower((wint_t)c);
+}
+
+void PatternMatcher::Clear()
+{
+    m_trie.clear();
+    m_trieOutput.clear();
+    m_nodes.clear();
+    m_edges.clear();
+}
+
+void PatternMatcher::Add(const std::wstring& pattern, uint8_t output)
+{
+    if (pattern.empty())
+        return;
+    if (m_trie.empty())
+    {
+        m_trie.push_back(std::map<wchar_t, uint32_t>());
+        m_trieOutput.push_back(0);
+    }
+    uint32_t state = 0;
+    for (size_t i = 0; i < pattern.size(); i++)
+    {
+        wchar_t ch = Fold(pattern[i]);
+        std::map<wchar_t, uint32_t>::iterator it = m_trie[state].find(ch);
+        if (it != m_trie[state].end())
+        {
+            state = it->second;
+            continue;
+        }
+        uint32_t next = (uint32_t)m_trie.size();
+        m_trie[state][ch] = next; // push_back 전에 기록 (push_back이 m_trie[state] 참조를 무효화함)
+        m_trie.push_back(std::map<wchar_t, uint32_t>());
+        m_trieOutput.push_back(0);
+        state = next;
+    }
+    m_trieOutput[state] |= output;
+}
+
+bool PatternMatcher::Step(uint32_t state, wchar_t ch, uint32_t* next) const
+{
+    const Node& node = m_nodes[state];
+    if (node.edgeCount == 0)
+        return false;
+    const Edge* first = &m_edges[0] + node.firstEdge;
+    const Edge* last = first + node.edgeCount;
+    // 간선은 글자순 정렬: 이진 탐색
+    while (first < last)
+    {
+        const Edge* mid = first + (last - first) / 2;
+        if (mid->ch < ch)
+            first = mid + 1;
+        else
+            last = mid;
+    }
+    if (first < &m_edges[0] + node.firstEdge + node.edgeCount && first->ch == ch)
+    {
+        *next = first->next;
+        return true;
+    }
+    return false;
+}
+
+void PatternMatcher::Build()
+{
+    m_nodes.clear();
+    m_edges.clear();
+    if (m_trie.empty())
+        return;
+
+    // 1. 트라이를 노드 번호 순서 그대로 연속 배열로 옮김 (std::map은 이미 글자순)
+    m_nodes.resize(m_trie.size());
+    for (size_t n = 0; n < m_trie.size(); n++)
+    {
+        Node& node = m_nodes[n];
+        node.firstEdge = (uint32_t)m_edges.size();
+        node.edgeCount = (uint32_t)m_trie[n].size();
+        node.fail = 0;
+        node.output = m_trieOutput[n];
+        for (std::map<wchar_t, uint32_t>::const_iterator it = m_trie[n].begin(); it != m_trie[n].end(); ++it)
+        {
+            Edge edge = { it->first, it->second };
+            m_edges.push_back(edge);
+        }
+    }
+
+    // 2. 너비 우선으로 실패 링크 계산. 부모의 실패 링크가 먼저 정해지므로 출력도 함께 누적
+    std::vector<uint32_t> queue;
+    queue.reserve(m_nodes.size());
+    for (uint32_t e = 0; e < m_nodes[0].edgeCount; e++)
+        queue.push_back(m_edges[m_nodes[0].firstEdge + e].next); // 루트의 자식은 실패 링크가 루트
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        uint32_t parent = queue[head];
+        for (uint32_t e = 0; e < m_nodes[parent].edgeCount; e++)
+        {
+            const Edge& edge = m_edges[m_nodes[parent].firstEdge + e];
+            uint32_t fail = m_nodes[parent].fail;
+            uint32_t target = 0;
+            while (!Step(fail, edge.ch, &target) && fail != 0)
+                fail = m_nodes[fail].fail;
+            if (!Step(fail, edge.ch, &target))
+                target = 0;
+            m_nodes[edge.next].fail = target;
+            m_nodes[edge.next].output |= m_nodes[target].output;
+            queue.push_back(edge.next);
+        }
+    }
+}
+
+uint8_t PatternMatcher::Match(const wchar_t* text, size_t length, uint8_t stopMask) const
+{
+    if (Empty())
+        return 0;
+    uint8_t result = 0;
+    uint32_t state = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        wchar_t ch = Fold(text[i]);
+        uint32_t next;
+        while (!Step(state, ch, &next))
+        {
+            if (state == 0)
+            {
+                next = 0;
+                break;
+            }
+            state = m_nodes[state].fail;
+        }
+        state = next;
+        result |= m_nodes[state].output;
+        if (result & stopMask)
+            break;
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+// WindowFilter: 규칙 해석/컴파일
+//-----------------------------------------------------------------------------
+static bool StartsWith(const wchar_t* text, size_t length, const wchar_t* prefix, size_t* consumed)
+{
+    size_t n = wcslen(prefix);
+    if (length < n)
+        return false;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (PatternMatcher::Fold(text[i]) != prefix[i])
+            return false;
+    }
+    *consumed = n;
+    return true;
+}
+
+bool WindowFilter::AddRule(const wchar_t* rule, size_t length)
+{
+    // 앞뒤 공백 제거 (패턴 안쪽 공백은 유지)
+    while (length > 0 && iswspace((wint_t)*rule))
+    {
+        rule++;
+        length--;
+    }
+    while (length > 0 && iswspace((wint_t)rule[length - 1]))
+        length--;
+    if (length == 0 || *rule == L'#')
+        return true; // 빈 줄/주석
+
+    uint8_t action = FILTER_EXCLUDE;
+    if (*rule == L'+' || *rule == L'-')
+    {
+        action = (*rule == L'+') ? FILTER_INCLUDE : FILTER_EXCLUDE;
+        rule++;
+        length--;
+    }
+
+    static const wchar_t* const kFieldPrefixes[FIELD_COUNT] = { L"title:", L"class:", L"process:" };
+    size_t consumed = 0;
+    for (int f = 0; f < FIELD_COUNT; f++)
+    {
+        if (!StartsWith(rule, length, kFieldPrefixes[f], &consumed))
+            continue;
+        if (consumed == length)
+            return false; // 빈 패턴은 모든 창에 일치하므로 실수로 보고 무시
+        m_matchers[f].Add(std::wstring(rule + consumed, length - consumed), action);
+        m_hasInclude = m_hasInclude || action == FILTER_INCLUDE;
+        m_ruleCount++;
+        return true;
+    }
+    if (StartsWith(rule, length, L"owned", &consumed) && consumed == length)
+        m_ownedMask |= action;
+    else if (StartsWith(rule, length, L"toolwindow", &consumed) && consumed == length)
+        m_toolMask |= action;
+    else
+        return false;
+    m_hasInclude = m_hasInclude || action == FILTER_INCLUDE;
+    m_ruleCount++;
+    return true;
+}
+
+void WindowFilter::ClearRules()
+{
+    for (int f = 0; f < FIELD_COUNT; f++)
+        m_matchers[f].Clear();
+    m_hasInclude = false;
+    m_ownedMask = 0;
+    m_toolMask = 0;
+    m_ruleCount = 0;
+    m_cache.clear();
+}
+
+void WindowFilter::Compile()
+{
+    for (int f = 0; f < FIELD_COUNT; f++)
+        m_matchers[f].Build();
+    m_cache.clear(); // 규칙이 바뀌었으므로 모든 창을 다시 판정
+}
+
+//-----------------------------------------------------------------------------
+// 판정과 캐시
+//-----------------------------------------------------------------------------
+uint64_t WindowFilter::HashTitle(const wchar_t* title, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (uint64_t)(uint32_t)title[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash ^ (uint64_t)length;
+}
+
+bool WindowFilter::Decide(uint8_t mask) const
+{
+    if (mask & FILTER_EXCLUDE)
+        return false;
+    return !m_hasInclude || (mask & FILTER_INCLUDE) != 0;
+}
+
+uint8_t WindowFilter::MatchTitle(const wchar_t* title, size_t length, uint8_t originMask)
+{
+    if ((originMask & FILTER_EXCLUDE) || m_matchers[FIELD_TITLE].Empty())
+        return 0; // 이미 제외됐거나 제목 규칙이 없으면 훑지 않음
+    m_titleScans++;
+    return m_matchers[FIELD_TITLE].Match(title, length, FILTER_EXCLUDE);
+}
+
+bool WindowFilter::Lookup(WindowId id, const wchar_t* title, size_t length, bool* accepted)
+{
+    std::unordered_map<WindowId, CacheEntry>::iterator it = m_cache.find(id);
+    if (it == m_cache.end())
+        return false;
+    CacheEntry& entry = it->second;
+    entry.seenGeneration = m_generation;
+    uint64_t hash = HashTitle(title, length);
+    if (hash != entry.titleHash)
+    {
+        // 제목이 바뀐 창만 제목 규칙을 다시 적용 (클래스/프로세스 판정은 그대로)
+        entry.titleHash = hash;
+        entry.titleMask = MatchTitle(title, length, entry.originMask);
+        entry.accepted = Decide(entry.originMask | entry.titleMask);
+    }
+    *accepted = entry.accepted;
+    return true;
+}
+
+bool WindowFilter::Evaluate(WindowId id, const wchar_t* title, size_t length, const WindowOrigin& origin)
+{
+    uint8_t originMask = 0;
+    if (origin.owned)
+        originMask |= m_ownedMask;
+    if (origin.toolWindow)
+        originMask |= m_toolMask;
+    if (!(originMask & FILTER_EXCLUDE) && origin.className)
+        originMask |= m_matchers[FIELD_CLASS].Match(origin.className, wcslen(origin.className), FILTER_EXCLUDE);
+    if (!(originMask & FILTER_EXCLUDE) && origin.process)
+        originMask |= m_matchers[FIELD_PROCESS].Match(origin.process, wcslen(origin.process), FILTER_EXCLUDE);
+
+    CacheEntry& entry = m_cache[id];
+    entry.titleHash = HashTitle(title, length);
+    entry.seenGeneration = m_generation;
+    entry.originMask = originMask;
+    entry.titleMask = MatchTitle(title, length, originMask);
+    entry.accepted = Decide(originMask | entry.titleMask);
+    return entry.accepted;
+}
+
+void WindowFilter::BeginPass()
+{
+    m_generation++;
+}
+
+void WindowFilter::EndPass()
+{
+    for (std::unordered_map<WindowId, CacheEntry>::iterator it = m_cache.begin(); it != m_cache.end(); )
+    {
+        if (it->second.seenGeneration != m_generation)
+            it = m_cache.erase(it);
+        else
+            ++it;
+    }
+}
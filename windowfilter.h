@@ -0,0 +1,138 @@
+// windowfilter.h
+// 창 목록 포함/제외 규칙. 규칙 문자열을 제목/클래스/프로세스 필드별 다중 패턴 매처(Aho-Corasick)로 컴파일하고,
+// 창마다 판정을 캐시하여 제목이 바뀐 창만 제목을 한 번 훑어 다시 판정한다 (패턴 수 x 창 수 x 틱 비용 없음).
+// Win32 헤더에 의존하지 않음: 클래스/프로세스 이름과 소유자/도구 창 여부는 호출 측이 읽어서 넘김.
+#ifndef WINDOWFILTER_H
+#define WINDOWFILTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include "windowtracker.h" // WindowId
+
+// 규칙이 일치했을 때의 동작 (패턴 출력 비트)
+enum FilterAction
+{
+    FILTER_INCLUDE = 1,
+    FILTER_EXCLUDE = 2
+};
+
+//=============================================================================
+// PatternMatcher: Aho-Corasick 다중 부분 문자열 매처
+// - 패턴마다 출력 비트(FilterAction)를 붙이고, 본문을 한 번 훑어 일치한 패턴들의 비트 OR을 돌려줌
+// - 대소문자 구분 없음 (패턴과 본문 모두 소문자로 비교)
+// - 컴파일 후에는 노드/간선을 연속 배열에 두고 간선은 글자순 정렬 (노드별 이진 탐색)
+//=============================================================================
+class PatternMatcher
+{
+public:
+    PatternMatcher() {}
+
+    void Clear();
+    void Add(const std::wstring& pattern, uint8_t output);
+    void Build();                   // Add 이후 Match 전에 한 번 호출
+    bool Empty() const { return m_nodes.size() <= 1; }
+
+    // stopMask의 비트가 하나라도 나오면 바로 반환
+    uint8_t Match(const wchar_t* text, size_t length, uint8_t stopMask) const;
+
+    static wchar_t Fold(wchar_t c);
+
+private:
+    struct Node
+    {
+        uint32_t firstEdge;
+        uint32_t edgeCount;
+        uint32_t fail;              // 실패 링크
+        uint8_t output;             // 이 노드와 실패 링크를 따라가며 끝나는 패턴들의 출력 OR
+    };
+    struct Edge
+    {
+        wchar_t ch;
+        uint32_t next;
+    };
+
+    bool Step(uint32_t state, wchar_t ch, uint32_t* next) const;
+
+    std::vector<std::map<wchar_t, uint32_t> > m_trie; // 구성용 트라이 (Build는 이것을 연속 배열로 옮김)
+    std::vector<uint8_t> m_trieOutput;
+    std::vector<Node> m_nodes;
+    std::vector<Edge> m_edges;
+};
+
+// 판정에 필요한 창 정보 중 제목 외의 것 (창이 처음 보일 때 한 번만 읽음)
+struct WindowOrigin
+{
+    const wchar_t* className;   // NULL이면 빈 문자열
+    const wchar_t* process;     // 실행 파일 이름 (경로 제외), NULL이면 빈 문자열
+    bool owned;                 // 소유자 창(GW_OWNER)이 있음
+    bool toolWindow;            // WS_EX_TOOLWINDOW
+};
+
+//=============================================================================
+// WindowFilter
+// - 규칙 한 줄: [+|-]대상  (+ 포함, - 또는 생략 시 제외)
+//   대상: title:부분문자열 | class:부분문자열 | process:부분문자열 | owned | toolwindow
+//   빈 줄과 #으로 시작하는 줄은 무시
+// - 포함 규칙이 하나라도 있으면 포함 규칙에 일치한 창만 남기고, 제외 규칙에 일치하면 항상 제외
+// - 판정 캐시: 창마다 제목 외 정보의 판정과 제목 해시를 보관. Lookup은 제목이 같으면 캐시를,
+//   달라졌으면 제목만 다시 훑음. 처음 보는 창이면 호출 측이 WindowOrigin을 읽어 Evaluate
+// - BeginPass/EndPass: 열거 한 번 동안 보지 못한 창(파괴/숨김)의 캐시를 지움
+//=============================================================================
+class WindowFilter
+{
+public:
+    WindowFilter() : m_hasInclude(false), m_ownedMask(0), m_toolMask(0), m_ruleCount(0),
+                     m_generation(0), m_titleScans(0) {}
+
+    // 규칙 추가 (Compile 전까지 반영되지 않음). 형식이 잘못된 규칙은 무시하고 false
+    bool AddRule(const wchar_t* rule, size_t length);
+    void ClearRules();
+    // 규칙을 매처로 컴파일하고 판정 캐시를 비움
+    void Compile();
+    size_t RuleCount() const { return m_ruleCount; }
+    // 클래스/프로세스 규칙이 있는지 (없으면 호출 측은 WindowOrigin의 해당 이름을 읽지 않아도 됨)
+    bool UsesClass() const { return !m_matchers[FIELD_CLASS].Empty(); }
+    bool UsesProcess() const { return !m_matchers[FIELD_PROCESS].Empty(); }
+
+    // 캐시된 판정. 처음 보는 창이면 false (accepted는 그대로)
+    bool Lookup(WindowId id, const wchar_t* title, size_t length, bool* accepted);
+    // 판정 후 캐시에 저장. 반환값: 목록에 포함할지
+    bool Evaluate(WindowId id, const wchar_t* title, size_t length, const WindowOrigin& origin);
+
+    void BeginPass();
+    void EndPass();
+
+    size_t CacheSize() const { return m_cache.size(); }
+    uint64_t TitleScans() const { return m_titleScans; } // 진단용: 제목을 훑은 횟수
+
+private:
+    enum { FIELD_TITLE, FIELD_CLASS, FIELD_PROCESS, FIELD_COUNT };
+
+    struct CacheEntry
+    {
+        uint64_t titleHash;
+        uint32_t seenGeneration;
+        uint8_t originMask;     // 클래스/프로세스/소유자/도구 창 규칙의 출력 OR
+        uint8_t titleMask;      // 제목 규칙의 출력 OR
+        bool accepted;
+    };
+
+    static uint64_t HashTitle(const wchar_t* title, size_t length);
+    bool Decide(uint8_t mask) const;
+    uint8_t MatchTitle(const wchar_t* title, size_t length, uint8_t originMask);
+
+    PatternMatcher m_matchers[FIELD_COUNT];
+    bool m_hasInclude;
+    uint8_t m_ownedMask;        // owned 규칙의 출력 OR
+    uint8_t m_toolMask;         // toolwindow 규칙의 출력 OR
+    size_t m_ruleCount;
+    std::unordered_map<WindowId, CacheEntry> m_cache;
+    uint32_t m_generation;
+    uint64_t m_titleScans;
+};
+
+#endif // WINDOWFILTER_H
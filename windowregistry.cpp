@@ -0,0 +1,133 @@
+/*
+    windowregistry.cpp
+    =======================
+    WindowRegistry 구현
+*/
+#include "windowregistry.h"
+#include <algorithm>
+
+void WindowRegistry::BeginPass()
+{
+    m_generation++;
+    if (m_generation == 0) // 세대 번호가 한 바퀴 돌면 0은 "한 번도 안 보임"으로 남겨 둠
+        m_generation = 1;
+    m_inPass = true;
+}
+
+void WindowRegistry::Observe(WindowId id, const wchar_t* title, size_t length, WindowDiff& diff)
+{
+    std::unordered_map<WindowId, size_t>::iterator it = m_index.find(id);
+    if (it == m_index.end()) {
+        Entry entry;
+        entry.id = id;
+        entry.seenGeneration = m_generation;
+        entry.title = m_titles.Alloc();
+        m_titles.Set(entry.title, title, length);
+        m_index[id] = m_entries.size();
+        m_entries.push_back(entry);
+        diff.added.push_back(id);
+        return;
+    }
+
+    Entry& entry = m_entries[it->second];
+    entry.seenGeneration = m_generation;
+    // 빈 제목은 무시하고 마지막으로 알려진 제목 유지
+    if (length > 0 && m_titles.Set(entry.title, title, length)) {
+        diff.changed.push_back(id);
+    }
+}
+
+void WindowRegistry::EndPass(WindowDiff& diff)
+{
+    if (!m_inPass)
+        return;
+    m_inPass = false;
+
+    // 이번 세대에 보이지 않은 항목을 제거하면서 순서를 유지한 채 앞으로 당김
+    size_t write = 0;
+    for (size_t read = 0; read < m_entries.size(); read++) {
+        if (m_entries[read].seenGeneration != m_generation) {
+            diff.removed.push_back(m_entries[read].id);
+            diff.removedPositions.push_back(read);
+            m_index.erase(m_entries[read].id);
+            m_titles.Free(m_entries[read].title);
+            continue;
+        }
+        if (write != read) {
+            m_entries[write] = m_entries[read];
+            m_index[m_entries[write].id] = write;
+        }
+        write++;
+    }
+    m_entries.resize(write);
+}
+
+bool WindowRegistry::UpdateTitle(WindowId id, const wchar_t* title, size_t length, WindowDiff& diff)
+{
+    std::unordered_map<WindowId, size_t>::iterator it = m_index.find(id);
+    if (it == m_index.end() || length == 0)
+        return false;
+    if (!m_titles.Set(m_entries[it->second].title, title, length))
+        return false;
+    diff.changed.push_back(id);
+    return true;
+}
+
+bool WindowRegistry::Add(WindowId id, const wchar_t* title, size_t length, WindowDiff& diff)
+{
+    if (m_index.find(id) != m_index.end())
+        return UpdateTitle(id, title, length, diff);
+    Entry entry;
+    entry.id = id;
+    entry.seenGeneration = m_generation;
+    entry.title = m_titles.Alloc();
+    m_titles.Set(entry.title, title, length);
+    m_index[id] = m_entries.size();
+    m_entries.push_back(entry);
+    diff.added.push_back(id);
+    return true;
+}
+
+void WindowRegistry::Remove(const std::vector<WindowId>& ids, WindowDiff& diff)
+{
+    m_removePositions.clear();
+    for (size_t k = 0; k < ids.size(); k++) {
+        std::unordered_map<WindowId, size_t>::const_iterator it = m_index.find(ids[k]);
+        if (it != m_index.end())
+            m_removePositions.push_back(it->second);
+    }
+    if (m_removePositions.empty())
+        return;
+    std::sort(m_removePositions.begin(), m_removePositions.end());
+    m_removePositions.erase(std::unique(m_removePositions.begin(), m_removePositions.end()), m_removePositions.end());
+
+    // EndPass와 같이 첫 제거 위치부터 한 번만 훑으며 앞으로 당김
+    size_t write = m_removePositions[0];
+    size_t next = 0;
+    for (size_t read = write; read < m_entries.size(); read++) {
+        if (next < m_removePositions.size() && m_removePositions[next] == read) {
+            next++;
+            diff.removed.push_back(m_entries[read].id);
+            diff.removedPositions.push_back(read);
+            m_index.erase(m_entries[read].id);
+            m_titles.Free(m_entries[read].title);
+            continue;
+        }
+        m_entries[write] = m_entries[read];
+        m_index[m_entries[write].id] = write;
+        write++;
+    }
+    m_entries.resize(write);
+}
+
+const WindowRegistry::Entry* WindowRegistry::Find(WindowId id) const
+{
+    std::unordered_map<WindowId, size_t>::const_iterator it = m_index.find(id);
+    return it == m_index.end() ? NULL : &m_entries[it->second];
+}
+
+int WindowRegistry::IndexOf(WindowId id) const
+{
+    std::unordered_map<WindowId, size_t>::const_iterator it = m_index.find(id);
+    return it == m_index.end() ? -1 : (int)it->second;
+}
@@ -0,0 +1,80 @@
+// windowregistry.h
+// 추적 중인 최상위 창들의 중앙 목록. 해시 인덱스 + 세대(generation) 표식으로
+// 열거 한 번마다 추가/제거/변경 집합(diff)을 만들어 UI에는 변경분만 전달한다.
+#ifndef WINDOWREGISTRY_H
+#define WINDOWREGISTRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+#include "windowtracker.h" // WindowId
+#include "titlestore.h"    // 제목 저장소
+
+// 한 번의 갱신에서 발생한 목록 변경분
+struct WindowDiff
+{
+    std::vector<WindowId> added;           // 새로 나타난 창 (목록 끝에 추가됨)
+    std::vector<WindowId> removed;         // 사라진 창
+    std::vector<size_t> removedPositions;  // 제거 전 목록에서의 위치 (오름차순, removed와 같은 순서)
+    std::vector<WindowId> changed;         // 제목이 바뀐 창 (제목 버전이 올라간 창)
+
+    bool Empty() const { return added.empty() && removed.empty() && changed.empty(); }
+    void Clear() { added.clear(); removed.clear(); removedPositions.clear(); changed.clear(); }
+};
+
+//=============================================================================
+// WindowRegistry: 창 목록의 단일 원본
+// - 항목은 처음 발견된 순서대로 연속 배열에 보관 (UI 목록 순서와 동일)
+// - WindowId -> 위치 해시 인덱스로 멤버십 확인은 O(1)
+// - BeginPass/Observe/EndPass: 열거 한 번을 세대 하나로 보고, 이번 세대에 보이지 않은 항목을 제거
+// - 제목은 TitleStore에 보관하며 바뀔 때마다 항목별 버전이 증가
+//=============================================================================
+class WindowRegistry
+{
+public:
+    struct Entry
+    {
+        WindowId id;
+        uint32_t seenGeneration; // 마지막으로 열거에서 확인된 세대
+        TitleStore::Handle title; // 제목 저장소 핸들
+    };
+
+    WindowRegistry() : m_generation(0), m_inPass(false) {}
+
+    // 열거 패스 시작: 세대 번호 증가
+    void BeginPass();
+    // 열거 중 발견된 창 보고 (추가 또는 제목 변경을 diff에 기록)
+    void Observe(WindowId id, const wchar_t* title, size_t length, WindowDiff& diff);
+    // 열거 패스 종료: 이번 세대에 보이지 않은 창을 제거하고 diff에 기록
+    void EndPass(WindowDiff& diff);
+
+    // 열거 없이 한 창의 제목만 갱신 (제목 변경 이벤트). 빈 제목은 무시하고 기존 제목 유지
+    bool UpdateTitle(WindowId id, const wchar_t* title, size_t length, WindowDiff& diff);
+
+    // 열거 없이 변경분을 직접 적용 (다른 스레드의 레지스트리가 만든 변경분을 받는 사본용)
+    // Add: 목록 끝에 추가 (이미 있으면 제목만 갱신). Remove: 여러 창을 한 번에 제거하며 순서 유지
+    bool Add(WindowId id, const wchar_t* title, size_t length, WindowDiff& diff);
+    void Remove(const std::vector<WindowId>& ids, WindowDiff& diff);
+
+    // 조회
+    size_t Size() const { return m_entries.size(); }
+    const Entry& At(size_t position) const { return m_entries[position]; }
+    const Entry* Find(WindowId id) const;
+    // 목록에서의 위치, 없으면 -1
+    int IndexOf(WindowId id) const;
+    // 제목 조회 (포인터는 다음 제목 갱신 전까지만 유효)
+    const wchar_t* Title(const Entry& entry, size_t* length) const { return m_titles.Get(entry.title, length); }
+    uint32_t TitleVersion(const Entry& entry) const { return m_titles.Version(entry.title); }
+    uint32_t Generation() const { return m_generation; }
+
+private:
+    std::vector<Entry> m_entries;
+    TitleStore m_titles;
+    std::unordered_map<WindowId, size_t> m_index;
+    std::vector<size_t> m_removePositions; // Remove용 재사용 버퍼
+    uint32_t m_generation;
+    bool m_inPass;
+};
+
+#endif // WINDOWREGISTRY_H
@@ -0,0 +1,114 @@
+/*
+    windowtracker.cpp
+    =======================
+    WindowTracker / ScriptedEventSource 구현
+*/
+#include "windowtracker.h"
+
+//=============================================================================
+// ScriptedEventSource
+//=============================================================================
+void ScriptedEventSource::Push(WindowEventKind kind, WindowId window)
+{
+    WindowEvent ev;
+    ev.kind = kind;
+    ev.window = window;
+    m_script.push_back(ev);
+}
+
+size_t ScriptedEventSource::Pump(size_t maxEvents)
+{
+    size_t delivered = 0;
+    while (m_next < m_script.size() && delivered < maxEvents) {
+        if (m_sink) {
+            m_sink->OnWindowEvent(m_script[m_next]);
+        }
+        m_next++;
+        delivered++;
+    }
+    // 모두 전달했으면 버퍼를 재사용할 수 있도록 비움
+    if (m_next == m_script.size()) {
+        m_script.clear();
+        m_next = 0;
+    }
+    return delivered;
+}
+
+//=============================================================================
+// WindowTracker
+//=============================================================================
+WindowTracker::WindowTracker(WakeFn wake, void* context)
+    : m_wake(wake), m_context(context), m_wakePosted(false), m_listChanged(false),
+      m_eventCount(0), m_wakeCount(0)
+{
+}
+
+void WindowTracker::OnWindowEvent(const WindowEvent& ev)
+{
+    m_eventCount++;
+    switch (ev.kind)
+    {
+        case WINDOW_EVENT_CREATE:
+        case WINDOW_EVENT_DESTROY:
+        case WINDOW_EVENT_SHOW:
+        case WINDOW_EVENT_HIDE:
+            m_listChanged = true;
+            MarkPending();
+            break;
+        case WINDOW_EVENT_NAMECHANGE:
+            m_titleChanged.insert(ev.window);
+            MarkPending();
+            break;
+        case WINDOW_EVENT_LOCATIONCHANGE:
+            // 미리보기 중이 아닌 창의 이동/크기 변경은 무시 (드래그 중 대량 발생)
+            if (m_watched.count(ev.window)) {
+                m_locationChanged.insert(ev.window);
+                MarkPending();
+            }
+            break;
+    }
+}
+
+void WindowTracker::SetWatched(const std::vector<WindowId>& windows)
+{
+    m_watched.clear();
+    for (size_t i = 0; i < windows.size(); i++) {
+        if (windows[i])
+            m_watched.insert(windows[i]);
+    }
+}
+
+void WindowTracker::RequestSweep()
+{
+    m_listChanged = true;
+    MarkPending();
+}
+
+void WindowTracker::TakeChanges(WindowChanges& out)
+{
+    out.listChanged = m_listChanged;
+    out.titleChanged.assign(m_titleChanged.begin(), m_titleChanged.end());
+    out.locationChanged.assign(m_locationChanged.begin(), m_locationChanged.end());
+    m_listChanged = false;
+    m_titleChanged.clear();
+    m_locationChanged.clear();
+    m_wakePosted = false;
+}
+
+void WindowTracker::TakeTitleChanges(std::vector<WindowId>& out)
+{
+    out.assign(m_titleChanged.begin(), m_titleChanged.end());
+    m_titleChanged.clear();
+    // 이후 도착하는 제목 변경도 다시 깨울 수 있도록 함. 남은 목록/위치 변경은 HasPending()으로 확인
+    m_wakePosted = false;
+}
+
+void WindowTracker::MarkPending()
+{
+    if (m_wakePosted)
+        return; // 이미 깨우기 요청을 보냄 (TakeChanges 전까지 합쳐짐)
+    m_wakePosted = true;
+    m_wakeCount++;
+    if (m_wake)
+        m_wake(m_context);
+}
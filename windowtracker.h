@@ -0,0 +1,124 @@
+// windowtracker.h
+// 창 이벤트(생성/파괴/표시/숨김/제목 변경/위치 변경)를 모아 UI 갱신 작업으로 변환하는 추적기.
+// Win32 헤더에 의존하지 않으므로 ScriptedEventSource와 함께 Linux에서도 빌드/검증 가능.
+#ifndef WINDOWTRACKER_H
+#define WINDOWTRACKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <unordered_set>
+
+// 플랫폼 창 핸들 (Win32에서는 HWND를 그대로 정수로 보관)
+typedef uintptr_t WindowId;
+
+// 추적기가 이해하는 창 이벤트 종류
+enum WindowEventKind
+{
+    WINDOW_EVENT_CREATE,         // 창 생성
+    WINDOW_EVENT_DESTROY,        // 창 파괴
+    WINDOW_EVENT_SHOW,           // 창 표시
+    WINDOW_EVENT_HIDE,           // 창 숨김
+    WINDOW_EVENT_NAMECHANGE,     // 창 제목 변경
+    WINDOW_EVENT_LOCATIONCHANGE  // 창 이동/크기 변경 (최소화/복원 포함)
+};
+
+struct WindowEvent
+{
+    WindowEventKind kind;
+    WindowId window;
+};
+
+// 이벤트를 받는 쪽 인터페이스
+class WindowEventSink
+{
+public:
+    virtual ~WindowEventSink() {}
+    virtual void OnWindowEvent(const WindowEvent& ev) = 0;
+};
+
+// 이벤트를 만들어 내는 쪽 인터페이스 (Win32: WinEvent 훅, 테스트: ScriptedEventSource)
+class WindowEventSource
+{
+public:
+    virtual ~WindowEventSource() {}
+    virtual bool Start(WindowEventSink* sink) = 0;
+    virtual void Stop() = 0;
+};
+
+// 미리 기록해 둔 이벤트를 Pump() 호출 시점에 전달하는 가짜 이벤트 소스
+class ScriptedEventSource : public WindowEventSource
+{
+public:
+    ScriptedEventSource() : m_sink(NULL), m_next(0) {}
+
+    bool Start(WindowEventSink* sink) { m_sink = sink; return true; }
+    void Stop() { m_sink = NULL; }
+
+    void Push(WindowEventKind kind, WindowId window);
+    // 대기 중인 이벤트를 최대 maxEvents개 전달하고 실제 전달한 개수를 반환
+    size_t Pump(size_t maxEvents = (size_t)-1);
+    size_t Pending() const { return m_script.size() - m_next; }
+
+private:
+    WindowEventSink* m_sink;
+    std::vector<WindowEvent> m_script;
+    size_t m_next;
+};
+
+// 한 번의 갱신에서 처리할 변경 사항 묶음
+struct WindowChanges
+{
+    bool listChanged;                      // 창 목록 재열거 필요 (생성/파괴/표시/숨김 또는 안전 점검)
+    std::vector<WindowId> titleChanged;    // 제목이 바뀐 창 (중복 제거됨)
+    std::vector<WindowId> locationChanged; // 크기/위치가 바뀐 감시 대상 창 (중복 제거됨)
+
+    WindowChanges() : listChanged(false) {}
+    bool Empty() const { return !listChanged && titleChanged.empty() && locationChanged.empty(); }
+};
+
+//=============================================================================
+// WindowTracker: 이벤트를 모아 두었다가 UI 스레드가 한 번에 가져가도록 합쳐 주는 계층
+// - 처음 쌓이는 이벤트에서만 wake 콜백을 호출 (UI 쪽 PostMessage는 갱신 1회당 최대 1번)
+// - 위치 변경은 미리보기 중인 창(SetWatched)에 대해서만 기록하여 유휴 시 깨어나지 않음
+// - 스레드 안전하지 않음: 이벤트 전달과 TakeChanges는 같은 스레드에서 호출해야 함
+//=============================================================================
+class WindowTracker : public WindowEventSink
+{
+public:
+    typedef void (*WakeFn)(void* context);
+
+    WindowTracker(WakeFn wake, void* context);
+
+    void OnWindowEvent(const WindowEvent& ev);
+
+    // 위치 변경을 추적할 창 목록 (미리보기 슬롯에 선택된 창들)
+    void SetWatched(const std::vector<WindowId>& windows);
+    // 안전 점검(sweep) 요청: 이벤트 누락에 대비해 전체 목록 재열거를 예약
+    void RequestSweep();
+
+    bool HasPending() const { return m_listChanged || !m_titleChanged.empty() || !m_locationChanged.empty(); }
+    // 쌓인 변경 사항을 out으로 옮기고 내부 상태를 비움
+    void TakeChanges(WindowChanges& out);
+    // 제목 변경만 가져가고 목록/위치 변경은 남겨 둠 (드롭다운이 열려 있는 동안 사용)
+    void TakeTitleChanges(std::vector<WindowId>& out);
+
+    // 누적 통계 (벤치마크/진단용)
+    uint64_t EventCount() const { return m_eventCount; }
+    uint64_t WakeCount() const { return m_wakeCount; }
+
+private:
+    void MarkPending();
+
+    WakeFn m_wake;
+    void* m_context;
+    bool m_wakePosted; // 깨우기 요청을 보낸 뒤 아직 변경 사항을 가져가지 않음
+    bool m_listChanged;
+    std::unordered_set<WindowId> m_titleChanged;
+    std::unordered_set<WindowId> m_locationChanged;
+    std::unordered_set<WindowId> m_watched;
+    uint64_t m_eventCount;
+    uint64_t m_wakeCount;
+};
+
+#endif // WINDOWTRACKER_H
@@ -17,6 +17,79 @@
       - 재수정: '창+1'/'창-1' 기능의 정확한 슬롯 이동 및 우클릭 영역 인식 로직 개선.
       - 재재수정: '창+1' 기능이 우클릭한 창의 *오른쪽*에 삽입되도록 `insertIndex` 로직 수정.
       - **재재재수정:** 창 추가/제거 시 `g_Thumbnails` 핸들 관리 로직을 가장 안정적인 방법으로 개선하여 검정 화면 문제 해결.
+      - 0.5초 폴링 대신 WinEvent 훅 기반 창 추적(windowtracker.h)으로 변경. 타이머는 느린 안전 점검용으로만 사용.
+      - 창 목록을 해시 인덱스 기반 중앙 레지스트리(windowregistry.h)로 관리하고, 콤보박스에는 변경분(diff)만 반영.
+      - 콤보박스를 오너 드로우로 변경: 닫힌 콤보박스는 선택 항목 하나만 보관하고, 드롭다운을 열 때만
+                레지스트리에서 목록을 채움. 항목 문자열은 복사하지 않고 그릴 때 레지스트리에서 읽음.
+      - 창 제목을 길이 제한 없이 제목 저장소(titlestore.h)에 보관하고, 버전이 바뀐 항목만 제자리에서 다시 그림.
+      - 슬롯 배치 계산을 배치 계산기(layout.h)로 통합. 클릭 위치 판별은 캐시된 배치에서 이진 탐색.
+      - 썸네일 원본 크기를 슬롯별로 캐시(sizecache.h)하고 대상 창의 크기 변경/최소화/복원 이벤트에서만 다시 질의.
+      - 배치 변경을 프레임 단위로 모아(framecommit.h) 바뀐 것만 한 번에 적용: 콤보박스는 DeferWindowPos 일괄 이동,
+                썸네일은 슬롯당 DwmUpdateThumbnailProperties 1회 (숨김/재노출 2회 호출 제거, 비워진 영역은 다시 그림).
+      - 고정 주기 타이머 대신 적응형 갱신 스케줄러(refreshscheduler.h) 사용: 창 목록/제목 점검을
+                작업별 간격으로 실행하고, 변경이 없으면 간격을 늘리며, 조작 직후에는 짧게, 최소화/가려짐/배터리/절전
+                시에는 길게 잡음. 타이머는 가장 이른 작업 시각에 한 번만 깨어나며 초당 깨어남 횟수를 메뉴에 표시.
+                원본 크기는 주기적으로 묻지 않고 추적기의 감시 창 크기 변경 이벤트로만 다시 질의.
+      - '격자 배치' 메뉴 추가: 현재 모니터 작업 영역 안에 슬롯을 여러 줄로 배치하고 썸네일 높이를 맞춤.
+                격자 배치에서는 한 줄 너비 제한 대신 작업 영역에 최소 높이 썸네일이 들어가는 개수까지 표시.
+      - 슬롯 상태를 고정 크기 병렬 배열 대신 슬롯 저장소(slottable.h)에 보관: 자주 읽는 필드(선택 창, 썸네일)와
+                가끔 쓰는 필드(콤보박스, 제목 버전)를 나눈 연속 배열. 컴파일 시 최대 개수(MAX_SEGMENTS) 제거,
+                개수는 화면에 담을 수 있는 만큼으로 제한. 창+1/창-1은 콤보박스 하나만 생성/파괴하고 썸네일은 유지하며,
+                '왼쪽으로 이동'/'오른쪽으로 이동' 메뉴로 슬롯 순서 변경.
+      - WM_PAINT마다 메모리 DC/비트맵을 만들고 전체를 복사하던 방식 대신 유지되는 백 버퍼(BackBuffer)에
+                무효화된 영역(ps.rcPaint)만 다시 그려 복사. 버퍼는 창이 커질 때만 다시 만들고 크게 줄면 축소.
+      - 성능 계측(perfcounters.h) 추가: 틱 처리/재열거/제목/배치/적용/재생성/그리기 단계별 소요 시간 히스토그램과
+                SendMessage/DWM/DeferWindowPos/EnumWindows 호출 횟수. '성능 통계 표시' 메뉴로 메인 윈도우 위에
+                클릭이 통과하는 작은 창으로 1초마다 표시하고, '성능 기록 저장' 메뉴로 1분마다
+                %LOCALAPPDATA%\MultiWindowViewer\perf.log에 추가 기록.
+      - 가상 데스크톱(simdesktop.h)과 벤치마크(viewerbench.cpp) 추가: 창 목록/제목/슬롯/배치 처리를 Win32 없이
+                수천 개의 창에 대해 돌려 틱당 지연 시간과 할당 횟수를 측정 (Linux에서는 benchbuild.sh로 빌드).
+                목록 갱신/슬롯 반영 처리는 viewermodel.h(WindowListUpdater/SlotPresenter)로 분리하고, 창 열거와
+                썸네일 등록/배치/해제는 미리보기 백엔드 인터페이스(previewbackend.h)의 DwmPreviewBackend 뒤로 옮겨
+                벤치마크가 winview.cpp와 같은 코드를 가상 데스크톱 백엔드로 실행.
+      - 드롭다운 검색 추가: 목록이 열린 상태에서 입력하면 제목/프로세스 이름/클래스 이름으로 걸러 보여줌.
+                검색 색인(searchindex.h)은 레지스트리 변경분(diff)으로만 갱신하는 1~3글자 조각 색인.
+      - 창 목록 필터 규칙 추가: 하드코딩된 제외 제목 목록과 g_excludeOwnerWindows 대신 제목/클래스/프로세스/
+                소유자 창/도구 창에 대한 포함·제외 규칙을 레지스트리(FilterRules, REG_MULTI_SZ)에서 읽어
+                다중 패턴 매처로 컴파일 (windowfilter.h). 판정은 창마다 캐시하여 제목이 바뀐 창만 다시 판정.
+      - 슬롯 연결 복원 추가: 슬롯마다 선택한 창을 실행 파일 이름/클래스 이름/제목 패턴으로
+                %LOCALAPPDATA%\MultiWindowViewer\session.dat에 저장하고 (sessionstore.h), 시작 시 첫 열거에서
+                대조하여 첫 화면부터 미리보기를 채움. 종료 시 한 번 저장하던 설정도 변경 후 잠잠해지면 모아서 저장하며,
+                세션 파일은 임시 파일에 쓴 뒤 교체하여 비정상 종료에도 손상되지 않음.
+      - 시작 지연 단축: WM_CREATE에서는 빈 콤보박스와 배치만 만들고 창을 먼저 표시한 뒤, 창 목록 열거/슬롯 복원/
+                이벤트 훅 설치는 첫 그리기 다음 메시지(WM_APP_STARTUP)에서 처리. UI 폰트는 정적 초기화 대신 첫 사용 시
+                생성하고, 검색 색인은 처음 검색할 때 만들며, 필터 규칙에 클래스/프로세스 규칙이 없으면 그 이름을 읽지 않음.
+                /startuptime 옵션으로 실행하면 첫 그리기/목록 준비/첫 썸네일까지의 시간을 startup.log에 남기고 종료.
+      - 창 목록 열거/제목 읽기/필터 판정과 WinEvent 훅을 작업 스레드(EnumerationWorker)로 옮김. 작업 스레드는 원본
+                레지스트리의 변경분을 스냅숏으로 만들어 잠금 없는 이중 버퍼(modelsnapshot.h)로 게시한 뒤 WM_APP_SNAPSHOT을
+                한 번 보내고, UI 스레드는 사본 레지스트리에 변경분만 적용. UI가 바쁜 동안의 갱신은 하나로 합쳐지며,
+                드롭다운이 열려 있으면 제목만 반영하고 목록 변경은 닫힐 때 적용.
+      - 응답 없는 창 격리: 제목 길이 질의를 SendMessageTimeout(SMTO_ABORTIFHUNG, 200ms)으로 바꾸고, 시간 초과된 창은
+                격리 목록(hungwindows.h)에 넣어 마지막으로 알려진 제목을 유지하며 2초부터 2배씩(최대 60초) 늘어나는
+                간격으로만 다시 확인. 드롭다운 항목에는 "[응답 없음]" 표시를 붙이고, 열거에서 이 프로세스의 창은 제외.
+                더블클릭 활성화는 ShowWindowAsync로 바꿔 응답 없는 창을 기다리지 않음.
+      - 미리보기 백엔드 인터페이스(previewbackend.h)에 Commit 단계 추가 (썸네일 속성은 한 프레임에 모아 반영).
+                Linux용 X11 백엔드(x11backend.h, XComposite/XDamage/XRender)와 같은 슬롯/배치 엔진을 쓰는
+                x11viewer.cpp 추가 (x11build.sh, Xvfb에서 --selftest로 검증).
+      - 캡처 대체 경로 추가: DWM 썸네일 등록이 실패하면 (합성이 꺼진 원격/헤드리스 세션 등) 슬롯을 비우는 대신
+                PrintWindow/BitBlt로 캡처해 슬롯 크기로 줄여 그림 (0.5초마다 갱신). 축소 커널(downscale.h)은 박스(1/2)와
+                쌍선형이며 스칼라 기준 구현과 비트 단위로 같은 SSE2/AVX2/NEON 구현을 실행 시 골라 씀. 처리량은
+                scalebench.cpp로 측정. /capture 옵션으로 실행하면 DWM 대신 항상 캡처 경로를 씀. X11 쪽은 XGetImage/MIT-SHM.
+                PrintWindow는 대상 창이 답할 때까지 기다리므로 SendMessageCallback(WM_NULL) 확인에 답한 창에만 쓰고
+                바쁘거나 응답 없는 창은 화면 복사로 대신함 (UI 스레드는 다른 프로세스를 기다리지 않음).
+      - 캡처 변경 감지 (framediff.h): 캡처한 프레임을 64x32 타일로 나눠 SIMD 해시를 비교하고, 바뀐 타일이 없으면
+                축소와 다시 그리기를 건너뜀. 바뀐 타일이 있으면 그 행을 읽는 축소 결과 행만 다시 계산하고
+                (Downscaler::ScaleRows) 바뀐 자리만 무효화. 슬롯별 바뀐/건너뛴 캡처 수는 계측 요약에 표시.
+      - 슬롯 활동 알림 (activitymonitor.h): 우클릭 메뉴 "바뀌면 알림"/"멈추면 알림"으로 켠 슬롯만 1초마다 64x36 표본을
+                떠서 SIMD 절댓값 차이로 비교. 표본은 화면에서 64x36 DIB로 바로 줄여 읽음 (StretchBlt HALFTONE). 알림이 켜지면 썸네일 둘레에 테두리(변경 주황, 멈춤 빨강)를 그리고 작업 표시줄
+                버튼을 깜빡임. 더블클릭이나 "알림 끄기"로 끔. 표본 비용은 코어 1% 예산 안에서만 쓰고 넘치면 표본 간격을 늘림.
+      - 슬롯 화면 기록 (framerecorder.h): "화면 기록"을 켠 슬롯만 1초마다 160x90 프레임을 슬롯별 고정 크기 링 버퍼에
+                직전 프레임과의 차이(건너뛰기/리터럴/채우기 RLE)로 쌓아 최근 5분을 남김. 링과 버퍼는 기록을 켤 때 할당
+                (캡처 DIB와 축소 중간 버퍼도 대상 창 모니터 크기로 미리 맞추고, 더 큰 창은 화면에서 바로 160x90으로 줄임).
+                "기록 저장"은 링을 파일 형식으로 복사만 하고 쓰기는 별도 스레드(RecordingWriter)가 함 (.mwvrec).
+      - 모니터별 DPI 대응: 콤보박스/미리보기 높이, 글꼴, 항목 높이, 알림 테두리를 창이 있는 모니터의 DPI로 배율 적용.
+                모니터 작업 영역과 DPI는 g_monitor에 캐시하고 WM_DPICHANGED/WM_DISPLAYCHANGE/작업 영역 변경/다른
+                모니터로 옮긴 뒤에만 다시 읽음. 슬롯 상한과 격자 영역은 캐시 기준 (시작 시 상한은 복원한 위치의 모니터 기준).
 */
 #ifndef UNICODE
 #define UNICODE
@@ -24,22 +97,89 @@
 #ifndef _UNICODE
 #define _UNICODE
 #endif
+#ifndef NOMINMAX
+#define NOMINMAX // windows.h의 min/max 매크로가 <vector> 등 표준 헤더와 충돌하지 않도록 함
+#endif
 
 #include <windows.h>
 #include <tchar.h>
 #include <commctrl.h>
 #include <dwmapi.h> // DWM Thumbnail API를 위해 필요
 #include <wchar.h>  // wcslen, wcscmp 등을 위해 필요
-#include <cmath>    // std::round를 사용하기 위해 추가 (C++11 표준)
+#include <limits.h> // INT_MAX (캡처 크기 상한 없음)
+#include <vector>   // std::vector (창 추적기 감시 목록 등)
+#include <string>   // std::wstring (창 제목 읽기 버퍼)
+#include <algorithm> // std::find (검색 결과에서 행 찾기)
+#include <unordered_set> // 응답 없는 창 집합
+#include <unordered_map> // 캡처 대상 창 응답 확인 상태
 #include <uxtheme.h> // SetWindowTheme 함수를 위해 필요
 #include "resource.h" // 리소스 파일(아이콘 등)을 위해 필요
+#include "windowtracker.h" // 이벤트 기반 창 추적기
+#include "windowregistry.h" // 창 목록 중앙 레지스트리
+#include "layout.h"         // 슬롯 배치 계산기
+#include "sizecache.h"      // 썸네일 원본 크기 캐시
+#include "framecommit.h"    // 프레임 단위 변경 적용 단계
+#include "refreshscheduler.h" // 적응형 갱신 스케줄러
+#include "slottable.h"      // 미리보기 슬롯 상태 저장소
+#include "perfcounters.h"   // 단계별 소요 시간/호출 횟수 계측
+#include "previewbackend.h" // 창 열거/썸네일 백엔드 인터페이스
+#include "viewermodel.h"    // 창 목록 갱신/슬롯 반영 (viewerbench와 공용)
+#include "searchindex.h"    // 드롭다운 검색 색인
+#include "windowfilter.h"   // 창 목록 포함/제외 규칙
+#include "sessionstore.h"   // 슬롯 연결 저장/복원
+#include "modelsnapshot.h"  // 작업 스레드 -> UI 스레드 창 목록 스냅숏 전달
+#include "hungwindows.h"    // 응답 없는 창 격리
+#include "downscale.h"      // 캡처 대체 경로의 축소 커널
+#include "framediff.h"      // 캡처 프레임 타일 변경 감지
+#include "activitymonitor.h" // 슬롯 활동 감시 알림
+#include "framerecorder.h"   // 슬롯 화면 기록
 
 //=============================================================================
 // 매크로 및 상수 정의
 //=============================================================================
-#define MAX_SEGMENTS 32              // 미리보기 창의 최대 개수
-#define IDC_COMBO1   101             // 첫 번째 콤보박스의 ID (이후 IDC_COMBO1 + 인덱스로 사용)
-#define ID_TIMER     1               // WM_TIMER 메시지 식별자
+#define IDC_COMBO1   101             // 첫 번째 콤보박스의 ID (이후 IDC_COMBO1 + 인덱스로 사용, 슬롯 이동 시 다시 매김)
+#define ID_TIMER     1               // WM_TIMER 메시지 식별자 (갱신 스케줄러용, 가장 이른 작업 시각에 맞춰 재설정)
+#define ID_PERF_OVERLAY_TIMER 2      // 성능 통계 창 갱신 타이머 (통계 창이 보일 때만)
+#define ID_PERF_DUMP_TIMER    3      // 성능 기록 저장 타이머 (기록이 켜져 있을 때만)
+#define PERF_OVERLAY_INTERVAL 1000   // 성능 통계 창 갱신 주기(ms)
+#define PERF_DUMP_INTERVAL    60000  // 성능 기록 저장 주기(ms)
+#define ID_SAVE_TIMER         4      // 설정/세션 저장 타이머 (저장할 변경이 있을 때만)
+#define SAVE_QUIET_DELAY      2000   // 마지막 변경 후 이만큼 조용하면 저장(ms)
+#define SAVE_MAX_DELAY        15000  // 변경이 계속되어도 첫 변경 후 이 시간 안에는 저장(ms)
+#define ID_CAPTURE_TIMER      5      // 캡처 대체 경로 갱신 타이머 (캡처로 그리는 썸네일이 있을 때만)
+#define CAPTURE_INTERVAL      500    // 캡처 대체 경로 갱신 주기(ms)
+#define ID_ACTIVITY_TIMER     6      // 활동 감시 타이머 (감시 슬롯이나 깜빡이는 알림이 있을 때만, 다음 할 일 시각에 맞춰 재설정)
+#define ID_RECORD_TIMER       7      // 화면 기록 타이머 (기록 중인 슬롯이 있을 때만)
+#define ALERT_BORDER          3      // 알림 테두리 두께(px, BASE_DPI 기준)
+#define ALERT_FLASH_MILLIS    3000   // 알림이 켜진 뒤 테두리가 깜빡이는 시간(ms), 이후에는 계속 켜져 있음
+#define ALERT_FLASH_INTERVAL  500    // 깜빡임 주기의 절반(ms)
+#define RECORD_WRITE_CHUNK    (256 * 1024) // 기록 파일을 한 번에 쓰는 크기
+#ifndef PW_RENDERFULLCONTENT
+#define PW_RENDERFULLCONTENT  0x00000002 // Windows 8.1 이상: DirectComposition으로 그리는 창 내용도 PrintWindow로 캡처
+#endif
+// 갱신 작업별 간격(ms): 조작 직후 / 기본 / 변경 없을 때 최대
+#define LIST_SWEEP_MIN   2000        // 창 목록 안전 점검: WinEvent 누락에 대비한 전체 재열거
+#define LIST_SWEEP_BASE  5000
+#define LIST_SWEEP_MAX   120000
+#define TITLE_CHECK_MIN  1000        // 미리보기 중인 창 제목 재확인
+#define TITLE_CHECK_BASE 3000
+#define TITLE_CHECK_MAX  60000
+#define WM_APP_SNAPSHOT (WM_APP + 1) // 작업 스레드가 창 목록 변경분 스냅숏을 게시했음을 알리는 메시지
+#define WM_APP_COLLAPSEPICKER (WM_APP + 2) // 드롭다운이 닫힌 뒤 콤보박스 항목을 선택 항목 하나로 축소 (wParam: 슬롯 인덱스)
+#define WM_APP_STARTUP (WM_APP + 3)  // 첫 그리기 후 작업 스레드 시작/스케줄러 시작 (WM_CREATE에서 한 번 게시)
+#define WM_APP_RECORDING_SAVED (WM_APP + 4) // 기록 파일 쓰기 스레드가 끝남 (wParam: 성공 여부)
+// 작업 스레드(EnumerationWorker)에 보내는 스레드 메시지
+#define WM_WORKER_EVENTS (WM_APP + 10) // 창 추적기에 처리할 변경 사항이 쌓임 (작업 스레드가 자신에게 게시)
+#define WM_WORKER_SWEEP  (WM_APP + 11) // 창 목록 안전 점검 (전체 재열거)
+#define WM_WORKER_TITLES (WM_APP + 12) // 미리보기 중인 창의 제목 재확인
+#define WM_WORKER_WATCH  (WM_APP + 13) // 감시 대상 창 목록 변경 (lParam: new로 만든 std::vector<WindowId>*, 받는 쪽이 해제)
+#define WM_WORKER_FILTER (WM_APP + 14) // 필터 규칙 다시 읽기
+#define WORKER_STOP_TIMEOUT 5000     // 종료 시 작업 스레드가 끝나기를 기다리는 최대 시간(ms)
+#define TITLE_QUERY_TIMEOUT 200      // 제목 길이 질의(WM_GETTEXTLENGTH) 응답을 기다리는 최대 시간(ms)
+#define HUNG_PROBE_MIN   2000        // 응답 없는 창을 처음 다시 확인하기까지의 시간(ms), 이후 실패할 때마다 2배
+#define HUNG_PROBE_MAX   60000
+#define HUNG_BADGE_TEXT  L"[응답 없음]" // 드롭다운 항목에서 응답 없는 창 제목 앞에 붙이는 표시
+#define HUNG_BADGE_COLOR RGB(200, 60, 40)
 #define NUM_SEGMENTS_DEFAULT 3       // 애플리케이션 시작 시 기본 미리보기 창 개수
 
 // 미리보기 창의 기본 가로세로 비율 설정
@@ -52,15 +192,25 @@
 // #define PREVIEW_ASPECT_RATIO_NUMERATOR 16
 // #define PREVIEW_ASPECT_RATIO_DENOMINATOR 9
 
+// WM_DPICHANGED 정의 (Windows 8.1 이전 SDK 헤더에 없을 경우)
+#ifndef WM_DPICHANGED
+#define WM_DPICHANGED 0x02E0
+#endif
+#define BASE_DPI 96 // 아래 픽셀 상수의 기준 DPI (100%)
+
 // DWMWA_USE_IMMERSIVE_DARK_MODE 정의 (dwmapi.h에 없을 경우)
 #ifndef DWMWA_USE_IMMERSIVE_DARK_MODE
 #define DWMWA_USE_IMMERSIVE_DARK_MODE 20
 #endif
 
-// 클라이언트 영역 레이아웃 상수
+// 클라이언트 영역 레이아웃 상수 (BASE_DPI 기준 픽셀, 쓸 때 ScaleDpi로 메인 윈도우가 있는 모니터의 DPI에 맞춤)
 const int DROP_HEIGHT = 25;               // 드롭다운(콤보박스) 영역 높이
 const int PREVIEW_HEIGHT = 300;           // 미리보기 영역 높이 (썸네일이 이 높이에 맞춰 스케일됨)
 const int TOTAL_HEIGHT = DROP_HEIGHT + PREVIEW_HEIGHT; // 전체 클라이언트 영역 높이
+const int PICKER_ITEM_HEIGHT = 20;        // 오너 드로우 콤보박스 항목 높이 (18px 폰트 기준)
+const int UI_FONT_HEIGHT = 18;            // 콤보박스 글꼴 높이
+const int PERF_FONT_HEIGHT = 14;          // 성능 통계 창 글꼴 높이
+const int MIN_GRID_PREVIEW_HEIGHT = 60;   // 격자 배치에서 슬롯 개수 상한을 정할 때 쓰는 최소 썸네일 높이
 
 // 컨텍스트 메뉴 항목 ID
 #define IDM_ALWAYS_ON_TOP    40001 // "항상 위에" 메뉴 항목
@@ -69,47 +219,127 @@ const int TOTAL_HEIGHT = DROP_HEIGHT + PREVIEW_HEIGHT; // 전체 클라이언트
 #define IDM_EXIT             40004 // "종료" 메뉴 항목
 #define IDM_ADD_PREVIEW      40005 // "창+1" (미리보기 창 추가) 메뉴 항목
 #define IDM_REMOVE_PREVIEW   40006 // "창-1" (미리보기 창 제거) 메뉴 항목
+#define IDM_GRID_LAYOUT      40007 // "격자 배치" 메뉴 항목
+#define IDM_MOVE_LEFT        40008 // "왼쪽으로 이동" (슬롯 순서 변경) 메뉴 항목
+#define IDM_MOVE_RIGHT       40009 // "오른쪽으로 이동" (슬롯 순서 변경) 메뉴 항목
+#define IDM_PERF_OVERLAY     40010 // "성능 통계 표시" 메뉴 항목
+#define IDM_PERF_DUMP        40011 // "성능 기록 저장" 메뉴 항목
+#define IDM_RELOAD_FILTER    40012 // "창 필터 다시 읽기" 메뉴 항목
+#define IDM_WATCH_CHANGE     40013 // "바뀌면 알림" (우클릭한 슬롯 활동 감시) 메뉴 항목
+#define IDM_WATCH_IDLE       40014 // "멈추면 알림" (우클릭한 슬롯 활동 감시) 메뉴 항목
+#define IDM_ACKNOWLEDGE      40015 // "알림 끄기" 메뉴 항목
+#define IDM_RECORD           40016 // "화면 기록" (우클릭한 슬롯) 메뉴 항목
+#define IDM_SAVE_RECORDING   40017 // "기록 저장" (우클릭한 슬롯) 메뉴 항목
 
 //=============================================================================
 // 전역 변수
 //=============================================================================
-int g_numSegments = NUM_SEGMENTS_DEFAULT;    // 현재 표시되는 미리보기 창 개수
-int g_maxSegments = 0;                         // 화면 너비에 따라 계산된 최대 미리보기 창 개수
 int g_windowWidth = 0;                         // 메인 윈도우의 클라이언트 영역 전체 가로폭
-const int g_windowHeight = TOTAL_HEIGHT;       // 메인 윈도우의 클라이언트 영역 전체 세로폭
+int g_windowHeight = TOTAL_HEIGHT;             // 메인 윈도우의 클라이언트 영역 전체 세로폭 (격자 배치에서는 줄 수에 따라 변함)
 
-HWND g_ComboBoxes[MAX_SEGMENTS] = { NULL };    // 각 미리보기 창에 연결된 콤보박스 핸들 배열
-HWND g_Selected[MAX_SEGMENTS]   = { NULL };    // 각 콤bo박스에서 현재 선택된 대상 창의 핸들
-HTHUMBNAIL g_Thumbnails[MAX_SEGMENTS] = { NULL }; // 각 콤보박스에 선택된 창의 DWM 썸네일 핸들
-// 플리커링 방지를 위해 마지막으로 업데이트된 썸네일의 목적지 사각형을 저장
-RECT g_lastDestRects[MAX_SEGMENTS] = {}; // 모든 멤버를 0으로 초기화 (C++11 이상)
+// 메인 윈도우가 있는 모니터의 정보. 배치/슬롯 상한/글꼴이 매번 모니터를 질의하지 않도록 캐시하고
+// WM_DPICHANGED, WM_DISPLAYCHANGE, 작업 영역 변경, 다른 모니터로 옮긴 뒤(WM_EXITSIZEMOVE)에만 다시 읽음
+struct MonitorMetrics
+{
+    HMONITOR monitor;
+    RECT work; // 작업 영역 (작업 표시줄 제외, 가상 화면 좌표)
+    UINT dpi;  // BASE_DPI = 100%
+};
+MonitorMetrics g_monitor = { NULL, { 0, 0, 0, 0 }, BASE_DPI };
+
+// 슬롯마다 배치/갱신 루프에서 매번 읽는 필드는 PreviewSlot (viewermodel.h: 선택된 창, 썸네일, 제목 버전)
+// 슬롯마다 콤보박스 생성/그리기 때만 쓰는 필드
+struct SlotCold
+{
+    HWND combo;            // 슬롯에 연결된 콤보박스 핸들
+    SlotBinding binding;   // 선택한 창의 식별 정보 (세션 저장용, 선택한 창이 사라져도 다음 실행에서 복원하도록 유지)
+};
+// 미리보기 슬롯 상태 (개수 = 현재 표시되는 미리보기 창 개수)
+SlotTable<PreviewSlot, SlotCold> g_slots;
 
 bool g_alwaysOnTop = 0; // 메인 윈도우가 항상 최상단에 있을지 여부 (false=0, true=1)
 bool g_runAtStartup = false; // 애플리케이션이 부팅 시 자동 실행될지 여부
+bool g_gridLayout = false; // 격자 배치 여부 (false면 가로 한 줄 배치)
 HINSTANCE g_hInst = NULL; // 애플리케이션 인스턴스 핸들
 
 // 초기화(Reset) 요청 플래그: "초기화 후 종료" 명령 실행 시 true로 설정되어 종료 시 레지스트리 저장 방지
 bool g_resetRequested = false;
-// 드롭다운 팝업 활성 상태 플래그: 드롭다운이 열려 있을 때는 타이머 업데이트를 일시 중지
+// 드롭다운 팝업 활성 상태 플래그: 드롭다운이 열려 있을 때는 목록/배치 갱신을 일시 중지
 bool g_dropdownActive = false;
 // 마지막으로 우클릭된 미리보기 슬롯의 인덱스. -1은 빈 공간을 의미
 int g_rightClickedSegmentIndex = -1; 
-
-// 윈도우 목록에서 제외할 창 제목의 부분 문자열 목록
-const TCHAR* g_excludedSubstrings[] = { _T("설정"), _T("Windows 입력"), _T("팝업 호스트"), _T("GeForce Overlay"), _T("위젯"), _T("작업 전환") };
-const size_t g_excludedCount = sizeof(g_excludedSubstrings) / sizeof(g_excludedSubstrings[0]);
-// GW_OWNER를 가진 창(주로 부모 창에 종속된 팝업 창 등)을 제외할지 여부
-const bool g_excludeOwnerWindows = false;
-
-// UI 폰트 핸들
-HFONT g_hFont = CreateFont(18, 0, 0, 0,
-                     FW_NORMAL, FALSE, FALSE, FALSE,
-                     DEFAULT_CHARSET,
-                     OUT_DEFAULT_PRECIS,
-                     CLIP_DEFAULT_PRECIS,
-                     CLEARTYPE_QUALITY,  // 부드러운 텍스트 렌더링
-                     DEFAULT_PITCH | FF_DONTCARE,
-                     L"맑은 고딕");
+// 드롭다운이 열려 있는 슬롯의 인덱스. -1은 열린 드롭다운 없음
+int g_openPicker = -1;
+// 드롭다운 검색: 창 목록 색인, 열린 드롭다운에 입력된 검색어, 검색 중일 때 목록에 표시된 창 (목록 순서)
+SearchIndex g_search;
+std::wstring g_pickerQuery;
+std::vector<WindowId> g_pickerRows;
+
+// 창 목록 포함/제외 규칙 (레지스트리 FilterRules 값, 없으면 기본 규칙: AddDefaultFilterRules). 작업 스레드 시작 후에는 작업 스레드 전용
+WindowFilter g_filter;
+
+// 슬롯 연결 복원: 시작 시 첫 열거에서 저장된 식별 정보와 창을 대조
+SessionMatcher g_sessionMatcher;
+// 설정/세션 저장 시각 (변경이 잠잠해진 뒤 모아서 저장)
+SaveDebouncer g_pendingSave(SAVE_QUIET_DELAY, SAVE_MAX_DELAY);
+std::vector<uint8_t> g_sessionSaved; // 마지막으로 읽거나 쓴 세션 파일 내용 (같으면 다시 쓰지 않음)
+std::wstring g_patternBuffer;        // 제목 패턴 계산용 재사용 버퍼
+
+// 메인 윈도우 핸들 (작업 스레드 시작 후 설정, 저장 예약 대상)
+HWND g_hMainWnd = NULL;
+
+// 창 추적기: WinEvent를 모아 두었다가 WM_WORKER_EVENTS 한 번으로 작업 스레드를 깨움 (작업 스레드 전용)
+void WakeWorker(void* context);
+WindowTracker g_tracker(WakeWorker, NULL);
+// 원본 창 목록 레지스트리: 작업 스레드가 열거/제목 읽기로 갱신하고 변경분을 스냅숏으로 게시 (작업 스레드 전용)
+WindowRegistry g_model;
+// 제목 질의가 시간 초과된 창: 다시 확인할 때까지 질의하지 않고 마지막 제목 유지 (작업 스레드 전용)
+HungWindowList g_hung(HUNG_PROBE_MIN, HUNG_PROBE_MAX);
+// UI 쪽에서 응답 없음 표시를 붙일 창 (스냅숏으로 전달받음, UI 스레드 전용)
+std::unordered_set<WindowId> g_hungWindows;
+// 작업 스레드 -> UI 스레드 스냅숏 전달
+SnapshotExchange g_snapshots;
+// 드롭다운이 열려 있는 동안 받은 스냅숏 중 아직 적용하지 않은 목록 변경 (닫힐 때 적용, UI 스레드 전용)
+WindowSnapshot* g_deferredSnapshot = NULL;
+// UI 쪽 창 목록 레지스트리 (원본의 사본): 모든 콤보박스의 항목은 이 목록과 같은 순서를 유지
+WindowRegistry g_registry;
+// 슬롯 배치 계산기: 콤보박스/썸네일 사각형과 클릭 위치 판별을 담당
+LayoutEngine g_layout;
+// 슬롯별 썸네일 원본 크기 캐시: 크기 변경 이벤트가 없으면 DWM에 다시 질의하지 않음
+SourceSizeCache g_sizeCache;
+// 슬롯 활동 감시 (슬롯 저장소와 같은 순서, 사용자가 켠 슬롯만 표본을 뜸)
+ActivityMonitor g_activity;
+bool g_activityTimer = false; // ID_ACTIVITY_TIMER가 설정되어 있는지
+// 슬롯 화면 기록 (슬롯 저장소와 같은 순서, 사용자가 켠 슬롯만 링 버퍼를 가짐)
+FrameRecorder g_recorder;
+bool g_recordTimer = false;   // ID_RECORD_TIMER가 설정되어 있는지
+int g_recordCaptureCx = 0;    // 화면 기록이 원본 크기로 캡처할 상한 (기록을 켤 때 캡처 DIB/축소 버퍼를 이만큼 할당)
+int g_recordCaptureCy = 0;
+// 마지막으로 적용한 썸네일 목적지/콤보박스 위치: 바뀐 것만 한 번에 적용하여 플리커링 방지
+FrameCommitter g_frame;
+// 주기 점검 작업의 실행 시각 결정 및 깨어남 횟수 집계
+RefreshScheduler g_scheduler;
+// 전원 상태에 따른 스케줄러 제한 조건 (WM_POWERBROADCAST에서 갱신)
+unsigned g_powerThrottle = THROTTLE_NONE;
+// 단계별 소요 시간/호출 횟수 계측 (항상 기록하며 표시/저장만 메뉴로 켬)
+PerfCounters g_perf;
+HWND g_hPerfOverlay = NULL;  // 성능 통계 창 (NULL이면 표시 안 함)
+HFONT g_hPerfFont = NULL;    // 성능 통계 창 고정폭 글꼴
+bool g_perfDump = false;     // 성능 기록을 주기적으로 파일에 저장할지 여부
+std::wstring g_perfText;     // 성능 통계 창에 그릴 문자열
+
+// UI 폰트 핸들 (GetUiFont가 처음 필요할 때 생성. 정적 초기화 중에는 GDI를 호출하지 않음)
+HFONT g_hFont = NULL;
+UINT g_fontDpi = 0; // g_hFont를 만들 때의 DPI
+
+// 시작 시간 측정 (PerfClockMicros 기준 시각, 0이면 아직 일어나지 않음)
+// /startuptime 옵션이면 시작 처리가 끝난 뒤 startup.log에 기록하고 종료
+bool g_startupTiming = false;
+uint64_t g_launchTime = 0;          // wWinMain 진입
+uint64_t g_launchDelay = 0;         // 프로세스 생성부터 wWinMain 진입까지 (정적 초기화/로더, 마이크로초, 시스템 시계 정밀도)
+uint64_t g_firstPaintTime = 0;      // 첫 WM_PAINT 완료
+uint64_t g_populatedTime = 0;       // 창 목록 열거/슬롯 복원 완료
+uint64_t g_firstThumbnailTime = 0;  // 첫 썸네일 표시
 
 //=============================================================================
 // 함수 프로토타입
@@ -119,13 +349,71 @@ void LoadSettings(HWND hWnd);           // 저장된 설정(위치, 항상 위
 void SetRunAtStartup(bool enable);      // 부팅시 자동 실행 설정/해제
 void LoadRunAtStartup();                // 부팅시 자동 실행 설정 로드
 void LoadStartupSettings();             // 미리보기 창 개수 설정을 레지스트리에서 로드
+void LoadFilterRules();                 // 창 목록 필터 규칙을 레지스트리에서 읽어 컴파일
 void ResetRegistrySettings();           // 애플리케이션 관련 레지스트리 설정 초기화
+bool GetDataFilePath(const wchar_t* name, wchar_t* path); // %LOCALAPPDATA%\MultiWindowViewer 아래 파일 경로
+void LoadSession();                     // 세션 파일에서 슬롯 개수와 슬롯별 창 식별 정보 로드
+void SaveSession();                     // 슬롯별 창 식별 정보를 세션 파일에 저장 (임시 파일에 쓴 뒤 교체)
+void RestoreSlotBindings(const WindowDiff& initial); // 첫 열거 결과와 저장된 식별 정보를 대조하여 슬롯에 창 배정
+void UpdateSlotBinding(int slot);       // 슬롯에 선택된 창의 식별 정보 기록
+void ScheduleSave(HWND hWnd);           // 설정/세션 저장 예약 (변경이 잠잠해진 뒤 한 번)
 void RecreatePreviews(HWND hWnd);       // 미리보기 콤보박스 컨트롤들을 재생성 및 상태 복원
-void UpdateComboBoxItem(HWND hCombo);   // 특정 콤보박스의 항목(윈도우 타이틀)들을 주기적으로 업데이트
+void CreatePicker(HWND hWnd, int slot); // 슬롯 하나의 콤보박스 생성
+void DestroyPicker(int slot);           // 슬롯 하나의 콤보박스 파괴
+void RenumberPickers(int first);        // first 이후 슬롯들의 콤보박스 ID를 인덱스에 맞게 다시 매김
+void InsertSlot(HWND hWnd, int index);  // index 위치에 빈 슬롯 추가
+void RemoveSlot(HWND hWnd, int index);  // index 위치의 슬롯 제거
+void MoveSlot(HWND hWnd, int from, int to); // 슬롯 순서 변경
+int MaxSlotCount();                     // 화면에 담을 수 있는 최대 슬롯 개수
+void ApplyWindowDiff(const WindowDiff& diff); // 레지스트리 변경분을 닫힌 콤보박스들에 반영
+void CollapsePicker(int slot);          // 콤보박스 항목을 선택된 창 하나로 축소
+void ExpandPicker(int slot);            // 드롭다운을 열 때 레지스트리 전체 목록으로 채움
+void DrawPickerItem(const DRAWITEMSTRUCT* dis); // 오너 드로우 콤보박스 항목 그리기
+void RepaintOpenPickerRows(const WindowDiff& diff); // 열린 드롭다운에서 제목이 바뀐 행만 다시 그림
+bool ReadWindowTitle(HWND hwnd, std::wstring& buffer); // 창 제목을 길이 제한 없이 읽음 (응답 없는 창이면 false)
+void ApplyHungStates(const WindowSnapshot& snapshot); // 격리 상태 변경을 UI 쪽 집합에 반영하고 해당 표시를 다시 그림
+void ReadWindowOrigin(HWND hwnd, std::wstring& process, std::wstring& className); // 창의 프로세스 이름과 클래스 이름
+void ReadWindowClass(HWND hwnd, std::wstring& className); // 창의 클래스 이름
+void ReadWindowProcess(HWND hwnd, std::wstring& process); // 창의 프로세스 실행 파일 이름 (경로 제외)
+HFONT GetUiFont();                      // UI 폰트 (처음 호출 시 생성)
+HFONT CreatePerfFont();                 // 성능 통계 창 고정폭 글꼴 (현재 DPI 크기)
+bool RefreshMonitorMetrics(HWND hWnd, UINT dpi); // 모니터 정보 캐시를 다시 읽음 (dpi가 0이면 질의). 바뀌었으면 true
+int ScaleDpi(int px);                   // BASE_DPI 기준 픽셀을 현재 모니터 DPI로 변환
+void ApplyMonitorMetrics(HWND hWnd);    // 바뀐 모니터 정보를 배치/글꼴/콤보박스 항목 높이/격자 영역에 반영
+void CompleteStartup(HWND hWnd);        // 첫 그리기 후 작업 스레드(열거/훅)와 스케줄러 시작
+void NoteStartupMilestone(HWND hWnd);   // 시작 시간 측정: 모든 단계가 끝났으면 기록 후 종료
+void FillPicker(int slot);              // 열린 드롭다운 목록을 검색어에 맞춰 채움 (검색어가 없으면 전체)
 extern "C" LRESULT CALLBACK ComboSubclassProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData); // 콤보박스 서브클래스 프로시저
 extern "C" LRESULT CALLBACK ListSubclassProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData);   // 콤보박스 드롭다운 리스트박스 서브클래스 프로시저
-BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam); // EnumWindows에 사용될 콜백 함수: 실행 중인 창 목록을 콤보박스에 추가
 int GetSegmentIndexAtPoint(POINT pt);   // 주어진 클라이언트 좌표에 해당하는 미리보기 슬롯 인덱스 반환
+void UpdatePreviewLayout(HWND hWnd);    // DWM 썸네일 등록/목적지 갱신 및 콤보박스/메인 윈도우 크기 조정
+void UpdateGridArea(HWND hWnd);         // 격자 배치 목표 영역을 메인 윈도우가 있는 모니터의 작업 영역으로 설정
+void ArmCaptureTimer(HWND hWnd);        // 캡처 대체 경로로 그리는 썸네일이 있으면 갱신 타이머 설정/해제
+void RunActivityMonitor(HWND hWnd);     // 표본 시각이 된 감시 슬롯의 표본을 뜨고 알림 상태 갱신
+void ArmActivityTimer(HWND hWnd);       // 활동 감시의 다음 할 일 시각에 맞춰 타이머 재설정 (할 일이 없으면 해제)
+void SetSlotWatch(HWND hWnd, int slot, ActivityWatch watch); // 슬롯 활동 감시 방식 변경 (대상 창이 바뀔 때 기준 재설정)
+void AcknowledgeAlert(HWND hWnd, int slot); // 슬롯 알림 끄기
+void InvalidateAlertBorder(HWND hWnd, int slot); // 슬롯 알림 테두리 영역 무효화
+void RunRecorder(HWND hWnd);            // 프레임 시각이 된 기록 슬롯의 화면을 링 버퍼에 추가
+void ArmRecordTimer(HWND hWnd);         // 화면 기록의 다음 프레임 시각에 맞춰 타이머 재설정 (기록 중인 슬롯이 없으면 해제)
+void SetSlotRecording(HWND hWnd, int slot, bool on); // 슬롯 화면 기록 켜기/끄기 (켤 때마다 빈 기록으로 시작)
+void SaveRecording(HWND hWnd, int slot); // 슬롯 기록을 파일로 저장 (쓰기는 별도 스레드)
+void PaintAlertBorders(HDC hdc, const RECT& area); // 알림이 켜진 슬롯의 테두리 그리기
+void ProcessSnapshot(HWND hWnd);        // 작업 스레드가 게시한 스냅숏을 UI 쪽 레지스트리/콤보박스/배치에 반영
+void NoteWorkerSnapshot(const WindowSnapshot& snapshot); // 작업 스레드 계측과 주기 점검 결과를 기록
+unsigned QueryPowerThrottle();          // 배터리/절전 모드 여부를 스케줄러 제한 조건으로 변환
+bool IsMainWindowOccluded(HWND hWnd);   // 메인 윈도우가 완전히 가려졌거나 다른 가상 데스크톱에 있는지
+void UpdateThrottle(HWND hWnd);         // 최소화/가려짐/전원 상태를 스케줄러에 반영
+void ArmRefreshTimer(HWND hWnd);        // 가장 이른 갱신 작업 시각에 맞춰 타이머 재설정
+void NoteUserInteraction(HWND hWnd);    // 사용자 조작 직후 갱신 간격을 잠시 줄임
+void RunRefreshTasks(HWND hWnd);        // 실행 시각이 된 갱신 작업 실행
+uint64_t PerfClockMicros();             // 계측용 마이크로초 시계 (QueryPerformanceCounter)
+void FormatPerfStats(std::string& text); // 계측 요약 + 깨어남 횟수 문자열
+void FormatStartupTiming(std::string& text); // 시작 시간 요약 한 줄
+void ShowPerfOverlay(HWND hWnd, bool show); // 성능 통계 창 표시/숨김
+void UpdatePerfOverlay(HWND hWnd);      // 성능 통계 창 내용 및 위치 갱신
+void AppendPerfDump();                  // 성능 기록 파일에 현재 요약 추가
+LRESULT CALLBACK PerfOverlayProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam); // 성능 통계 창 프로시저
 void ShowContextMenu(HWND hWnd);        // 메인 윈도우 우클릭 시 컨텍스트 메뉴 표시
 LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam); // 메인 윈도우 프로시저
 
@@ -167,12 +455,85 @@ void LoadStartupSettings()
         // "PreviewCount" 값을 읽어옴
         if (RegQueryValueEx(hKey, L"PreviewCount", NULL, &dwType, (LPBYTE)&dwPreview, &dwSize) == ERROR_SUCCESS)
         {
-            // 읽어온 값이 유효한 범위 내에 있으면 g_numSegments에 적용
-            if (dwPreview > 0 && dwPreview <= MAX_SEGMENTS)
-                g_numSegments = (int)dwPreview;
+            // 읽어온 값이 유효하면 슬롯 개수에 적용 (화면에 담을 수 있는 개수 제한은 wWinMain에서 적용)
+            if (dwPreview > 0 && dwPreview <= 0xFFFF)
+                g_slots.Resize((int)dwPreview);
+        }
+        // "GridLayout" 값을 읽어옴 (미리보기 개수 제한이 배치 방식에 따라 다르므로 함께 로드)
+        DWORD dwGrid = 0;
+        dwSize = sizeof(dwGrid);
+        if (RegQueryValueEx(hKey, L"GridLayout", NULL, &dwType, (LPBYTE)&dwGrid, &dwSize) == ERROR_SUCCESS)
+            g_gridLayout = dwGrid != 0;
+        // "PerfDump" 값을 읽어옴 (성능 기록 저장 여부)
+        DWORD dwDump = 0;
+        dwSize = sizeof(dwDump);
+        if (RegQueryValueEx(hKey, L"PerfDump", NULL, &dwType, (LPBYTE)&dwDump, &dwSize) == ERROR_SUCCESS)
+            g_perfDump = dwDump != 0;
+        // 활동 감시 설정 (사용자가 직접 편집하는 값이므로 저장하지 않음, 없으면 기본값)
+        ActivityConfig activity = ActivityMonitor::DefaultConfig();
+        DWORD dwValue = 0;
+        dwSize = sizeof(dwValue);
+        if (RegQueryValueEx(hKey, L"ActivitySampleMillis", NULL, &dwType, (LPBYTE)&dwValue, &dwSize) == ERROR_SUCCESS)
+            activity.sampleMillis = dwValue;
+        dwSize = sizeof(dwValue);
+        if (RegQueryValueEx(hKey, L"ActivityIdleSeconds", NULL, &dwType, (LPBYTE)&dwValue, &dwSize) == ERROR_SUCCESS &&
+            dwValue > 0 && dwValue <= 86400)
+            activity.idleMillis = dwValue * 1000;
+        dwSize = sizeof(dwValue);
+        if (RegQueryValueEx(hKey, L"ActivityThreshold", NULL, &dwType, (LPBYTE)&dwValue, &dwSize) == ERROR_SUCCESS)
+            activity.threshold = dwValue;
+        dwSize = sizeof(dwValue);
+        if (RegQueryValueEx(hKey, L"ActivityBudgetPermille", NULL, &dwType, (LPBYTE)&dwValue, &dwSize) == ERROR_SUCCESS &&
+            dwValue <= 1000)
+            activity.budgetPermille = dwValue;
+        g_activity.SetConfig(activity);
+        // 화면 기록 설정 (저장하지 않음)
+        RecordConfig record = FrameRecorder::DefaultConfig();
+        dwSize = sizeof(dwValue);
+        if (RegQueryValueEx(hKey, L"RecordIntervalMillis", NULL, &dwType, (LPBYTE)&dwValue, &dwSize) == ERROR_SUCCESS)
+            record.intervalMillis = dwValue;
+        dwSize = sizeof(dwValue);
+        if (RegQueryValueEx(hKey, L"RecordMinutes", NULL, &dwType, (LPBYTE)&dwValue, &dwSize) == ERROR_SUCCESS &&
+            dwValue > 0 && dwValue <= 24 * 60)
+            record.keepMillis = dwValue * 60 * 1000;
+        dwSize = sizeof(dwValue);
+        if (RegQueryValueEx(hKey, L"RecordKilobytes", NULL, &dwType, (LPBYTE)&dwValue, &dwSize) == ERROR_SUCCESS &&
+            dwValue > 0 && dwValue <= 512 * 1024)
+            record.ringBytes = dwValue * 1024;
+        g_recorder.SetConfig(record);
+        RegCloseKey(hKey);
+    }
+}
+
+// 창 목록 필터 규칙을 레지스트리에서 읽어 컴파일 (값이 없으면 기본 규칙). 사용자가 직접 편집하는 값이므로 저장하지 않음
+void LoadFilterRules()
+{
+    g_filter.ClearRules();
+    bool loaded = false;
+    HKEY hKey;
+    if (RegOpenKeyEx(HKEY_CURRENT_USER, L"Software\\MultiWindowViewer", 0, KEY_QUERY_VALUE | KEY_WOW64_64KEY, &hKey) == ERROR_SUCCESS)
+    {
+        DWORD dwType = 0;
+        DWORD dwSize = 0;
+        if (RegQueryValueEx(hKey, L"FilterRules", NULL, &dwType, NULL, &dwSize) == ERROR_SUCCESS &&
+            dwType == REG_MULTI_SZ && dwSize >= sizeof(WCHAR))
+        {
+            // REG_MULTI_SZ: NUL로 구분된 문자열들 + 마지막 NUL. 끝 NUL이 빠진 값도 읽을 수 있도록 여유를 둠
+            std::vector<WCHAR> buffer(dwSize / sizeof(WCHAR) + 2, 0);
+            if (RegQueryValueEx(hKey, L"FilterRules", NULL, &dwType, (LPBYTE)&buffer[0], &dwSize) == ERROR_SUCCESS)
+            {
+                loaded = true;
+                for (const WCHAR* rule = &buffer[0]; *rule; rule += wcslen(rule) + 1)
+                    g_filter.AddRule(rule, wcslen(rule)); // 형식이 잘못된 줄은 무시
+            }
         }
         RegCloseKey(hKey);
     }
+    if (!loaded)
+    {
+        AddDefaultFilterRules(g_filter); // 목록에 보일 필요가 없는 시스템 UI 창 제목 (viewermodel.h)
+    }
+    g_filter.Compile();
 }
 
 // 현재 설정(창 위치, 항상 위에, 미리보기 개수)을 레지스트리에 저장
@@ -195,8 +556,14 @@ void SaveSettings(HWND hWnd)
         DWORD dwAlways = (DWORD)g_alwaysOnTop;
         RegSetValueEx(hKey, L"AlwaysOnTop", 0, REG_DWORD, (const BYTE*)&dwAlways, sizeof(dwAlways));
         // 현재 미리보기 창 개수 저장
-        DWORD dwPreview = (DWORD)g_numSegments;
+        DWORD dwPreview = (DWORD)g_slots.Count();
         RegSetValueEx(hKey, L"PreviewCount", 0, REG_DWORD, (const BYTE*)&dwPreview, sizeof(dwPreview));
+        // 격자 배치 여부 저장
+        DWORD dwGrid = (DWORD)g_gridLayout;
+        RegSetValueEx(hKey, L"GridLayout", 0, REG_DWORD, (const BYTE*)&dwGrid, sizeof(dwGrid));
+        // 성능 기록 저장 여부 저장
+        DWORD dwDump = (DWORD)g_perfDump;
+        RegSetValueEx(hKey, L"PerfDump", 0, REG_DWORD, (const BYTE*)&dwDump, sizeof(dwDump));
         RegCloseKey(hKey);
     }
 }
@@ -265,164 +632,1578 @@ void ResetRegistrySettings()
 }
 
 //=============================================================================
-// UpdateComboBoxItem: 각 콤보박스의 항목(윈도우 타이틀)을 업데이트
-// - 대상 윈도우가 유효한지 확인하고, 타이틀이 변경되었으면 업데이트
-// - 사라진 윈도우는 목록에서 제거
+// DwmPreviewBackend: DWM 썸네일과 EnumWindows 기반 미리보기 백엔드 (previewbackend.h)
+// - 썸네일은 DWM이 합성하므로 내용이 바뀌어도 다시 그릴 것이 없음 (Commit은 할 일 없음)
+// - 핸들은 HTHUMBNAIL을 그대로 씀. 호스트(메인 윈도우)는 WM_CREATE에서 설정
 //=============================================================================
-void UpdateComboBoxItem(HWND hCombo)
-{
-    int count = (int)SendMessage(hCombo, CB_GETCOUNT, 0, 0);
-    for (int index = 0; index < count; index++) {
-        HWND hwnd = (HWND)SendMessage(hCombo, CB_GETITEMDATA, index, 0);
-        if (hwnd && IsWindow(hwnd)) { // 윈도우 핸들이 유효하고 윈도우가 존재하는지 확인
-            wchar_t newTitle[256] = {0}, currTitle[256] = {0};
-            GetWindowText(hwnd, newTitle, 256); // 현재 윈도우의 타이틀 가져오기
-            SendMessage(hCombo, CB_GETLBTEXT, index, (LPARAM)currTitle); // 콤보박스에 저장된 타이틀 가져오기
-
-            // 새 타이틀이 비어있지 않고, 기존 타이틀과 다르면 업데이트
-            if (wcslen(newTitle) > 0 && wcscmp(newTitle, currTitle) != 0) {
-                int sel = (int)SendMessage(hCombo, CB_GETCURSEL, 0, 0); // 현재 선택된 인덱스 저장
-                SendMessage(hCombo, CB_DELETESTRING, index, 0); // 기존 항목 삭제
-                int newIndex = (int)SendMessage(hCombo, CB_INSERTSTRING, index, (LPARAM)newTitle); // 새 타이틀로 항목 추가
-                SendMessage(hCombo, CB_SETITEMDATA, newIndex, (LPARAM)hwnd); // 윈도우 핸들 다시 저장
-                if (sel == index) { // 이전에 선택된 항목이었다면 다시 선택 상태로 만듦
-                    SendMessage(hCombo, CB_SETCURSEL, newIndex, 0);
-                }
-            }
-        } else {
-            // 윈도우가 유효하지 않으면 (닫혔거나 등) 목록에서 삭제
-            SendMessage(hCombo, CB_DELETESTRING, index, 0);
-            index--; count--; // 항목이 삭제되었으므로 인덱스와 카운트 조정
+class DwmPreviewBackend : public PreviewBackend
+{
+public:
+    DwmPreviewBackend() : m_host(NULL) {}
+    void SetHost(HWND host) { m_host = host; }
+
+    virtual void EnumerateWindows(WindowVisitor visit, void* context)
+    {
+        Visit visitContext = { visit, context };
+        EnumWindows(EnumProc, (LPARAM)&visitContext);
+    }
+    virtual bool IsCandidate(WindowId id)
+    {
+        HWND hwnd = (HWND)id;
+        // 메인 윈도우 자신, 유효하지 않은 창, 숨겨진 창은 제외
+        if (hwnd == m_host || !IsWindow(hwnd) || !IsWindowVisible(hwnd))
+            return false;
+        // 이 프로세스의 창(드롭다운 목록, 성능 통계 창 등)은 UI 스레드 소유이므로 제목 질의가 UI 스레드를 기다리게 됨: 제외
+        DWORD pid = 0;
+        GetWindowThreadProcessId(hwnd, &pid);
+        return pid != GetCurrentProcessId();
+    }
+    virtual bool ReadTitle(WindowId id, std::wstring& title) { return ReadWindowTitle((HWND)id, title); }
+    virtual bool IsAlive(WindowId id) { return IsWindow((HWND)id) != FALSE; }
+    virtual void ReadCaption(WindowId id, std::wstring& caption)
+    {
+        WCHAR buffer[MAX_PATH];
+        int length = InternalGetWindowText((HWND)id, buffer, MAX_PATH);
+        caption.assign(buffer, length > 0 ? length : 0);
+    }
+    virtual void ReadClass(WindowId id, std::wstring& className) { ReadWindowClass((HWND)id, className); }
+    virtual void ReadProcess(WindowId id, std::wstring& process) { ReadWindowProcess((HWND)id, process); }
+    virtual void ReadTraits(WindowId id, bool* owned, bool* toolWindow)
+    {
+        *owned = GetWindow((HWND)id, GW_OWNER) != NULL;
+        *toolWindow = (GetWindowLong((HWND)id, GWL_EXSTYLE) & WS_EX_TOOLWINDOW) != 0;
+    }
+
+    virtual PreviewHandle Register(WindowId source)
+    {
+        HTHUMBNAIL thumbnail = NULL;
+        if (FAILED(DwmRegisterThumbnail(m_host, (HWND)source, &thumbnail)))
+            return 0;
+        return (PreviewHandle)thumbnail;
+    }
+    virtual void Unregister(PreviewHandle thumbnail) { DwmUnregisterThumbnail((HTHUMBNAIL)thumbnail); }
+    virtual bool QuerySourceSize(PreviewHandle thumbnail, int* cx, int* cy)
+    {
+        SIZE size = {};
+        if (SUCCEEDED(DwmQueryThumbnailSourceSize((HTHUMBNAIL)thumbnail, &size)) && size.cx > 0 && size.cy > 0)
+        {
+            *cx = size.cx;
+            *cy = size.cy;
+            return true;
         }
+        *cx = *cy = 0;
+        return false;
+    }
+    virtual void Update(PreviewHandle thumbnail, const LayoutRect& destination, bool visible)
+    {
+        DWM_THUMBNAIL_PROPERTIES props = {}; // 모든 멤버를 0으로 초기화
+        props.dwFlags = DWM_TNP_RECTDESTINATION | DWM_TNP_VISIBLE |
+                        DWM_TNP_SOURCECLIENTAREAONLY | DWM_TNP_OPACITY;
+        props.fVisible = visible ? TRUE : FALSE;
+        props.fSourceClientAreaOnly = TRUE; // 클라이언트 영역만 표시
+        props.opacity = 255; // 완전 불투명
+        SetRect(&props.rcDestination, destination.left, destination.top, destination.right, destination.bottom);
+        DwmUpdateThumbnailProperties((HTHUMBNAIL)thumbnail, &props);
+    }
+    virtual void Flush() { DwmFlush(); }
+
+private:
+    struct Visit
+    {
+        WindowVisitor visit;
+        void* context;
+    };
+    static BOOL CALLBACK EnumProc(HWND hwnd, LPARAM lParam)
+    {
+        Visit* visit = (Visit*)lParam;
+        return visit->visit(visit->context, (WindowId)hwnd) ? TRUE : FALSE;
     }
-}
+
+protected:
+    HWND m_host;
+};
 
 //=============================================================================
-// RecreatePreviews: 콤보박스(드롭다운) 컨트롤들을 새로 생성하며, 기존 선택 상태 보존 및 목록 재채우기
-// - 미리보기 창 개수 변경(창+1, 창-1) 시 호출됨
+// 세션 저장/복원: 슬롯마다 선택한 창의 식별 정보를 %LOCALAPPDATA%\MultiWindowViewer\session.dat에 보관
+// - 창 핸들은 재시작하면 의미가 없으므로 실행 파일 이름/클래스 이름/제목 패턴으로 저장 (sessionstore.h)
+// - 저장은 ScheduleSave로 예약해 두었다가 변경이 잠잠해지면 설정(레지스트리)과 함께 한 번에 씀
 //=============================================================================
-void RecreatePreviews(HWND hWnd)
+
+// %LOCALAPPDATA%\MultiWindowViewer\name 경로 (폴더가 없으면 만듦). 경로가 너무 길면 false
+bool GetDataFilePath(const wchar_t* name, wchar_t* path)
 {
-    // 1. 기존 콤보박스 제거 (DWM 썸네일 핸들은 WM_COMMAND에서 이미 처리되었음)
-    for (int i = 0; i < MAX_SEGMENTS; i++) {
-        if (g_ComboBoxes[i]) {
-            RemoveWindowSubclass(g_ComboBoxes[i], ComboSubclassProc, i); // 서브클래스 해제
-            DestroyWindow(g_ComboBoxes[i]); // 콤보박스 윈도우 파괴
-            g_ComboBoxes[i] = NULL;
-        }
+    DWORD length = GetEnvironmentVariable(L"LOCALAPPDATA", path, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH - 40)
+        return false;
+    lstrcat(path, L"\\MultiWindowViewer");
+    CreateDirectory(path, NULL); // 이미 있으면 실패하지만 무시
+    lstrcat(path, L"\\");
+    lstrcat(path, name);
+    return true;
+}
+
+// 세션 파일을 읽어 슬롯 개수와 슬롯별 식별 정보에 반영 (창 배정은 WM_CREATE의 첫 열거에서)
+// 파일이 없거나 손상되었으면 레지스트리의 PreviewCount대로 빈 슬롯으로 시작
+void LoadSession()
+{
+    wchar_t path[MAX_PATH];
+    if (!GetDataFilePath(L"session.dat", path))
+        return;
+    HANDLE hFile = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return;
+    std::vector<uint8_t> bytes;
+    DWORD size = GetFileSize(hFile, NULL);
+    if (size != INVALID_FILE_SIZE && size > 0 && size <= (1u << 22))
+    {
+        bytes.resize(size);
+        DWORD read = 0;
+        if (!ReadFile(hFile, &bytes[0], size, &read, NULL) || read != size)
+            bytes.clear();
     }
-    
-    int comboHeight = DROP_HEIGHT;
-    // 미리보기 영역 높이와 정의된 비율을 사용하여 기본 콤보박스 및 미리보기 슬롯 너비 계산
-    int defaultPreviewWidth = (PREVIEW_HEIGHT * PREVIEW_ASPECT_RATIO_NUMERATOR) / PREVIEW_ASPECT_RATIO_DENOMINATOR;
-    
-    // 2. g_numSegments 개수만큼 새로운 콤보박스 생성
-    for (int i = 0; i < g_numSegments; i++) {
-        int x = i * defaultPreviewWidth; // 각 콤보박스의 X 위치 계산
-        g_ComboBoxes[i] = CreateWindowEx(0, TEXT("COMBOBOX"), NULL,
-            WS_CHILD | WS_VISIBLE | CBS_DROPDOWNLIST | CBS_HASSTRINGS, // 자식 윈도우, 보임, 드롭다운 목록, 문자열 포함
-            x, 0, defaultPreviewWidth, comboHeight, // 위치 및 크기
-            hWnd, (HMENU)(INT_PTR)(IDC_COMBO1 + i), // 부모 윈도우, 컨트롤 ID
-            g_hInst, NULL);
-        SetWindowSubclass(g_ComboBoxes[i], ComboSubclassProc, i, 0); // 콤보박스 서브클래스 설정
-        SendMessage(g_ComboBoxes[i], WM_SETFONT, (WPARAM)g_hFont, TRUE); // 폰트 설정
-        SetWindowTheme(g_ComboBoxes[i], L"", L""); // 콤보박스 테마 초기화 (클래식 스타일 적용 시도)
+    CloseHandle(hFile);
+
+    std::vector<SlotBinding> bindings;
+    if (bytes.empty() || !DecodeSession(&bytes[0], bytes.size(), bindings) || bindings.empty())
+        return;
+    // 비정상 종료로 PreviewCount가 저장되지 않았어도 마지막으로 저장된 슬롯 수로 복원
+    g_slots.Resize((int)bindings.size());
+    for (int i = 0; i < g_slots.Count(); i++)
+        g_slots.Cold(i).binding = bindings[i];
+    g_sessionSaved.swap(bytes);
+}
+
+// 슬롯별 식별 정보를 세션 파일에 저장. 임시 파일에 끝까지 쓰고 디스크에 내린 뒤 교체하므로
+// 저장 도중 비정상 종료되어도 이전 파일과 새 파일 중 하나는 온전히 남음. 마지막 저장과 내용이 같으면 쓰지 않음
+void SaveSession()
+{
+    std::vector<SlotBinding> bindings(g_slots.Count());
+    for (int i = 0; i < g_slots.Count(); i++)
+        bindings[i] = g_slots.Cold(i).binding;
+    std::vector<uint8_t> bytes;
+    EncodeSession(bindings, bytes);
+    if (bytes == g_sessionSaved)
+        return;
+
+    wchar_t path[MAX_PATH];
+    wchar_t temp[MAX_PATH];
+    if (!GetDataFilePath(L"session.dat", path) || !GetDataFilePath(L"session.tmp", temp))
+        return;
+    HANDLE hFile = CreateFile(temp, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return;
+    DWORD written = 0;
+    bool ok = WriteFile(hFile, &bytes[0], (DWORD)bytes.size(), &written, NULL) && written == bytes.size() &&
+              FlushFileBuffers(hFile);
+    CloseHandle(hFile);
+    if (ok && MoveFileEx(temp, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+        g_sessionSaved.swap(bytes);
+    else
+        DeleteFile(temp);
+}
+
+// 첫 열거에서 목록에 들어온 창들을 저장된 식별 정보와 대조하여 슬롯에 창 배정.
+// 클래스 이름이 저장된 슬롯과 같은 창만 프로세스 이름을 읽음 (창마다 OpenProcess를 하지 않음)
+void RestoreSlotBindings(const WindowDiff& initial)
+{
+    std::vector<SlotBinding> saved(g_slots.Count());
+    for (int i = 0; i < g_slots.Count(); i++)
+        saved[i] = g_slots.Cold(i).binding;
+    g_sessionMatcher.Begin(saved);
+    if (!g_sessionMatcher.Active())
+        return;
+    std::wstring process, className;
+    for (size_t k = 0; k < initial.added.size(); k++)
+    {
+        const WindowRegistry::Entry* entry = g_registry.Find(initial.added[k]);
+        if (!entry) continue;
+        ReadWindowClass((HWND)initial.added[k], className);
+        if (!g_sessionMatcher.WantsClass(className.c_str())) continue;
+        ReadWindowProcess((HWND)initial.added[k], process);
+        size_t length;
+        const wchar_t* title = g_registry.Title(*entry, &length);
+        g_sessionMatcher.Offer(initial.added[k], process.c_str(), className.c_str(), title, length);
     }
-    
-    // 3. EnumWindows로 현재 실행 중인 창들을 열거하여 각 콤보박스에 항목 추가/업데이트
-    EnumWindows(EnumWindowsProc, (LPARAM)hWnd);
-    
-    // 4. g_Selected 배열에 있는 값을 기반으로 콤보박스 선택 상태 복원
-    //    g_Selected 배열 자체는 WM_COMMAND에서 이미 올바른 상태로 조정되었음.
-    for (int i = 0; i < g_numSegments; i++) {
-        if (g_ComboBoxes[i]) {
-            int count = (int)SendMessage(g_ComboBoxes[i], CB_GETCOUNT, 0, 0);
-            int selIndex = CB_ERR;
-            if (g_Selected[i] != NULL) {
-                for (int j = 0; j < count; j++) {
-                    HWND h = (HWND)SendMessage(g_ComboBoxes[i], CB_GETITEMDATA, j, 0);
-                    if (h == g_Selected[i]) { // 저장된 핸들과 일치하는 항목을 찾음
-                        selIndex = j;
-                        break;
-                    }
-                }
-            }
-            if (selIndex != CB_ERR) { // 일치하는 항목을 찾으면 해당 항목을 선택
-                SendMessage(g_ComboBoxes[i], CB_SETCURSEL, selIndex, 0);
-            } else {
-                // g_Selected[i]가 유효하지 않거나 콤보박스에 없는 경우
-                SendMessage(g_ComboBoxes[i], CB_SETCURSEL, -1, 0);
-                g_Selected[i] = NULL; // 실제 선택 상태를 반영
-            }
-        }
+    std::vector<WindowId> assigned;
+    g_sessionMatcher.Finish(assigned);
+    for (int i = 0; i < g_slots.Count() && i < (int)assigned.size(); i++)
+    {
+        if (assigned[i])
+            g_slots.Hot(i).selected = assigned[i];
+    }
+}
+
+// 슬롯에 선택된 창의 식별 정보 기록 (선택이 해제되었으면 비움)
+void UpdateSlotBinding(int slot)
+{
+    SlotBinding& binding = g_slots.Cold(slot).binding;
+    HWND hwnd = (HWND)g_slots.Hot(slot).selected;
+    const WindowRegistry::Entry* entry = hwnd ? g_registry.Find((WindowId)hwnd) : NULL;
+    if (!entry)
+    {
+        binding.Clear();
+        return;
     }
+    ReadWindowOrigin(hwnd, binding.process, binding.className);
+    size_t length;
+    const wchar_t* title = g_registry.Title(*entry, &length);
+    MakeTitlePattern(title, length, binding.titlePattern);
+}
+
+// 설정/세션 저장 예약: 마지막 변경 후 SAVE_QUIET_DELAY 동안 조용하면 (늦어도 SAVE_MAX_DELAY 안에) 한 번 저장
+void ScheduleSave(HWND hWnd)
+{
+    if (!hWnd || g_resetRequested)
+        return;
+    uint64_t now = GetTickCount64();
+    uint64_t due = g_pendingSave.Touch(now);
+    SetTimer(hWnd, ID_SAVE_TIMER, (UINT)(due - now), NULL); // 같은 ID로 다시 설정하면 기존 타이머를 대체
 }
 
 //=============================================================================
-// ComboSubclassProc: 콤보박스 서브클래스 콜백 (extern "C" 명시로 이름 맹글링 문제 방지)
-// - 콤보박스 자체의 마우스 휠 이벤트를 처리하여 항목 변경
+// CapturePreviewBackend: DWM 썸네일을 등록할 수 없을 때 (합성이 꺼진 원격/헤드리스 세션 등) 쓰는 화면 캡처 백엔드
+// - 대상 창 클라이언트 영역을 PrintWindow(PW_RENDERFULLCONTENT)로 읽고, 실패하거나 응답 없는 창이면
+//   화면 DC에서 BitBlt로 읽음 (이 경우 가려진 부분은 화면에 보이는 그대로)
+// - PrintWindow는 대상 창에 WM_PRINT를 보내고 응답을 시간 제한 없이 기다리므로, UI 스레드가 다른 프로세스를 기다리지
+//   않도록 캡처할 때마다 WM_NULL을 SendMessageCallback으로 보내 두고(기다리지 않음) 지난번 확인에 답한 창에만 씀.
+//   답이 아직 없거나(바쁨) 응답 없음으로 격리된 창은 화면 복사로 대신함
+// - 캡처 DIB는 모든 썸네일이 함께 쓰고(가장 큰 원본 크기로 키워 재사용), 썸네일마다 목적지 크기로 줄인 DIB만 가짐.
+//   축소는 downscale.h 커널 (실행 중인 CPU에 맞는 SSE2/AVX2/NEON 구현)
+// - 썸네일마다 FrameChangeDetector로 캡처를 타일 단위로 비교해, 바뀐 것이 없으면 축소/무효화를 건너뛰고
+//   바뀐 타일이 있으면 그 행만 다시 줄이고 바뀐 자리만 무효화함
+// - CAPTURE_INTERVAL마다 Refresh로 다시 캡처하고, 메인 윈도우 WM_PAINT에서 Paint로 백 버퍼에 그림
+// - 창 열거/제목은 DWM 백엔드와 같음. 썸네일 함수는 UI 스레드 전용
 //=============================================================================
-extern "C" LRESULT CALLBACK ComboSubclassProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam,
-                                                UINT_PTR uIdSubclass, DWORD_PTR dwRefData)
+class CapturePreviewBackend : public DwmPreviewBackend
 {
-    UNREFERENCED_PARAMETER(dwRefData); // dwRefData는 사용되지 않음
-    switch (uMsg)
+public:
+    CapturePreviewBackend()
+        : m_captureDC(NULL), m_captureBitmap(NULL), m_captureOld(NULL), m_captureBits(NULL),
+          m_captureCx(0), m_captureCy(0), m_sampleDC(NULL), m_sampleOld(NULL), m_paintDC(NULL), m_captures(0),
+          m_captureMicros(0), m_screenCopies(0) {}
+    ~CapturePreviewBackend();
+
+    virtual PreviewHandle Register(WindowId source);
+    virtual void Unregister(PreviewHandle thumbnail);
+    virtual bool QuerySourceSize(PreviewHandle thumbnail, int* cx, int* cy);
+    virtual void Update(PreviewHandle thumbnail, const LayoutRect& destination, bool visible);
+    virtual void Commit();
+    virtual void Flush() {}
+
+    size_t Count() const { return m_thumbnails.size(); }
+    // 보이는 썸네일을 모두 다시 캡처하고 그 영역을 무효화
+    void Refresh();
+    // area와 겹치는 썸네일을 hdc(메인 윈도우 클라이언트 좌표)에 그림
+    void Paint(HDC hdc, const RECT& area);
+    // 창 클라이언트 영역을 공유 캡처 버퍼로 읽음 (image는 다음 캡처 전까지 유효). 화면 기록에도 씀.
+    // 클라이언트 영역이 maxCx x maxCy보다 크면 버퍼를 키우지 않고 false
+    bool CaptureWindow(HWND source, PixelImage* image, int maxCx = INT_MAX, int maxCy = INT_MAX);
+    // 공유 캡처 버퍼를 cx x cy 이상으로 미리 키움 (화면 기록을 켤 때)
+    bool ReserveCapture(int cx, int cy) { return EnsureCaptureBuffer(cx, cy); }
+    // 창 클라이언트 영역을 화면에서 cx x cy 표본 DIB로 바로 줄여 읽음 (StretchBlt HALFTONE, image는 같은 크기의 다음
+    // 표본 전까지 유효). 원본 크기 캡처 DIB와 축소 커널을 거치지 않고 대상 창에 메시지도 보내지 않음.
+    // 가려진 부분은 화면에 보이는 그대로. 활동 감시 표본과, 캡처 버퍼에 들어가지 않는 창의 화면 기록에 씀
+    bool CaptureSample(HWND source, int cx, int cy, PixelImage* image);
+    // 크기별 표본 DIB를 미리 만듦 (감시/기록을 켤 때. 표본 중에는 만들지 않음)
+    bool PrepareSample(int cx, int cy) { return FindSample(cx, cy) != NULL; }
+
+    uint64_t Captures() const { return m_captures; }
+    uint64_t CaptureMicros() const { return m_captureMicros; } // 캡처 + 축소 누적 시간
+    uint64_t ScreenCopies() const { return m_screenCopies; }   // 대상 창이 바쁘거나 응답 없어 화면 복사로 대신한 횟수
+    // 썸네일 하나의 바뀐/건너뛴 캡처 수 (이 백엔드가 발급한 핸들)
+    void FrameCounts(PreviewHandle thumbnail, uint64_t* changed, uint64_t* skipped) const;
+
+private:
+    struct Thumbnail
     {
-        case WM_MOUSEWHEEL: // 마우스 휠 이벤트 처리
+        HWND source;
+        LayoutRect destination;
+        bool visible;
+        bool stale;          // 아직 캡처하지 않았거나 목적지 크기가 바뀜 (다음 Commit에서 캡처)
+        HBITMAP scaled;      // 목적지 크기로 줄인 결과 (위에서 아래 순서 32비트 DIB)
+        void* scaledBits;
+        int scaledCx, scaledCy;
+        FrameChangeDetector changes; // 이전 캡처와 비교할 타일 해시
+    };
+
+    // 캡처해서 바뀐 부분만 다시 줄이고 무효화. 캡처하지 못하면 false (바뀐 것이 없어도 캡처했으면 true)
+    bool Capture(Thumbnail* thumbnail);
+    bool EnsureCaptureBuffer(int cx, int cy);
+    void InvalidateDestination(const Thumbnail* thumbnail);
+    // PrintWindow를 써도 되는지 (지난번 WM_NULL 확인에 답했고 응답 없음으로 격리되지 않음). 다음 확인을 보냄
+    bool Responsive(HWND source);
+    static void CALLBACK ProbeAnswered(HWND hwnd, UINT message, ULONG_PTR data, LRESULT result);
+
+    struct Probe
+    {
+        bool pending;  // 보낸 확인에 아직 답이 없음 (답이 올 때까지 다시 보내지 않음)
+        bool answered; // 확인에 한 번이라도 답함
+    };
+
+    HDC m_captureDC;
+    HBITMAP m_captureBitmap;
+    HGDIOBJ m_captureOld;
+    void* m_captureBits;
+    int m_captureCx, m_captureCy; // 캡처 DIB 크기 (줄 간격 = m_captureCx * 4)
+    struct SampleDib
+    {
+        int cx, cy;
+        HBITMAP bitmap;
+        void* bits;
+    };
+    // cx x cy 표본 DIB (없으면 만듦. 크기는 활동 감시/화면 기록 두 가지뿐)
+    SampleDib* FindSample(int cx, int cy);
+
+    HDC m_sampleDC;               // 표본 DIB를 선택해 StretchBlt 대상으로 쓰는 메모리 DC (HALFTONE)
+    HGDIOBJ m_sampleOld;
+    std::vector<SampleDib> m_sampleDibs;
+    HDC m_paintDC;                // 축소 DIB를 선택해 그릴 때 쓰는 메모리 DC
+    Downscaler m_scaler;
+    std::vector<Thumbnail*> m_thumbnails; // 슬롯 수만큼이므로 선형 검색
+    std::vector<LayoutRect> m_dirtyRects; // Capture에서 재사용
+    std::unordered_map<HWND, Probe> m_probes; // 캡처한 창마다 응답 확인 상태 (사라진 창은 가끔 정리)
+    uint64_t m_captures;
+    uint64_t m_captureMicros;
+    uint64_t m_screenCopies; // PrintWindow 대신 화면 복사로 캡처한 횟수
+};
+
+// 32비트 DIB 섹션 (위에서 아래 순서이므로 PixelImage로 바로 읽고 쓸 수 있음)
+static HBITMAP CreateTopDownDib(int cx, int cy, void** bits)
+{
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = cx;
+    bmi.bmiHeader.biHeight = -cy;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    return CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, bits, NULL, 0);
+}
+
+CapturePreviewBackend::~CapturePreviewBackend()
+{
+    for (size_t i = 0; i < m_thumbnails.size(); i++)
+    {
+        if (m_thumbnails[i]->scaled)
+            DeleteObject(m_thumbnails[i]->scaled);
+        delete m_thumbnails[i];
+    }
+    if (m_captureBitmap)
+    {
+        SelectObject(m_captureDC, m_captureOld);
+        DeleteObject(m_captureBitmap);
+    }
+    if (m_captureDC)
+        DeleteDC(m_captureDC);
+    if (m_sampleOld)
+        SelectObject(m_sampleDC, m_sampleOld);
+    for (size_t i = 0; i < m_sampleDibs.size(); i++)
+        DeleteObject(m_sampleDibs[i].bitmap);
+    if (m_sampleDC)
+        DeleteDC(m_sampleDC);
+    if (m_paintDC)
+        DeleteDC(m_paintDC);
+}
+
+PreviewHandle CapturePreviewBackend::Register(WindowId source)
+{
+    if (!IsWindow((HWND)source))
+        return 0;
+    Thumbnail* thumbnail = new Thumbnail();
+    thumbnail->source = (HWND)source;
+    thumbnail->visible = false;
+    thumbnail->stale = true;
+    thumbnail->scaled = NULL;
+    thumbnail->scaledBits = NULL;
+    thumbnail->scaledCx = thumbnail->scaledCy = 0;
+    m_thumbnails.push_back(thumbnail);
+    return (PreviewHandle)thumbnail;
+}
+
+void CapturePreviewBackend::Unregister(PreviewHandle handle)
+{
+    Thumbnail* thumbnail = (Thumbnail*)handle;
+    for (size_t i = 0; i < m_thumbnails.size(); i++)
+    {
+        if (m_thumbnails[i] != thumbnail)
+            continue;
+        if (thumbnail->visible)
+            InvalidateDestination(thumbnail); // 썸네일이 있던 자리를 배경으로 다시 그림
+        if (thumbnail->scaled)
+            DeleteObject(thumbnail->scaled);
+        delete thumbnail;
+        m_thumbnails.erase(m_thumbnails.begin() + i);
+        return;
+    }
+}
+
+bool CapturePreviewBackend::QuerySourceSize(PreviewHandle handle, int* cx, int* cy)
+{
+    const Thumbnail* thumbnail = (const Thumbnail*)handle;
+    RECT rc;
+    if (!IsIconic(thumbnail->source) && GetClientRect(thumbnail->source, &rc) && rc.right > 0 && rc.bottom > 0)
+    {
+        *cx = rc.right;
+        *cy = rc.bottom;
+        return true;
+    }
+    *cx = *cy = 0;
+    return false;
+}
+
+void CapturePreviewBackend::Update(PreviewHandle handle, const LayoutRect& destination, bool visible)
+{
+    Thumbnail* thumbnail = (Thumbnail*)handle;
+    if (thumbnail->visible == visible && thumbnail->destination == destination)
+        return;
+    if (thumbnail->visible)
+        InvalidateDestination(thumbnail);
+    if (thumbnail->destination.Width() != destination.Width() || thumbnail->destination.Height() != destination.Height())
+        thumbnail->stale = true; // 크기가 바뀌면 다시 캡처해서 줄임 (원본 캡처는 썸네일마다 보관하지 않음)
+    thumbnail->destination = destination;
+    thumbnail->visible = visible;
+    if (visible)
+        InvalidateDestination(thumbnail);
+}
+
+void CapturePreviewBackend::Commit()
+{
+    for (size_t i = 0; i < m_thumbnails.size(); i++)
+    {
+        Thumbnail* thumbnail = m_thumbnails[i];
+        if (!thumbnail->stale || !thumbnail->visible)
+            continue;
+        thumbnail->stale = false; // 캡처하지 못했으면 (최소화 등) 다음 Refresh에서 다시 시도
+        Capture(thumbnail);
+    }
+}
+
+void CapturePreviewBackend::Refresh()
+{
+    for (size_t i = 0; i < m_thumbnails.size(); i++)
+    {
+        Thumbnail* thumbnail = m_thumbnails[i];
+        if (thumbnail->visible && Capture(thumbnail))
+            thumbnail->stale = false;
+    }
+}
+
+void CapturePreviewBackend::Paint(HDC hdc, const RECT& area)
+{
+    for (size_t i = 0; i < m_thumbnails.size(); i++)
+    {
+        const Thumbnail* thumbnail = m_thumbnails[i];
+        if (!thumbnail->visible || !thumbnail->scaled)
+            continue;
+        const LayoutRect& dest = thumbnail->destination;
+        RECT rcDest = { dest.left, dest.top, dest.left + thumbnail->scaledCx, dest.top + thumbnail->scaledCy };
+        RECT overlap;
+        if (!IntersectRect(&overlap, &rcDest, &area))
+            continue;
+        if (!m_paintDC)
+            m_paintDC = CreateCompatibleDC(hdc);
+        HGDIOBJ old = SelectObject(m_paintDC, thumbnail->scaled);
+        BitBlt(hdc, overlap.left, overlap.top, overlap.right - overlap.left, overlap.bottom - overlap.top,
+               m_paintDC, overlap.left - rcDest.left, overlap.top - rcDest.top, SRCCOPY);
+        SelectObject(m_paintDC, old);
+    }
+}
+
+bool CapturePreviewBackend::CaptureWindow(HWND source, PixelImage* image, int maxCx, int maxCy)
+{
+    RECT rc;
+    if (IsIconic(source) || !GetClientRect(source, &rc) || rc.right <= 0 || rc.bottom <= 0)
+        return false;
+    if (rc.right > maxCx || rc.bottom > maxCy)
+        return false;
+    if (!EnsureCaptureBuffer(rc.right, rc.bottom))
+        return false;
+
+    // PrintWindow는 대상 창에 그리기 메시지를 보내고 기다리므로 지난번 확인에 답한 창에만 쓰고, 나머지는 화면 복사만 함
+    BOOL printed = FALSE;
+    if (Responsive(source))
+        printed = PrintWindow(source, m_captureDC, PW_CLIENTONLY | PW_RENDERFULLCONTENT);
+    if (!printed)
+    {
+        m_screenCopies++;
+        HDC windowDC = GetDC(source);
+        if (!windowDC)
+            return false;
+        BitBlt(m_captureDC, 0, 0, rc.right, rc.bottom, windowDC, 0, 0, SRCCOPY | CAPTUREBLT);
+        ReleaseDC(source, windowDC);
+    }
+    GdiFlush(); // DIB 메모리를 직접 읽기 전에 GDI 작업을 마침
+    image->pixels = (uint8_t*)m_captureBits;
+    image->width = (int)rc.right;
+    image->height = (int)rc.bottom;
+    image->stride = m_captureCx * 4;
+    return true;
+}
+
+bool CapturePreviewBackend::CaptureSample(HWND source, int cx, int cy, PixelImage* image)
+{
+    RECT rc;
+    if (IsIconic(source) || !GetClientRect(source, &rc) || rc.right <= 0 || rc.bottom <= 0)
+        return false;
+    SampleDib* sample = FindSample(cx, cy);
+    if (!sample)
+        return false;
+    HDC windowDC = GetDC(source);
+    if (!windowDC)
+        return false;
+    HGDIOBJ old = SelectObject(m_sampleDC, sample->bitmap);
+    if (!m_sampleOld)
+        m_sampleOld = old; // 처음 선택할 때의 기본 비트맵 (해제 전에 되돌림)
+    BOOL copied = StretchBlt(m_sampleDC, 0, 0, cx, cy, windowDC, 0, 0, rc.right, rc.bottom, SRCCOPY | CAPTUREBLT);
+    ReleaseDC(source, windowDC);
+    if (!copied)
+        return false;
+    GdiFlush(); // DIB 메모리를 직접 읽기 전에 GDI 작업을 마침
+    image->pixels = (uint8_t*)sample->bits;
+    image->width = cx;
+    image->height = cy;
+    image->stride = cx * 4;
+    return true;
+}
+
+CapturePreviewBackend::SampleDib* CapturePreviewBackend::FindSample(int cx, int cy)
+{
+    for (size_t i = 0; i < m_sampleDibs.size(); i++)
+    {
+        if (m_sampleDibs[i].cx == cx && m_sampleDibs[i].cy == cy)
+            return &m_sampleDibs[i];
+    }
+    if (!m_sampleDC)
+    {
+        m_sampleDC = CreateCompatibleDC(NULL);
+        if (!m_sampleDC)
+            return NULL;
+        SetStretchBltMode(m_sampleDC, HALFTONE);
+        SetBrushOrgEx(m_sampleDC, 0, 0, NULL); // HALFTONE 모드로 바꾼 뒤에는 브러시 원점을 다시 맞춰야 함
+    }
+    SampleDib sample = { cx, cy, NULL, NULL };
+    sample.bitmap = CreateTopDownDib(cx, cy, &sample.bits);
+    if (!sample.bitmap)
+        return NULL;
+    m_sampleDibs.push_back(sample);
+    return &m_sampleDibs.back();
+}
+
+bool CapturePreviewBackend::Capture(Thumbnail* thumbnail)
+{
+    int dx = thumbnail->destination.Width();
+    int dy = thumbnail->destination.Height();
+    if (dx <= 0 || dy <= 0)
+        return false;
+    uint64_t start = PerfClockMicros();
+    PixelImage src;
+    if (!CaptureWindow(thumbnail->source, &src))
+        return false;
+
+    if (!thumbnail->scaled || thumbnail->scaledCx != dx || thumbnail->scaledCy != dy)
+    {
+        if (thumbnail->scaled)
+            DeleteObject(thumbnail->scaled);
+        thumbnail->scaled = CreateTopDownDib(dx, dy, &thumbnail->scaledBits);
+        thumbnail->scaledCx = thumbnail->scaled ? dx : 0;
+        thumbnail->scaledCy = thumbnail->scaled ? dy : 0;
+        if (!thumbnail->scaled)
+            return false;
+        thumbnail->changes.Reset(); // 새 DIB는 비어 있으므로 전체를 줄임
+    }
+    PixelImage dst = { (uint8_t*)thumbnail->scaledBits, dx, dy, dx * 4 };
+    m_captures++;
+    if (!thumbnail->changes.Update(src))
+    {
+        m_captureMicros += PerfClockMicros() - start;
+        return true; // 지난 캡처와 같음: 축소 DIB와 화면을 그대로 둠
+    }
+    int srcTop, srcBottom, dstTop, dstBottom;
+    thumbnail->changes.DirtyRows(&srcTop, &srcBottom);
+    m_scaler.ScaleRows(src, dst, srcTop, srcBottom, &dstTop, &dstBottom);
+    m_captureMicros += PerfClockMicros() - start;
+
+    if (thumbnail->changes.DirtyCount() == thumbnail->changes.Columns() * thumbnail->changes.Rows())
+    {
+        InvalidateDestination(thumbnail);
+        return true;
+    }
+    thumbnail->changes.DirtyRects(dx, dy, m_dirtyRects);
+    const LayoutRect& dest = thumbnail->destination;
+    for (size_t i = 0; i < m_dirtyRects.size() && m_host; i++)
+    {
+        const LayoutRect& dirty = m_dirtyRects[i];
+        RECT rcDirty = { dest.left + dirty.left, dest.top + dirty.top, dest.left + dirty.right, dest.top + dirty.bottom };
+        InvalidateRect(m_host, &rcDirty, FALSE);
+    }
+    return true;
+}
+
+bool CapturePreviewBackend::Responsive(HWND source)
+{
+    if (IsHungAppWindow(source) || g_hungWindows.count((WindowId)source))
+        return false;
+    if (m_probes.size() > 64) // 닫힌 창의 상태 정리 (슬롯/감시/기록 대상만 들어오므로 드묾)
+    {
+        for (std::unordered_map<HWND, Probe>::iterator it = m_probes.begin(); it != m_probes.end();)
         {
-            short delta = GET_WHEEL_DELTA_WPARAM(wParam); // 휠 스크롤 방향 (양수: 위, 음수: 아래)
-            int curSel = (int)SendMessage(hWnd, CB_GETCURSEL, 0, 0); // 현재 선택된 인덱스
-            int count = (int)SendMessage(hWnd, CB_GETCOUNT, 0, 0);   // 전체 항목 개수
-            if (delta > 0 && curSel > 0) // 위로 스크롤 & 현재 선택이 첫 항목이 아닐 때
-            {
-                curSel--; // 인덱스 감소
-                SendMessage(hWnd, CB_SETCURSEL, curSel, 0); // 새 항목 선택
-                // 부모 윈도우에 CBN_SELCHANGE 메시지를 보내 선택 변경 알림
-                SendMessage(GetParent(hWnd), WM_COMMAND,
-                            MAKEWPARAM(GetDlgCtrlID(hWnd), CBN_SELCHANGE), (LPARAM)hWnd);
-            }
-            else if (delta < 0 && curSel < count - 1) // 아래로 스크롤 & 현재 선택이 마지막 항목이 아닐 때
-            {
-                curSel++; // 인덱스 증가
-                SendMessage(hWnd, CB_SETCURSEL, curSel, 0); // 새 항목 선택
-                // 부모 윈도우에 CBN_SELCHANGE 메시지를 보내 선택 변경 알림
-                SendMessage(GetParent(hWnd), WM_COMMAND,
-                            MAKEWPARAM(GetDlgCtrlID(hWnd), CBN_SELCHANGE), (LPARAM)hWnd);
-            }
-            return 0; // 메시지 처리 완료
+            if (IsWindow(it->first))
+                ++it;
+            else
+                it = m_probes.erase(it);
         }
-        case WM_ERASEBKGND: // 배경 지우기 메시지 무시하여 깜빡임 감소
-            return 1;
-        case WM_NCDESTROY: // 서브클래스 해제 시 처리 (제거 시점 명확화)
-            RemoveWindowSubclass(hWnd, ComboSubclassProc, uIdSubclass);
-            break;
     }
-    return DefSubclassProc(hWnd, uMsg, wParam, lParam); // 기본 처리기로 메시지 전달
+    Probe& probe = m_probes[source]; // 처음이면 답한 적 없음 (이번에는 화면 복사)
+    bool responsive = probe.answered && !probe.pending;
+    // 답이 없는 확인이 있으면 보내지 않음 (멈춘 창의 메시지 큐에 쌓이지 않게)
+    if (!probe.pending && SendMessageCallback(source, WM_NULL, 0, 0, ProbeAnswered, (ULONG_PTR)this))
+        probe.pending = true;
+    return responsive;
+}
+
+// 대상 창이 WM_NULL을 처리하면 UI 스레드가 다음 메시지를 꺼낼 때 호출됨
+void CALLBACK CapturePreviewBackend::ProbeAnswered(HWND hwnd, UINT message, ULONG_PTR data, LRESULT result)
+{
+    UNREFERENCED_PARAMETER(message);
+    UNREFERENCED_PARAMETER(result);
+    CapturePreviewBackend* backend = (CapturePreviewBackend*)data;
+    std::unordered_map<HWND, Probe>::iterator it = backend->m_probes.find(hwnd);
+    if (it == backend->m_probes.end())
+        return;
+    it->second.pending = false;
+    it->second.answered = true;
+}
+
+void CapturePreviewBackend::FrameCounts(PreviewHandle handle, uint64_t* changed, uint64_t* skipped) const
+{
+    const Thumbnail* thumbnail = (const Thumbnail*)handle;
+    *changed = thumbnail->changes.FramesChanged();
+    *skipped = thumbnail->changes.FramesSkipped();
+}
+
+bool CapturePreviewBackend::EnsureCaptureBuffer(int cx, int cy)
+{
+    if (m_captureBitmap && cx <= m_captureCx && cy <= m_captureCy)
+        return true;
+    int width = cx > m_captureCx ? cx : m_captureCx;
+    int height = cy > m_captureCy ? cy : m_captureCy;
+    if (!m_captureDC)
+        m_captureDC = CreateCompatibleDC(NULL);
+    void* bits = NULL;
+    HBITMAP bitmap = m_captureDC ? CreateTopDownDib(width, height, &bits) : NULL;
+    if (!bitmap)
+        return false;
+    if (m_captureBitmap)
+    {
+        SelectObject(m_captureDC, m_captureOld);
+        DeleteObject(m_captureBitmap);
+    }
+    m_captureOld = SelectObject(m_captureDC, bitmap);
+    m_captureBitmap = bitmap;
+    m_captureBits = bits;
+    m_captureCx = width;
+    m_captureCy = height;
+    return true;
+}
+
+void CapturePreviewBackend::InvalidateDestination(const Thumbnail* thumbnail)
+{
+    const LayoutRect& dest = thumbnail->destination;
+    RECT rc = { dest.left, dest.top, dest.right, dest.bottom };
+    if (m_host && !IsRectEmpty(&rc))
+        InvalidateRect(m_host, &rc, FALSE);
 }
 
+DwmPreviewBackend g_dwmBackend;
+CapturePreviewBackend g_captureBackend; // DWM 썸네일 등록이 실패한 슬롯
+FallbackPreviewBackend g_previewBackend(&g_dwmBackend, &g_captureBackend);
+// 미리보기 백엔드 (창 열거는 작업 스레드, 썸네일은 UI 스레드에서 사용)
+PreviewBackend* g_backend = &g_previewBackend;
+// 원본 레지스트리 갱신 (작업 스레드 전용)과 스냅숏/슬롯 반영 (UI 스레드 전용)
+WindowListUpdater g_updater(g_backend, g_model, g_filter, g_hung, g_tracker);
+SlotPresenter g_presenter(g_backend, g_registry, g_search, g_sizeCache, g_layout, g_frame);
+bool g_captureTimer = false;            // ID_CAPTURE_TIMER가 설정되어 있는지
+
 //=============================================================================
-// ListSubclassProc: 드롭다운 리스트 서브클래스 콜백 (extern "C" 명시로 이름 맹글링 문제 방지)
-// - 콤보박스의 드롭다운 리스트박스에 대한 마우스 휠 이벤트를 처리하여 항목 변경
+// WinEventSource: SetWinEventHook 기반 창 이벤트 소스
+// - WINEVENT_OUTOFCONTEXT 훅은 훅을 설치한 스레드(작업 스레드)의 메시지 대기 중에 호출됨
+// - 최상위 창 자체(OBJID_WINDOW/CHILDID_SELF)에 대한 이벤트만 추적기로 전달
 //=============================================================================
-extern "C" LRESULT CALLBACK ListSubclassProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam,
-                                               UINT_PTR uIdSubclass, DWORD_PTR dwRefData)
+class WinEventSource : public WindowEventSource
 {
-    // dwRefData는 이 리스트박스와 연결된 콤보박스 핸들 (SetWindowSubclass에서 설정)
-    HWND hCombo = (HWND)dwRefData; 
-    UNREFERENCED_PARAMETER(uIdSubclass); // uIdSubclass는 사용되지 않음
+public:
+    WinEventSource() : m_hookObject(NULL), m_hookLocation(NULL), m_hookMinimize(NULL) {}
+    bool Start(WindowEventSink* sink);
+    void Stop();
+
+private:
+    static void CALLBACK HookProc(HWINEVENTHOOK hHook, DWORD event, HWND hwnd, LONG idObject,
+                                  LONG idChild, DWORD idEventThread, DWORD dwmsEventTime);
+    static WindowEventSink* s_sink;
+    HWINEVENTHOOK m_hookObject;   // EVENT_OBJECT_CREATE ~ EVENT_OBJECT_HIDE
+    HWINEVENTHOOK m_hookLocation; // EVENT_OBJECT_LOCATIONCHANGE ~ EVENT_OBJECT_NAMECHANGE
+    HWINEVENTHOOK m_hookMinimize; // EVENT_SYSTEM_MINIMIZESTART ~ EVENT_SYSTEM_MINIMIZEEND
+};
+
+WindowEventSink* WinEventSource::s_sink = NULL;
+WinEventSource g_winEventSource;
+
+bool WinEventSource::Start(WindowEventSink* sink)
+{
+    s_sink = sink;
+    const DWORD flags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS; // 자신의 콤보박스/드롭다운 이벤트 제외
+    m_hookObject = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_HIDE, NULL, HookProc, 0, 0, flags);
+    m_hookLocation = SetWinEventHook(EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_NAMECHANGE, NULL, HookProc, 0, 0, flags);
+    m_hookMinimize = SetWinEventHook(EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND, NULL, HookProc, 0, 0, flags);
+    return m_hookObject && m_hookLocation && m_hookMinimize;
+}
 
-    switch (uMsg)
+void WinEventSource::Stop()
+{
+    if (m_hookObject) { UnhookWinEvent(m_hookObject); m_hookObject = NULL; }
+    if (m_hookLocation) { UnhookWinEvent(m_hookLocation); m_hookLocation = NULL; }
+    if (m_hookMinimize) { UnhookWinEvent(m_hookMinimize); m_hookMinimize = NULL; }
+    s_sink = NULL;
+}
+
+void CALLBACK WinEventSource::HookProc(HWINEVENTHOOK hHook, DWORD event, HWND hwnd, LONG idObject,
+                                       LONG idChild, DWORD idEventThread, DWORD dwmsEventTime)
+{
+    UNREFERENCED_PARAMETER(hHook);
+    UNREFERENCED_PARAMETER(idEventThread);
+    UNREFERENCED_PARAMETER(dwmsEventTime);
+
+    // 캐럿/커서/스크롤바 등 창 내부 객체의 이벤트는 무시
+    if (!s_sink || !hwnd || idObject != OBJID_WINDOW || idChild != CHILDID_SELF)
+        return;
+
+    WindowEvent ev;
+    ev.window = (WindowId)hwnd;
+    switch (event)
     {
-        case WM_MOUSEWHEEL: // 마우스 휠 이벤트 처리
+        case EVENT_OBJECT_CREATE:         ev.kind = WINDOW_EVENT_CREATE; break;
+        case EVENT_OBJECT_DESTROY:        ev.kind = WINDOW_EVENT_DESTROY; break;
+        case EVENT_OBJECT_SHOW:           ev.kind = WINDOW_EVENT_SHOW; break;
+        case EVENT_OBJECT_HIDE:           ev.kind = WINDOW_EVENT_HIDE; break;
+        case EVENT_OBJECT_NAMECHANGE:     ev.kind = WINDOW_EVENT_NAMECHANGE; break;
+        case EVENT_OBJECT_LOCATIONCHANGE:
+        case EVENT_SYSTEM_MINIMIZESTART:
+        case EVENT_SYSTEM_MINIMIZEEND:    ev.kind = WINDOW_EVENT_LOCATIONCHANGE; break;
+        default: return;
+    }
+
+    // 파괴 이벤트 외에는 자식 창(컨트롤 등)의 이벤트를 걸러냄 (파괴된 창은 GetAncestor가 실패함)
+    if (ev.kind != WINDOW_EVENT_DESTROY && GetAncestor(hwnd, GA_ROOT) != hwnd)
+        return;
+
+    s_sink->OnWindowEvent(ev);
+}
+
+//=============================================================================
+// EnumerationWorker: 창 목록 열거/제목 읽기/필터 판정을 UI 스레드 밖에서 수행하는 작업 스레드
+// - 창 이벤트 훅도 이 스레드에서 설치하므로 WinEvent 콜백, 창 추적기(g_tracker), 원본 레지스트리(g_model),
+//   필터(g_filter)는 이 스레드만 사용. UI 스레드의 요청은 스레드 메시지(WM_WORKER_*)로 받음
+// - 갱신 결과는 변경분 스냅숏으로 g_snapshots에 게시하고, UI가 아직 가져가지 않은 스냅숏이 없을 때만
+//   메인 윈도우에 WM_APP_SNAPSHOT 한 번 게시. UI 스레드는 변경분만 적용하며 열거를 기다리지 않음
+// - 변경이 없는 갱신은 게시하지 않고 (UI를 깨우지 않음) 계측만 다음 게시에 함께 보냄
+//=============================================================================
+class EnumerationWorker
+{
+public:
+    EnumerationWorker() : m_thread(NULL), m_threadId(0), m_ready(NULL), m_hMain(NULL), m_pending(NULL), m_probeTimer(0), m_first(true) {}
+
+    bool Start(HWND hMain);                 // 스레드 시작 (스레드 메시지 큐가 준비될 때까지만 기다림)
+    void Stop();                            // 종료 요청 후 스레드가 끝나기를 기다림 (최대 WORKER_STOP_TIMEOUT)
+    bool Post(UINT message, LPARAM lParam = 0) const;
+    // 감시 대상 창 목록 전달 (UI 스레드). 마지막으로 보낸 목록과 같으면 보내지 않음
+    void SetWatched(const std::vector<WindowId>& windows);
+    // 창 추적기 깨우기 (작업 스레드의 WinEvent 콜백 안에서 호출)
+    void Wake() const { Post(WM_WORKER_EVENTS); }
+
+private:
+    static DWORD WINAPI ThreadProc(LPVOID param);
+    void Run();
+    void Process(const WindowChanges& changes, unsigned task); // 변경 사항 처리 후 결과가 있으면 게시
+    void ProbeHungWindows();                // 다시 확인할 때가 된 응답 없는 창의 제목을 다시 질의
+    void ArmProbeTimer();                   // 가장 이른 다시 확인 시각에 맞춰 스레드 타이머 설정 (격리된 창이 없으면 해제)
+
+    HANDLE m_thread;
+    DWORD m_threadId;
+    HANDLE m_ready;                         // 스레드 메시지 큐 준비 완료 이벤트 (Start 동안만 유효)
+    HWND m_hMain;                           // 알림을 보낼 메인 윈도우 (열거에서는 백엔드가 호스트로 제외)
+    std::vector<WindowId> m_sentWatched;    // UI 스레드가 마지막으로 보낸 감시 목록 (UI 스레드 전용)
+
+    // 이하 작업 스레드 전용
+    WindowSnapshot* m_pending;              // 아직 게시하지 않은 스냅숏 (변경 없는 갱신의 계측이 쌓임)
+    std::vector<WindowId> m_watched;        // 미리보기 중인 창 (제목 재확인 대상)
+    WindowChanges m_changes;
+    UINT_PTR m_probeTimer;                  // 응답 없는 창 다시 확인 타이머 (스레드 타이머, hwnd 없음)
+    bool m_first;                           // 첫 열거 결과는 변경이 없어도 게시 (UI의 시작 처리 완료 표시)
+};
+
+EnumerationWorker g_worker;
+
+// 창 추적기에 처음 변경 사항이 쌓였을 때 호출되어 작업 스레드를 깨움
+void WakeWorker(void* context)
+{
+    UNREFERENCED_PARAMETER(context);
+    g_worker.Wake();
+}
+
+bool EnumerationWorker::Start(HWND hMain)
+{
+    m_hMain = hMain;
+    m_ready = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!m_ready)
+        return false;
+    m_thread = CreateThread(NULL, 0, ThreadProc, this, 0, &m_threadId);
+    if (m_thread)
+        WaitForSingleObject(m_ready, INFINITE); // 큐가 생기기 전의 PostThreadMessage는 실패하므로 그때까지만 기다림
+    else
+        m_threadId = 0;
+    CloseHandle(m_ready);
+    m_ready = NULL;
+    return m_thread != NULL;
+}
+
+void EnumerationWorker::Stop()
+{
+    if (!m_thread)
+        return;
+    PostThreadMessage(m_threadId, WM_QUIT, 0, 0);
+    WaitForSingleObject(m_thread, WORKER_STOP_TIMEOUT); // 응답 없는 창 때문에 늦어지면 프로세스 종료에 맡김
+    CloseHandle(m_thread);
+    m_thread = NULL;
+    m_threadId = 0;
+}
+
+bool EnumerationWorker::Post(UINT message, LPARAM lParam) const
+{
+    return m_threadId != 0 && PostThreadMessage(m_threadId, message, 0, lParam);
+}
+
+void EnumerationWorker::SetWatched(const std::vector<WindowId>& windows)
+{
+    if (!m_thread || windows == m_sentWatched)
+        return;
+    m_sentWatched = windows;
+    std::vector<WindowId>* copy = new std::vector<WindowId>(windows);
+    if (!Post(WM_WORKER_WATCH, (LPARAM)copy))
+        delete copy;
+}
+
+DWORD WINAPI EnumerationWorker::ThreadProc(LPVOID param)
+{
+    ((EnumerationWorker*)param)->Run();
+    return 0;
+}
+
+void EnumerationWorker::Run()
+{
+    MSG msg;
+    PeekMessage(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE); // 스레드 메시지 큐 생성
+    SetEvent(m_ready);
+
+    // WINEVENT_OUTOFCONTEXT 훅은 설치한 스레드의 메시지 대기 중에 호출되므로 이 스레드에서 설치.
+    // 훅 설치에 실패해도 안전 점검 요청으로 동작은 유지됨
+    g_winEventSource.Start(&g_tracker);
+
+    // 첫 열거 (UI는 이 결과로 슬롯 연결을 복원)
+    m_changes.listChanged = true;
+    Process(m_changes, 0);
+
+    while (GetMessage(&msg, NULL, 0, 0) > 0)
+    {
+        switch (msg.message)
         {
-            short delta = GET_WHEEL_DELTA_WPARAM(wParam);
-            int curSel = (int)SendMessage(hCombo, CB_GETCURSEL, 0, 0);
-            int count = (int)SendMessage(hCombo, CB_GETCOUNT, 0, 0);
-            if (delta > 0 && curSel > 0)
-            {
-                curSel--;
-                SendMessage(hCombo, CB_SETCURSEL, curSel, 0);
-                SendMessage(GetParent(hCombo), WM_COMMAND,
+        case WM_WORKER_EVENTS:
+            g_tracker.TakeChanges(m_changes);
+            Process(m_changes, 0);
+            break;
+        case WM_WORKER_SWEEP:
+            g_tracker.TakeChanges(m_changes); // 쌓여 있던 이벤트도 함께 처리
+            m_changes.listChanged = true;
+            Process(m_changes, 1u << REFRESH_WINDOWLIST);
+            break;
+        case WM_WORKER_TITLES:
+            m_changes.listChanged = false;
+            m_changes.titleChanged = m_watched;
+            m_changes.locationChanged.clear();
+            Process(m_changes, 1u << REFRESH_TITLES);
+            break;
+        case WM_WORKER_WATCH:
+        {
+            std::vector<WindowId>* windows = (std::vector<WindowId>*)msg.lParam;
+            m_watched.swap(*windows);
+            delete windows;
+            g_tracker.SetWatched(m_watched);
+        }
+        break;
+        case WM_TIMER:
+            if (msg.hwnd == NULL && msg.wParam == m_probeTimer)
+            {
+                KillTimer(NULL, m_probeTimer);
+                m_probeTimer = 0;
+                ProbeHungWindows();
+            }
+            else
+                DispatchMessage(&msg);
+            break;
+        case WM_WORKER_FILTER:
+            // 규칙을 다시 컴파일하면 판정 캐시가 비워지므로 다음 열거에서 모든 창을 다시 판정
+            LoadFilterRules();
+            g_tracker.RequestSweep();
+            break;
+        default:
+            DispatchMessage(&msg);
+            break;
+        }
+    }
+
+    g_winEventSource.Stop();
+    if (m_probeTimer)
+        KillTimer(NULL, m_probeTimer);
+    m_probeTimer = 0;
+    // 게시하지 못한 스냅숏과 처리되지 않은 감시 목록 정리
+    if (m_pending)
+        g_snapshots.Release(m_pending);
+    m_pending = NULL;
+    while (PeekMessage(&msg, NULL, WM_WORKER_WATCH, WM_WORKER_WATCH, PM_REMOVE))
+        delete (std::vector<WindowId>*)msg.lParam;
+}
+
+// 목록 재열거/제목 다시 읽기 결과를 원본 레지스트리에 반영하고 변경분을 스냅숏에 기록하여 게시.
+// task: 이 처리를 요청한 주기 점검 작업 비트 (변경을 찾으면 UI가 그 작업의 간격을 기본값으로 되돌림)
+void EnumerationWorker::Process(const WindowChanges& changes, unsigned task)
+{
+    if (!m_pending)
+        m_pending = g_snapshots.Acquire();
+    WindowSnapshot& snapshot = *m_pending;
+
+    // 1~4. 열거/제목 다시 읽기 결과와 격리 상태 변경을 기록 (viewermodel.h). 격리된 창이 남아 있으면 다시 확인 예약
+    g_updater.Process(changes, task, GetTickCount64(), snapshot);
+    ArmProbeTimer();
+
+    // 5. 변경이 있을 때만 게시 (UI가 이전 스냅숏을 아직 가져가지 않았으면 합쳐지고 메시지는 보내지 않음)
+    if (snapshot.Empty() && !m_first)
+        return;
+    m_first = false;
+    m_pending = NULL;
+    if (g_snapshots.Publish(&snapshot))
+        PostMessage(m_hMain, WM_APP_SNAPSHOT, 0, 0);
+}
+
+// 다시 확인할 때가 된 격리 창만 제목 다시 읽기 경로로 처리 (응답하면 격리 해제, 아니면 간격이 늘어남)
+void EnumerationWorker::ProbeHungWindows()
+{
+    g_updater.CollectDueProbes(GetTickCount64(), m_changes);
+    Process(m_changes, 0);
+}
+
+void EnumerationWorker::ArmProbeTimer()
+{
+    uint64_t next = g_hung.NextProbe();
+    if (next == 0) {
+        if (m_probeTimer)
+            KillTimer(NULL, m_probeTimer);
+        m_probeTimer = 0;
+        return;
+    }
+    uint64_t now = GetTickCount64();
+    UINT delay = next > now ? (UINT)(next - now) : USER_TIMER_MINIMUM;
+    // 스레드 타이머는 hwnd가 없으므로 기존 ID를 넘겨 재설정 (WM_TIMER는 이 스레드의 메시지 루프로 옴)
+    m_probeTimer = SetTimer(NULL, m_probeTimer, delay, NULL);
+}
+
+//=============================================================================
+// BackBuffer: WM_PAINT용 메모리 DC/비트맵을 유지하여 매번 생성/파괴하지 않음
+// - 요청 크기보다 작을 때만 다시 만들고, 요청 크기가 1/4 이하로 줄면 메모리를 돌려주기 위해 다시 만듦
+// - 화면 색 형식이 바뀌면(WM_DISPLAYCHANGE) Release 후 다음 그리기에서 다시 만듦
+//=============================================================================
+class BackBuffer
+{
+public:
+    BackBuffer() : m_dc(NULL), m_bitmap(NULL), m_oldBitmap(NULL), m_cx(0), m_cy(0) {}
+    ~BackBuffer() { Release(); }
+
+    // cx x cy 이상 크기의 버퍼를 준비하고 메모리 DC를 반환 (실패 시 NULL)
+    HDC Prepare(HDC hdcTarget, int cx, int cy)
+    {
+        if (cx <= 0 || cy <= 0)
+            return NULL;
+        bool tooSmall = cx > m_cx || cy > m_cy;
+        bool tooLarge = (long long)cx * cy * 4 <= (long long)m_cx * m_cy;
+        if (m_dc && !tooSmall && !tooLarge)
+            return m_dc;
+
+        Release();
+        m_dc = CreateCompatibleDC(hdcTarget);
+        if (!m_dc)
+            return NULL;
+        m_bitmap = CreateCompatibleBitmap(hdcTarget, cx, cy);
+        if (!m_bitmap)
+        {
+            Release();
+            return NULL;
+        }
+        m_oldBitmap = (HBITMAP)SelectObject(m_dc, m_bitmap);
+        m_cx = cx;
+        m_cy = cy;
+        SetStretchBltMode(m_dc, HALFTONE); // 이미지 축소/확대 시 부드러운 렌더링 모드 설정
+        return m_dc;
+    }
+
+    void Release()
+    {
+        if (m_dc)
+        {
+            if (m_oldBitmap)
+                SelectObject(m_dc, m_oldBitmap);
+            DeleteDC(m_dc);
+        }
+        if (m_bitmap)
+            DeleteObject(m_bitmap);
+        m_dc = NULL;
+        m_bitmap = NULL;
+        m_oldBitmap = NULL;
+        m_cx = m_cy = 0;
+    }
+
+private:
+    HDC m_dc;
+    HBITMAP m_bitmap;
+    HBITMAP m_oldBitmap;
+    int m_cx, m_cy;
+};
+
+BackBuffer g_backBuffer;
+
+//=============================================================================
+// 슬롯 선택기(콤보박스) 항목 관리
+// - 모든 콤보박스는 CBS_OWNERDRAWFIXED (CBS_HASSTRINGS 없음): 항목 데이터로 창 핸들만 보관
+// - 닫혀 있을 때는 선택된 창 하나만, 드롭다운이 열려 있는 하나의 콤보박스만 전체 목록을 가짐
+//   -> 슬롯 개수가 늘어나도 목록 메모리와 갱신 비용은 늘지 않음
+//=============================================================================
+void CollapsePicker(int slot)
+{
+    HWND hCombo = g_slots.Cold(slot).combo;
+    if (!hCombo) return;
+    SendMessage(hCombo, CB_RESETCONTENT, 0, 0);
+    g_perf.Add(PERF_COUNT_SENDMESSAGE);
+    if (g_slots.Hot(slot).selected && g_registry.Find(g_slots.Hot(slot).selected)) {
+        // CBS_HASSTRINGS가 없으므로 lParam은 문자열이 아닌 항목 데이터로 저장됨
+        SendMessage(hCombo, CB_ADDSTRING, 0, (LPARAM)g_slots.Hot(slot).selected);
+        SendMessage(hCombo, CB_SETCURSEL, 0, 0);
+        g_perf.Add(PERF_COUNT_SENDMESSAGE, 2);
+    }
+}
+
+void ExpandPicker(int slot)
+{
+    g_pickerQuery.clear(); // 드롭다운을 열 때마다 검색어 없이 전체 목록으로 시작
+    FillPicker(slot);
+}
+
+// 검색어가 없으면 레지스트리 전체, 있으면 검색 결과를 레지스트리 순서로 채움
+void FillPicker(int slot)
+{
+    HWND hCombo = g_slots.Cold(slot).combo;
+    if (!hCombo) return;
+    PerfScope perf(g_perf, PERF_PHASE_SEARCH);
+    bool filtered = g_presenter.Search(g_pickerQuery, g_pickerRows); // 결과는 목록(레지스트리) 순서
+
+    size_t count = filtered ? g_pickerRows.size() : g_registry.Size();
+    SendMessage(hCombo, WM_SETREDRAW, FALSE, 0);
+    SendMessage(hCombo, CB_RESETCONTENT, 0, 0);
+    SendMessage(hCombo, CB_INITSTORAGE, (WPARAM)count, 0); // 문자열 저장 공간은 필요 없음
+    for (size_t j = 0; j < count; j++) {
+        SendMessage(hCombo, CB_ADDSTRING, 0, (LPARAM)(filtered ? g_pickerRows[j] : g_registry.At(j).id));
+    }
+    int selIndex;
+    if (filtered) // 검색 중에는 첫 결과를 강조하여 Enter로 바로 고를 수 있게 함
+        selIndex = count > 0 ? 0 : -1;
+    else
+        selIndex = g_slots.Hot(slot).selected ? g_registry.IndexOf(g_slots.Hot(slot).selected) : -1;
+    SendMessage(hCombo, CB_SETCURSEL, selIndex, 0);
+    SendMessage(hCombo, WM_SETREDRAW, TRUE, 0);
+    InvalidateRect(hCombo, NULL, FALSE); // 본체에 표시되는 검색어 갱신
+    g_perf.Add(PERF_COUNT_SENDMESSAGE, count + 5);
+}
+
+void DrawPickerItem(const DRAWITEMSTRUCT* dis)
+{
+    bool selected = (dis->itemState & ODS_SELECTED) != 0;
+    FillRect(dis->hDC, &dis->rcItem, GetSysColorBrush(selected ? COLOR_HIGHLIGHT : COLOR_WINDOW));
+
+    // 열린 드롭다운의 본체에는 선택 항목 대신 입력 중인 검색어를 표시
+    if ((dis->itemState & ODS_COMBOBOXEDIT) && !g_pickerQuery.empty() &&
+        (int)dis->CtlID - IDC_COMBO1 == g_openPicker)
+    {
+        std::wstring text = L"검색: " + g_pickerQuery;
+        RECT rc = dis->rcItem;
+        rc.left += 3;
+        SetBkMode(dis->hDC, TRANSPARENT);
+        SetTextColor(dis->hDC, GetSysColor(selected ? COLOR_HIGHLIGHTTEXT : COLOR_WINDOWTEXT));
+        DrawText(dis->hDC, text.c_str(), (int)text.size(), &rc,
+                 DT_LEFT | DT_VCENTER | DT_SINGLELINE | DT_END_ELLIPSIS | DT_NOPREFIX);
+        return;
+    }
+    if (dis->itemID == (UINT)-1) // 선택 항목이 없는 콤보박스 본체
+        return;
+
+    // 항목 문자열은 보관하지 않고 그릴 때마다 레지스트리에서 읽음
+    const WindowRegistry::Entry* entry = g_registry.Find((WindowId)dis->itemData);
+    if (!entry)
+        return;
+    size_t length = 0;
+    const wchar_t* title = g_registry.Title(*entry, &length);
+
+    RECT rc = dis->rcItem;
+    rc.left += 3;
+    SetBkMode(dis->hDC, TRANSPARENT);
+    if (!g_hungWindows.empty() && g_hungWindows.count(entry->id))
+    {
+        // 응답 없는 창: 마지막으로 알려진 제목 앞에 표시를 붙임
+        RECT rcBadge = rc;
+        DrawText(dis->hDC, HUNG_BADGE_TEXT, -1, &rcBadge, DT_LEFT | DT_SINGLELINE | DT_NOPREFIX | DT_CALCRECT);
+        SetTextColor(dis->hDC, selected ? GetSysColor(COLOR_HIGHLIGHTTEXT) : HUNG_BADGE_COLOR);
+        DrawText(dis->hDC, HUNG_BADGE_TEXT, -1, &rc, DT_LEFT | DT_VCENTER | DT_SINGLELINE | DT_NOPREFIX);
+        rc.left = rcBadge.right + 4;
+    }
+    SetTextColor(dis->hDC, GetSysColor(selected ? COLOR_HIGHLIGHTTEXT : COLOR_WINDOWTEXT));
+    DrawText(dis->hDC, title, (int)length, &rc,
+             DT_LEFT | DT_VCENTER | DT_SINGLELINE | DT_END_ELLIPSIS | DT_NOPREFIX);
+}
+
+// 열린 드롭다운 목록에서 제목이 바뀐 행만 무효화 (목록 순서 = 레지스트리 순서)
+void RepaintOpenPickerRows(const WindowDiff& diff)
+{
+    if (g_openPicker < 0 || g_openPicker >= g_slots.Count() || !g_slots.Cold(g_openPicker).combo || diff.changed.empty())
+        return;
+    COMBOBOXINFO cbi = {};
+    cbi.cbSize = sizeof(cbi);
+    if (!GetComboBoxInfo(g_slots.Cold(g_openPicker).combo, &cbi) || !cbi.hwndList)
+        return;
+    for (size_t k = 0; k < diff.changed.size(); k++) {
+        int row;
+        if (g_pickerQuery.empty()) {
+            row = g_registry.IndexOf(diff.changed[k]);
+        } else { // 검색 중에는 걸러진 목록에서의 위치 (결과는 다음 입력 때까지 그대로 둠)
+            std::vector<WindowId>::const_iterator it = std::find(g_pickerRows.begin(), g_pickerRows.end(), diff.changed[k]);
+            row = (it == g_pickerRows.end()) ? -1 : (int)(it - g_pickerRows.begin());
+        }
+        RECT rcRow;
+        if (row < 0)
+            continue;
+        g_perf.Add(PERF_COUNT_SENDMESSAGE);
+        if (SendMessage(cbi.hwndList, LB_GETITEMRECT, row, (LPARAM)&rcRow) != LB_ERR) {
+            InvalidateRect(cbi.hwndList, &rcRow, FALSE); // 화면 밖 행은 클리핑되어 그려지지 않음
+        }
+    }
+}
+
+//=============================================================================
+// ApplyWindowDiff: 레지스트리 변경분을 닫힌 콤보박스들에 반영
+// - 닫힌 콤보박스는 선택된 창 하나만 가지므로 그 창이 사라졌거나 제목 버전이 바뀐 슬롯만 처리 (g_presenter가 골라냄)
+// - 드롭다운이 열려 있는 동안은 목록 변경 처리가 보류되므로 열린 목록은 여기서 다루지 않음
+//=============================================================================
+void ApplyWindowDiff(const WindowDiff& diff)
+{
+    static std::vector<int> removed, retitled; // 호출마다 할당하지 않도록 재사용
+    g_presenter.ApplyWindowDiff(diff, g_slots.HotData(), g_slots.Count(), removed, retitled);
+
+    // 1. 선택된 창이 목록에서 사라졌으면 콤보박스를 비움 (미리보기 자체는 창이 살아 있는 동안 유지)
+    for (size_t k = 0; k < removed.size(); k++)
+        CollapsePicker(removed[k]);
+
+    // 2. 마지막으로 그린 뒤 선택된 창의 제목 버전이 바뀌었으면 콤보박스 본체만 다시 그림 (항목 삭제/재삽입 없음)
+    for (size_t k = 0; k < retitled.size(); k++) {
+        int i = retitled[k];
+        if (g_slots.Cold(i).combo)
+            InvalidateRect(g_slots.Cold(i).combo, NULL, FALSE);
+
+        // 3. 제목 패턴이 달라졌을 때만 세션 저장 예약 (숫자만 바뀌는 시계/카운터 제목은 저장하지 않음)
+        const WindowRegistry::Entry* entry = g_registry.Find(g_slots.Hot(i).selected);
+        size_t length;
+        const wchar_t* title = g_registry.Title(*entry, &length);
+        MakeTitlePattern(title, length, g_patternBuffer);
+        SlotBinding& binding = g_slots.Cold(i).binding;
+        if (!binding.Empty() && g_patternBuffer != binding.titlePattern) {
+            binding.titlePattern.swap(g_patternBuffer);
+            ScheduleSave(g_hMainWnd);
+        }
+    }
+}
+
+// 창 제목을 길이 제한 없이 읽음 (buffer는 재사용되어 보통은 할당이 일어나지 않음)
+// 길이 질의는 대상 창에 보내는 메시지이므로 시간 제한을 두고, 응답 없는 창이면 기다리지 않고 false (buffer는 비움).
+// 제목 자체는 GetWindowText가 다른 프로세스의 창이면 메시지 없이 읽으므로 막히지 않음
+bool ReadWindowTitle(HWND hwnd, std::wstring& buffer)
+{
+    DWORD_PTR length = 0; // 실제보다 클 수는 있어도 작지는 않음
+    if (!SendMessageTimeout(hwnd, WM_GETTEXTLENGTH, 0, 0, SMTO_ABORTIFHUNG | SMTO_ERRORONEXIT,
+                            TITLE_QUERY_TIMEOUT, &length)) {
+        buffer.clear();
+        return !IsWindow(hwnd); // 그 사이 파괴된 창은 빈 제목으로 처리
+    }
+    if (length == 0) {
+        buffer.clear();
+        return true;
+    }
+    buffer.resize(length + 1);
+    int copied = GetWindowText(hwnd, &buffer[0], (int)length + 1);
+    buffer.resize(copied > 0 ? copied : 0);
+    return true;
+}
+
+// 창의 프로세스 실행 파일 이름(경로 제외)과 클래스 이름. 권한 부족 등으로 읽지 못한 값은 빈 문자열
+void ReadWindowOrigin(HWND hwnd, std::wstring& process, std::wstring& className)
+{
+    ReadWindowClass(hwnd, className);
+    ReadWindowProcess(hwnd, process);
+}
+
+void ReadWindowClass(HWND hwnd, std::wstring& className)
+{
+    WCHAR buffer[MAX_PATH];
+    int length = GetClassName(hwnd, buffer, MAX_PATH);
+    className.assign(buffer, length > 0 ? length : 0);
+}
+
+// 프로세스 핸들을 열어야 하므로 클래스 이름보다 훨씬 비쌈: 필요한 경우에만 호출
+void ReadWindowProcess(HWND hwnd, std::wstring& process)
+{
+    WCHAR buffer[MAX_PATH];
+    process.clear();
+    DWORD pid = 0;
+    GetWindowThreadProcessId(hwnd, &pid);
+    HANDLE hProcess = pid ? OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid) : NULL;
+    if (!hProcess)
+        return;
+    DWORD size = MAX_PATH;
+    if (QueryFullProcessImageName(hProcess, 0, buffer, &size))
+    {
+        const WCHAR* name = buffer;
+        for (DWORD i = 0; i < size; i++) {
+            if (buffer[i] == L'\\' || buffer[i] == L'/')
+                name = buffer + i + 1;
+        }
+        process.assign(name, (const WCHAR*)buffer + size);
+    }
+    CloseHandle(hProcess);
+}
+
+HFONT GetUiFont()
+{
+    if (!g_hFont)
+    {
+        g_hFont = CreateFont(ScaleDpi(UI_FONT_HEIGHT), 0, 0, 0,
+                             FW_NORMAL, FALSE, FALSE, FALSE,
+                             DEFAULT_CHARSET,
+                             OUT_DEFAULT_PRECIS,
+                             CLIP_DEFAULT_PRECIS,
+                             CLEARTYPE_QUALITY,  // 부드러운 텍스트 렌더링
+                             DEFAULT_PITCH | FF_DONTCARE,
+                             L"맑은 고딕");
+        g_fontDpi = g_monitor.dpi;
+    }
+    return g_hFont;
+}
+
+//=============================================================================
+// 모니터/DPI
+// - 매니페스트가 PerMonitorV2를 선언하므로 좌표는 실제 픽셀이고, 레이아웃 상수는 ScaleDpi로 모니터 배율에 맞춤
+// - GetDpiForWindow(Windows 10 1607+)가 없으면 시스템 DPI(화면 DC의 LOGPIXELSY)를 씀
+//=============================================================================
+static UINT QueryWindowDpi(HWND hWnd)
+{
+    typedef UINT (WINAPI* GetDpiForWindowProc)(HWND);
+    static GetDpiForWindowProc getDpiForWindow =
+        (GetDpiForWindowProc)(void*)GetProcAddress(GetModuleHandle(L"user32.dll"), "GetDpiForWindow");
+    UINT dpi = hWnd && getDpiForWindow ? getDpiForWindow(hWnd) : 0;
+    if (dpi == 0)
+    {
+        HDC hdc = GetDC(NULL);
+        dpi = (UINT)GetDeviceCaps(hdc, LOGPIXELSY);
+        ReleaseDC(NULL, hdc);
+    }
+    return dpi ? dpi : BASE_DPI;
+}
+
+bool RefreshMonitorMetrics(HWND hWnd, UINT dpi)
+{
+    MonitorMetrics metrics = {};
+    // 창이 아직 없으면(시작 시) 주 모니터 기준
+    metrics.monitor = MonitorFromWindow(hWnd, hWnd ? MONITOR_DEFAULTTONEAREST : MONITOR_DEFAULTTOPRIMARY);
+    MONITORINFO mi = {};
+    mi.cbSize = sizeof(mi);
+    if (GetMonitorInfo(metrics.monitor, &mi))
+        metrics.work = mi.rcWork;
+    else
+        SetRect(&metrics.work, 0, 0, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN));
+    metrics.dpi = dpi ? dpi : QueryWindowDpi(hWnd);
+
+    bool changed = metrics.monitor != g_monitor.monitor || !EqualRect(&metrics.work, &g_monitor.work) ||
+                   metrics.dpi != g_monitor.dpi;
+    g_monitor = metrics;
+    return changed;
+}
+
+int ScaleDpi(int px)
+{
+    return MulDiv(px, (int)g_monitor.dpi, BASE_DPI);
+}
+
+void ApplyMonitorMetrics(HWND hWnd)
+{
+    g_layout.SetPickerHeight(ScaleDpi(DROP_HEIGHT));
+    g_layout.SetPreviewHeight(ScaleDpi(PREVIEW_HEIGHT));
+
+    // 글꼴은 DPI가 바뀐 경우에만 다시 만듦 (콤보박스가 옛 글꼴을 쓰는 동안 지우지 않도록 새 글꼴을 먼저 설정)
+    if (g_hFont && g_fontDpi != g_monitor.dpi)
+    {
+        HFONT oldFont = g_hFont;
+        g_hFont = NULL;
+        HFONT font = GetUiFont();
+        for (int i = 0; i < g_slots.Count(); i++)
+        {
+            HWND hCombo = g_slots.Cold(i).combo;
+            if (!hCombo)
+                continue;
+            SendMessage(hCombo, WM_SETFONT, (WPARAM)font, FALSE);
+            // WM_MEASUREITEM은 생성 시에만 오므로 선택 영역(-1)/목록 항목 높이는 직접 바꿈
+            SendMessage(hCombo, CB_SETITEMHEIGHT, (WPARAM)-1, ScaleDpi(PICKER_ITEM_HEIGHT));
+            SendMessage(hCombo, CB_SETITEMHEIGHT, 0, ScaleDpi(PICKER_ITEM_HEIGHT));
+        }
+        DeleteObject(oldFont);
+        if (g_hPerfFont)
+        {
+            DeleteObject(g_hPerfFont);
+            g_hPerfFont = CreatePerfFont();
+        }
+    }
+
+    UpdateGridArea(hWnd);
+    g_frame.InvalidateAll(); // 썸네일 목적지/콤보박스 위치를 모두 다시 적용
+    UpdatePreviewLayout(hWnd);
+    if (g_hPerfOverlay)
+        UpdatePerfOverlay(hWnd);
+    InvalidateRect(hWnd, NULL, FALSE);
+}
+
+//=============================================================================
+// 슬롯 콤보박스 생성/파괴
+// - 콤보박스 ID는 IDC_COMBO1 + 슬롯 인덱스. 슬롯이 삽입/제거/이동되면 RenumberPickers로 ID만 다시 매김
+//   (서브클래스 콜백은 ID에서 슬롯 인덱스를 구하므로 콤보박스를 다시 만들 필요 없음)
+//=============================================================================
+void CreatePicker(HWND hWnd, int slot)
+{
+    // 초기 위치는 임시값, 이후 UpdatePreviewLayout에서 배치에 맞춰 이동
+    HWND hCombo = CreateWindowEx(0, TEXT("COMBOBOX"), NULL,
+        WS_CHILD | WS_VISIBLE | CBS_DROPDOWNLIST | CBS_OWNERDRAWFIXED, // 자식 윈도우, 보임, 드롭다운 목록, 오너 드로우(항목 데이터만 보관)
+        0, 0, g_layout.DefaultSlotWidth(), ScaleDpi(DROP_HEIGHT), // 위치 및 크기
+        hWnd, (HMENU)(INT_PTR)(IDC_COMBO1 + slot), // 부모 윈도우, 컨트롤 ID
+        g_hInst, NULL);
+    g_slots.Cold(slot).combo = hCombo;
+    g_slots.Hot(slot).titleVersion = 0;
+    SetWindowSubclass(hCombo, ComboSubclassProc, 0, 0); // 콤보박스 서브클래스 설정
+    SendMessage(hCombo, WM_SETFONT, (WPARAM)GetUiFont(), TRUE); // 폰트 설정
+    SetWindowTheme(hCombo, L"", L""); // 콤보박스 테마 초기화 (클래식 스타일 적용 시도)
+}
+
+void DestroyPicker(int slot)
+{
+    HWND hCombo = g_slots.Cold(slot).combo;
+    if (!hCombo) return;
+    RemoveWindowSubclass(hCombo, ComboSubclassProc, 0); // 서브클래스 해제
+    DestroyWindow(hCombo); // 콤보박스 윈도우 파괴
+    g_slots.Cold(slot).combo = NULL;
+}
+
+// first 이후 슬롯들의 콤보박스 ID를 현재 인덱스에 맞게 다시 매김
+void RenumberPickers(int first)
+{
+    for (int i = first; i < g_slots.Count(); i++) {
+        if (g_slots.Cold(i).combo)
+            SetWindowLongPtr(g_slots.Cold(i).combo, GWLP_ID, (LONG_PTR)(IDC_COMBO1 + i));
+    }
+}
+
+//=============================================================================
+// RecreatePreviews: 모든 콤보박스(드롭다운) 컨트롤을 새로 생성하며, 기존 선택 상태 보존
+// - 시작 시 호출됨 (슬롯 추가/제거/이동은 해당 콤보박스만 생성/파괴하고 ID를 다시 매김)
+//=============================================================================
+void RecreatePreviews(HWND hWnd)
+{
+    PerfScope perf(g_perf, PERF_PHASE_RECREATE);
+    // 1. 기존 콤보박스 제거 (DWM 썸네일 핸들은 유지)
+    for (int i = 0; i < g_slots.Count(); i++) {
+        DestroyPicker(i);
+    }
+
+    // 2. 슬롯 개수만큼 새로운 콤보박스 생성
+    g_frame.InvalidateAll(); // 새 콤보박스는 다음 배치에서 반드시 위치를 다시 적용
+    for (int i = 0; i < g_slots.Count(); i++) {
+        CreatePicker(hWnd, i);
+    }
+
+    // 3. 슬롯에 선택된 창을 기반으로 콤보박스 선택 상태 복원
+    //    목록 전체는 드롭다운을 열 때 레지스트리에서 채우므로 여기서는 선택 항목 하나만 넣음.
+    for (int i = 0; i < g_slots.Count(); i++) {
+        if (g_slots.Hot(i).selected && !g_registry.Find(g_slots.Hot(i).selected)) {
+            g_slots.Hot(i).selected = 0; // 목록에 없는 창이면 실제 선택 상태를 반영
+        }
+        CollapsePicker(i);
+    }
+}
+
+//=============================================================================
+// 슬롯 추가/제거/이동: 슬롯 저장소, 원본 크기 캐시, 활동 감시, 화면 기록을 같은 순서로 옮기고, 바뀐 콤보박스만 처리
+// - 옮겨진 슬롯의 DWM 썸네일 핸들은 그대로 유지됨 (목적지 사각형만 다음 배치에서 갱신)
+//=============================================================================
+void InsertSlot(HWND hWnd, int index)
+{
+    g_slots.Insert(index);
+    g_sizeCache.Insert(index);
+    g_activity.Insert(index);
+    g_recorder.Insert(index);
+    CreatePicker(hWnd, index);
+    RenumberPickers(index + 1);
+    g_frame.InvalidateAll(); // 뒤쪽 슬롯들은 위치가 바뀜
+    UpdatePreviewLayout(hWnd);
+}
+
+void RemoveSlot(HWND hWnd, int index)
+{
+    if (g_slots.Hot(index).thumbnail) {
+        g_backend->Unregister(g_slots.Hot(index).thumbnail); // 제거되는 슬롯의 썸네일만 해제
+        g_perf.Add(PERF_COUNT_DWM);
+    }
+    DestroyPicker(index);
+    g_slots.Erase(index);
+    g_sizeCache.Erase(index);
+    g_activity.Erase(index);
+    g_recorder.Erase(index);
+    RenumberPickers(index);
+    g_frame.InvalidateAll();
+    UpdatePreviewLayout(hWnd);
+}
+
+void MoveSlot(HWND hWnd, int from, int to)
+{
+    g_slots.Move(from, to);
+    g_sizeCache.Move(from, to);
+    g_activity.Move(from, to);
+    g_recorder.Move(from, to);
+    RenumberPickers(from < to ? from : to);
+    g_frame.InvalidateAll();
+    UpdatePreviewLayout(hWnd);
+}
+
+// 화면(메인 윈도우가 있는 모니터)에 담을 수 있는 최대 슬롯 개수 (캐시한 모니터 정보와 DPI 기준)
+int MaxSlotCount()
+{
+    int defaultWidth = g_layout.DefaultSlotWidth();
+    if (!g_gridLayout)
+    {
+        // 가로 한 줄 배치: 모니터 작업 영역 너비에 (DPI 배율을 적용한) 기본 너비 슬롯이 들어가는 개수
+        int count = (g_monitor.work.right - g_monitor.work.left) / (defaultWidth > 0 ? defaultWidth : 1);
+        return count < 1 ? 1 : count;
+    }
+    // 격자 배치: 작업 영역에 최소 썸네일 높이의 기본 비율 슬롯이 들어가는 개수
+    int minHeight = ScaleDpi(MIN_GRID_PREVIEW_HEIGHT);
+    int minWidth = minHeight * PREVIEW_ASPECT_RATIO_NUMERATOR / PREVIEW_ASPECT_RATIO_DENOMINATOR;
+    int columns = (g_monitor.work.right - g_monitor.work.left) / (minWidth > 0 ? minWidth : 1);
+    int rows = (g_monitor.work.bottom - g_monitor.work.top) / (ScaleDpi(DROP_HEIGHT) + minHeight);
+    int count = columns * rows;
+    return count < 1 ? 1 : count;
+}
+
+//=============================================================================
+// ComboSubclassProc: 콤보박스 서브클래스 콜백 (extern "C" 명시로 이름 맹글링 문제 방지)
+// - 콤보박스 자체의 마우스 휠 이벤트를 처리하여 항목 변경
+//=============================================================================
+extern "C" LRESULT CALLBACK ComboSubclassProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam,
+                                                UINT_PTR uIdSubclass, DWORD_PTR dwRefData)
+{
+    UNREFERENCED_PARAMETER(dwRefData); // dwRefData는 사용되지 않음
+    switch (uMsg)
+    {
+        case WM_MOUSEWHEEL: // 마우스 휠 이벤트 처리
+        {
+            // 닫힌 콤보박스는 선택 항목 하나만 가지므로 레지스트리 순서를 기준으로 이전/다음 창을 선택
+            short delta = GET_WHEEL_DELTA_WPARAM(wParam); // 휠 스크롤 방향 (양수: 위, 음수: 아래)
+            int slot = GetDlgCtrlID(hWnd) - IDC_COMBO1;   // 콤보박스 ID = IDC_COMBO1 + 슬롯 인덱스
+            if (slot < 0 || slot >= g_slots.Count())
+                return 0;
+            int curSel = g_slots.Hot(slot).selected ? g_registry.IndexOf(g_slots.Hot(slot).selected) : -1; // 현재 선택 위치
+            int count = (int)g_registry.Size();           // 전체 창 개수
+            int newSel = curSel;
+            if (delta > 0 && curSel > 0) // 위로 스크롤 & 현재 선택이 첫 항목이 아닐 때
+                newSel = curSel - 1;
+            else if (delta < 0 && curSel < count - 1) // 아래로 스크롤 & 현재 선택이 마지막 항목이 아닐 때
+                newSel = curSel + 1;
+            if (newSel != curSel)
+            {
+                SendMessage(hWnd, CB_RESETCONTENT, 0, 0);
+                SendMessage(hWnd, CB_ADDSTRING, 0, (LPARAM)g_registry.At(newSel).id); // 새 항목 하나만 보관
+                SendMessage(hWnd, CB_SETCURSEL, 0, 0);
+                // 부모 윈도우에 CBN_SELCHANGE 메시지를 보내 선택 변경 알림
+                SendMessage(GetParent(hWnd), WM_COMMAND,
+                            MAKEWPARAM(GetDlgCtrlID(hWnd), CBN_SELCHANGE), (LPARAM)hWnd);
+            }
+            return 0; // 메시지 처리 완료
+        }
+        case WM_CHAR: // 드롭다운이 열려 있으면 입력한 글자를 검색어로 사용 (기본 처리인 첫 글자 이동 대신)
+        {
+            int slot = GetDlgCtrlID(hWnd) - IDC_COMBO1;
+            if (slot != g_openPicker || !SendMessage(hWnd, CB_GETDROPPEDSTATE, 0, 0))
+                break;
+            WCHAR ch = (WCHAR)wParam;
+            if (ch == VK_BACK) {
+                if (g_pickerQuery.empty())
+                    return 0;
+                g_pickerQuery.erase(g_pickerQuery.size() - 1);
+            } else if (ch >= 0x20) {
+                g_pickerQuery += ch;
+            } else {
+                break; // Enter/Esc 등은 기본 처리
+            }
+            FillPicker(slot);
+            return 0;
+        }
+        case WM_ERASEBKGND: // 배경 지우기 메시지 무시하여 깜빡임 감소
+            return 1;
+        case WM_NCDESTROY: // 서브클래스 해제 시 처리 (제거 시점 명확화)
+            RemoveWindowSubclass(hWnd, ComboSubclassProc, uIdSubclass);
+            break;
+    }
+    return DefSubclassProc(hWnd, uMsg, wParam, lParam); // 기본 처리기로 메시지 전달
+}
+
+//=============================================================================
+// ListSubclassProc: 드롭다운 리스트 서브클래스 콜백 (extern "C" 명시로 이름 맹글링 문제 방지)
+// - 콤보박스의 드롭다운 리스트박스에 대한 마우스 휠 이벤트를 처리하여 항목 변경
+//=============================================================================
+extern "C" LRESULT CALLBACK ListSubclassProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam,
+                                               UINT_PTR uIdSubclass, DWORD_PTR dwRefData)
+{
+    // dwRefData는 이 리스트박스와 연결된 콤보박스 핸들 (SetWindowSubclass에서 설정)
+    HWND hCombo = (HWND)dwRefData; 
+    UNREFERENCED_PARAMETER(uIdSubclass); // uIdSubclass는 사용되지 않음
+
+    switch (uMsg)
+    {
+        case WM_MOUSEWHEEL: // 마우스 휠 이벤트 처리
+        {
+            short delta = GET_WHEEL_DELTA_WPARAM(wParam);
+            int curSel = (int)SendMessage(hCombo, CB_GETCURSEL, 0, 0);
+            int count = (int)SendMessage(hCombo, CB_GETCOUNT, 0, 0);
+            if (delta > 0 && curSel > 0)
+            {
+                curSel--;
+                SendMessage(hCombo, CB_SETCURSEL, curSel, 0);
+                SendMessage(GetParent(hCombo), WM_COMMAND,
                             MAKEWPARAM(GetDlgCtrlID(hCombo), CBN_SELCHANGE), (LPARAM)hCombo);
             }
             else if (delta < 0 && curSel < count - 1)
@@ -438,138 +2219,953 @@ extern "C" LRESULT CALLBACK ListSubclassProc(HWND hWnd, UINT uMsg, WPARAM wParam
             RemoveWindowSubclass(hWnd, ListSubclassProc, uIdSubclass);
             break;
     }
-    return DefSubclassProc(hWnd, uMsg, wParam, lParam); // 기본 처리기로 메시지 전달
+    return DefSubclassProc(hWnd, uMsg, wParam, lParam); // 기본 처리기로 메시지 전달
+}
+
+//=============================================================================
+// GetSegmentIndexAtPoint: 주어진 클라이언트 좌표에 해당하는 미리보기 슬롯 인덱스 반환
+// - 더블 클릭 또는 우클릭 시 어떤 슬롯이 클릭되었는지 판별하는 헬퍼 함수
+// - 마지막으로 계산된 배치에서 이진 탐색 (DWM 질의 없음)
+//=============================================================================
+int GetSegmentIndexAtPoint(POINT pt)
+{
+    return g_layout.HitTest(pt.x, pt.y);
+}
+
+//=============================================================================
+// UpdatePreviewLayout: 미리보기 슬롯의 DWM 썸네일과 콤보박스 배치를 갱신
+// - 선택 변경, 슬롯 추가/제거, 감시 대상 창의 크기 변경 또는 안전 점검 시 호출됨
+//=============================================================================
+void UpdatePreviewLayout(HWND hWnd)
+{
+    PerfScope perf(g_perf, PERF_PHASE_LAYOUT);
+    int count = g_slots.Count();
+    g_activity.Resize(count);
+    g_recorder.Resize(count);
+
+    // 1~2. 슬롯별 썸네일 등록/해제와 원본 크기(캐시가 무효화된 경우만 질의)로 배치를 계산하고
+    //      마지막으로 적용한 배치와 비교 (바뀐 것만 적용 대상). 알림 테두리 자리는 AlertInset만큼 비움
+    g_presenter.BuildFrame(g_slots.HotData(), count);
+
+    // 3. 메인 윈도우의 전체 크기 조정 (가장 넓은 줄의 너비, 줄 수에 맞춰)
+    if (g_layout.TotalWidth() != g_windowWidth || g_layout.TotalHeight() != g_windowHeight)
+    {
+        g_windowWidth = g_layout.TotalWidth();
+        g_windowHeight = g_layout.TotalHeight();
+        RECT rcClient = {0, 0, g_windowWidth, g_windowHeight};
+        // 클라이언트 영역 크기에 맞춰 윈도우 실제 크기 계산 (타이틀바 없는 팝업 윈도우이므로 거의 동일)
+        AdjustWindowRect(&rcClient, GetWindowLong(hWnd, GWL_STYLE), FALSE);
+        int newW = rcClient.right - rcClient.left;
+        int newH = rcClient.bottom - rcClient.top;
+        RECT rc;
+        GetWindowRect(hWnd, &rc); // 현재 윈도우의 화면 좌표 가져오기
+        // 윈도우 크기만 변경 (위치 및 Z-오더는 유지)
+        SetWindowPos(hWnd, NULL, rc.left, rc.top, newW, newH,
+                     SWP_NOZORDER | SWP_NOACTIVATE);
+    }
+
+    uint64_t commitStart = g_perf.Now(); // 4~5단계(적용)는 따로 시간을 잼
+
+    // 4. 위치가 바뀐 콤보박스들을 DeferWindowPos로 한 번에 이동 (변경 없으면 호출 없음)
+    const std::vector<int>& pickerUpdates = g_frame.PickerUpdates();
+    if (!pickerUpdates.empty())
+    {
+        HDWP hdwp = BeginDeferWindowPos((int)pickerUpdates.size());
+        for (size_t k = 0; k < pickerUpdates.size() && hdwp; k++)
+        {
+            int i = pickerUpdates[k];
+            if (!g_slots.Cold(i).combo) continue;
+            const LayoutRect& rcPicker = g_frame.Pending(i).picker;
+            hdwp = DeferWindowPos(hdwp, g_slots.Cold(i).combo, NULL, rcPicker.left, rcPicker.top,
+                                  rcPicker.Width(), rcPicker.Height(), SWP_NOZORDER | SWP_NOACTIVATE);
+            g_perf.Add(PERF_COUNT_DEFERPOS);
+        }
+        if (hdwp)
+            EndDeferWindowPos(hdwp);
+        for (size_t k = 0; k < pickerUpdates.size(); k++)
+        {
+            int i = pickerUpdates[k];
+            // 너비가 바뀐 경우에만 드롭다운 리스트의 너비도 콤보박스 너비에 맞춰 설정
+            const FrameCommitter::SlotFrame& prev = g_frame.Committed(i);
+            int width = g_frame.Pending(i).picker.Width();
+            if (g_slots.Cold(i).combo && (!prev.applied || prev.picker.Width() != width))
+            {
+                SendMessage(g_slots.Cold(i).combo, CB_SETDROPPEDWIDTH, (WPARAM)width, 0);
+                g_perf.Add(PERF_COUNT_SENDMESSAGE);
+            }
+        }
+    }
+
+    // 5. 목적지가 바뀐 썸네일 속성을 연달아 보내 같은 합성 프레임에 반영되도록 함 (슬롯당 1회).
+    //    이전 목적지 영역은 썸네일이 비켜난 자리에 잔상이 남지 않도록 다시 그림
+    const std::vector<int>& thumbnailUpdates = g_frame.ThumbnailUpdates();
+    for (size_t k = 0; k < thumbnailUpdates.size(); k++)
+    {
+        int i = thumbnailUpdates[k];
+        const FrameCommitter::SlotFrame& prev = g_frame.Committed(i);
+        if (prev.applied && prev.hasThumbnail && prev.thumbnail != g_frame.Pending(i).thumbnail)
+        {
+            RECT rcOld = { prev.thumbnail.left, prev.thumbnail.top, prev.thumbnail.right, prev.thumbnail.bottom };
+            InvalidateRect(hWnd, &rcOld, FALSE);
+        }
+    }
+    g_presenter.Commit(g_slots.HotData());
+    ArmCaptureTimer(hWnd);
+    g_perf.Record(PERF_PHASE_COMMIT, g_perf.Now() - commitStart);
+    if (!g_firstThumbnailTime && !thumbnailUpdates.empty())
+    {
+        if (g_startupTiming)
+            g_backend->Flush(); // 측정 모드에서는 썸네일이 실제로 합성될 때까지 기다린 뒤 시각을 잼
+        g_firstThumbnailTime = PerfClockMicros();
+    }
+
+    // 6. 크기 변경을 추적할 창 목록 갱신 (미리보기 중인 창만)
+    static std::vector<WindowId> watched;
+    SlotPresenter::CollectWatched(g_slots.HotData(), g_slots.Count(), watched);
+    g_worker.SetWatched(watched);
+}
+
+// 캡처로 그리는 썸네일이 있을 때만 갱신 타이머를 둠 (DWM만 쓰는 평소에는 깨어나지 않음)
+void ArmCaptureTimer(HWND hWnd)
+{
+    bool needed = g_captureBackend.Count() > 0;
+    if (needed == g_captureTimer)
+        return;
+    g_captureTimer = needed;
+    if (needed)
+        SetTimer(hWnd, ID_CAPTURE_TIMER, CAPTURE_INTERVAL, NULL);
+    else
+        KillTimer(hWnd, ID_CAPTURE_TIMER);
+}
+
+//=============================================================================
+// 슬롯 활동 감시
+// - 사용자가 켠 슬롯만 표본을 뜸 (캡처 버퍼 재사용, 64x36으로 축소해 비교). 감시 슬롯이 없으면 타이머도 없음
+// - 알림이 켜진 슬롯은 썸네일을 ALERT_BORDER만큼 안으로 줄이고 그 자리에 테두리를 그림
+//   (변경: 주황, 멈춤: 빨강). 켜진 뒤 ALERT_FLASH_MILLIS 동안은 깜빡임
+//=============================================================================
+static bool AlertFlashing(int slot, uint64_t now)
+{
+    return g_activity.Alert(slot) != ALERT_NONE && now - g_activity.AlertTime(slot) < ALERT_FLASH_MILLIS;
+}
+
+// 알림이 켜진 슬롯은 썸네일을 테두리 두께만큼 안으로 줄여 테두리 자리를 비움 (g_presenter의 배치 단계가 호출)
+static int AlertInset(void* context, int slot)
+{
+    UNREFERENCED_PARAMETER(context);
+    return g_activity.Alert(slot) != ALERT_NONE ? ScaleDpi(ALERT_BORDER) : 0;
+}
+
+// 슬롯 썸네일 영역 가장자리의 테두리 띠 4개 (위, 아래, 왼쪽, 오른쪽)
+static void AlertBorderStrips(int slot, RECT strips[4])
+{
+    const LayoutRect& rc = g_layout.Slot(slot).thumbnail;
+    int border = ScaleDpi(ALERT_BORDER);
+    SetRect(&strips[0], rc.left, rc.top, rc.right, rc.top + border);
+    SetRect(&strips[1], rc.left, rc.bottom - border, rc.right, rc.bottom);
+    SetRect(&strips[2], rc.left, rc.top + border, rc.left + border, rc.bottom - border);
+    SetRect(&strips[3], rc.right - border, rc.top + border, rc.right, rc.bottom - border);
+}
+
+void InvalidateAlertBorder(HWND hWnd, int slot)
+{
+    if (slot < 0 || slot >= g_layout.SlotCount())
+        return;
+    RECT strips[4];
+    AlertBorderStrips(slot, strips);
+    for (int k = 0; k < 4; k++)
+        InvalidateRect(hWnd, &strips[k], FALSE);
+}
+
+void PaintAlertBorders(HDC hdc, const RECT& area)
+{
+    static HBRUSH s_changedBrush = NULL; // 한 번 만들어 계속 씀
+    static HBRUSH s_idleBrush = NULL;
+    uint64_t now = GetTickCount64();
+    int count = g_slots.Count() < g_layout.SlotCount() ? g_slots.Count() : g_layout.SlotCount();
+    for (int i = 0; i < count; i++)
+    {
+        ActivityAlert alert = g_activity.Alert(i);
+        if (alert == ALERT_NONE)
+            continue;
+        // 깜빡이는 동안에는 꺼진 반주기에 그리지 않음 (배경이 그대로 보임)
+        if (AlertFlashing(i, now) && ((now - g_activity.AlertTime(i)) / ALERT_FLASH_INTERVAL) % 2 == 1)
+            continue;
+        if (!s_changedBrush)
+            s_changedBrush = CreateSolidBrush(RGB(255, 176, 0));
+        if (!s_idleBrush)
+            s_idleBrush = CreateSolidBrush(RGB(220, 40, 40));
+        RECT strips[4], clip;
+        AlertBorderStrips(i, strips);
+        for (int k = 0; k < 4; k++)
+        {
+            if (IntersectRect(&clip, &strips[k], &area))
+                FillRect(hdc, &strips[k], alert == ALERT_CHANGED ? s_changedBrush : s_idleBrush);
+        }
+    }
+}
+
+// 표본 시각이 된 감시 슬롯의 표본을 뜨고 멈춤 판정. 알림이 바뀐 슬롯은 썸네일을 줄이거나 되돌리고 작업 표시줄 버튼을 깜빡임
+void RunActivityMonitor(HWND hWnd)
+{
+    uint64_t now = GetTickCount64();
+    int count = g_slots.Count();
+    static std::vector<ActivityAlert> before; // 틱마다 할당하지 않도록 재사용
+    before.resize(count);
+    for (int i = 0; i < count; i++)
+        before[i] = g_activity.Alert(i);
+
+    for (int slot = g_activity.NextDue(now); slot >= 0; slot = g_activity.NextDue(now))
+    {
+        HWND source = (HWND)g_slots.Hot(slot).selected;
+        uint64_t start = PerfClockMicros();
+        PixelImage frame;
+        if (source && IsWindow(source) &&
+            g_captureBackend.CaptureSample(source, ActivityMonitor::SAMPLE_WIDTH, ActivityMonitor::SAMPLE_HEIGHT, &frame))
+            g_activity.Submit(slot, frame, now);
+        else
+            g_activity.Skip(slot, now);
+        g_activity.Charge(PerfClockMicros() - start); // 실패한 시도도 예산에서 뺌
+    }
+    g_activity.CheckIdle(now);
+
+    bool layoutChanged = false;
+    bool raised = false;
+    for (int i = 0; i < count; i++)
+    {
+        ActivityAlert alert = g_activity.Alert(i);
+        if (alert != before[i])
+        {
+            layoutChanged |= (alert == ALERT_NONE) != (before[i] == ALERT_NONE);
+            raised |= alert != ALERT_NONE;
+            InvalidateAlertBorder(hWnd, i);
+        }
+        else if (AlertFlashing(i, now))
+        {
+            InvalidateAlertBorder(hWnd, i); // 깜빡임 반주기 전환
+        }
+    }
+    if (layoutChanged)
+        UpdatePreviewLayout(hWnd); // 썸네일 목적지를 테두리 안쪽으로 줄이거나 되돌림
+    if (raised && GetForegroundWindow() != hWnd)
+    {
+        FLASHWINFO flash = { sizeof(flash), hWnd, FLASHW_TRAY | FLASHW_TIMERNOFG, 0, 0 };
+        FlashWindowEx(&flash);
+    }
+    ArmActivityTimer(hWnd);
+}
+
+// 다음 표본/멈춤 판정 시각과 깜빡임 전환 시각 중 이른 쪽에 맞춰 타이머 재설정
+void ArmActivityTimer(HWND hWnd)
+{
+    uint64_t now = GetTickCount64();
+    uint64_t wakeup = g_activity.NextWakeup(now);
+    for (int i = 0; i < g_slots.Count(); i++)
+    {
+        if (!AlertFlashing(i, now))
+            continue;
+        uint64_t elapsed = now - g_activity.AlertTime(i);
+        uint64_t toggle = now + ALERT_FLASH_INTERVAL - elapsed % ALERT_FLASH_INTERVAL;
+        if (elapsed + (toggle - now) >= ALERT_FLASH_MILLIS)
+            toggle = g_activity.AlertTime(i) + ALERT_FLASH_MILLIS; // 마지막에는 켜진 상태로 멈춤
+        if (!wakeup || toggle < wakeup)
+            wakeup = toggle;
+    }
+    if (!wakeup)
+    {
+        if (g_activityTimer)
+            KillTimer(hWnd, ID_ACTIVITY_TIMER);
+        g_activityTimer = false;
+        return;
+    }
+    UINT delay = wakeup > now ? (UINT)(wakeup - now) : USER_TIMER_MINIMUM;
+    SetTimer(hWnd, ID_ACTIVITY_TIMER, delay, NULL); // 같은 ID로 다시 설정하면 기존 타이머를 대체함
+    g_activityTimer = true;
+}
+
+void SetSlotWatch(HWND hWnd, int slot, ActivityWatch watch)
+{
+    if (slot < 0 || slot >= g_slots.Count())
+        return;
+    bool hadAlert = g_activity.Alert(slot) != ALERT_NONE;
+    if (watch != ACTIVITY_OFF) // 표본 DIB는 감시를 켤 때 만듦
+        g_captureBackend.PrepareSample(ActivityMonitor::SAMPLE_WIDTH, ActivityMonitor::SAMPLE_HEIGHT);
+    g_activity.SetWatch(slot, watch, GetTickCount64());
+    if (hadAlert)
+    {
+        InvalidateAlertBorder(hWnd, slot);
+        UpdatePreviewLayout(hWnd);
+    }
+    ArmActivityTimer(hWnd);
+}
+
+void AcknowledgeAlert(HWND hWnd, int slot)
+{
+    if (slot < 0 || slot >= g_slots.Count() || g_activity.Alert(slot) == ALERT_NONE)
+        return;
+    g_activity.Acknowledge(slot, GetTickCount64());
+    InvalidateAlertBorder(hWnd, slot);
+    UpdatePreviewLayout(hWnd);
+    ArmActivityTimer(hWnd);
+}
+
+//=============================================================================
+// 슬롯 화면 기록
+// - 사용자가 켠 슬롯만 RecordIntervalMillis마다 캡처를 160x90으로 줄여 슬롯별 링 버퍼에 차이로 쌓음 (framerecorder.h)
+// - 링과 프레임 버퍼는 기록을 켤 때 할당하므로 타이머마다 하는 일에는 할당이 없음
+// - "기록 저장"은 링을 파일 형식 버퍼로 복사만 하고 파일 쓰기는 RecordingWriter 스레드가 함
+//=============================================================================
+void RunRecorder(HWND hWnd)
+{
+    uint64_t now = GetTickCount64();
+    for (int slot = g_recorder.NextDue(now); slot >= 0; slot = g_recorder.NextDue(now))
+    {
+        HWND source = (HWND)g_slots.Hot(slot).selected;
+        PixelImage frame;
+        // 기록을 켤 때 맞춘 캡처 버퍼에 들어가면 PrintWindow/화면 복사 후 축소, 더 커졌으면 화면에서 바로 기록 크기로
+        // 줄여 읽음 (어느 쪽이든 기록 중에는 버퍼를 키우지 않음)
+        if (source && IsWindow(source) &&
+            (g_captureBackend.CaptureWindow(source, &frame, g_recordCaptureCx, g_recordCaptureCy) ||
+             g_captureBackend.CaptureSample(source, FrameRecorder::RECORD_WIDTH, FrameRecorder::RECORD_HEIGHT, &frame)))
+            g_recorder.Submit(slot, frame, now);
+        else
+            g_recorder.Skip(slot, now); // 최소화/닫힌 창은 이번 프레임을 건너뜀 (기록에는 시간 간격으로 남음)
+    }
+    ArmRecordTimer(hWnd);
+}
+
+void ArmRecordTimer(HWND hWnd)
+{
+    uint64_t now = GetTickCount64();
+    uint64_t wakeup = g_recorder.NextWakeup(now);
+    if (!wakeup)
+    {
+        if (g_recordTimer)
+            KillTimer(hWnd, ID_RECORD_TIMER);
+        g_recordTimer = false;
+        return;
+    }
+    UINT delay = wakeup > now ? (UINT)(wakeup - now) : USER_TIMER_MINIMUM;
+    SetTimer(hWnd, ID_RECORD_TIMER, delay, NULL);
+    g_recordTimer = true;
+}
+
+void SetSlotRecording(HWND hWnd, int slot, bool on)
+{
+    if (slot < 0 || slot >= g_slots.Count())
+        return;
+    HWND source = (HWND)g_slots.Hot(slot).selected;
+    if (on && source)
+    {
+        // 기록 중에는 버퍼를 키우지 않도록 지금 캡처 상한을 정함: 대상 창이 있는 모니터 크기 (클라이언트 영역이 더 크면 그 크기).
+        // 공유 캡처 DIB와 축소 중간 버퍼를 그만큼 미리 할당하고, 나중에 상한보다 커진 창은 표본 DIB로 바로 줄여 기록
+        MONITORINFO mi = {};
+        mi.cbSize = sizeof(mi);
+        RECT rc = {};
+        int cx = 0, cy = 0;
+        if (GetMonitorInfo(MonitorFromWindow(source, MONITOR_DEFAULTTONEAREST), &mi))
+        {
+            cx = mi.rcMonitor.right - mi.rcMonitor.left;
+            cy = mi.rcMonitor.bottom - mi.rcMonitor.top;
+        }
+        if (GetClientRect(source, &rc))
+        {
+            cx = rc.right > cx ? rc.right : cx;
+            cy = rc.bottom > cy ? rc.bottom : cy;
+        }
+        if (cx > 0 && cy > 0 && g_captureBackend.ReserveCapture(cx, cy))
+        {
+            g_recorder.Reserve(cx, cy);
+            g_recordCaptureCx = cx > g_recordCaptureCx ? cx : g_recordCaptureCx;
+            g_recordCaptureCy = cy > g_recordCaptureCy ? cy : g_recordCaptureCy;
+        }
+        g_captureBackend.PrepareSample(FrameRecorder::RECORD_WIDTH, FrameRecorder::RECORD_HEIGHT);
+    }
+    g_recorder.SetRecording(slot, on, GetTickCount64());
+    ArmRecordTimer(hWnd);
+}
+
+//=============================================================================
+// RecordingWriter: 기록 파일을 쓰는 스레드
+// - UI 스레드가 Buffer()에 파일 내용을 채우고 Start하면, 스레드가 RECORD_WRITE_CHUNK씩 나눠 쓴 뒤
+//   메인 윈도우에 WM_APP_RECORDING_SAVED를 게시. UI 스레드는 그 메시지에서 Finish로 스레드를 닫음
+// - 한 번에 하나만 씀 (Busy 동안 "기록 저장" 비활성화). 버퍼 용량은 다음 저장에 재사용
+//=============================================================================
+class RecordingWriter
+{
+public:
+    RecordingWriter() : m_thread(NULL), m_hMain(NULL), m_ok(false) { m_path[0] = 0; }
+
+    bool Busy() const { return m_thread != NULL; }
+    std::vector<uint8_t>& Buffer() { return m_buffer; } // Busy가 아닐 때만 UI 스레드가 채움
+    const wchar_t* Path() const { return m_path; }
+    bool Start(HWND hMain, const wchar_t* path);
+    bool Finish(); // 스레드가 끝나기를 기다리고 닫음. 파일을 온전히 썼으면 true
+
+private:
+    static DWORD WINAPI ThreadProc(LPVOID param);
+    void Run();
+
+    HANDLE m_thread;
+    HWND m_hMain;
+    wchar_t m_path[MAX_PATH];
+    std::vector<uint8_t> m_buffer;
+    bool m_ok; // 스레드가 쓰고 Finish 뒤에 UI 스레드가 읽음
+};
+
+RecordingWriter g_recordingWriter;
+
+bool RecordingWriter::Start(HWND hMain, const wchar_t* path)
+{
+    if (m_thread || m_buffer.empty())
+        return false;
+    m_hMain = hMain;
+    lstrcpyn(m_path, path, MAX_PATH);
+    m_ok = false;
+    m_thread = CreateThread(NULL, 0, ThreadProc, this, 0, NULL);
+    return m_thread != NULL;
+}
+
+bool RecordingWriter::Finish()
+{
+    if (!m_thread)
+        return false;
+    WaitForSingleObject(m_thread, INFINITE);
+    CloseHandle(m_thread);
+    m_thread = NULL;
+    m_buffer.clear(); // 용량은 남겨 둠
+    return m_ok;
+}
+
+DWORD WINAPI RecordingWriter::ThreadProc(LPVOID param)
+{
+    ((RecordingWriter*)param)->Run();
+    return 0;
+}
+
+void RecordingWriter::Run()
+{
+    HANDLE hFile = CreateFile(m_path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    bool ok = hFile != INVALID_HANDLE_VALUE;
+    for (size_t at = 0; ok && at < m_buffer.size(); )
+    {
+        DWORD chunk = (DWORD)(m_buffer.size() - at < RECORD_WRITE_CHUNK ? m_buffer.size() - at : RECORD_WRITE_CHUNK);
+        DWORD written = 0;
+        ok = WriteFile(hFile, &m_buffer[at], chunk, &written, NULL) && written == chunk;
+        at += chunk;
+    }
+    if (hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(hFile);
+        if (!ok)
+            DeleteFile(m_path); // 반쯤 쓴 파일은 남기지 않음
+    }
+    m_ok = ok;
+    PostMessage(m_hMain, WM_APP_RECORDING_SAVED, ok ? 1 : 0, 0);
+}
+
+// 슬롯 기록을 %LOCALAPPDATA%\MultiWindowViewer\record-<슬롯>-<날짜>-<시각>.mwvrec 으로 저장
+void SaveRecording(HWND hWnd, int slot)
+{
+    if (slot < 0 || slot >= g_slots.Count() || g_recordingWriter.Busy())
+        return;
+    // 1970년 기준 ms (FILETIME은 1601년 기준 100ns)
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    uint64_t wallNow = ((((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime) - 116444736000000000ull) / 10000;
+    if (!g_recorder.Export(slot, GetTickCount64(), wallNow, g_recordingWriter.Buffer()))
+        return;
+
+    SYSTEMTIME st;
+    GetLocalTime(&st);
+    wchar_t name[64];
+    wsprintf(name, L"record-%d-%04u%02u%02u-%02u%02u%02u.mwvrec", slot + 1,
+             st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond);
+    wchar_t path[MAX_PATH];
+    if (!GetDataFilePath(name, path) || !g_recordingWriter.Start(hWnd, path))
+    {
+        g_recordingWriter.Buffer().clear();
+        MessageBox(hWnd, L"기록을 저장할 수 없습니다.", L"알림", MB_OK | MB_ICONWARNING);
+    }
+}
+
+void UpdateGridArea(HWND hWnd)
+{
+    if (!g_gridLayout)
+    {
+        g_layout.SetGridArea(0, 0); // 가로 한 줄 배치
+        return;
+    }
+    UNREFERENCED_PARAMETER(hWnd); // 모니터는 g_monitor에 캐시됨
+    g_layout.SetGridArea(g_monitor.work.right - g_monitor.work.left, g_monitor.work.bottom - g_monitor.work.top);
+}
+
+//=============================================================================
+// ProcessSnapshot: 작업 스레드가 게시한 스냅숏을 UI에 반영 (UI 스레드는 열거하지 않고 변경분만 적용)
+// - 목록 변경: UI 쪽 레지스트리(사본)에 추가/제거 + 콤보박스/검색 색인 갱신 + 레이아웃 갱신
+// - 제목 변경: 콤보박스 항목 갱신만 수행
+// - 크기 변경: 해당 창의 원본 크기 캐시를 무효화하고 레이아웃 갱신
+// - 드롭다운이 열려 있으면 이미 목록에 있는 창의 제목만 고치고 (열린 목록의 행 위치가 바뀌지 않음)
+//   나머지는 g_deferredSnapshot에 합쳐 두었다가 닫힌 뒤 적용
+// - 첫 스냅숏(시작 시 첫 열거)이면 저장된 슬롯 연결을 복원하고 시작 처리 완료를 기록
+//=============================================================================
+void ProcessSnapshot(HWND hWnd)
+{
+    WindowSnapshot* snapshot = g_snapshots.Take();
+    if (snapshot)
+        NoteWorkerSnapshot(*snapshot);
+
+    if (g_dropdownActive)
+    {
+        if (!snapshot)
+            return;
+        WindowDiff diff;
+        for (size_t k = 0; k < snapshot->diff.changed.size(); k++)
+        {
+            size_t length;
+            const wchar_t* title = snapshot->ChangedTitle(k, &length);
+            g_registry.UpdateTitle(snapshot->diff.changed[k], title, length, diff);
+        }
+        g_presenter.UpdateSearchIndex(diff);
+        RepaintOpenPickerRows(diff);
+        ApplyWindowDiff(diff);
+        ApplyHungStates(*snapshot); // 응답 없음 표시는 행 위치를 바꾸지 않으므로 바로 반영
+        if (g_deferredSnapshot)
+        {
+            MergeSnapshot(*g_deferredSnapshot, *snapshot);
+            g_snapshots.Release(snapshot);
+        }
+        else
+        {
+            g_deferredSnapshot = snapshot;
+        }
+        return;
+    }
+
+    // 보류해 둔 변경이 있으면 먼저 합침 (보류분 다음 새 스냅숏 순서)
+    if (g_deferredSnapshot)
+    {
+        if (snapshot)
+        {
+            MergeSnapshot(*g_deferredSnapshot, *snapshot);
+            g_snapshots.Release(snapshot);
+        }
+        snapshot = g_deferredSnapshot;
+        g_deferredSnapshot = NULL;
+    }
+    if (!snapshot)
+        return; // 이전 메시지에서 이미 가져감
+
+    // 1. 변경분을 사본에 적용하고 실제로 바뀐 것만 검색 색인과 콤보박스에 반영.
+    //    크기가 바뀐 창을 표시 중인 슬롯의 원본 크기 캐시도 여기서 무효화됨
+    bool first = g_populatedTime == 0;
+    WindowDiff applied;
+    bool relayout = g_presenter.ApplySnapshot(*snapshot, applied);
+    if (first)
+    {
+        RestoreSlotBindings(applied); // 복원된 슬롯만 콤보박스에 선택 항목 하나를 넣음
+        for (int i = 0; i < g_slots.Count(); i++) {
+            if (g_slots.Hot(i).selected)
+                CollapsePicker(i);
+        }
+    }
+    if (!applied.Empty())
+        ApplyWindowDiff(applied);
+    for (size_t k = 0; k < applied.removed.size(); k++)
+        g_hungWindows.erase(applied.removed[k]);
+    ApplyHungStates(*snapshot);
+
+    // 2. DWM 썸네일 및 콤보박스 배치 갱신 (원본 크기는 캐시에서 읽음)
+    if (first || relayout)
+    {
+        UpdatePreviewLayout(hWnd);
+    }
+    g_snapshots.Release(snapshot);
+
+    if (first)
+    {
+        g_populatedTime = PerfClockMicros();
+        NoteStartupMilestone(hWnd);
+    }
+}
+
+// 격리 상태 변경을 UI 쪽 집합에 반영하고, 표시가 바뀐 창을 보여 주는 콤보박스 본체와 열린 목록 행만 다시 그림
+void ApplyHungStates(const WindowSnapshot& snapshot)
+{
+    WindowDiff repaint; // changed만 사용 (RepaintOpenPickerRows 입력)
+    for (size_t k = 0; k < snapshot.hung.size(); k++) {
+        if (g_hungWindows.insert(snapshot.hung[k]).second)
+            repaint.changed.push_back(snapshot.hung[k]);
+    }
+    for (size_t k = 0; k < snapshot.recovered.size(); k++) {
+        if (g_hungWindows.erase(snapshot.recovered[k]))
+            repaint.changed.push_back(snapshot.recovered[k]);
+    }
+    if (repaint.changed.empty())
+        return;
+    RepaintOpenPickerRows(repaint);
+    for (int i = 0; i < g_slots.Count(); i++) {
+        WindowId selected = g_slots.Hot(i).selected;
+        if (selected && g_slots.Cold(i).combo &&
+            std::find(repaint.changed.begin(), repaint.changed.end(), selected) != repaint.changed.end())
+            InvalidateRect(g_slots.Cold(i).combo, NULL, FALSE);
+    }
+}
+
+// 작업 스레드의 계측을 성능 통계에 옮기고, 변경을 찾은 주기 점검 작업은 간격을 기본값으로 되돌림
+// (스냅숏을 가져갈 때 한 번만 호출. 보류 후 합쳐진 스냅숏은 다시 기록하지 않음)
+void NoteWorkerSnapshot(const WindowSnapshot& snapshot)
+{
+    if (snapshot.enumVisits)
+    {
+        g_perf.Record(PERF_PHASE_ENUMERATE, snapshot.enumerateMicros);
+        g_perf.Add(PERF_COUNT_ENUMVISITS, snapshot.enumVisits);
+    }
+    if (snapshot.titleMicros)
+        g_perf.Record(PERF_PHASE_TITLES, snapshot.titleMicros);
+
+    uint64_t now = GetTickCount64();
+    bool rearm = false;
+    for (int task = 0; task < REFRESH_TASK_COUNT; task++)
+    {
+        if (snapshot.foundChanges & (1u << task))
+        {
+            g_scheduler.Completed((RefreshTask)task, true, now);
+            rearm = true;
+        }
+    }
+    if (rearm && g_hMainWnd)
+        ArmRefreshTimer(g_hMainWnd);
+}
+
+//=============================================================================
+// 적응형 갱신 스케줄러 연동
+// - 창 변경은 WinEvent로 즉시 반영되므로 주기 작업은 이벤트 누락에 대비한 점검만 수행
+// - 타이머는 하나만 사용하며, 실행할 작업이 생기는 가장 이른 시각에 한 번 깨어나도록 매번 재설정
+//=============================================================================
+unsigned QueryPowerThrottle()
+{
+    SYSTEM_POWER_STATUS status;
+    if (!GetSystemPowerStatus(&status))
+        return THROTTLE_NONE;
+    unsigned flags = THROTTLE_NONE;
+    if (status.ACLineStatus == 0)      // 0: 배터리 전원, 1: AC 전원, 255: 알 수 없음
+        flags |= THROTTLE_BATTERY;
+    if (status.SystemStatusFlag == 1)  // 1: 배터리 절약 모드 켜짐 (Windows 10 이상)
+        flags |= THROTTLE_POWERSAVER;
+    return flags;
+}
+
+bool IsMainWindowOccluded(HWND hWnd)
+{
+    // 다른 가상 데스크톱으로 옮겨지는 등 DWM이 숨긴(cloaked) 상태
+    DWORD cloaked = 0;
+    if (SUCCEEDED(DwmGetWindowAttribute(hWnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked))) && cloaked)
+        return true;
+    if (g_alwaysOnTop)
+        return false;
+
+    // 전면 창이 메인 윈도우를 완전히 덮고 있는지 (전체 화면 앱, 최대화된 창 등)
+    HWND hForeground = GetForegroundWindow();
+    if (!hForeground || hForeground == hWnd || GetAncestor(hForeground, GA_ROOTOWNER) == hWnd ||
+        IsIconic(hForeground))
+        return false;
+    RECT rcMain, rcForeground;
+    if (!GetWindowRect(hWnd, &rcMain) ||
+        FAILED(DwmGetWindowAttribute(hForeground, DWMWA_EXTENDED_FRAME_BOUNDS, &rcForeground, sizeof(rcForeground))))
+        return false;
+    return rcForeground.left <= rcMain.left && rcForeground.top <= rcMain.top &&
+           rcForeground.right >= rcMain.right && rcForeground.bottom >= rcMain.bottom;
+}
+
+void UpdateThrottle(HWND hWnd)
+{
+    unsigned flags = g_powerThrottle;
+    if (IsIconic(hWnd))
+        flags |= THROTTLE_MINIMIZED;
+    else if (IsMainWindowOccluded(hWnd))
+        flags |= THROTTLE_OCCLUDED;
+    g_scheduler.SetThrottle(flags, GetTickCount64());
+}
+
+void ArmRefreshTimer(HWND hWnd)
+{
+    UINT delay = g_scheduler.NextDelay(GetTickCount64());
+    if (delay < USER_TIMER_MINIMUM)
+        delay = USER_TIMER_MINIMUM;
+    SetTimer(hWnd, ID_TIMER, delay, NULL); // 같은 ID로 다시 설정하면 기존 타이머를 대체
+}
+
+void NoteUserInteraction(HWND hWnd)
+{
+    g_scheduler.NoteInteraction(GetTickCount64());
+    ArmRefreshTimer(hWnd);
+}
+
+void RunRefreshTasks(HWND hWnd)
+{
+    UpdateThrottle(hWnd);
+    uint64_t now = GetTickCount64();
+
+    // 1. 창 목록 안전 점검과 2. 제목 재확인은 작업 스레드에 요청만 하고 기다리지 않음.
+    //    일단 변경 없음으로 보고하고, 변경을 찾았으면 그 결과 스냅숏을 받을 때 간격을 되돌림 (NoteWorkerSnapshot)
+    if (g_scheduler.IsDue(REFRESH_WINDOWLIST, now))
+    {
+        g_worker.Post(WM_WORKER_SWEEP);
+        g_scheduler.Completed(REFRESH_WINDOWLIST, false, now);
+    }
+    if (g_scheduler.IsDue(REFRESH_TITLES, now))
+    {
+        g_worker.Post(WM_WORKER_TITLES);
+        g_scheduler.Completed(REFRESH_TITLES, false, now);
+    }
+
+    ArmRefreshTimer(hWnd);
 }
 
 //=============================================================================
-// EnumWindowsProc: 실행 중인 창들을 열거하여 각 콤보박스에 항목 추가/업데이트
-// - EnumWindows 함수에 의해 호출되는 콜백 함수
+// 성능 계측 표시/저장
+// - 계측은 항상 켜져 있음 (기록 비용은 QueryPerformanceCounter 두 번과 정수 덧셈 정도)
+// - 통계 창: 메인 윈도우 왼쪽 위에 겹치는 소유 팝업. 반투명 + WS_EX_TRANSPARENT로 클릭은 아래로 통과
+// - 기록 파일: %LOCALAPPDATA%\MultiWindowViewer\perf.log 끝에 UTF-8(ASCII) 텍스트로 추가
 //=============================================================================
-BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam)
+uint64_t PerfClockMicros()
 {
-    HWND hMain = (HWND)lParam; // 메인 윈도우 핸들
-    
-    // 현재 창이 메인 윈도우 자신이거나, 유효하지 않은 창인 경우 건너뛰기
-    if (hwnd == hMain || !IsWindow(hwnd))
-        return TRUE;
-    
-    // g_excludeOwnerWindows가 true이고, 창이 GW_OWNER를 가지고 있다면 건너뛰기
-    if (g_excludeOwnerWindows && (GetWindow(hwnd, GW_OWNER) != NULL))
-        return TRUE;
-    
-    // 숨겨진 창은 건너뛰기
-    if (!IsWindowVisible(hwnd))
-        return TRUE;
-    
-    TCHAR title[256];
-    GetWindowText(hwnd, title, 256); // 창 타이틀 가져오기
-    
-    // 타이틀이 없거나 (빈 문자열), 특정 제외 문자열을 포함하는 경우 건너뛰기
-    if (_tcslen(title) == 0)
-        return TRUE;
-    for (size_t i = 0; i < g_excludedCount; i++) {
-        if (_tcsstr(title, g_excludedSubstrings[i]) != NULL)
-            return TRUE;
-    }
-
-    // 현재 열거된 창을 모든 콤보박스에 추가 (중복 방지)
-    for (int i = 0; i < g_numSegments; i++) {
-        if (!g_ComboBoxes[i]) continue; // 콤보박스가 유효하지 않으면 건너뛰기
-        bool found = false;
-        int count = (int)SendMessage(g_ComboBoxes[i], CB_GETCOUNT, 0, 0);
-        for (int j = 0; j < count; j++) {
-            HWND hwndStored = (HWND)SendMessage(g_ComboBoxes[i], CB_GETITEMDATA, j, 0);
-            if (hwndStored == hwnd) { // 이미 목록에 있는 창이면
-                found = true;
-                break;
-            }
-        }
-        if (!found) { // 목록에 없는 창이면 추가
-            int index = (int)SendMessage(g_ComboBoxes[i], CB_ADDSTRING, 0, (LPARAM)title);
-            SendMessage(g_ComboBoxes[i], CB_SETITEMDATA, index, (LPARAM)hwnd); // 창 핸들도 함께 저장
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    // 나눗셈 전에 곱하면 넘칠 수 있으므로 초 단위와 나머지를 나눠서 변환
+    uint64_t seconds = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+    uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+    return seconds * 1000000 + remainder * 1000000 / (uint64_t)frequency.QuadPart;
+}
+
+void FormatPerfStats(std::string& text)
+{
+    g_perf.Format(text);
+    uint64_t now = GetTickCount64();
+    UINT average = g_scheduler.AverageWakeupsPer100Sec(now);
+    UINT recent = g_scheduler.RecentWakeupsPer100Sec(now);
+    char line[128];
+    wsprintfA(line, "wakeups/s %u.%02u (last 1 min %u.%02u), slots %d\n",
+              average / 100, average % 100, recent / 100, recent % 100, g_slots.Count());
+    text += line;
+    if (g_captureBackend.Count() > 0 || g_captureBackend.Captures() > 0)
+    {
+        uint64_t captures = g_captureBackend.Captures();
+        wsprintfA(line, "capture: slots %u, captures %u, avg %u us, screen copies %u (%s)\n",
+                  (UINT)g_captureBackend.Count(), (UINT)captures,
+                  captures ? (UINT)(g_captureBackend.CaptureMicros() / captures) : 0,
+                  (UINT)g_captureBackend.ScreenCopies(), SimdLevelName(DetectSimdLevel()));
+        text += line;
+        // 캡처 슬롯마다 바뀐/건너뛴 캡처 수 (건너뛴 캡처는 축소와 다시 그리기를 하지 않음)
+        for (int i = 0; i < g_slots.Count(); i++)
+        {
+            PreviewHandle inner = g_previewBackend.FallbackHandle(g_slots.Hot(i).thumbnail);
+            if (!inner)
+                continue;
+            uint64_t changed, skipped;
+            g_captureBackend.FrameCounts(inner, &changed, &skipped);
+            wsprintfA(line, "  slot %d: changed %u, skipped %u\n", i + 1, (UINT)changed, (UINT)skipped);
+            text += line;
         }
     }
-    return TRUE; // 계속해서 다음 창 열거
+    if (g_activity.WatchedCount() > 0 || g_activity.Samples() > 0)
+    {
+        // 활동 감시: 표본 수와 표본당 평균 시간(캡처 + 비교, 실패한 시도 포함), 예산 때문에 미룬 횟수,
+        // 실제 표본 간격 (설정 간격보다 길면 예산 때문에 밀리고 있음)
+        uint64_t samples = g_activity.Samples();
+        UINT budget = g_activity.Config().budgetPermille;
+        wsprintfA(line, "activity: watched %d, samples %u, avg %u us, deferred %u, interval %u/%u ms, budget %u.%u%%\n",
+                  g_activity.WatchedCount(), (UINT)samples, samples ? (UINT)(g_activity.SampleMicros() / samples) : 0,
+                  (UINT)g_activity.Deferred(), g_activity.EffectiveIntervalMillis(), g_activity.Config().sampleMillis,
+                  budget / 10, budget % 10);
+        text += line;
+    }
+    if (g_recorder.RecordingCount() > 0 || g_recorder.Frames() > 0)
+    {
+        // 화면 기록: 프레임당 평균 차이 크기 (원본 프레임은 160x90x3 = 43200바이트)
+        uint64_t frames = g_recorder.Frames();
+        wsprintfA(line, "recorder: slots %d, frames %u, avg %u bytes/frame, evicted %u\n", g_recorder.RecordingCount(),
+                  (UINT)frames, frames ? (UINT)(g_recorder.EncodedBytes() / frames) : 0, (UINT)g_recorder.Evicted());
+        text += line;
+    }
+    FormatStartupTiming(text);
 }
 
-//=============================================================================
-// GetSegmentIndexAtPoint: 주어진 클라이언트 좌표에 해당하는 미리보기 슬롯 인덱스 반환
-// - 더블 클릭 또는 우클릭 시 어떤 슬롯이 클릭되었는지 판별하는 헬퍼 함수
-//=============================================================================
-int GetSegmentIndexAtPoint(POINT pt)
+// 시작 시간 요약 한 줄 (wWinMain 진입 기준 ms, 소수 첫째 자리까지). 아직 일어나지 않은 단계는 "-"
+void FormatStartupTiming(std::string& text)
 {
-    // 클릭된 Y 좌표가 미리보기 영역 밖이면 -1 반환
-    if (pt.y < DROP_HEIGHT || pt.y > DROP_HEIGHT + PREVIEW_HEIGHT)
-        return -1;
-
-    int cumulativeWidth = 0; // 각 미리보기 슬롯의 누적 너비
-
-    for (int i = 0; i < g_numSegments; i++)
+    const char* names[] = { "paint", "populated", "thumbnail" };
+    uint64_t marks[] = { g_firstPaintTime, g_populatedTime, g_firstThumbnailTime };
+    char part[64];
+    wsprintfA(part, "startup: launch %u.%u ms", (UINT)(g_launchDelay / 1000), (UINT)(g_launchDelay % 1000 / 100));
+    text += part;
+    for (int k = 0; k < 3; k++)
     {
-        int slotWidth = 0; // 현재 미리보기 슬롯의 너비
-
-        // 썸네일이 유효하고 소스 크기를 가져올 수 있으면 실제 썸네일 크기로 계산
-        // g_Thumbnails[i]가 NULL일 수 있으므로 먼저 검사
-        if (g_Selected[i] && IsWindow(g_Selected[i]) && g_Thumbnails[i])
+        if (marks[k] && marks[k] >= g_launchTime)
         {
-            SIZE srcSize = {};
-            if (SUCCEEDED(DwmQueryThumbnailSourceSize(g_Thumbnails[i], &srcSize)) && srcSize.cy > 0)
-            {
-                if (srcSize.cy <= PREVIEW_HEIGHT)
-                {
-                    slotWidth = srcSize.cx;
-                }
-                else
-                {
-                    double scale = (double)PREVIEW_HEIGHT / srcSize.cy;
-                    slotWidth = (int)std::round(srcSize.cx * scale);
-                }
-            }
-            else // 썸네일은 있으나 소스 크기 가져오기 실패 (예: 대상 창 최소화)
-            {
-                slotWidth = (PREVIEW_HEIGHT * PREVIEW_ASPECT_RATIO_NUMERATOR) / PREVIEW_ASPECT_RATIO_DENOMINATOR;
-            }
+            uint64_t elapsed = marks[k] - g_launchTime;
+            wsprintfA(part, ", %s %u.%u ms", names[k], (UINT)(elapsed / 1000), (UINT)(elapsed % 1000 / 100));
         }
-        else // 썸네일이 없거나 (선택되지 않았거나, 대상 창이 닫히거나)
+        else
         {
-            slotWidth = (PREVIEW_HEIGHT * PREVIEW_ASPECT_RATIO_NUMERATOR) / PREVIEW_ASPECT_RATIO_DENOMINATOR;
+            wsprintfA(part, ", %s -", names[k]);
         }
+        text += part;
+    }
+    text += "\n";
+}
+
+HFONT CreatePerfFont()
+{
+    return CreateFont(ScaleDpi(PERF_FONT_HEIGHT), 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
+                      OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, DEFAULT_QUALITY,
+                      FIXED_PITCH | FF_MODERN, L"Consolas");
+}
+
+void ShowPerfOverlay(HWND hWnd, bool show)
+{
+    if (!show)
+    {
+        KillTimer(hWnd, ID_PERF_OVERLAY_TIMER);
+        if (g_hPerfOverlay)
+            DestroyWindow(g_hPerfOverlay);
+        g_hPerfOverlay = NULL;
+        return;
+    }
+    if (g_hPerfOverlay)
+        return;
+
+    static bool classRegistered = false;
+    if (!classRegistered)
+    {
+        WNDCLASS wc = {};
+        wc.lpfnWndProc = PerfOverlayProc;
+        wc.hInstance = g_hInst;
+        wc.lpszClassName = TEXT("MultiWindowViewerPerf");
+        wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+        wc.hbrBackground = (HBRUSH)GetStockObject(BLACK_BRUSH);
+        classRegistered = RegisterClass(&wc) != 0;
+        if (!classRegistered)
+            return;
+    }
+    if (!g_hPerfFont)
+        g_hPerfFont = CreatePerfFont();
+
+    // 소유 팝업이므로 메인 윈도우와 함께 최소화/복원되고 항상 메인 윈도우 위에 표시됨
+    g_hPerfOverlay = CreateWindowEx(WS_EX_LAYERED | WS_EX_TRANSPARENT | WS_EX_TOOLWINDOW | WS_EX_NOACTIVATE,
+                                    TEXT("MultiWindowViewerPerf"), NULL, WS_POPUP,
+                                    0, 0, 0, 0, hWnd, NULL, g_hInst, NULL);
+    if (!g_hPerfOverlay)
+        return;
+    SetLayeredWindowAttributes(g_hPerfOverlay, 0, 200, LWA_ALPHA);
+    UpdatePerfOverlay(hWnd);
+    ShowWindow(g_hPerfOverlay, SW_SHOWNOACTIVATE);
+    SetTimer(hWnd, ID_PERF_OVERLAY_TIMER, PERF_OVERLAY_INTERVAL, NULL);
+}
+
+void UpdatePerfOverlay(HWND hWnd)
+{
+    if (!g_hPerfOverlay)
+        return;
+    std::string text;
+    FormatPerfStats(text);
+    g_perfText.assign(text.begin(), text.end()); // ASCII만 사용하므로 그대로 넓힘
+
+    // 글자 크기에 맞춰 창 크기를 정하고 메인 윈도우의 클라이언트 왼쪽 위에 붙임
+    RECT rcText = { 0, 0, 0, 0 };
+    HDC hdc = GetDC(g_hPerfOverlay);
+    HGDIOBJ oldFont = SelectObject(hdc, g_hPerfFont ? (HGDIOBJ)g_hPerfFont : GetStockObject(ANSI_FIXED_FONT));
+    DrawText(hdc, g_perfText.c_str(), (int)g_perfText.size(), &rcText, DT_CALCRECT | DT_NOPREFIX);
+    SelectObject(hdc, oldFont);
+    ReleaseDC(g_hPerfOverlay, hdc);
+
+    POINT origin = { 0, ScaleDpi(DROP_HEIGHT) }; // 콤보박스 줄은 가리지 않음
+    ClientToScreen(hWnd, &origin);
+    SetWindowPos(g_hPerfOverlay, NULL, origin.x, origin.y, rcText.right + 8, rcText.bottom + 8,
+                 SWP_NOZORDER | SWP_NOACTIVATE);
+    InvalidateRect(g_hPerfOverlay, NULL, TRUE);
+}
+
+LRESULT CALLBACK PerfOverlayProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    switch (message)
+    {
+        case WM_NCHITTEST: // 클릭이 메인 윈도우로 통과하도록 함
+            return HTTRANSPARENT;
 
-        // 클릭된 X 좌표가 현재 슬롯의 범위 내에 있는지 확인
-        if (pt.x >= cumulativeWidth && pt.x < cumulativeWidth + slotWidth)
+        case WM_PAINT:
         {
-            return i; // 해당 슬롯의 인덱스 반환
+            PAINTSTRUCT ps;
+            HDC hdc = BeginPaint(hWnd, &ps);
+            RECT rc;
+            GetClientRect(hWnd, &rc);
+            rc.left += 4;
+            rc.top += 4;
+            HGDIOBJ oldFont = SelectObject(hdc, g_hPerfFont ? (HGDIOBJ)g_hPerfFont : GetStockObject(ANSI_FIXED_FONT));
+            SetBkMode(hdc, TRANSPARENT);
+            SetTextColor(hdc, RGB(0, 255, 0));
+            DrawText(hdc, g_perfText.c_str(), (int)g_perfText.size(), &rc, DT_NOPREFIX);
+            SelectObject(hdc, oldFont);
+            EndPaint(hWnd, &ps);
         }
-        cumulativeWidth += slotWidth; // 다음 슬롯의 시작 X 좌표 계산
+        return 0;
     }
-    return -1; // 어떤 슬롯도 클릭되지 않았을 경우
+    return DefWindowProc(hWnd, message, wParam, lParam);
+}
+
+void AppendPerfDump()
+{
+    wchar_t path[MAX_PATH];
+    if (!GetDataFilePath(L"perf.log", path))
+        return;
+
+    HANDLE hFile = CreateFile(path, FILE_APPEND_DATA, FILE_SHARE_READ, NULL, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return;
+    SYSTEMTIME st;
+    GetLocalTime(&st);
+    char header[64];
+    wsprintfA(header, "\n== %04u-%02u-%02u %02u:%02u:%02u ==\n",
+              st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond);
+    std::string text = header;
+    std::string stats;
+    FormatPerfStats(stats);
+    text += stats;
+    DWORD written = 0;
+    WriteFile(hFile, text.data(), (DWORD)text.size(), &written, NULL);
+    CloseHandle(hFile);
 }
 
 //=============================================================================
-// HandleDoubleClick: 미리보기 영역 더블클릭 시 해당 창 활성화
+// HandleDoubleClick: 미리보기 영역 더블클릭 시 해당 창 활성화 (활동 알림도 끔)
 //=============================================================================
 LRESULT HandleDoubleClick(HWND hWnd, LPARAM lParam)
 {
-    UNREFERENCED_PARAMETER(hWnd); // hWnd는 이 함수 내에서 직접 사용되지 않음.
-
     POINT pt;
     pt.x = LOWORD(lParam); // 마우스 클릭 X 좌표
     pt.y = HIWORD(lParam); // 마우스 클릭 Y 좌표
 
     int indexFound = GetSegmentIndexAtPoint(pt); // 헬퍼 함수를 사용하여 클릭된 슬롯 인덱스 가져오기
+    AcknowledgeAlert(hWnd, indexFound); // 알림이 켜진 슬롯이면 창으로 가면서 알림을 끔
 
     // 클릭된 슬롯이 있고, 해당 슬롯에 유효한 창이 선택되어 있다면
-    if (indexFound != -1 && g_Selected[indexFound] && IsWindow(g_Selected[indexFound]))
+    HWND target = indexFound != -1 ? (HWND)g_slots.Hot(indexFound).selected : NULL;
+    if (target && IsWindow(target))
     {
         // 창이 최소화되어 있다면 복원
-        if (IsIconic(g_Selected[indexFound]))
+        if (IsIconic(target))
         {
-            ShowWindow(g_Selected[indexFound], SW_RESTORE);
+            ShowWindowAsync(target, SW_RESTORE); // 응답 없는 창이어도 기다리지 않음
         }
         // 창을 전면으로 가져오고 활성화
-        BringWindowToTop(g_Selected[indexFound]);
-        SetForegroundWindow(g_Selected[indexFound]);
-        SetActiveWindow(g_Selected[indexFound]);
+        BringWindowToTop(target);
+        SetForegroundWindow(target);
+        SetActiveWindow(target);
     }
     return 0;
 }
@@ -586,27 +3182,66 @@ void ShowContextMenu(HWND hWnd)
     // 우클릭된 슬롯의 인덱스를 저장. 메뉴 핸들러에서 사용됨.
     g_rightClickedSegmentIndex = GetSegmentIndexAtPoint(pt); 
 
+    LoadRunAtStartup(); // 부팅시 실행 체크 표시는 메뉴를 열 때 레지스트리에서 읽음 (시작 시에는 읽지 않음)
     HMENU hMenu = CreatePopupMenu(); // 팝업 메뉴 생성
 
     // 메뉴 항목 추가 및 현재 상태에 따라 체크 표시
     AppendMenu(hMenu, MF_STRING | (g_alwaysOnTop ? MF_CHECKED : 0), IDM_ALWAYS_ON_TOP, L"항상 위에");
     AppendMenu(hMenu, MF_STRING | (g_runAtStartup ? MF_CHECKED : 0), IDM_RUN_AT_STARTUP, L"부팅시 실행");
+    AppendMenu(hMenu, MF_STRING | (g_gridLayout ? MF_CHECKED : 0), IDM_GRID_LAYOUT, L"격자 배치");
     AppendMenu(hMenu, MF_STRING, IDM_INITIALIZE, L"초기화 후 종료");
     
     // '창+1' 및 '창-1' 메뉴 활성화/비활성화 조건
     UINT addFlags = MF_STRING;
-    if (g_numSegments >= MAX_SEGMENTS) { // 최대 미리보기 개수 도달 시 비활성화
+    if (g_slots.Count() >= MaxSlotCount()) { // 화면에 담을 수 있는 최대 개수 도달 시 비활성화
         addFlags |= MF_GRAYED;
     }
     AppendMenu(hMenu, addFlags, IDM_ADD_PREVIEW, L"창+1");
 
     UINT removeFlags = MF_STRING;
-    if (g_numSegments <= 1) { // 최소 미리보기 개수 도달 시 비활성화
+    if (g_slots.Count() <= 1) { // 최소 미리보기 개수 도달 시 비활성화
         removeFlags |= MF_GRAYED;
     }
     AppendMenu(hMenu, removeFlags, IDM_REMOVE_PREVIEW, L"창-1");
 
+    // 우클릭한 슬롯의 순서 변경 (양 끝에서는 비활성화)
+    int slot = g_rightClickedSegmentIndex;
+    AppendMenu(hMenu, MF_STRING | (slot > 0 ? 0 : MF_GRAYED), IDM_MOVE_LEFT, L"왼쪽으로 이동");
+    AppendMenu(hMenu, MF_STRING | (slot >= 0 && slot < g_slots.Count() - 1 ? 0 : MF_GRAYED), IDM_MOVE_RIGHT, L"오른쪽으로 이동");
+
+    // 우클릭한 슬롯 활동 감시 (창이 선택된 슬롯만, 같은 항목을 다시 고르면 끔)
+    bool watchable = slot >= 0 && slot < g_slots.Count() && g_slots.Hot(slot).selected;
+    ActivityWatch watch = watchable ? g_activity.Watch(slot) : ACTIVITY_OFF;
+    AppendMenu(hMenu, MF_STRING | (watchable ? 0 : MF_GRAYED) | (watch == ACTIVITY_CHANGE ? MF_CHECKED : 0),
+               IDM_WATCH_CHANGE, L"바뀌면 알림");
+    AppendMenu(hMenu, MF_STRING | (watchable ? 0 : MF_GRAYED) | (watch == ACTIVITY_IDLE ? MF_CHECKED : 0),
+               IDM_WATCH_IDLE, L"멈추면 알림");
+    AppendMenu(hMenu, MF_STRING | (slot >= 0 && slot < g_slots.Count() && g_activity.Alert(slot) != ALERT_NONE ? 0 : MF_GRAYED),
+               IDM_ACKNOWLEDGE, L"알림 끄기");
+    bool recording = watchable && g_recorder.Recording(slot);
+    AppendMenu(hMenu, MF_STRING | (watchable ? 0 : MF_GRAYED) | (recording ? MF_CHECKED : 0), IDM_RECORD, L"화면 기록");
+    AppendMenu(hMenu, MF_STRING | (recording && g_recorder.FrameCount(slot) > 0 && !g_recordingWriter.Busy() ? 0 : MF_GRAYED),
+               IDM_SAVE_RECORDING, L"기록 저장");
+
     AppendMenu(hMenu, MF_STRING, IDM_EXIT, L"종료");
+
+    // 성능 계측 표시/저장
+    AppendMenu(hMenu, MF_SEPARATOR, 0, NULL);
+    AppendMenu(hMenu, MF_STRING | (g_hPerfOverlay ? MF_CHECKED : 0), IDM_PERF_OVERLAY, L"성능 통계 표시");
+    AppendMenu(hMenu, MF_STRING | (g_perfDump ? MF_CHECKED : 0), IDM_PERF_DUMP, L"성능 기록 저장");
+    AppendMenu(hMenu, MF_STRING, IDM_RELOAD_FILTER, L"창 필터 다시 읽기");
+
+    // 갱신 스케줄러 상태: 초당 깨어남 횟수 (시작 이후 평균 / 최근 1분)
+    {
+        uint64_t now = GetTickCount64();
+        UINT average = g_scheduler.AverageWakeupsPer100Sec(now);
+        UINT recent = g_scheduler.RecentWakeupsPer100Sec(now);
+        wchar_t stats[128];
+        wsprintf(stats, L"깨어남 %u.%02u회/초 (최근 1분 %u.%02u회/초)",
+                 average / 100, average % 100, recent / 100, recent % 100);
+        AppendMenu(hMenu, MF_SEPARATOR, 0, NULL);
+        AppendMenu(hMenu, MF_STRING | MF_GRAYED, 0, stats);
+    }
     
     // 팝업 메뉴 표시
     GetCursorPos(&pt); // TrackPopupMenu는 화면 좌표를 사용하므로 다시 가져옴
@@ -614,6 +3249,65 @@ void ShowContextMenu(HWND hWnd)
     DestroyMenu(hMenu); // 메뉴 사용 후 파괴
 }
 
+//=============================================================================
+// CompleteStartup: 창을 표시한 뒤 창 목록을 처음 열거하고, 저장된 슬롯 연결을 복원하고, 훅과 스케줄러를 시작
+// - 콤보박스 목록은 드롭다운을 열 때, 검색 색인은 처음 검색할 때 만듦
+//=============================================================================
+void CompleteStartup(HWND hWnd)
+{
+    // 작업 스레드가 창 이벤트 훅을 설치하고 첫 열거 결과를 게시함. 슬롯 복원과 썸네일 등록은
+    // 그 스냅숏을 받을 때 수행 (ProcessSnapshot). 스레드를 만들지 못하면 빈 목록으로 남음
+    g_hMainWnd = hWnd;
+    g_worker.Start(hWnd);
+
+    // 갱신 스케줄러 시작 (작업별 간격 설정 후 가장 이른 작업 시각에 타이머 설정)
+    g_scheduler.SetInterval(REFRESH_WINDOWLIST, LIST_SWEEP_MIN, LIST_SWEEP_BASE, LIST_SWEEP_MAX);
+    g_scheduler.SetInterval(REFRESH_TITLES, TITLE_CHECK_MIN, TITLE_CHECK_BASE, TITLE_CHECK_MAX);
+    g_scheduler.Start(GetTickCount64());
+    g_powerThrottle = QueryPowerThrottle();
+    UpdateThrottle(hWnd);
+    ArmRefreshTimer(hWnd);
+    if (g_perfDump)
+        SetTimer(hWnd, ID_PERF_DUMP_TIMER, PERF_DUMP_INTERVAL, NULL);
+    NoteStartupMilestone(hWnd);
+}
+
+// 시작 시간 측정 모드에서 첫 그리기와 목록 준비가 끝났으면 (썸네일을 띄울 슬롯이 있으면 첫 썸네일까지)
+// startup.log에 한 줄 추가하고 종료. 복원된 슬롯이 없으면 첫 썸네일은 "-"로 기록
+void NoteStartupMilestone(HWND hWnd)
+{
+    if (!g_startupTiming || !g_firstPaintTime || !g_populatedTime)
+        return;
+    bool anyThumbnail = false;
+    for (int i = 0; i < g_slots.Count(); i++)
+        anyThumbnail = anyThumbnail || g_slots.Hot(i).thumbnail != 0;
+    if (anyThumbnail && !g_firstThumbnailTime)
+        return;
+    g_startupTiming = false;
+
+    wchar_t path[MAX_PATH];
+    if (GetDataFilePath(L"startup.log", path))
+    {
+        HANDLE hFile = CreateFile(path, FILE_APPEND_DATA, FILE_SHARE_READ, NULL, OPEN_ALWAYS,
+                                  FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hFile != INVALID_HANDLE_VALUE)
+        {
+            std::string text;
+            FormatStartupTiming(text);
+            SYSTEMTIME st;
+            GetLocalTime(&st);
+            char stamp[32];
+            wsprintfA(stamp, "%04u-%02u-%02u %02u:%02u:%02u ", st.wYear, st.wMonth, st.wDay,
+                      st.wHour, st.wMinute, st.wSecond);
+            text.insert(0, stamp);
+            DWORD written = 0;
+            WriteFile(hFile, text.data(), (DWORD)text.size(), &written, NULL);
+            CloseHandle(hFile);
+        }
+    }
+    PostMessage(hWnd, WM_CLOSE, 0, 0);
+}
+
 //=============================================================================
 // WndProc: 메인 윈도우 프로시저 (메시지 처리 핸들러)
 //=============================================================================
@@ -627,6 +3321,8 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             INITCOMMONCONTROLSEX icex = { sizeof(icex), ICC_WIN95_CLASSES };
             InitCommonControlsEx(&icex);
             g_hInst = ((LPCREATESTRUCT)lParam)->hInstance; // 인스턴스 핸들 저장
+            g_dwmBackend.SetHost(hWnd); // 썸네일은 메인 윈도우에 합성
+            g_captureBackend.SetHost(hWnd);
             
             // 애플리케이션 아이콘 로드 및 설정
             HICON hIconSmall = (HICON)LoadImage(g_hInst, MAKEINTRESOURCE(IDI_APP_ICON), IMAGE_ICON, GetSystemMetrics(SM_CXSMICON), GetSystemMetrics(SM_CYSMICON), LR_DEFAULTCOLOR);
@@ -639,10 +3335,21 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 SendMessage(hWnd, WM_SETICON, ICON_BIG, (LPARAM)hIconLarge);
             }
 
-            // 레지스트리에서 이전 설정 로드 (창 위치, 항상 위에 옵션)
+            // 레지스트리에서 이전 설정 로드 (창 위치, 항상 위에 옵션). 부팅 시 자동 실행 여부는 메뉴를 열 때 읽음
             LoadSettings(hWnd);
-            // 부팅 시 자동 실행 설정 로드
-            LoadRunAtStartup();
+
+            // 복원한 위치의 모니터 기준으로 DPI/작업 영역을 다시 읽고 배치 크기를 맞춤
+            RefreshMonitorMetrics(hWnd, 0);
+            g_layout.SetPickerHeight(ScaleDpi(DROP_HEIGHT));
+            g_layout.SetPreviewHeight(ScaleDpi(PREVIEW_HEIGHT));
+            // 로드된 개수가 이 모니터에 담을 수 있는 최대 개수를 초과하면 조정 (이후에는 추가만 막고 있는 슬롯은 지우지 않음)
+            {
+                int maxSlots = MaxSlotCount();
+                if (g_slots.Count() > maxSlots)
+                    g_slots.Resize(maxSlots);
+                g_windowWidth = g_slots.Count() * g_layout.DefaultSlotWidth();
+                g_windowHeight = ScaleDpi(TOTAL_HEIGHT);
+            }
 
             // 윈도우의 현재 위치를 유지하면서 크기를 g_windowWidth, g_windowHeight로 설정
             RECT rc;
@@ -652,13 +3359,23 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                              SWP_NOZORDER | SWP_NOACTIVATE);
             }
             
-            RecreatePreviews(hWnd); // 콤보박스 및 미리보기 영역 초기 생성
-            SetTimer(hWnd, ID_TIMER, 500, NULL); // 0.5초 간격으로 타이머 설정
+            // 빈 콤보박스와 배치만 만들어 창을 바로 표시할 수 있게 함 (썸네일 없음)
+            RecreatePreviews(hWnd);
+            UpdateGridArea(hWnd);
+            UpdatePreviewLayout(hWnd);
+
+            // 창 목록 열거와 슬롯 복원은 wWinMain의 첫 그리기(UpdateWindow) 다음 메시지에서 처리
+            PostMessage(hWnd, WM_APP_STARTUP, 0, 0);
         }
         break;
+
+        case WM_APP_STARTUP: // 첫 그리기 후 시작 처리
+            CompleteStartup(hWnd);
+            break;
         
         case WM_LBUTTONDOWN: // 마우스 왼쪽 버튼 클릭 (타이틀바 없는 창 이동용)
         {
+            NoteUserInteraction(hWnd);
             ReleaseCapture(); // 혹시 모를 기존 캡처 해제
             // WM_NCLBUTTONDOWN 메시지를 HTCAPTION과 함께 보내 창 이동을 시뮬레이션
             SendMessage(hWnd, WM_NCLBUTTONDOWN, HTCAPTION, 0);
@@ -672,6 +3389,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             return 1; // 배경을 지우지 않도록 1 반환
             
         case WM_RBUTTONUP: // 마우스 오른쪽 버튼 떼기 (컨텍스트 메뉴 표시용)
+            NoteUserInteraction(hWnd);
             ShowContextMenu(hWnd); // 컨텍스트 메뉴 표시 함수 호출
             break;
         
@@ -681,24 +3399,27 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             int code = HIWORD(wParam); // 알림 코드 (콤보박스 등)
 
             // 콤보박스 관련 메시지 처리
-            if ((id >= IDC_COMBO1 && id < IDC_COMBO1 + g_numSegments))
+            if ((id >= IDC_COMBO1 && id < IDC_COMBO1 + g_slots.Count()))
             {
                 if (code == CBN_DROPDOWN) // 콤보박스 드롭다운 목록이 열릴 때
                 {
                     g_dropdownActive = true; // 드롭다운 활성 상태로 설정
+                    g_openPicker = id - IDC_COMBO1;
+                    NoteUserInteraction(hWnd);
                     // WS_CLIPCHILDREN 스타일 제거하여 드롭다운 리스트가 부모 창 밖으로 그려지게 허용
                     LONG style = GetWindowLong(hWnd, GWL_STYLE);
                     SetWindowLong(hWnd, GWL_STYLE, style & ~WS_CLIPCHILDREN);
                     
                     int index = id - IDC_COMBO1;
-                    HWND hCombo = g_ComboBoxes[index];
+                    HWND hCombo = g_slots.Cold(index).combo;
+                    ExpandPicker(index); // 열리는 콤보박스에만 공유 목록을 채움
                     COMBOBOXINFO cbi = {}; // 모든 멤버를 0으로 초기화
                     cbi.cbSize = sizeof(cbi);
                     // 콤보박스 정보(특히 리스트박스 핸들) 가져오기
                     if (GetComboBoxInfo(hCombo, &cbi) && cbi.hwndList)
                     {
                         SetWindowTheme(cbi.hwndList, L"", L""); // 리스트박스 테마 초기화
-                        SendMessage(cbi.hwndList, WM_SETFONT, (WPARAM)g_hFont, TRUE); // 리스트박스 폰트 설정
+                        SendMessage(cbi.hwndList, WM_SETFONT, (WPARAM)GetUiFont(), TRUE); // 리스트박스 폰트 설정
                         
                         RECT rcCombo;
                         GetWindowRect(hCombo, &rcCombo); // 콤보박스의 화면 좌표 가져오기
@@ -716,36 +3437,63 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 else if (code == CBN_CLOSEUP) // 콤보박스 드롭down 목록이 닫힐 때
                 {
                     g_dropdownActive = false; // 드롭다운 비활성 상태로 설정
+                    g_openPicker = -1;
+                    g_pickerQuery.clear();
+                    g_pickerRows.clear();
                     // WS_CLIPCHILDREN 스타일 복원 (자식 창이 부모 영역을 벗어나지 않도록 함)
                     LONG style = GetWindowLong(hWnd, GWL_STYLE);
                     SetWindowLong(hWnd, GWL_STYLE, style | WS_CLIPCHILDREN);
+                    // CBN_SELCHANGE가 처리된 뒤 항목을 선택 항목 하나로 축소
+                    PostMessage(hWnd, WM_APP_COLLAPSEPICKER, (WPARAM)(id - IDC_COMBO1), 0);
+                    // 드롭다운이 열려 있는 동안 보류된 창 목록 변경 적용 요청
+                    if (g_deferredSnapshot)
+                        PostMessage(hWnd, WM_APP_SNAPSHOT, 0, 0);
+                }
+                else if (code == CBN_SELENDOK && !g_pickerQuery.empty()) // 검색 후 Enter로 확정
+                {
+                    // 검색 결과를 채우며 강조한 첫 항목은 CBN_SELCHANGE 없이 확정될 수 있으므로 직접 반영
+                    int index = id - IDC_COMBO1;
+                    HWND hCombo = g_slots.Cold(index).combo;
+                    int sel = (int)SendMessage(hCombo, CB_GETCURSEL, 0, 0);
+                    if (sel != CB_ERR && (WindowId)SendMessage(hCombo, CB_GETITEMDATA, sel, 0) != g_slots.Hot(index).selected)
+                        SendMessage(hWnd, WM_COMMAND, MAKEWPARAM(id, CBN_SELCHANGE), (LPARAM)hCombo);
                 }
                 else if (code == CBN_SELCHANGE) // 콤보박스 선택 항목이 변경될 때
                 {
                     int index = id - IDC_COMBO1;
-                    HWND hCombo = g_ComboBoxes[index];
+                    HWND hCombo = g_slots.Cold(index).combo;
                     int sel = (int)SendMessage(hCombo, CB_GETCURSEL, 0, 0); // 새로 선택된 항목의 인덱스
                     if (sel != CB_ERR)
                     {
-                        HWND hwndTarget = (HWND)SendMessage(hCombo, CB_GETITEMDATA, sel, 0); // 선택된 항목의 창 핸들
-                        g_Selected[index] = hwndTarget; // 전역 변수에 선택된 창 핸들 저장
+                        WindowId target = (WindowId)SendMessage(hCombo, CB_GETITEMDATA, sel, 0); // 선택된 항목의 창 핸들
+                        g_slots.Hot(index).selected = target; // 전역 변수에 선택된 창 핸들 저장
                         // 이전에 등록된 DWM 썸네일이 있다면 해제
-                        if (g_Thumbnails[index])
+                        if (g_slots.Hot(index).thumbnail)
                         {
-                            DwmUnregisterThumbnail(g_Thumbnails[index]);
-                            g_Thumbnails[index] = NULL;
+                            g_backend->Unregister(g_slots.Hot(index).thumbnail);
+                            g_slots.Hot(index).thumbnail = 0;
+                            g_perf.Add(PERF_COUNT_DWM);
                         }
-                        // 선택이 변경되었으므로, 해당 썸네일의 이전 목적지 사각형을 초기화하여 다음 타이머에서 강제 업데이트 유도
-                        g_lastDestRects[index] = {}; // 모든 멤버를 0으로 초기화
+                        // 선택이 변경되었으므로, 해당 슬롯의 마지막 적용 배치를 잊어 강제 업데이트 유도
+                        g_frame.InvalidateSlot(index);
                     } else { // 선택이 해제된 경우
-                        g_Selected[index] = NULL;
-                        if (g_Thumbnails[index])
+                        g_slots.Hot(index).selected = 0;
+                        if (g_slots.Hot(index).thumbnail)
                         {
-                            DwmUnregisterThumbnail(g_Thumbnails[index]);
-                            g_Thumbnails[index] = NULL;
+                            g_backend->Unregister(g_slots.Hot(index).thumbnail);
+                            g_slots.Hot(index).thumbnail = 0;
+                            g_perf.Add(PERF_COUNT_DWM);
                         }
-                        g_lastDestRects[index] = {}; // 모든 멤버를 0으로 초기화
+                        g_frame.InvalidateSlot(index);
                     }
+                    if (g_activity.Watch(index) != ACTIVITY_OFF) // 감시 중이면 새 창을 기준으로 다시 시작
+                        SetSlotWatch(hWnd, index, g_slots.Hot(index).selected ? g_activity.Watch(index) : ACTIVITY_OFF);
+                    if (g_recorder.Recording(index)) // 기록 중이면 새 창으로 빈 기록부터 다시 시작
+                        SetSlotRecording(hWnd, index, g_slots.Hot(index).selected != 0);
+                    UpdateSlotBinding(index);
+                    ScheduleSave(hWnd);
+                    UpdatePreviewLayout(hWnd); // 새로 선택된 창의 썸네일을 즉시 등록
+                    NoteUserInteraction(hWnd);
                 }
             }
             
@@ -756,26 +3504,96 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 // HWND_TOPMOST 또는 HWND_NOTOPMOST를 사용하여 창 최상단 상태 변경
                 SetWindowPos(hWnd, (g_alwaysOnTop ? HWND_TOPMOST : HWND_NOTOPMOST),
                              0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE);
+                ScheduleSave(hWnd);
             }
             else if (id == IDM_RUN_AT_STARTUP) // "부팅시 실행" 메뉴
             {
                 g_runAtStartup = !g_runAtStartup; // 상태 토글
                 SetRunAtStartup(g_runAtStartup); // 레지스트리 설정 업데이트
             }
+            else if (id == IDM_PERF_OVERLAY) // "성능 통계 표시" 메뉴
+            {
+                ShowPerfOverlay(hWnd, g_hPerfOverlay == NULL);
+            }
+            else if (id == IDM_PERF_DUMP) // "성능 기록 저장" 메뉴
+            {
+                g_perfDump = !g_perfDump;
+                if (g_perfDump)
+                    SetTimer(hWnd, ID_PERF_DUMP_TIMER, PERF_DUMP_INTERVAL, NULL);
+                else
+                    KillTimer(hWnd, ID_PERF_DUMP_TIMER);
+                ScheduleSave(hWnd);
+            }
+            else if (id == IDM_WATCH_CHANGE || id == IDM_WATCH_IDLE) // "바뀌면 알림"/"멈추면 알림" 메뉴
+            {
+                int slot = g_rightClickedSegmentIndex;
+                if (slot >= 0 && slot < g_slots.Count())
+                {
+                    ActivityWatch watch = id == IDM_WATCH_CHANGE ? ACTIVITY_CHANGE : ACTIVITY_IDLE;
+                    SetSlotWatch(hWnd, slot, g_activity.Watch(slot) == watch ? ACTIVITY_OFF : watch);
+                }
+            }
+            else if (id == IDM_ACKNOWLEDGE) // "알림 끄기" 메뉴
+            {
+                AcknowledgeAlert(hWnd, g_rightClickedSegmentIndex);
+            }
+            else if (id == IDM_RECORD) // "화면 기록" 메뉴
+            {
+                int slot = g_rightClickedSegmentIndex;
+                if (slot >= 0 && slot < g_slots.Count())
+                    SetSlotRecording(hWnd, slot, !g_recorder.Recording(slot));
+            }
+            else if (id == IDM_SAVE_RECORDING) // "기록 저장" 메뉴
+            {
+                SaveRecording(hWnd, g_rightClickedSegmentIndex);
+            }
+            else if (id == IDM_RELOAD_FILTER) // "창 필터 다시 읽기" 메뉴
+            {
+                // 필터는 작업 스레드가 사용하므로 다시 읽기와 재열거도 작업 스레드에서 수행
+                g_worker.Post(WM_WORKER_FILTER);
+            }
+            else if (id == IDM_GRID_LAYOUT) // "격자 배치" 메뉴
+            {
+                g_gridLayout = !g_gridLayout; // 상태 토글
+                int maxSlots = MaxSlotCount();
+                if (!g_gridLayout && g_slots.Count() > maxSlots)
+                {
+                    // 가로 한 줄로는 지금 슬롯을 모두 담을 수 없음: 슬롯(선택)을 지우지 않도록 전환을 취소
+                    g_gridLayout = true;
+                    wchar_t buf[160];
+                    wsprintf(buf, L"가로 한 줄 배치에서는 최대 %d개까지 표시할 수 있습니다.\n창을 %d개 이하로 줄인 뒤 다시 시도하세요.",
+                             maxSlots, maxSlots);
+                    MessageBox(hWnd, buf, L"알림", MB_OK | MB_ICONINFORMATION);
+                }
+                else
+                {
+                    UpdateGridArea(hWnd);
+                    UpdatePreviewLayout(hWnd); // 바뀐 배치에 맞춰 콤보박스/썸네일 이동 및 메인 윈도우 크기 조정
+                    InvalidateRect(hWnd, NULL, FALSE);
+                    ScheduleSave(hWnd);
+                }
+            }
             else if (id == IDM_INITIALIZE) // "초기화 후 종료" 메뉴
             {
                 g_resetRequested = true; // 초기화 요청 플래그 설정
+                KillTimer(hWnd, ID_SAVE_TIMER); // 예약된 저장 취소
                 g_alwaysOnTop = false;   // 초기 상태로 설정
                 g_runAtStartup = false;
-                g_numSegments = NUM_SEGMENTS_DEFAULT; // 기본 미리보기 개수로 복원
+                g_gridLayout = false;
+                g_slots.Resize(NUM_SEGMENTS_DEFAULT); // 기본 미리보기 개수로 복원
                 
                 // 윈도우 크기를 기본 미리보기 개수에 맞춰 재설정
-                int previewWidth = (PREVIEW_HEIGHT * PREVIEW_ASPECT_RATIO_NUMERATOR) / PREVIEW_ASPECT_RATIO_DENOMINATOR;
-                g_windowWidth = g_numSegments * previewWidth;
+                g_windowWidth = g_slots.Count() * g_layout.DefaultSlotWidth();
+                g_windowHeight = ScaleDpi(TOTAL_HEIGHT);
                 SetWindowPos(hWnd, NULL, CW_USEDEFAULT, CW_USEDEFAULT, g_windowWidth, g_windowHeight,
                              SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
                 
                 ResetRegistrySettings(); // 애플리케이션 레지스트리 설정 초기화
+                {
+                    wchar_t path[MAX_PATH];
+                    if (GetDataFilePath(L"session.dat", path))
+                        DeleteFile(path); // 저장된 슬롯 연결 삭제
+                }
                 // 부팅 시 자동 실행 레지스트리도 명시적으로 삭제
                 {
                     HKEY hRunKey;
@@ -790,79 +3608,46 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             }
             else if (id == IDM_ADD_PREVIEW) // "창+1" (미리보기 창 추가) 메뉴
             {
-                if (g_numSegments < MAX_SEGMENTS) // 최대 개수를 초과하지 않는 경우
+                int maxSlots = MaxSlotCount();
+                if (g_slots.Count() < maxSlots) // 화면에 담을 수 있는 개수를 초과하지 않는 경우
                 {
                     SendMessage(hWnd, WM_SETREDRAW, FALSE, 0); // 화면 업데이트 일시 중지
-                    
+
                     int insertIndex;
                     // 우클릭된 인덱스가 유효하면 해당 인덱스의 '오른쪽'에 삽입
-                    if (g_rightClickedSegmentIndex >= 0 && g_rightClickedSegmentIndex < g_numSegments) {
+                    if (g_rightClickedSegmentIndex >= 0 && g_rightClickedSegmentIndex < g_slots.Count()) {
                         insertIndex = g_rightClickedSegmentIndex + 1;
                     } else {
-                        // 유효하지 않은 인덱스 (빈 공간 우클릭) 또는 현재 개수보다 크거나 같으면 맨 마지막에 추가
-                        insertIndex = g_numSegments; 
-                    }
-                    
-                    // Step 1: g_Selected 요소들을 오른쪽으로 한 칸씩 이동
-                    for (int i = g_numSegments; i > insertIndex; --i) {
-                        g_Selected[i] = g_Selected[i-1];
+                        // 유효하지 않은 인덱스 (빈 공간 우클릭)면 맨 마지막에 추가
+                        insertIndex = g_slots.Count();
                     }
-                    g_Selected[insertIndex] = NULL; // 새로 추가될 슬롯은 비어있음
+                    InsertSlot(hWnd, insertIndex); // 빈 슬롯과 콤보박스 하나만 추가, 뒤쪽 슬롯의 썸네일은 유지
+                    ScheduleSave(hWnd);
 
-                    // Step 2: DWM 썸네일 핸들과 관련 상태들을 모두 정리.
-                    // 이 위치 이후의 모든 슬롯은 이제 새로운 DWM 썸네일 등록이 필요함.
-                    for (int i = insertIndex; i <= g_numSegments; ++i) { // g_numSegments는 증가 전 마지막 인덱스 + 1
-                        if (g_Thumbnails[i]) {
-                            DwmUnregisterThumbnail(g_Thumbnails[i]); // 기존 핸들 해제
-                        }
-                        g_Thumbnails[i] = NULL; // 핸들 NULL
-                        g_lastDestRects[i] = {}; // 이전 목적지 사각형 초기화
-                    }
-
-                    g_numSegments++; // 미리보기 개수 증가
-                    RecreatePreviews(hWnd); // 콤보박스 컨트롤들만 재구성 (데이터 배열은 이미 조정됨)
                     SendMessage(hWnd, WM_SETREDRAW, TRUE, 0); // 화면 업데이트 재개
                     RedrawWindow(hWnd, NULL, NULL, RDW_ERASE | RDW_INVALIDATE | RDW_ALLCHILDREN); // 전체 다시 그리기
                 }
                 else
                 {
                     wchar_t buf[128];
-                    wsprintf(buf, L"최대 창의 갯수는 %d개 입니다.", MAX_SEGMENTS);
+                    wsprintf(buf, L"최대 창의 갯수는 %d개 입니다.", maxSlots);
                     MessageBox(hWnd, buf, L"알림", MB_OK | MB_ICONINFORMATION);
                 }
             }
             else if (id == IDM_REMOVE_PREVIEW) // "창-1" (미리보기 창 제거) 메뉴
             {
-                if (g_numSegments > 1) // 최소 개수(1개) 이하로 줄어들지 않도록 함
+                if (g_slots.Count() > 1) // 최소 개수(1개) 이하로 줄어들지 않도록 함
                 {
                     SendMessage(hWnd, WM_SETREDRAW, FALSE, 0); // 화면 업데이트 일시 중지
 
                     int removeIndex = g_rightClickedSegmentIndex; // 우클릭된 위치를 제거 인덱스로 사용
-                    // 우클릭 인덱스가 유효하지 않거나 (빈 공간 우클릭), 현재 개수보다 크거나 같으면 맨 마지막에서 제거
-                    if (removeIndex < 0 || removeIndex >= g_numSegments) { 
-                        removeIndex = g_numSegments - 1; // 맨 마지막에서 제거
-                    }
-                    
-                    // Step 1: g_Selected 요소들을 왼쪽으로 한 칸씩 이동
-                    // (removeIndex부터 시작하여, removeIndex + 1의 내용을 removeIndex로 복사)
-                    for (int i = removeIndex; i < g_numSegments - 1; ++i) {
-                        g_Selected[i] = g_Selected[i+1];
-                    }
-                    g_Selected[g_numSegments - 1] = NULL; // 맨 마지막 슬롯은 비어있음
-
-                    // Step 2: DWM 썸네일 핸들과 관련 상태들을 모두 정리.
-                    // 이 위치 이후의 모든 슬롯은 이제 새로운 DWM 썸네일 등록이 필요하거나 비어있음.
-                    // (g_numSegments는 아직 감소 전이므로 g_numSegments - 1 인덱스까지 반복)
-                    for (int i = removeIndex; i < g_numSegments; ++i) { 
-                        if (g_Thumbnails[i]) {
-                            DwmUnregisterThumbnail(g_Thumbnails[i]); // 기존 핸들 해제
-                        }
-                        g_Thumbnails[i] = NULL; // 핸들 NULL
-                        g_lastDestRects[i] = {}; // 이전 목적지 사각형 초기화
+                    // 우클릭 인덱스가 유효하지 않으면 (빈 공간 우클릭) 맨 마지막에서 제거
+                    if (removeIndex < 0 || removeIndex >= g_slots.Count()) {
+                        removeIndex = g_slots.Count() - 1;
                     }
+                    RemoveSlot(hWnd, removeIndex); // 해당 슬롯의 썸네일과 콤보박스만 제거
+                    ScheduleSave(hWnd);
 
-                    g_numSegments--; // 미리보기 개수 감소
-                    RecreatePreviews(hWnd); // 콤보박스 컨트롤들만 재구성 (데이터 배열은 이미 조정됨)
                     SendMessage(hWnd, WM_SETREDRAW, TRUE, 0); // 화면 업데이트 재개
                     RedrawWindow(hWnd, NULL, NULL, RDW_ERASE | RDW_INVALIDATE | RDW_ALLCHILDREN); // 전체 다시 그리기
                 }
@@ -871,6 +3656,17 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                     MessageBox(hWnd, L"최소 창의 갯수는 1개 입니다.", L"알림", MB_OK | MB_ICONINFORMATION);
                 }
             }
+            else if (id == IDM_MOVE_LEFT || id == IDM_MOVE_RIGHT) // 슬롯 순서 변경 메뉴
+            {
+                int from = g_rightClickedSegmentIndex;
+                int to = from + (id == IDM_MOVE_LEFT ? -1 : 1);
+                if (from >= 0 && from < g_slots.Count() && to >= 0 && to < g_slots.Count())
+                {
+                    MoveSlot(hWnd, from, to);
+                    InvalidateRect(hWnd, NULL, FALSE);
+                    ScheduleSave(hWnd);
+                }
+            }
             else if (id == IDM_EXIT) // "종료" 메뉴
             {
                 DestroyWindow(hWnd); // 윈도우 파괴 (종료)
@@ -878,212 +3674,229 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         }
         break;
         
-        case WM_TIMER: // 타이머 메시지 (주기적인 업데이트)
+        case WM_TIMER: // 타이머 메시지 (갱신 스케줄러)
         {
-            if (!g_dropdownActive) // 드롭다운이 열려있지 않을 때만 업데이트 진행
+            if (wParam == ID_TIMER)
             {
-                int cumulativeWidth = 0;             // 현재까지의 미리보기 슬롯들의 누적 너비
-                int newWidths[MAX_SEGMENTS] = {0};   // 각 썸네일의 새로운 너비를 저장할 배열
-                RECT destRect;                       // 썸네일이 그려질 목적지 사각형
-
-                // 1. 현재 실행 중인 창 목록을 모든 콤보박스에 업데이트 (새 창 추가, 닫힌 창 제거)
-                EnumWindows(EnumWindowsProc, (LPARAM)hWnd);
-
-                // 2. 각 미리보기 슬롯에 대한 DWM 썸네일 업데이트 및 너비 계산
-                for (int i = 0; i < g_numSegments; i++)
-                {
-                    int currentPreviewWidth = 0;   // 실제 썸네일이 그려질 너비
-                    int currentPreviewHeight = 0;  // 실제 썸네일이 그려질 높이
-                    
-                    bool bThumbnailRegisteredThisCycle = false; // 이번 사이클에 썸네일이 새로 등록되었는지 여부
-
-                    // 대상 창이 선택되어 있고 유효한 경우
-                    if (g_Selected[i] && IsWindow(g_Selected[i]))
-                    {
-                        // 썸네일이 아직 등록되지 않았다면 등록 시도
-                        if (!g_Thumbnails[i])
-                        {
-                            HRESULT hr = DwmRegisterThumbnail(hWnd, g_Selected[i], &g_Thumbnails[i]);
-                            if (SUCCEEDED(hr)) {
-                                bThumbnailRegisteredThisCycle = true; // 새로 등록됨
-                            } else {
-                                // 등록 실패 (예: 대상 창이 갑자기 유효하지 않게 됨), 선택되지 않은 상태로 처리
-                                // 이 경우 DWM 썸네일이 생성되지 않으므로, 이 슬롯은 빈 상태처럼 동작해야 함.
-                                g_Selected[i] = NULL; // 선택 해제 처리하여 아래 'no selection' 블록으로 이동
-                            }
-                        }
+                g_scheduler.NoteWakeup(GetTickCount64());
+                PerfScope perf(g_perf, PERF_PHASE_REFRESH);
+                g_perf.Add(PERF_COUNT_TICKS);
+                RunRefreshTasks(hWnd); // 실행 시각이 된 점검 작업만 실행하고 타이머 재설정
+            }
+            else if (wParam == ID_PERF_OVERLAY_TIMER)
+            {
+                UpdatePerfOverlay(hWnd);
+            }
+            else if (wParam == ID_CAPTURE_TIMER) // 캡처로 그리는 썸네일 갱신 (최소화 중에는 건너뜀)
+            {
+                if (!IsIconic(hWnd))
+                    g_captureBackend.Refresh();
+            }
+            else if (wParam == ID_ACTIVITY_TIMER) // 감시 슬롯 표본/멈춤 판정, 알림 테두리 깜빡임
+            {
+                RunActivityMonitor(hWnd);
+            }
+            else if (wParam == ID_RECORD_TIMER) // 기록 슬롯 프레임 추가
+            {
+                RunRecorder(hWnd);
+            }
+            else if (wParam == ID_PERF_DUMP_TIMER)
+            {
+                AppendPerfDump();
+            }
+            else if (wParam == ID_SAVE_TIMER) // 예약된 설정/세션 저장
+            {
+                KillTimer(hWnd, ID_SAVE_TIMER);
+                g_pendingSave.Done();
+                SaveSettings(hWnd);
+                SaveSession();
+            }
+        }
+        break;
 
-                        if (g_Thumbnails[i]) // 썸네일이 유효한 경우 (기존 또는 방금 등록)
-                        {
-                            SIZE srcSize = {};
-                            if (SUCCEEDED(DwmQueryThumbnailSourceSize(g_Thumbnails[i], &srcSize)) && srcSize.cy > 0)
-                            {
-                                if (srcSize.cy <= PREVIEW_HEIGHT)
-                                {
-                                    currentPreviewHeight = srcSize.cy;
-                                    currentPreviewWidth = srcSize.cx;
-                                }
-                                else
-                                {
-                                    double scale = (double)PREVIEW_HEIGHT / srcSize.cy;
-                                    currentPreviewHeight = PREVIEW_HEIGHT;
-                                    currentPreviewWidth = (int)std::round(srcSize.cx * scale);
-                                }
-                            }
-                            else // 썸네일은 있으나 소스 크기 가져오기 실패 (예: 대상 창 최소화 또는 DWM 문제)
-                            {
-                                // 썸네일이 존재하지만 소스 크기를 가져올 수 없는 경우, 여전히 기본 비율 사용
-                                currentPreviewHeight = PREVIEW_HEIGHT;
-                                currentPreviewWidth = (PREVIEW_HEIGHT * PREVIEW_ASPECT_RATIO_NUMERATOR) / PREVIEW_ASPECT_RATIO_DENOMINATOR;
-                            }
-                        }
-                        else // g_Selected[i]는 있지만 g_Thumbnails[i]가 NULL인 경우 (방금 등록 실패한 경우 등)
-                        {
-                            // 선택된 창은 있지만 썸네일이 없는 경우, 기본 비율 사용
-                            currentPreviewHeight = PREVIEW_HEIGHT;
-                            currentPreviewWidth = (PREVIEW_HEIGHT * PREVIEW_ASPECT_RATIO_NUMERATOR) / PREVIEW_ASPECT_RATIO_DENOMINATOR;
-                        }
-                    }
-                    else // 콤보박스에 선택된 창이 없거나 유효하지 않은 경우
-                    {
-                        // 기존 썸네일이 있다면 해제 (WM_COMMAND에서 이미 해제되었을 가능성도 있음)
-                        if (g_Thumbnails[i]) {
-                            DwmUnregisterThumbnail(g_Thumbnails[i]);
-                            g_Thumbnails[i] = NULL;
-                        }
-                        currentPreviewHeight = PREVIEW_HEIGHT;
-                        currentPreviewWidth = (PREVIEW_HEIGHT * PREVIEW_ASPECT_RATIO_NUMERATOR) / PREVIEW_ASPECT_RATIO_DENOMINATOR;
-                    }
+        case WM_SIZE: // 최소화/복원 시 갱신 간격 조정
+        {
+            if (g_hMainWnd && (wParam == SIZE_MINIMIZED || wParam == SIZE_RESTORED))
+            {
+                UpdateThrottle(hWnd);
+                ArmRefreshTimer(hWnd);
+            }
+        }
+        break;
 
-                    newWidths[i] = currentPreviewWidth; // 각 콤보박스 너비 조절에 사용될 너비 저장
-                    
-                    // 썸네일이 그려질 목적지 사각형 설정 (콤보박스 아래, 계산된 너비/높이)
-                    destRect.left = cumulativeWidth;
-                    destRect.top = DROP_HEIGHT;
-                    destRect.right = cumulativeWidth + currentPreviewWidth;
-                    destRect.bottom = DROP_HEIGHT + currentPreviewHeight;
-                    
-                    // DWM 썸네일 업데이트 조건 확인:
-                    // 1. 썸네일 핸들이 유효하고 (즉, 대상 창이 선택됨)
-                    // 2. 새로 등록되었거나 (bThumbnailRegisteredThisCycle)
-                    // 3. 목적지 사각형이 이전과 달라졌을 때
-                    if (g_Thumbnails[i] && (bThumbnailRegisteredThisCycle || !EqualRect(&destRect, &g_lastDestRects[i])))
-                    {
-                        // 잔여 이미지 문제 해결을 위해 일시적으로 숨김 후 재노출
-                        DWM_THUMBNAIL_PROPERTIES propsHide = {}; // 모든 멤버를 0으로 초기화
-                        propsHide.dwFlags = DWM_TNP_RECTDESTINATION | DWM_TNP_VISIBLE;
-                        propsHide.fVisible = FALSE; // 썸네일을 숨김
-                        propsHide.rcDestination = destRect; // 목적지 사각형 업데이트
-                        DwmUpdateThumbnailProperties(g_Thumbnails[i], &propsHide);
-                        
-                        DWM_THUMBNAIL_PROPERTIES propsShow = {}; // 모든 멤버를 0으로 초기화
-                        propsShow.dwFlags = DWM_TNP_RECTDESTINATION | DWM_TNP_VISIBLE |
-                                            DWM_TNP_SOURCECLIENTAREAONLY | DWM_TNP_OPACITY;
-                        propsShow.fVisible = TRUE; // 썸네일을 다시 보이게 함
-                        propsShow.fSourceClientAreaOnly = TRUE; // 클라이언트 영역만 표시
-                        propsShow.opacity = 255; // 완전 불투명
-                        propsShow.rcDestination = destRect; // 최종 목적지 사각형 설정
-                        DwmUpdateThumbnailProperties(g_Thumbnails[i], &propsShow);
-
-                        // 마지막으로 업데이트된 목적지 사각형 저장
-                        g_lastDestRects[i] = destRect;
-                    }
-                    // 썸네일이 더 이상 없는데 g_lastDestRects에 이전 값이 남아있다면 초기화
-                    else if (!g_Thumbnails[i] && (g_lastDestRects[i].left != 0 || g_lastDestRects[i].top != 0 || g_lastDestRects[i].right != 0 || g_lastDestRects[i].bottom != 0)) {
-                        g_lastDestRects[i] = {}; // 모든 멤버를 0으로 초기화
-                    }
+        case WM_POWERBROADCAST: // 전원 상태(AC/배터리, 절전 모드) 변경 시 갱신 간격 조정
+        {
+            if (wParam == PBT_APMPOWERSTATUSCHANGE)
+            {
+                g_powerThrottle = QueryPowerThrottle();
+                UpdateThrottle(hWnd);
+                ArmRefreshTimer(hWnd);
+            }
+        }
+        return TRUE;
 
+        case WM_APP_COLLAPSEPICKER: // 닫힌 드롭다운의 항목 축소
+        {
+            int slot = (int)wParam;
+            if (slot >= 0 && slot < g_slots.Count() && g_slots.Cold(slot).combo &&
+                !SendMessage(g_slots.Cold(slot).combo, CB_GETDROPPEDSTATE, 0, 0))
+            {
+                CollapsePicker(slot);
+            }
+        }
+        break;
 
-                    cumulativeWidth += currentPreviewWidth; // 다음 썸네일의 시작 X 좌표 계산
-                }
+        case WM_MEASUREITEM: // 오너 드로우 콤보박스 항목 높이
+        {
+            LPMEASUREITEMSTRUCT mis = (LPMEASUREITEMSTRUCT)lParam;
+            if (mis->CtlType == ODT_COMBOBOX)
+            {
+                mis->itemHeight = ScaleDpi(PICKER_ITEM_HEIGHT);
+                return TRUE;
+            }
+        }
+        break;
 
-                // 3. 메인 윈도우의 전체 너비 조정 (썸네일들의 누적 너비에 맞춰)
-                if (cumulativeWidth != g_windowWidth)
-                {
-                    g_windowWidth = cumulativeWidth;
-                    RECT rcClient = {0, 0, g_windowWidth, g_windowHeight};
-                    // 클라이언트 영역 크기에 맞춰 윈도우 실제 크기 계산 (타이틀바 없는 팝업 윈도우이므로 거의 동일)
-                    AdjustWindowRect(&rcClient, GetWindowLong(hWnd, GWL_STYLE), FALSE);
-                    int newW = rcClient.right - rcClient.left;
-                    int newH = rcClient.bottom - rcClient.top;
-                    RECT rc;
-                    GetWindowRect(hWnd, &rc); // 현재 윈도우의 화면 좌표 가져오기
-                    // 윈도우 크기만 변경 (위치 및 Z-오더는 유지)
-                    SetWindowPos(hWnd, NULL, rc.left, rc.top, newW, newH,
-                                 SWP_NOZORDER | SWP_NOACTIVATE);
-                }
+        case WM_DRAWITEM: // 오너 드로우 콤보박스 항목 그리기
+        {
+            const DRAWITEMSTRUCT* dis = (const DRAWITEMSTRUCT*)lParam;
+            if (dis->CtlType == ODT_COMBOBOX)
+            {
+                DrawPickerItem(dis);
+                return TRUE;
+            }
+        }
+        break;
 
-                // 4. 콤보박스들의 위치 및 너비 조정
-                int cumulativeX = 0;
-                for (int i = 0; i < g_numSegments; i++)
-                {
-                    if (g_ComboBoxes[i])
-                    {
-                        // 콤보박스를 계산된 새 너비(newWidths[i])로 이동 및 크기 조절
-                        MoveWindow(g_ComboBoxes[i], cumulativeX, 0, newWidths[i], DROP_HEIGHT, TRUE);
-                        // 드롭다운 리스트의 너비도 콤보박스 너비에 맞춰 설정
-                        SendMessage(g_ComboBoxes[i], CB_SETDROPPEDWIDTH, (WPARAM)newWidths[i], 0);
-                    }
-                    cumulativeX += newWidths[i]; // 다음 콤보박스의 시작 X 좌표 계산
-                }
+        case WM_APP_RECORDING_SAVED: // 기록 파일 쓰기가 끝남
+        {
+            bool ok = g_recordingWriter.Finish();
+            std::wstring message = ok ? L"기록을 저장했습니다.\n" : L"기록을 저장하지 못했습니다.\n";
+            message += g_recordingWriter.Path();
+            MessageBox(hWnd, message.c_str(), L"알림", MB_OK | (ok ? MB_ICONINFORMATION : MB_ICONWARNING));
+        }
+        break;
 
-                // 5. 각 콤보박스의 항목(윈도우 타이틀) 업데이트
-                for (int i = 0; i < g_numSegments; i++)
-                {
-                    if (g_ComboBoxes[i])
-                    {
-                        UpdateComboBoxItem(g_ComboBoxes[i]);
-                    }
-                }
-            }
+        case WM_APP_SNAPSHOT: // 작업 스레드가 창 목록 변경분을 게시함
+        {
+            g_scheduler.NoteWakeup(GetTickCount64());
+            PerfScope perf(g_perf, PERF_PHASE_EVENTS);
+            g_perf.Add(PERF_COUNT_TICKS);
+            ProcessSnapshot(hWnd);
         }
         break;
         
-        case WM_PAINT: // 윈도우 그리기 메시지 (더블 버퍼링 적용)
+        case WM_PAINT: // 윈도우 그리기 메시지 (더블 버퍼링 적용, 무효화된 영역만 그림)
         {
+            PerfScope perf(g_perf, PERF_PHASE_PAINT);
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hWnd, &ps); // 윈도우 DC 가져오기
-            
-            HDC memDC = CreateCompatibleDC(hdc); // 메모리 DC 생성
-            // 윈도우 크기와 호환되는 비트맵 생성 (더블 버퍼링 버퍼)
-            HBITMAP memBMP = CreateCompatibleBitmap(hdc, g_windowWidth, g_windowHeight);
-            HBITMAP oldBmp = (HBITMAP)SelectObject(memDC, memBMP); // 비트맵을 메모리 DC에 선택
-            
-            RECT rc;
-            SetRect(&rc, 0, 0, g_windowWidth, g_windowHeight); // 그릴 영역 설정
-            FillRect(memDC, &rc, (HBRUSH)GetStockObject(BLACK_BRUSH)); // 배경을 검은색으로 채움
-            
-            SetStretchBltMode(memDC, HALFTONE); // 이미지 축소/확대 시 부드러운 렌더링 모드 설정
-            // 메모리 DC의 내용을 실제 윈도우 DC로 복사 (더블 버퍼링의 최종 단계)
-            BitBlt(hdc, 0, 0, g_windowWidth, g_windowHeight, memDC, 0, 0, SRCCOPY);
-            
-            SelectObject(memDC, oldBmp); // 원래 비트맵으로 복원
-            DeleteObject(memBMP);        // 생성한 비트맵 파괴
-            DeleteDC(memDC);             // 메모리 DC 파괴
-            
+
+            RECT rc = ps.rcPaint; // 다시 그려야 하는 영역 (클라이언트 좌표)
+            int cx = rc.right - rc.left;
+            int cy = rc.bottom - rc.top;
+            HDC memDC = (cx > 0 && cy > 0) ? g_backBuffer.Prepare(hdc, g_windowWidth, g_windowHeight) : NULL;
+            if (memDC)
+            {
+                FillRect(memDC, &rc, (HBRUSH)GetStockObject(BLACK_BRUSH)); // 무효화된 영역만 배경을 검은색으로 채움
+                g_captureBackend.Paint(memDC, rc); // 캡처 대체 경로 썸네일 (DWM 썸네일은 합성기가 그 위에 그림)
+                PaintAlertBorders(memDC, rc);      // 알림 테두리 (썸네일은 테두리 안쪽으로 줄어 있음)
+                // 백 버퍼의 같은 영역만 실제 윈도우 DC로 복사 (더블 버퍼링의 최종 단계)
+                BitBlt(hdc, rc.left, rc.top, cx, cy, memDC, rc.left, rc.top, SRCCOPY);
+            }
+            else if (cx > 0 && cy > 0)
+            {
+                FillRect(hdc, &rc, (HBRUSH)GetStockObject(BLACK_BRUSH)); // 버퍼를 만들 수 없으면 직접 그림
+                g_captureBackend.Paint(hdc, rc);
+                PaintAlertBorders(hdc, rc);
+            }
+
             EndPaint(hWnd, &ps); // 그리기 완료
+            if (!g_firstPaintTime)
+            {
+                g_firstPaintTime = PerfClockMicros();
+                NoteStartupMilestone(hWnd);
+            }
+        }
+        break;
+
+        case WM_MOVE: // 성능 통계 창을 메인 윈도우에 붙여 둠
+        {
+            if (g_hPerfOverlay)
+                UpdatePerfOverlay(hWnd);
+        }
+        break;
+
+        case WM_EXITSIZEMOVE: // 드래그 이동이 끝나면 창 위치 저장 예약 (이동 중에는 저장하지 않음)
+            // 같은 DPI의 다른 모니터로 옮기면 WM_DPICHANGED가 오지 않으므로 작업 영역/슬롯 상한은 여기서 다시 읽음
+            if (MonitorFromWindow(hWnd, MONITOR_DEFAULTTONEAREST) != g_monitor.monitor && RefreshMonitorMetrics(hWnd, 0))
+                ApplyMonitorMetrics(hWnd);
+            ScheduleSave(hWnd);
+            break;
+
+        case WM_DPICHANGED: // 다른 배율의 모니터로 옮겼거나 배율이 바뀜: 제안된 위치로 옮기고 새 DPI로 다시 배치
+        {
+            const RECT* suggested = (const RECT*)lParam;
+            // 크기는 배치 결과(UpdatePreviewLayout)로 정하므로 위치만 따름
+            SetWindowPos(hWnd, NULL, suggested->left, suggested->top, 0, 0,
+                         SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE);
+            if (RefreshMonitorMetrics(hWnd, HIWORD(wParam)))
+                ApplyMonitorMetrics(hWnd);
+        }
+        break;
+
+        case WM_SETTINGCHANGE: // 작업 표시줄 크기/위치 변경: 격자 배치 영역과 슬롯 상한이 바뀜
+            if (wParam == SPI_SETWORKAREA && RefreshMonitorMetrics(hWnd, 0))
+                ApplyMonitorMetrics(hWnd);
+            break;
+
+        case WM_DISPLAYCHANGE: // 화면 해상도/색 형식/모니터 구성 변경: 백 버퍼를 다음 그리기에서 다시 만들고 모니터 정보를 다시 읽음
+        {
+            g_backBuffer.Release();
+            if (RefreshMonitorMetrics(hWnd, 0))
+                ApplyMonitorMetrics(hWnd);
+            InvalidateRect(hWnd, NULL, FALSE);
         }
         break;
         
         case WM_DESTROY: // 윈도우 파괴 시 정리 작업
         {
             KillTimer(hWnd, ID_TIMER); // 타이머 해제
+            KillTimer(hWnd, ID_ACTIVITY_TIMER);
+            KillTimer(hWnd, ID_RECORD_TIMER);
+            g_recordingWriter.Finish(); // 쓰는 중인 기록 파일은 끝까지 씀
+            g_worker.Stop();           // 작업 스레드 종료 (창 이벤트 훅은 작업 스레드가 해제)
+            g_snapshots.Release(g_deferredSnapshot);
+            g_deferredSnapshot = NULL;
+            ShowPerfOverlay(hWnd, false);
+            if (g_perfDump)
+            {
+                KillTimer(hWnd, ID_PERF_DUMP_TIMER);
+                AppendPerfDump(); // 마지막 저장 이후 구간도 남김
+            }
+            g_hMainWnd = NULL;
             
+            KillTimer(hWnd, ID_SAVE_TIMER); // 예약된 저장은 여기서 바로 수행
             if (!g_resetRequested) // "초기화 후 종료"가 아닌 일반 종료인 경우에만 설정 저장
             {
                 SaveSettings(hWnd);
+                SaveSession(); // 마지막 저장과 같으면 쓰지 않음
             }
             
             // 모든 DWM 썸네일 핸들 해제
-            for (int i = 0; i < MAX_SEGMENTS; i++)
+            for (int i = 0; i < g_slots.Count(); i++)
             {
-                if (g_Thumbnails[i])
+                if (g_slots.Hot(i).thumbnail)
                 {
-                    DwmUnregisterThumbnail(g_Thumbnails[i]);
-                    g_Thumbnails[i] = NULL;
+                    g_backend->Unregister(g_slots.Hot(i).thumbnail);
+                    g_slots.Hot(i).thumbnail = 0;
                 }
             }
-            DeleteObject(g_hFont); // 생성한 폰트 객체 파괴
+            g_backBuffer.Release(); // 백 버퍼 해제
+            if (g_hFont)
+                DeleteObject(g_hFont); // 생성한 폰트 객체 파괴
+            if (g_hPerfFont)
+                DeleteObject(g_hPerfFont);
             PostQuitMessage(0); // 메시지 루프 종료를 알림
         }
         break;
@@ -1096,28 +3909,47 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
 //=============================================================================
 // wWinMain: 프로그램의 유니코드 진입점
-// - 클라이언트 영역 높이: DROP_HEIGHT + PREVIEW_HEIGHT = 325px
+// - 클라이언트 영역 높이: DROP_HEIGHT + PREVIEW_HEIGHT = 325px x DPI 배율 (격자 배치에서는 줄 수만큼, 썸네일 높이는 축소될 수 있음)
 // - 전체 가로폭은 모든 미리보기 창의 누적 폭 (초기 g_windowWidth는 미리보기 개수 * 기본PreviewWidth)
 // - 타이틀바 제거(WS_POPUP) 및 창 내용 드래그로 이동 기능 구현
 //=============================================================================
 int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLine, int nCmdShow)
 {
     UNREFERENCED_PARAMETER(hPrevInstance); // 사용되지 않는 매개변수
-    UNREFERENCED_PARAMETER(lpCmdLine);     // 사용되지 않는 매개변수
     UNREFERENCED_PARAMETER(nCmdShow);      // 사용되지 않는 매개변수
 
-    // 화면 해상도에 기반하여 미리보기 슬롯의 기본 너비와 최대 개수 계산
-    int defaultPreviewWidth = (PREVIEW_HEIGHT * PREVIEW_ASPECT_RATIO_NUMERATOR) / PREVIEW_ASPECT_RATIO_DENOMINATOR;
-    int screenWidth = GetSystemMetrics(SM_CXSCREEN); // 주 모니터의 가로 해상도
-    g_maxSegments = screenWidth / defaultPreviewWidth; // 화면 너비에 들어갈 수 있는 최대 미리보기 개수
-    if (g_maxSegments < 1) // 최소 1개는 표시 가능하도록 보장
-        g_maxSegments = 1;
-
-    LoadStartupSettings(); // 레지스트리에서 저장된 미리보기 창 개수를 로드
-    if (g_numSegments > g_maxSegments) // 로드된 개수가 화면의 최대 개수를 초과하면 조정
-        g_numSegments = g_maxSegments;
-    
-    g_windowWidth = g_numSegments * defaultPreviewWidth; // 초기 메인 윈도우의 전체 클라이언트 가로폭 결정
+    g_perf.SetClock(PerfClockMicros); // 창 생성 단계부터 계측
+    g_updater.SetClock(PerfClockMicros);
+    g_presenter.SetPerf(&g_perf);
+    g_presenter.SetInset(AlertInset, NULL);
+    g_launchTime = PerfClockMicros();
+    {
+        // 프로세스 생성부터 여기까지 (로더, 정적 초기화). FILETIME은 100ns 단위
+        FILETIME creation, exitTime, kernelTime, userTime, now;
+        GetSystemTimeAsFileTime(&now);
+        if (GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernelTime, &userTime))
+        {
+            uint64_t start = ((uint64_t)creation.dwHighDateTime << 32) | creation.dwLowDateTime;
+            uint64_t current = ((uint64_t)now.dwHighDateTime << 32) | now.dwLowDateTime;
+            g_launchDelay = current > start ? (current - start) / 10 : 0;
+        }
+    }
+    g_startupTiming = lpCmdLine && wcsstr(lpCmdLine, L"/startuptime") != NULL;
+    // /capture: DWM 썸네일 대신 항상 캡처 대체 경로 사용 (합성 없는 세션의 동작 확인용)
+    g_previewBackend.SetForceFallback(lpCmdLine && wcsstr(lpCmdLine, L"/capture") != NULL);
+
+    // 배치 계산기 초기화 (콤보박스 높이, 미리보기 높이, 기본 비율). 창을 만든 뒤 창이 있는 모니터 기준으로 다시 맞춤
+    RefreshMonitorMetrics(NULL, 0);
+    g_layout.SetPickerHeight(ScaleDpi(DROP_HEIGHT));
+    g_layout.SetPreviewHeight(ScaleDpi(PREVIEW_HEIGHT));
+    g_layout.SetDefaultAspect(PREVIEW_ASPECT_RATIO_NUMERATOR, PREVIEW_ASPECT_RATIO_DENOMINATOR);
+
+    g_slots.Resize(NUM_SEGMENTS_DEFAULT);
+    LoadStartupSettings(); // 레지스트리에서 저장된 미리보기 창 개수와 배치 방식을 로드
+    LoadSession();         // 세션 파일이 있으면 슬롯 개수와 슬롯별 창 식별 정보를 복원
+    LoadFilterRules();     // 창 목록 필터 규칙 (첫 열거 전에 컴파일)
+    int defaultPreviewWidth = g_layout.DefaultSlotWidth();
+    g_windowWidth = g_slots.Count() * defaultPreviewWidth; // 초기 메인 윈도우의 전체 클라이언트 가로폭 결정
     
     MSG msg;
     WNDCLASS wc = {}; // 모든 멤버를 0으로 초기화
@@ -0,0 +1,820 @@
+/*
+    x11backend.cpp
+    =======================
+    X11PreviewBackend 구현 (XComposite/XDamage/XRender, 캡처 대체 경로는 XGetImage/MIT-SHM)
+*/
+#include "x11backend.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <chrono>
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/Xcomposite.h>
+#include <X11/extensions/Xdamage.h>
+
+namespace
+{
+    // 다른 클라이언트의 창은 언제든 사라질 수 있으므로 (BadWindow/BadDrawable/BadDamage 등)
+    // 기본 처리기(프로세스 종료) 대신 오류 수만 세고 넘어감. 요청이 실패했는지는 XSync 후 수가 바뀌었는지로 판단
+    unsigned long s_errorCount = 0;
+    int (*s_previousHandler)(Display*, XErrorEvent*) = NULL;
+
+    int HandleXError(Display* display, XErrorEvent* error)
+    {
+        (void)display;
+        (void)error;
+        s_errorCount++;
+        return 0;
+    }
+
+    // UTF-8 바이트열을 wchar_t(UTF-32) 문자열 끝에 붙임. 잘못된 바이트는 U+FFFD
+    void AppendUtf8(const unsigned char* bytes, size_t length, std::wstring& out)
+    {
+        size_t i = 0;
+        while (i < length)
+        {
+            unsigned char lead = bytes[i];
+            unsigned long code;
+            size_t extra;
+            if (lead < 0x80) { code = lead; extra = 0; }
+            else if ((lead & 0xE0) == 0xC0) { code = lead & 0x1F; extra = 1; }
+            else if ((lead & 0xF0) == 0xE0) { code = lead & 0x0F; extra = 2; }
+            else if ((lead & 0xF8) == 0xF0) { code = lead & 0x07; extra = 3; }
+            else { out.push_back((wchar_t)0xFFFD); i++; continue; }
+
+            size_t k = 1;
+            for (; k <= extra && i + k < length && (bytes[i + k] & 0xC0) == 0x80; k++)
+                code = (code << 6) | (bytes[i + k] & 0x3F);
+            if (k <= extra) // 중간에 끊긴 시퀀스
+            {
+                out.push_back((wchar_t)0xFFFD);
+                i += k;
+                continue;
+            }
+            out.push_back((wchar_t)code);
+            i += extra + 1;
+        }
+    }
+
+    bool Intersects(const LayoutRect& a, const LayoutRect& b)
+    {
+        return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+    }
+}
+
+X11PreviewBackend::X11PreviewBackend(Display* display, Window host)
+    : m_display(display), m_root(DefaultRootWindow(display)), m_host(host), m_hostPicture(None),
+      m_capture(false), m_gc(NULL), m_hostVisual(NULL), m_hostDepth(0), m_useShm(false), m_captureImage(NULL),
+      m_captureCx(0), m_captureCy(0), m_damageEventBase(0), m_clientList(None), m_netWmName(None),
+      m_utf8String(None), m_sink(NULL), m_dirtyCount(0), m_damageEvents(0), m_paints(0), m_captures(0),
+      m_captureMicros(0)
+{
+    m_shm.shmid = -1;
+    m_shm.shmaddr = NULL;
+}
+
+X11PreviewBackend::~X11PreviewBackend()
+{
+    Stop();
+    for (size_t i = 0; i < m_thumbnails.size(); i++)
+        Release(m_thumbnails[i]);
+    m_thumbnails.clear();
+    ReleaseCapture();
+    if (m_gc)
+        XFreeGC(m_display, m_gc);
+    if (m_hostPicture != None) // 합성 모드로 초기화됨
+    {
+        XRenderFreePicture(m_display, m_hostPicture);
+        XCompositeUnredirectSubwindows(m_display, m_root, CompositeRedirectAutomatic);
+    }
+    XSync(m_display, False);
+    if (s_previousHandler)
+        XSetErrorHandler(s_previousHandler);
+    s_previousHandler = NULL;
+}
+
+bool X11PreviewBackend::Initialize(std::string* error, bool captureOnly)
+{
+    XWindowAttributes attributes;
+    if (!XGetWindowAttributes(m_display, m_host, &attributes))
+    {
+        *error = "cannot query the host window";
+        return false;
+    }
+    m_hostVisual = attributes.visual;
+    m_hostDepth = attributes.depth;
+
+    int eventBase, errorBase;
+    int major = 0, minor = 2;
+    XRenderPictFormat* format = NULL;
+    if (captureOnly)
+        *error = "capture mode requested";
+    else if (!XCompositeQueryExtension(m_display, &eventBase, &errorBase) ||
+             !XCompositeQueryVersion(m_display, &major, &minor) || (major == 0 && minor < 2))
+        *error = "Composite extension 0.2 or later is not available";
+    else if (!XRenderQueryExtension(m_display, &eventBase, &errorBase))
+        *error = "RENDER extension is not available";
+    else if (!XDamageQueryExtension(m_display, &m_damageEventBase, &errorBase))
+        *error = "DAMAGE extension is not available";
+    else if ((format = XRenderFindVisualFormat(m_display, attributes.visual)) == NULL)
+        *error = "no RENDER format for the host visual";
+
+    if (!format)
+    {
+        // 캡처 대체 경로: 캡처 결과와 축소 결과를 그대로 주고받으려면 화면 픽셀이 32비트여야 함
+        int formatCount = 0;
+        int bitsPerPixel = 0;
+        XPixmapFormatValues* formats = XListPixmapFormats(m_display, &formatCount);
+        for (int i = 0; i < formatCount; i++)
+        {
+            if (formats[i].depth == m_hostDepth)
+                bitsPerPixel = formats[i].bits_per_pixel;
+        }
+        if (formats)
+            XFree(formats);
+        if (bitsPerPixel != 32 || m_hostVisual->c_class != TrueColor)
+        {
+            *error += "; capture fallback needs a 32-bit TrueColor screen";
+            return false;
+        }
+        m_capture = true;
+        m_gc = XCreateGC(m_display, m_host, 0, NULL);
+        m_useShm = XShmQueryExtension(m_display) != False;
+    }
+
+    s_previousHandler = XSetErrorHandler(HandleXError);
+    if (!m_capture)
+    {
+        // 자동 리디렉션: 서버가 화면 합성을 계속 맡고, 가려진 창도 화면 밖 버퍼에 내용을 유지
+        XCompositeRedirectSubwindows(m_display, m_root, CompositeRedirectAutomatic);
+        m_hostPicture = XRenderCreatePicture(m_display, m_host, format, 0, NULL);
+    }
+    m_clientList = XInternAtom(m_display, "_NET_CLIENT_LIST_STACKING", False);
+    m_netWmName = XInternAtom(m_display, "_NET_WM_NAME", False);
+    m_utf8String = XInternAtom(m_display, "UTF8_STRING", False);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// 창 열거/제목
+//-----------------------------------------------------------------------------
+void X11PreviewBackend::EnumerateWindows(WindowVisitor visit, void* context)
+{
+    // 창 관리자가 있으면 관리 대상 창 목록(아래 -> 위 순서), 없으면 (예: Xvfb 단독) 루트의 자식 창
+    Atom type = None;
+    int format = 0;
+    unsigned long count = 0, after = 0;
+    unsigned char* data = NULL;
+    if (XGetWindowProperty(m_display, m_root, m_clientList, 0, 0x10000, False, XA_WINDOW,
+                           &type, &format, &count, &after, &data) == Success &&
+        type == XA_WINDOW && format == 32 && count > 0)
+    {
+        const unsigned long* windows = (const unsigned long*)data; // 32비트 형식은 long 배열로 돌려줌
+        for (unsigned long i = count; i-- > 0;)
+        {
+            Track(windows[i]);
+            if (!visit(context, (WindowId)windows[i]))
+                break;
+        }
+        XFree(data);
+        return;
+    }
+    if (data)
+        XFree(data);
+
+    Window rootReturn, parent;
+    Window* children = NULL;
+    unsigned int childCount = 0;
+    if (!XQueryTree(m_display, m_root, &rootReturn, &parent, &children, &childCount))
+        return;
+    for (unsigned int i = childCount; i-- > 0;) // 위에 있는 창부터 (Win32 EnumWindows와 같은 순서)
+    {
+        if (children[i] == m_host)
+            continue;
+        Track(children[i]);
+        if (!visit(context, (WindowId)children[i]))
+            break;
+    }
+    if (children)
+        XFree(children);
+}
+
+bool X11PreviewBackend::ReadTitle(WindowId id, std::wstring& title)
+{
+    // 제목은 서버의 속성이므로 대상 클라이언트가 응답하지 않아도 읽힘 (항상 true)
+    title.clear();
+    if (!ReadTextProperty((Window)id, m_netWmName, title))
+        ReadTextProperty((Window)id, XA_WM_NAME, title);
+    return true;
+}
+
+bool X11PreviewBackend::ReadTextProperty(Window window, Atom property, std::wstring& text)
+{
+    XTextProperty prop;
+    if (!XGetTextProperty(m_display, window, &prop, property) || !prop.value)
+        return false;
+    bool ok = true;
+    if (prop.encoding == m_utf8String)
+    {
+        AppendUtf8(prop.value, prop.nitems, text);
+    }
+    else if (prop.encoding == XA_STRING)
+    {
+        for (unsigned long i = 0; i < prop.nitems; i++)
+            text.push_back((wchar_t)prop.value[i]); // Latin-1은 코드 포인트와 같음
+    }
+    else
+    {
+        // COMPOUND_TEXT 등: 로캘 변환을 거쳐 UTF-8로 받음
+        char** list = NULL;
+        int count = 0;
+        ok = Xutf8TextPropertyToTextList(m_display, &prop, &list, &count) >= Success && list;
+        for (int i = 0; ok && i < count; i++)
+        {
+            const unsigned char* bytes = (const unsigned char*)list[i];
+            size_t length = 0;
+            while (bytes[length])
+                length++;
+            AppendUtf8(bytes, length, text);
+        }
+        if (list)
+            XFreeStringList(list);
+    }
+    XFree(prop.value);
+    return ok && !text.empty();
+}
+
+bool X11PreviewBackend::IsAlive(WindowId id)
+{
+    XWindowAttributes attributes;
+    return XGetWindowAttributes(m_display, (Window)id, &attributes) != 0;
+}
+
+bool X11PreviewBackend::IsCandidate(WindowId id)
+{
+    return (Window)id != m_host && IsShown(id);
+}
+
+bool X11PreviewBackend::IsShown(WindowId id)
+{
+    XWindowAttributes attributes;
+    return XGetWindowAttributes(m_display, (Window)id, &attributes) &&
+           attributes.map_state == IsViewable && attributes.c_class == InputOutput;
+}
+
+void X11PreviewBackend::Track(Window window)
+{
+    if (m_sink && m_tracked.insert(window).second)
+        XSelectInput(m_display, window, StructureNotifyMask | PropertyChangeMask);
+}
+
+//-----------------------------------------------------------------------------
+// 썸네일
+//-----------------------------------------------------------------------------
+PreviewHandle X11PreviewBackend::Register(WindowId source)
+{
+    Window window = (Window)source;
+    XWindowAttributes attributes;
+    if (!XGetWindowAttributes(m_display, window, &attributes) || attributes.c_class != InputOutput)
+        return 0;
+    if (m_capture)
+    {
+        Thumbnail* thumbnail = new Thumbnail();
+        thumbnail->source = window;
+        thumbnail->picture = None;
+        thumbnail->damage = 0;
+        thumbnail->scaled = NULL;
+        thumbnail->cx = attributes.width;
+        thumbnail->cy = attributes.height;
+        thumbnail->viewable = attributes.map_state == IsViewable;
+        thumbnail->hasAlpha = false;
+        thumbnail->depth = attributes.depth;
+        thumbnail->destination.left = thumbnail->destination.top = 0;
+        thumbnail->destination.right = thumbnail->destination.bottom = 0;
+        thumbnail->visible = false;
+        thumbnail->dirty = false;
+        thumbnail->repaint = false;
+        thumbnail->transformCx = thumbnail->transformCy = 0;
+        thumbnail->transformDx = thumbnail->transformDy = 0;
+        thumbnail->paints = 0;
+        m_thumbnails.push_back(thumbnail);
+        Track(window);
+        return (PreviewHandle)thumbnail;
+    }
+    XRenderPictFormat* format = XRenderFindVisualFormat(m_display, attributes.visual);
+    if (!format)
+        return 0;
+
+    unsigned long errors = s_errorCount;
+    XRenderPictureAttributes pa;
+    pa.subwindow_mode = IncludeInferiors; // 창 관리자 프레임 안의 자식 창 내용까지 포함
+    Picture picture = XRenderCreatePicture(m_display, window, format, CPSubwindowMode, &pa);
+    XRenderSetPictureFilter(m_display, picture, FilterBilinear, NULL, 0);
+    Damage damage = XDamageCreate(m_display, window, XDamageReportNonEmpty);
+    XSync(m_display, False);
+    if (s_errorCount != errors) // 그 사이 창이 사라짐
+    {
+        XDamageDestroy(m_display, damage);
+        XRenderFreePicture(m_display, picture);
+        return 0;
+    }
+
+    Thumbnail* thumbnail = new Thumbnail();
+    thumbnail->source = window;
+    thumbnail->picture = picture;
+    thumbnail->damage = damage;
+    thumbnail->scaled = NULL;
+    thumbnail->cx = attributes.width;
+    thumbnail->cy = attributes.height;
+    thumbnail->viewable = attributes.map_state == IsViewable;
+    thumbnail->hasAlpha = format->type == PictTypeDirect && format->direct.alphaMask != 0;
+    thumbnail->depth = attributes.depth;
+    thumbnail->destination.left = thumbnail->destination.top = 0;
+    thumbnail->destination.right = thumbnail->destination.bottom = 0;
+    thumbnail->visible = false;
+    thumbnail->dirty = false;
+    thumbnail->repaint = false;
+    thumbnail->transformCx = thumbnail->transformCy = 0;
+    thumbnail->transformDx = thumbnail->transformDy = 0;
+    thumbnail->paints = 0;
+    m_thumbnails.push_back(thumbnail);
+    Track(window);
+    return (PreviewHandle)thumbnail;
+}
+
+void X11PreviewBackend::Unregister(PreviewHandle handle)
+{
+    Thumbnail* thumbnail = (Thumbnail*)handle;
+    for (size_t i = 0; i < m_thumbnails.size(); i++)
+    {
+        if (m_thumbnails[i] != thumbnail)
+            continue;
+        if (thumbnail->visible)
+            m_clears.push_back(thumbnail->destination);
+        if (thumbnail->dirty)
+            m_dirtyCount--;
+        Release(thumbnail);
+        m_thumbnails.erase(m_thumbnails.begin() + i);
+        return;
+    }
+}
+
+void X11PreviewBackend::Release(Thumbnail* thumbnail)
+{
+    if (thumbnail->damage)
+        XDamageDestroy(m_display, thumbnail->damage); // 창이 이미 파괴되었으면 BadDamage (무시됨)
+    if (thumbnail->picture != None)
+        XRenderFreePicture(m_display, thumbnail->picture);
+    if (thumbnail->scaled)
+        XDestroyImage(thumbnail->scaled); // 픽셀 버퍼(malloc)도 해제
+    delete thumbnail;
+}
+
+bool X11PreviewBackend::QuerySourceSize(PreviewHandle handle, int* cx, int* cy)
+{
+    // 크기는 ConfigureNotify로 갱신되므로 서버에 묻지 않음
+    const Thumbnail* thumbnail = (const Thumbnail*)handle;
+    if (!thumbnail || !thumbnail->viewable || thumbnail->cx <= 0 || thumbnail->cy <= 0)
+    {
+        *cx = *cy = 0;
+        return false;
+    }
+    *cx = thumbnail->cx;
+    *cy = thumbnail->cy;
+    return true;
+}
+
+void X11PreviewBackend::Update(PreviewHandle handle, const LayoutRect& destination, bool visible)
+{
+    Thumbnail* thumbnail = (Thumbnail*)handle;
+    if (thumbnail->visible == visible && thumbnail->destination == destination)
+        return;
+    if (thumbnail->visible)
+        m_clears.push_back(thumbnail->destination); // 비켜난 자리는 배경으로 지움
+    thumbnail->destination = destination;
+    thumbnail->visible = visible;
+    MarkDirty(thumbnail);
+}
+
+void X11PreviewBackend::Invalidate(const LayoutRect& area)
+{
+    for (size_t i = 0; i < m_thumbnails.size(); i++)
+    {
+        if (m_thumbnails[i]->visible && Intersects(m_thumbnails[i]->destination, area))
+            MarkDirty(m_thumbnails[i]);
+    }
+}
+
+void X11PreviewBackend::RefreshCaptures()
+{
+    for (size_t i = 0; i < m_thumbnails.size(); i++)
+    {
+        if (m_thumbnails[i]->visible)
+            MarkDirty(m_thumbnails[i], false);
+    }
+}
+
+void X11PreviewBackend::MarkDirty(Thumbnail* thumbnail, bool repaint)
+{
+    thumbnail->repaint = thumbnail->repaint || repaint;
+    if (!thumbnail->dirty)
+    {
+        thumbnail->dirty = true;
+        m_dirtyCount++;
+    }
+}
+
+void X11PreviewBackend::Commit()
+{
+    // 1. 썸네일이 비켜난 자리를 지우고, 그 자리와 겹치는 썸네일은 다시 그림
+    for (size_t k = 0; k < m_clears.size(); k++)
+    {
+        const LayoutRect& rc = m_clears[k];
+        if (rc.Width() > 0 && rc.Height() > 0)
+            XClearArea(m_display, m_host, rc.left, rc.top, rc.Width(), rc.Height(), False);
+        Invalidate(rc);
+    }
+    m_clears.clear();
+
+    // 2. 손상되었거나 옮겨진 썸네일만 합성
+    if (m_dirtyCount > 0)
+    {
+        for (size_t i = 0; i < m_thumbnails.size(); i++)
+        {
+            Thumbnail* thumbnail = m_thumbnails[i];
+            if (!thumbnail->dirty)
+                continue;
+            thumbnail->dirty = false;
+            if (thumbnail->visible && m_capture)
+                PaintCapture(thumbnail);
+            else if (thumbnail->visible)
+                Paint(thumbnail);
+            thumbnail->repaint = false;
+        }
+        m_dirtyCount = 0;
+    }
+    XFlush(m_display);
+}
+
+void X11PreviewBackend::Paint(Thumbnail* thumbnail)
+{
+    const LayoutRect& rc = thumbnail->destination;
+    int dx = rc.Width(), dy = rc.Height();
+    if (dx <= 0 || dy <= 0)
+        return;
+    if (!thumbnail->viewable || thumbnail->cx <= 0 || thumbnail->cy <= 0)
+    {
+        // 숨겨진 창은 그릴 내용이 없으므로 배경만 남김
+        XClearArea(m_display, m_host, rc.left, rc.top, dx, dy, False);
+        return;
+    }
+
+    // 변환은 목적지 좌표를 원본 좌표로 옮기므로 배율은 원본/목적지. 크기가 같으면 다시 설정하지 않음
+    if (thumbnail->transformCx != thumbnail->cx || thumbnail->transformCy != thumbnail->cy ||
+        thumbnail->transformDx != dx || thumbnail->transformDy != dy)
+    {
+        XTransform transform = { {
+            { XDoubleToFixed((double)thumbnail->cx / dx), XDoubleToFixed(0), XDoubleToFixed(0) },
+            { XDoubleToFixed(0), XDoubleToFixed((double)thumbnail->cy / dy), XDoubleToFixed(0) },
+            { XDoubleToFixed(0), XDoubleToFixed(0), XDoubleToFixed(1) }
+        } };
+        XRenderSetPictureTransform(m_display, thumbnail->picture, &transform);
+        thumbnail->transformCx = thumbnail->cx;
+        thumbnail->transformCy = thumbnail->cy;
+        thumbnail->transformDx = dx;
+        thumbnail->transformDy = dy;
+    }
+    if (thumbnail->hasAlpha)
+        XClearArea(m_display, m_host, rc.left, rc.top, dx, dy, False); // 반투명 창은 배경 위에 합성
+    XRenderComposite(m_display, thumbnail->hasAlpha ? PictOpOver : PictOpSrc, thumbnail->picture, None, m_hostPicture,
+                     0, 0, 0, 0, rc.left, rc.top, dx, dy);
+    thumbnail->paints++;
+    m_paints++;
+}
+
+void X11PreviewBackend::PaintCapture(Thumbnail* thumbnail)
+{
+    const LayoutRect& rc = thumbnail->destination;
+    int dx = rc.Width(), dy = rc.Height();
+    if (dx <= 0 || dy <= 0)
+        return;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    XImage* image = NULL;
+    if (thumbnail->viewable && thumbnail->cx > 0 && thumbnail->cy > 0)
+        image = Capture(thumbnail->source, thumbnail->depth, thumbnail->cx, thumbnail->cy);
+    if (!image || image->bits_per_pixel != 32)
+    {
+        // 숨겨졌거나 화면 밖으로 나가 읽을 수 없는 창은 배경만 남김. 다시 읽게 되면 전체를 그림
+        XClearArea(m_display, m_host, rc.left, rc.top, dx, dy, False);
+        thumbnail->changes.Reset();
+        return;
+    }
+
+    // 축소 결과 버퍼는 목적지 크기가 바뀔 때만 다시 만듦
+    if (!thumbnail->scaled || thumbnail->scaled->width != dx || thumbnail->scaled->height != dy)
+    {
+        if (thumbnail->scaled)
+            XDestroyImage(thumbnail->scaled);
+        char* data = (char*)malloc((size_t)dx * dy * 4);
+        thumbnail->scaled = XCreateImage(m_display, m_hostVisual, m_hostDepth, ZPixmap, 0, data, dx, dy, 32, dx * 4);
+        if (!thumbnail->scaled)
+        {
+            free(data);
+            return;
+        }
+        thumbnail->changes.Reset(); // 새 버퍼는 비어 있으므로 전체를 줄임
+    }
+    PixelImage src = { (uint8_t*)image->data, image->width, image->height, image->bytes_per_line };
+    PixelImage dst = { (uint8_t*)thumbnail->scaled->data, dx, dy, thumbnail->scaled->bytes_per_line };
+    m_captures++;
+    bool changed = thumbnail->changes.Update(src);
+    if (changed)
+    {
+        int srcTop, srcBottom, dstTop, dstBottom;
+        thumbnail->changes.DirtyRows(&srcTop, &srcBottom);
+        m_scaler.ScaleRows(src, dst, srcTop, srcBottom, &dstTop, &dstBottom);
+    }
+    if (thumbnail->repaint || (changed && thumbnail->changes.DirtyCount() ==
+                                          thumbnail->changes.Columns() * thumbnail->changes.Rows()))
+    {
+        XPutImage(m_display, m_host, m_gc, thumbnail->scaled, 0, 0, rc.left, rc.top, dx, dy);
+    }
+    else if (changed)
+    {
+        thumbnail->changes.DirtyRects(dx, dy, m_dirtyRects);
+        for (size_t i = 0; i < m_dirtyRects.size(); i++)
+        {
+            const LayoutRect& dirty = m_dirtyRects[i];
+            XPutImage(m_display, m_host, m_gc, thumbnail->scaled, dirty.left, dirty.top, rc.left + dirty.left,
+                      rc.top + dirty.top, dirty.Width(), dirty.Height());
+        }
+    }
+    if (thumbnail->repaint || changed) // 지난 캡처와 같고 다시 그릴 필요도 없으면 화면을 그대로 둠
+    {
+        thumbnail->paints++;
+        m_paints++;
+    }
+    m_captureMicros += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+XImage* X11PreviewBackend::Capture(Window source, int depth, int cx, int cy)
+{
+    // 창 이미지 요청은 사각형이 화면 안에 모두 보이고 깊이가 이미지와 같아야 함 (아니면 BadMatch).
+    // 화면 밖으로 걸친 부분은 잘라 읽고 나머지는 검게 두며, 호스트와 깊이가 다른 창(ARGB 등)은 화면에 합성된
+    // 결과를 루트 창에서 읽음 (캡처 모드는 합성 관리자가 없으므로 루트의 그 자리가 곧 창 내용)
+    int x, y;
+    Window child;
+    if (!XTranslateCoordinates(m_display, source, m_root, 0, 0, &x, &y, &child))
+        return NULL;
+    Screen* screen = DefaultScreenOfDisplay(m_display);
+    int left = x > 0 ? x : 0;
+    int top = y > 0 ? y : 0;
+    int right = x + cx < WidthOfScreen(screen) ? x + cx : WidthOfScreen(screen);
+    int bottom = y + cy < HeightOfScreen(screen) ? y + cy : HeightOfScreen(screen);
+    if (left >= right || top >= bottom)
+        return NULL; // 화면 밖에 있는 창
+    Drawable drawable = source;
+    int originX = x, originY = y; // drawable 좌표의 원점 (루트 기준)
+    if (depth != m_hostDepth)
+    {
+        if (DefaultDepthOfScreen(screen) != m_hostDepth)
+            return NULL;
+        drawable = m_root;
+        originX = originY = 0;
+    }
+    if (!EnsureCapture(cx, cy))
+        return NULL;
+
+    // 공유 버퍼는 지금까지 본 가장 큰 원본 크기로 만들고, 읽을 때마다 이미지 크기만 바꿔 씀.
+    // 서버는 요청한 너비에 맞춰 빈틈없이 쓰므로 줄 간격도 맞춤
+    m_captureImage->width = cx;
+    m_captureImage->height = cy;
+    m_captureImage->bytes_per_line = cx * (m_captureImage->bits_per_pixel / 8);
+    if (left == x && top == y && right == x + cx && bottom == y + cy)
+    {
+        if (m_useShm)
+            return XShmGetImage(m_display, drawable, m_captureImage, x - originX, y - originY, AllPlanes) ? m_captureImage : NULL;
+        return XGetSubImage(m_display, drawable, x - originX, y - originY, cx, cy, AllPlanes, ZPixmap, m_captureImage, 0, 0)
+                   ? m_captureImage : NULL;
+    }
+    // 일부만 화면 안: 보이는 부분만 읽어 제자리에 넣음 (드문 경우라 XGetSubImage로 복사)
+    memset(m_captureImage->data, 0, (size_t)m_captureImage->bytes_per_line * cy);
+    return XGetSubImage(m_display, drawable, left - originX, top - originY, right - left, bottom - top, AllPlanes, ZPixmap,
+                        m_captureImage, left - x, top - y) ? m_captureImage : NULL;
+}
+
+bool X11PreviewBackend::EnsureCapture(int cx, int cy)
+{
+    if (m_captureImage && cx <= m_captureCx && cy <= m_captureCy)
+        return true;
+    int width = cx > m_captureCx ? cx : m_captureCx;
+    int height = cy > m_captureCy ? cy : m_captureCy;
+    ReleaseCapture();
+    if (m_useShm)
+    {
+        m_captureImage = XShmCreateImage(m_display, m_hostVisual, m_hostDepth, ZPixmap, NULL, &m_shm, width, height);
+        if (m_captureImage)
+        {
+            m_shm.shmid = shmget(IPC_PRIVATE, (size_t)m_captureImage->bytes_per_line * height, IPC_CREAT | 0600);
+            m_shm.shmaddr = m_shm.shmid >= 0 ? (char*)shmat(m_shm.shmid, NULL, 0) : (char*)-1;
+        }
+        unsigned long errors = s_errorCount;
+        bool attached = false;
+        if (m_captureImage && m_shm.shmaddr != (char*)-1)
+        {
+            m_captureImage->data = m_shm.shmaddr;
+            m_shm.readOnly = False;
+            attached = XShmAttach(m_display, &m_shm) && (XSync(m_display, False), s_errorCount == errors);
+        }
+        if (m_shm.shmid >= 0)
+            shmctl(m_shm.shmid, IPC_RMID, NULL); // 양쪽이 떼어내면 세그먼트가 사라지도록 미리 삭제 표시
+        if (attached)
+        {
+            m_captureCx = width;
+            m_captureCy = height;
+            return true;
+        }
+        // 원격 서버 등: SHM을 포기하고 클라이언트 버퍼로
+        if (m_captureImage)
+        {
+            m_captureImage->data = NULL;
+            XDestroyImage(m_captureImage);
+            m_captureImage = NULL;
+        }
+        if (m_shm.shmaddr && m_shm.shmaddr != (char*)-1)
+            shmdt(m_shm.shmaddr);
+        m_shm.shmid = -1;
+        m_shm.shmaddr = NULL;
+        m_useShm = false;
+    }
+    char* data = (char*)malloc((size_t)width * height * 4);
+    if (!data)
+        return false;
+    m_captureImage = XCreateImage(m_display, m_hostVisual, m_hostDepth, ZPixmap, 0, data, width, height, 32, width * 4);
+    if (!m_captureImage)
+    {
+        free(data);
+        return false;
+    }
+    m_captureCx = width;
+    m_captureCy = height;
+    return true;
+}
+
+void X11PreviewBackend::ReleaseCapture()
+{
+    if (!m_captureImage)
+        return;
+    if (m_shm.shmaddr)
+    {
+        XShmDetach(m_display, &m_shm);
+        XSync(m_display, False);
+        shmdt(m_shm.shmaddr);
+        m_shm.shmaddr = NULL;
+        m_shm.shmid = -1;
+        m_captureImage->data = NULL; // 세그먼트는 XDestroyImage가 free하면 안 됨
+    }
+    XDestroyImage(m_captureImage);
+    m_captureImage = NULL;
+    m_captureCx = m_captureCy = 0;
+}
+
+void X11PreviewBackend::Flush()
+{
+    XSync(m_display, False);
+}
+
+uint64_t X11PreviewBackend::PaintCount(PreviewHandle handle) const
+{
+    return handle ? ((const Thumbnail*)handle)->paints : 0;
+}
+
+void X11PreviewBackend::FrameCounts(PreviewHandle handle, uint64_t* changed, uint64_t* skipped) const
+{
+    const Thumbnail* thumbnail = (const Thumbnail*)handle;
+    *changed = thumbnail ? thumbnail->changes.FramesChanged() : 0;
+    *skipped = thumbnail ? thumbnail->changes.FramesSkipped() : 0;
+}
+
+X11PreviewBackend::Thumbnail* X11PreviewBackend::Find(Window source) const
+{
+    for (size_t i = 0; i < m_thumbnails.size(); i++)
+    {
+        if (m_thumbnails[i]->source == source)
+            return m_thumbnails[i];
+    }
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// 이벤트
+//-----------------------------------------------------------------------------
+bool X11PreviewBackend::Start(WindowEventSink* sink)
+{
+    m_sink = sink;
+    XSelectInput(m_display, m_root, SubstructureNotifyMask | PropertyChangeMask);
+    return true;
+}
+
+void X11PreviewBackend::Stop()
+{
+    if (!m_sink)
+        return;
+    m_sink = NULL;
+    XSelectInput(m_display, m_root, NoEventMask);
+    for (std::unordered_set<Window>::const_iterator it = m_tracked.begin(); it != m_tracked.end(); ++it)
+        XSelectInput(m_display, *it, NoEventMask);
+    m_tracked.clear();
+}
+
+void X11PreviewBackend::Notify(WindowEventKind kind, Window window)
+{
+    if (m_sink)
+    {
+        WindowEvent ev = { kind, (WindowId)window };
+        m_sink->OnWindowEvent(ev);
+    }
+}
+
+bool X11PreviewBackend::HandleEvent(const XEvent& event)
+{
+    if (!m_capture && event.type == m_damageEventBase + XDamageNotify)
+    {
+        const XDamageNotifyEvent& damage = (const XDamageNotifyEvent&)event;
+        XDamageSubtract(m_display, damage.damage, None, None); // 다음 손상 알림을 다시 받음
+        m_damageEvents++;
+        for (size_t i = 0; i < m_thumbnails.size(); i++)
+        {
+            if (m_thumbnails[i]->damage == damage.damage)
+            {
+                MarkDirty(m_thumbnails[i]);
+                break;
+            }
+        }
+        return true;
+    }
+
+    Thumbnail* thumbnail;
+    switch (event.type)
+    {
+    case CreateNotify:
+        if (event.xcreatewindow.parent != m_root)
+            return false;
+        Notify(WINDOW_EVENT_CREATE, event.xcreatewindow.window);
+        return true;
+    case DestroyNotify:
+        m_tracked.erase(event.xdestroywindow.window);
+        if ((thumbnail = Find(event.xdestroywindow.window)) != NULL)
+            thumbnail->viewable = false; // 썸네일 해제는 목록에서 빠진 뒤 호출 측이 함
+        Notify(WINDOW_EVENT_DESTROY, event.xdestroywindow.window);
+        return true;
+    case MapNotify:
+        if (event.xmap.window == m_host)
+            return false;
+        if ((thumbnail = Find(event.xmap.window)) != NULL)
+        {
+            thumbnail->viewable = true;
+            MarkDirty(thumbnail);
+        }
+        Notify(WINDOW_EVENT_SHOW, event.xmap.window);
+        return true;
+    case UnmapNotify:
+        if (event.xunmap.window == m_host)
+            return false;
+        if ((thumbnail = Find(event.xunmap.window)) != NULL)
+        {
+            thumbnail->viewable = false;
+            MarkDirty(thumbnail);
+        }
+        Notify(WINDOW_EVENT_HIDE, event.xunmap.window);
+        return true;
+    case ConfigureNotify:
+        if (event.xconfigure.window == m_host)
+            return false;
+        if ((thumbnail = Find(event.xconfigure.window)) != NULL &&
+            (thumbnail->cx != event.xconfigure.width || thumbnail->cy != event.xconfigure.height))
+        {
+            thumbnail->cx = event.xconfigure.width;
+            thumbnail->cy = event.xconfigure.height;
+            MarkDirty(thumbnail);
+        }
+        Notify(WINDOW_EVENT_LOCATIONCHANGE, event.xconfigure.window);
+        return true;
+    case PropertyNotify:
+        if (event.xproperty.window == m_root)
+        {
+            // 관리 대상 창 목록이 바뀜: 목록 재열거 (창 하나를 특정하지 않으므로 루트로 알림)
+            if (event.xproperty.atom == m_clientList)
+                Notify(WINDOW_EVENT_SHOW, m_root);
+            return true;
+        }
+        if (event.xproperty.atom == m_netWmName || event.xproperty.atom == XA_WM_NAME)
+            Notify(WINDOW_EVENT_NAMECHANGE, event.xproperty.window);
+        return event.xproperty.window != m_host;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,152 @@
+// x11backend.h
+// X11 미리보기 백엔드 (previewbackend.h의 Linux 구현).
+// - XComposite: 최상위 창을 자동 리디렉션하여 가려지거나 화면 밖에 있는 창도 내용을 가짐
+// - XRender: 대상 창 그림(Picture)에 축소 변환과 쌍선형 필터를 걸어 호스트 창에 합성
+// - XDamage: 대상 창 내용이 바뀐 썸네일만 다음 Commit에서 다시 그림 (변경이 없으면 그리지 않음)
+// GPU 없이 소프트웨어 렌더링만으로 동작하므로 Xvfb에서도 검증 가능 (x11viewer --selftest).
+// 확장이 없는 서버(예: 원격 X, 오래된 Xvnc)에서는 캡처 대체 경로로 동작: 대상 창을 XGetImage(MIT-SHM이 있으면
+// XShmGetImage)로 읽어 downscale.h 커널로 줄인 뒤 XPutImage로 그림.
+// Xlib은 스레드 안전하지 않으므로 모든 함수는 디스플레이를 연 스레드에서만 호출.
+#ifndef X11BACKEND_H
+#define X11BACKEND_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <X11/Xlib.h>
+#include <X11/extensions/Xrender.h>
+#include <X11/extensions/XShm.h>
+#include "previewbackend.h"
+#include "downscale.h"
+#include "framediff.h"
+#include "windowtracker.h" // WindowEventSource
+
+//=============================================================================
+// X11PreviewBackend
+// - Initialize: Composite(0.2 이상)/RENDER/DAMAGE 확장을 확인하고 루트의 자식 창을 자동 리디렉션
+// - 창 이벤트 소스로도 동작: Start 후 HandleEvent가 생성/파괴/표시/숨김/제목/크기 변경을 추적기에 전달
+//   (루트의 SubstructureNotify/PropertyChange + 열거한 창마다 StructureNotify/PropertyChange)
+// - 썸네일 하나 = 대상 창 Picture(IncludeInferiors) + Damage. 목적지/원본 크기가 같으면 변환을 다시 설정하지 않음
+// - 손상 이벤트는 썸네일에 "다시 그림" 표시만 하므로 Commit 사이의 여러 손상은 한 번의 합성으로 합쳐짐
+// - 캡처 모드: 손상 알림이 없으므로 호출 측이 RefreshCaptures로 주기적으로 다시 그림을 요청.
+//   캡처 버퍼는 모든 썸네일이 함께 쓰고(가장 큰 원본 크기로 한 번 할당), 썸네일마다 슬롯 크기의 축소 결과만 가짐.
+//   리디렉션이 없으므로 가려진 부분은 화면에 보이는 내용 그대로이고, 화면 밖으로 나간 창은 읽지 못함(배경만 남김).
+//   주기적 재캡처는 FrameChangeDetector로 지난 캡처와 비교해 바뀐 타일이 없으면 축소/전송을 건너뛰고,
+//   바뀐 타일이 있으면 그 행만 다시 줄여 바뀐 자리만 XPutImage로 보냄
+//=============================================================================
+class X11PreviewBackend : public PreviewBackend, public WindowEventSource
+{
+public:
+    X11PreviewBackend(Display* display, Window host);
+    ~X11PreviewBackend();
+
+    // 확장 확인과 리디렉션. 확장이 없거나 captureOnly이면 캡처 모드로 초기화하고 error에 이유를 남김.
+    // 캡처 모드도 쓸 수 없으면 (32비트 픽셀이 아닌 화면) false
+    bool Initialize(std::string* error, bool captureOnly = false);
+    bool CaptureMode() const { return m_capture; }
+
+    // PreviewBackend
+    virtual void EnumerateWindows(WindowVisitor visit, void* context);
+    virtual bool IsCandidate(WindowId id);
+    virtual bool ReadTitle(WindowId id, std::wstring& title);
+    virtual bool IsAlive(WindowId id);
+    virtual PreviewHandle Register(WindowId source);
+    virtual void Unregister(PreviewHandle thumbnail);
+    virtual bool QuerySourceSize(PreviewHandle thumbnail, int* cx, int* cy);
+    virtual void Update(PreviewHandle thumbnail, const LayoutRect& destination, bool visible);
+    virtual void Commit();
+    virtual void Flush();
+
+    // WindowEventSource
+    virtual bool Start(WindowEventSink* sink);
+    virtual void Stop();
+
+    // 표시 중이고 그릴 수 있는(InputOutput) 창인지
+    bool IsShown(WindowId id);
+    // X 이벤트 처리. 이 백엔드가 쓰는 이벤트(손상/대상 창 구조·속성 변경)였으면 true
+    bool HandleEvent(const XEvent& event);
+    // 호스트 창의 영역이 노출됨(Expose): 겹치는 썸네일을 다음 Commit에서 다시 그림
+    void Invalidate(const LayoutRect& area);
+    // 다시 그릴 썸네일이 있는지 (호출 측이 Commit 시점을 정하는 데 사용)
+    bool HasDirty() const { return m_dirtyCount > 0 || !m_clears.empty(); }
+    // 캡처 모드: 보이는 썸네일을 모두 다음 Commit에서 다시 캡처
+    void RefreshCaptures();
+
+    // 진단/검증용 통계
+    uint64_t DamageEvents() const { return m_damageEvents; }
+    uint64_t Paints() const { return m_paints; }
+    uint64_t PaintCount(PreviewHandle thumbnail) const;
+    uint64_t Captures() const { return m_captures; }
+    uint64_t CaptureMicros() const { return m_captureMicros; } // 캡처 + 축소 + 전송 누적 시간
+    // 캡처 모드: 썸네일 하나의 바뀐/건너뛴 캡처 수
+    void FrameCounts(PreviewHandle thumbnail, uint64_t* changed, uint64_t* skipped) const;
+
+private:
+    struct Thumbnail
+    {
+        Window source;
+        Picture picture;       // 합성 모드
+        unsigned long damage;  // Damage (XID, 합성 모드)
+        XImage* scaled;        // 캡처 모드: 목적지 크기로 줄인 결과
+        int cx, cy;            // 원본 크기
+        bool viewable;         // 원본이 표시 중 (숨겨진 창은 내용이 없으므로 크기를 모름으로 보고)
+        bool hasAlpha;         // 원본 형식에 알파가 있으면 Over, 없으면 Src로 합성
+        int depth;             // 원본 깊이 (캡처 모드: 호스트와 다르면 루트에서 읽음)
+        LayoutRect destination;
+        bool visible;
+        bool dirty;
+        bool repaint;          // 캡처 모드: 바뀐 타일만이 아니라 목적지 전체를 다시 그려야 함 (이동/노출/표시)
+        FrameChangeDetector changes; // 캡처 모드: 지난 캡처의 타일 해시
+        int transformCx, transformCy; // 마지막으로 설정한 변환의 원본/목적지 크기
+        int transformDx, transformDy;
+        uint64_t paints;
+    };
+
+    X11PreviewBackend(const X11PreviewBackend&);
+    X11PreviewBackend& operator=(const X11PreviewBackend&);
+
+    Thumbnail* Find(Window source) const;
+    // repaint=false는 캡처 모드의 주기적 재캡처 (바뀐 부분만 그림)
+    void MarkDirty(Thumbnail* thumbnail, bool repaint = true);
+    void Paint(Thumbnail* thumbnail);
+    void PaintCapture(Thumbnail* thumbnail);
+    XImage* Capture(Window source, int depth, int cx, int cy); // 공유 캡처 버퍼로 읽음. 실패하면 NULL
+    bool EnsureCapture(int cx, int cy);             // 공유 캡처 버퍼를 cx x cy 이상으로 (SHM이 안 되면 클라이언트 버퍼)
+    void ReleaseCapture();
+    void Release(Thumbnail* thumbnail);
+    void Track(Window window);                      // 창 구조/속성 변경 이벤트 구독 (창마다 한 번)
+    bool ReadTextProperty(Window window, Atom property, std::wstring& text);
+    void Notify(WindowEventKind kind, Window window);
+
+    Display* m_display;
+    Window m_root;
+    Window m_host;
+    Picture m_hostPicture;
+    bool m_capture;             // 캡처 대체 경로
+    GC m_gc;                    // 캡처 모드: 축소 결과를 호스트에 그릴 때
+    Visual* m_hostVisual;
+    int m_hostDepth;
+    bool m_useShm;              // MIT-SHM으로 캡처 (같은 기계의 서버일 때)
+    XShmSegmentInfo m_shm;
+    XImage* m_captureImage;     // 공유 캡처 버퍼 (m_captureCx x m_captureCy, SHM이면 세그먼트)
+    int m_captureCx, m_captureCy;
+    Downscaler m_scaler;
+    std::vector<LayoutRect> m_dirtyRects; // PaintCapture에서 재사용
+    int m_damageEventBase;
+    Atom m_clientList;          // _NET_CLIENT_LIST_STACKING (창 관리자가 있으면 관리 대상 창만 열거)
+    Atom m_netWmName;           // _NET_WM_NAME
+    Atom m_utf8String;          // UTF8_STRING
+    WindowEventSink* m_sink;
+    std::vector<Thumbnail*> m_thumbnails;   // 슬롯 수만큼이므로 선형 검색
+    std::vector<LayoutRect> m_clears;       // 썸네일이 비켜난 자리 (Commit에서 배경으로 지움)
+    std::unordered_set<Window> m_tracked;   // 이벤트를 구독한 창
+    size_t m_dirtyCount;
+    uint64_t m_damageEvents;
+    uint64_t m_paints;
+    uint64_t m_captures;
+    uint64_t m_captureMicros;
+};
+
+#endif // X11BACKEND_H
@@ -0,0 +1,8 @@
+#!/bin/sh
+# Linux(X11) 미리보기 창 빌드 (libx11/libxcomposite/libxdamage/libxrender/libxext 개발 패키지 필요)
+echo "Compiling X11 viewer..."
+g++ -std=c++11 -O2 -Wall -Wextra x11viewer.cpp x11backend.cpp downscale.cpp framediff.cpp windowtracker.cpp windowregistry.cpp titlestore.cpp layout.cpp -o x11viewer -lXcomposite -lXdamage -lXrender -lXext -lX11 || {
+    echo "X11 viewer compilation failed!"
+    exit 1
+}
+echo "Build successful! Run ./x11viewer (--slots N, --height N, --grid, --capture), or xvfb-run ./x11viewer --selftest"
@@ -0,0 +1,818 @@
+/*
+    x11viewer.cpp
+    =======================
+    Linux(X11)용 미리보기 창. winview.cpp와 같은 슬롯/배치 엔진(SlotTable, LayoutEngine, FrameCommitter,
+    SourceSizeCache)과 창 목록 계층(WindowTracker, WindowRegistry)을 X11PreviewBackend로 구동한다 (x11build.sh).
+
+    - 창 이벤트는 백엔드가 추적기에 전달하고, 이벤트 루프가 한 번 돌 때마다 모인 변경만 처리 (winview의 WM_APP_SNAPSHOT에 해당)
+    - 썸네일은 XDamage로 내용이 바뀐 슬롯만 다시 합성하며, 합성은 FRAME_INTERVAL에 한 번으로 제한
+    - Composite/DAMAGE가 없는 서버(또는 --capture)에서는 캡처 대체 경로: CAPTURE_INTERVAL마다 보이는 슬롯을 다시 캡처
+    - 콤보박스 대신 슬롯 위쪽 띠에 선택한 창 제목을 표시: 왼쪽 클릭 = 다음 창, 오른쪽 클릭 = 선택 해제
+    - 썸네일 클릭 = 해당 창 활성화 (_NET_ACTIVE_WINDOW), 키: + / - 슬롯 추가/제거, g 격자 배치, q 종료
+    - --selftest: 시험용 창을 직접 만들어 열거/합성/손상 갱신/제목/크기/파괴 처리를 확인하고 결과를 종료 코드로 돌려줌
+      (GPU 없이 동작하므로 xvfb-run ./x11viewer --selftest 로 검증)
+
+    사용법: x11viewer [--display NAME] [--slots N] [--height N] [--grid] [--capture] [--selftest]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <sys/select.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/keysym.h>
+
+#include "x11backend.h"
+#include "windowtracker.h"
+#include "windowregistry.h"
+#include "layout.h"
+#include "framecommit.h"
+#include "sizecache.h"
+#include "slottable.h"
+
+#define NUM_SEGMENTS_DEFAULT 3       // 시작 시 기본 미리보기 슬롯 개수
+#define PICKER_HEIGHT        24      // 슬롯 위쪽 제목 띠 높이
+#define PREVIEW_HEIGHT       200     // 썸네일 높이 기본값
+#define PREVIEW_ASPECT_RATIO_NUMERATOR 4
+#define PREVIEW_ASPECT_RATIO_DENOMINATOR 3
+#define LIST_SWEEP_INTERVAL  5000    // 이벤트 누락에 대비한 전체 재열거 주기(ms)
+#define FRAME_INTERVAL       33      // 손상된 썸네일 다시 합성 최소 간격(ms)
+#define CAPTURE_INTERVAL     500     // 캡처 대체 경로의 슬롯 다시 캡처 주기(ms, 손상 알림이 없으므로 주기적으로)
+#define SELFTEST_TIMEOUT     3000    // 자체 시험 단계마다 기다리는 최대 시간(ms)
+#define PICKER_BACKGROUND    0x303030 // 제목 띠 배경/글자 색 (RGB, 화면 형식의 픽셀 값으로 바꿔 씀)
+#define PICKER_TEXT          0xE0E0E0
+
+// 슬롯마다 배치/갱신 루프가 읽는 필드
+struct SlotHot
+{
+    WindowId selected;          // 슬롯에 선택된 대상 창
+    PreviewHandle thumbnail;    // 대상 창의 썸네일 (g_backend가 발급)
+};
+// 슬롯마다 제목 띠를 그릴 때만 쓰는 필드
+struct SlotCold
+{
+    uint32_t titleVersion;      // 제목 띠에 마지막으로 그린 제목의 버전
+};
+
+SlotTable<SlotHot, SlotCold> g_slots;
+Display* g_display = NULL;
+Window g_host = None;
+GC g_gc = NULL;
+XFontSet g_fontSet = NULL;      // 로캘 글꼴 묶음 (만들지 못하면 ASCII만 그림)
+Atom g_wmDelete = None;
+Atom g_activeWindow = None;
+X11PreviewBackend* g_backend = NULL;
+
+void WakeNothing(void* context) { (void)context; } // 한 스레드에서 루프마다 변경을 가져가므로 깨울 필요 없음
+WindowTracker g_tracker(WakeNothing, NULL);
+WindowRegistry g_registry;
+LayoutEngine g_layout;
+FrameCommitter g_frame;
+SourceSizeCache g_sizeCache;
+std::wstring g_titleBuffer;
+WindowChanges g_changes;
+int g_windowWidth = 0;
+int g_windowHeight = 0;
+bool g_gridLayout = false;
+unsigned long g_pickerBackground = 0;
+unsigned long g_pickerText = 0;
+bool g_quit = false;
+uint64_t g_lastSweep = 0;
+uint64_t g_lastCommit = 0;
+uint64_t g_lastCapture = 0;
+
+uint64_t NowMillis()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// RGB 값을 TrueColor 화면 형식의 픽셀 값으로
+unsigned long MakePixel(Visual* visual, unsigned long rgb)
+{
+    unsigned long pixel = 0;
+    unsigned long masks[3] = { visual->red_mask, visual->green_mask, visual->blue_mask };
+    for (int c = 0; c < 3; c++)
+    {
+        unsigned long value = (rgb >> (16 - c * 8)) & 0xFF;
+        unsigned long mask = masks[c];
+        int shift = 0;
+        while (mask && !(mask & 1)) { mask >>= 1; shift++; }
+        int bits = 0;
+        while (mask & 1) { mask >>= 1; bits++; }
+        pixel |= (bits >= 8 ? value << (bits - 8) : value >> (8 - bits)) << shift;
+    }
+    return pixel;
+}
+
+// wchar_t(UTF-32) 제목을 UTF-8로 (Xutf8DrawString용)
+void EncodeUtf8(const wchar_t* text, size_t length, std::string& out)
+{
+    out.clear();
+    for (size_t i = 0; i < length; i++)
+    {
+        unsigned long c = (unsigned long)text[i];
+        if (c < 0x80) {
+            out.push_back((char)c);
+        } else if (c < 0x800) {
+            out.push_back((char)(0xC0 | (c >> 6)));
+            out.push_back((char)(0x80 | (c & 0x3F)));
+        } else if (c < 0x10000) {
+            out.push_back((char)(0xE0 | (c >> 12)));
+            out.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (c & 0x3F)));
+        } else {
+            out.push_back((char)(0xF0 | (c >> 18)));
+            out.push_back((char)(0x80 | ((c >> 12) & 0x3F)));
+            out.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (c & 0x3F)));
+        }
+    }
+}
+
+//=============================================================================
+// 창 목록: 열거/제목 갱신 (winview.cpp의 VisitWindow/RefreshTitles에 해당)
+//=============================================================================
+bool VisitWindow(void* context, WindowId id)
+{
+    WindowDiff* diff = (WindowDiff*)context;
+    if (!g_backend->IsCandidate(id))
+        return true;
+    g_backend->ReadTitle(id, g_titleBuffer);
+    if (g_titleBuffer.empty()) // 제목 없는 창 (도구 창, 창 관리자 보조 창 등)
+        return true;
+    g_registry.Observe(id, g_titleBuffer.data(), g_titleBuffer.size(), *diff);
+    return true;
+}
+
+void EnumerateWindows(WindowDiff& diff)
+{
+    g_registry.BeginPass();
+    g_backend->EnumerateWindows(VisitWindow, &diff);
+    g_registry.EndPass(diff);
+}
+
+void RefreshTitles(const std::vector<WindowId>& windows, WindowDiff& diff)
+{
+    for (size_t i = 0; i < windows.size(); i++)
+    {
+        if (!g_registry.Find(windows[i]))
+            continue; // 목록에 없는 창은 다음 열거에서 판정
+        g_backend->ReadTitle(windows[i], g_titleBuffer);
+        g_registry.UpdateTitle(windows[i], g_titleBuffer.data(), g_titleBuffer.size(), diff);
+    }
+}
+
+//=============================================================================
+// 그리기
+//=============================================================================
+void DrawPicker(int slot)
+{
+    const LayoutRect& rc = g_layout.Slot(slot).picker;
+    if (rc.Width() <= 0 || rc.Height() <= 0)
+        return;
+    XSetForeground(g_display, g_gc, g_pickerBackground);
+    XFillRectangle(g_display, g_host, g_gc, rc.left, rc.top, rc.Width(), rc.Height());
+
+    std::wstring text = L"(click to choose a window)";
+    const WindowRegistry::Entry* entry = g_slots.Hot(slot).selected ? g_registry.Find(g_slots.Hot(slot).selected) : NULL;
+    if (entry)
+    {
+        size_t length;
+        const wchar_t* title = g_registry.Title(*entry, &length);
+        text.assign(title, length);
+        g_slots.Cold(slot).titleVersion = g_registry.TitleVersion(*entry);
+    }
+
+    XRectangle clip = { (short)(rc.left + 1), (short)rc.top, (unsigned short)(rc.Width() - 2), (unsigned short)rc.Height() };
+    XSetClipRectangles(g_display, g_gc, 0, 0, &clip, 1, Unsorted);
+    XSetForeground(g_display, g_gc, g_pickerText);
+    int baseline = rc.top + rc.Height() * 2 / 3;
+    std::string bytes;
+    if (g_fontSet)
+    {
+        EncodeUtf8(text.data(), text.size(), bytes);
+        Xutf8DrawString(g_display, g_host, g_fontSet, g_gc, rc.left + 4, baseline, bytes.data(), (int)bytes.size());
+    }
+    else
+    {
+        for (size_t i = 0; i < text.size(); i++)
+            bytes.push_back(text[i] < 0x80 ? (char)text[i] : '?');
+        XDrawString(g_display, g_host, g_gc, rc.left + 4, baseline, bytes.data(), (int)bytes.size());
+    }
+    XSetClipMask(g_display, g_gc, None);
+}
+
+//=============================================================================
+// UpdatePreviewLayout: 썸네일 등록/해제, 원본 크기 -> 배치 계산 -> 바뀐 슬롯만 적용 (winview.cpp와 같은 순서)
+//=============================================================================
+void UpdatePreviewLayout()
+{
+    int count = g_slots.Count();
+    static std::vector<char> registeredThisCycle;
+    registeredThisCycle.assign(count, 0);
+
+    // 1. 썸네일 등록 및 원본 크기를 배치 계산기에 전달
+    g_layout.SetSlotCount(count);
+    g_sizeCache.Resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        int sourceWidth = 0, sourceHeight = 0;
+        SlotHot& hot = g_slots.Hot(i);
+        if (hot.selected && !hot.thumbnail)
+        {
+            hot.thumbnail = g_backend->Register(hot.selected);
+            if (hot.thumbnail)
+                registeredThisCycle[i] = true;
+            else
+                hot.selected = 0; // 그 사이 사라진 창
+        }
+        if (hot.thumbnail)
+        {
+            g_sizeCache.Bind(i, hot.selected);
+            if (registeredThisCycle[i])
+                g_sizeCache.InvalidateSlot(i);
+            if (!g_sizeCache.Get(i, &sourceWidth, &sourceHeight))
+            {
+                g_backend->QuerySourceSize(hot.thumbnail, &sourceWidth, &sourceHeight);
+                g_sizeCache.Store(i, sourceWidth, sourceHeight);
+            }
+        }
+        else
+        {
+            g_sizeCache.Bind(i, 0);
+        }
+        g_layout.SetSourceSize(i, sourceWidth, sourceHeight);
+    }
+    g_layout.Update();
+
+    // 2. 이번 프레임의 배치 중 바뀐 것만 골라냄
+    g_frame.Begin(count);
+    for (int i = 0; i < count; i++)
+    {
+        const SlotGeometry& geometry = g_layout.Slot(i);
+        g_frame.SetSlot(i, geometry.thumbnail, geometry.picker, g_slots.Hot(i).thumbnail != 0, registeredThisCycle[i]);
+    }
+
+    // 3. 호스트 창 크기 조정 (가장 넓은 줄의 너비, 줄 수에 맞춰)
+    if (g_layout.TotalWidth() != g_windowWidth || g_layout.TotalHeight() != g_windowHeight)
+    {
+        g_windowWidth = g_layout.TotalWidth();
+        g_windowHeight = g_layout.TotalHeight();
+        XResizeWindow(g_display, g_host, g_windowWidth > 0 ? g_windowWidth : 1, g_windowHeight > 0 ? g_windowHeight : 1);
+    }
+
+    // 4. 옮겨진 제목 띠 다시 그림, 5. 목적지가 바뀐 썸네일만 백엔드에 전달
+    const std::vector<int>& pickerUpdates = g_frame.PickerUpdates();
+    for (size_t k = 0; k < pickerUpdates.size(); k++)
+        DrawPicker(pickerUpdates[k]);
+    const std::vector<int>& thumbnailUpdates = g_frame.ThumbnailUpdates();
+    for (size_t k = 0; k < thumbnailUpdates.size(); k++)
+    {
+        int i = thumbnailUpdates[k];
+        g_backend->Update(g_slots.Hot(i).thumbnail, g_frame.Pending(i).thumbnail, true);
+    }
+    g_frame.Commit();
+    g_backend->Commit();
+    g_lastCommit = NowMillis();
+
+    // 6. 크기 변경을 추적할 창 목록 갱신 (미리보기 중인 창만)
+    std::vector<WindowId> watched;
+    for (int i = 0; i < count; i++)
+    {
+        if (g_slots.Hot(i).selected)
+            watched.push_back(g_slots.Hot(i).selected);
+    }
+    g_tracker.SetWatched(watched);
+}
+
+void ReleaseThumbnail(int slot)
+{
+    if (g_slots.Hot(slot).thumbnail)
+    {
+        g_backend->Unregister(g_slots.Hot(slot).thumbnail);
+        g_slots.Hot(slot).thumbnail = 0;
+    }
+    g_frame.InvalidateSlot(slot);
+}
+
+void SelectWindow(int slot, WindowId window)
+{
+    if (g_slots.Hot(slot).selected == window)
+        return;
+    ReleaseThumbnail(slot);
+    g_slots.Hot(slot).selected = window;
+    UpdatePreviewLayout();
+    DrawPicker(slot);
+}
+
+// 목록 순서에서 current 다음 창 (current가 목록에 없으면 첫 창)
+WindowId NextWindow(WindowId current)
+{
+    if (g_registry.Size() == 0)
+        return 0;
+    int index = current ? g_registry.IndexOf(current) : -1;
+    return g_registry.At((size_t)(index + 1) % g_registry.Size()).id;
+}
+
+//=============================================================================
+// ProcessWindowChanges: 추적기에 모인 변경을 목록/슬롯/배치에 반영
+//=============================================================================
+void ProcessWindowChanges(bool sweep)
+{
+    g_tracker.TakeChanges(g_changes);
+    if (sweep)
+        g_changes.listChanged = true;
+    if (g_changes.Empty())
+        return;
+
+    WindowDiff diff;
+    if (g_changes.listChanged)
+        EnumerateWindows(diff);
+    RefreshTitles(g_changes.titleChanged, diff);
+
+    bool layoutChanged = !g_changes.locationChanged.empty();
+    for (size_t i = 0; i < g_changes.locationChanged.size(); i++)
+        g_sizeCache.InvalidateWindow(g_changes.locationChanged[i]);
+
+    // 목록에서 사라진 창을 보여 주던 슬롯은 비우고, 제목이 바뀐 슬롯은 제목 띠만 다시 그림
+    for (int i = 0; i < g_slots.Count(); i++)
+    {
+        WindowId selected = g_slots.Hot(i).selected;
+        if (!selected)
+            continue;
+        const WindowRegistry::Entry* entry = g_registry.Find(selected);
+        if (!entry)
+        {
+            ReleaseThumbnail(i);
+            g_slots.Hot(i).selected = 0;
+            layoutChanged = true;
+            DrawPicker(i);
+        }
+        else if (g_registry.TitleVersion(*entry) != g_slots.Cold(i).titleVersion)
+        {
+            DrawPicker(i);
+        }
+    }
+    if (layoutChanged)
+        UpdatePreviewLayout();
+}
+
+//=============================================================================
+// 입력 처리
+//=============================================================================
+void ActivateWindow(WindowId window)
+{
+    // 창 관리자에게 활성화 요청 (없으면 올리기만 함)
+    XEvent ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.xclient.type = ClientMessage;
+    ev.xclient.window = (Window)window;
+    ev.xclient.message_type = g_activeWindow;
+    ev.xclient.format = 32;
+    ev.xclient.data.l[0] = 2; // 요청 출처: 호출기(pager)
+    ev.xclient.data.l[1] = CurrentTime;
+    XSendEvent(g_display, DefaultRootWindow(g_display), False,
+               SubstructureRedirectMask | SubstructureNotifyMask, &ev);
+    XRaiseWindow(g_display, (Window)window);
+}
+
+void HandleButton(const XButtonEvent& event)
+{
+    int slot = g_layout.HitTest(event.x, event.y);
+    if (slot < 0 || slot >= g_slots.Count())
+        return;
+    const LayoutRect& picker = g_layout.Slot(slot).picker;
+    if (event.y < picker.bottom)
+    {
+        if (event.button == Button1)
+            SelectWindow(slot, NextWindow(g_slots.Hot(slot).selected));
+        else if (event.button == Button3)
+            SelectWindow(slot, 0);
+    }
+    else if (event.button == Button1 && g_slots.Hot(slot).selected)
+    {
+        ActivateWindow(g_slots.Hot(slot).selected);
+    }
+}
+
+void SetSlotCount(int count)
+{
+    if (count < 1)
+        return;
+    for (int i = count; i < g_slots.Count(); i++)
+        ReleaseThumbnail(i);
+    g_slots.Resize(count);
+    g_frame.InvalidateAll();
+    XClearWindow(g_display, g_host);
+    UpdatePreviewLayout();
+}
+
+void UpdateGridArea()
+{
+    if (g_gridLayout)
+        g_layout.SetGridArea(DisplayWidth(g_display, DefaultScreen(g_display)),
+                             DisplayHeight(g_display, DefaultScreen(g_display)));
+    else
+        g_layout.SetGridArea(0, 0);
+}
+
+void HandleKey(XKeyEvent& event)
+{
+    KeySym key = XLookupKeysym(&event, 0);
+    if (key == XK_q || key == XK_Escape)
+        g_quit = true;
+    else if (key == XK_plus || key == XK_equal || key == XK_KP_Add)
+        SetSlotCount(g_slots.Count() + 1);
+    else if (key == XK_minus || key == XK_KP_Subtract)
+        SetSlotCount(g_slots.Count() - 1);
+    else if (key == XK_g)
+    {
+        g_gridLayout = !g_gridLayout;
+        UpdateGridArea();
+        g_frame.InvalidateAll();
+        XClearWindow(g_display, g_host);
+        UpdatePreviewLayout();
+    }
+}
+
+//=============================================================================
+// 이벤트 루프 한 번: 이벤트가 오거나 timeoutMs가 지날 때까지 기다린 뒤 쌓인 이벤트/변경을 처리
+//=============================================================================
+void RunOnce(int timeoutMs)
+{
+    if (!XPending(g_display) && timeoutMs > 0)
+    {
+        int fd = ConnectionNumber(g_display);
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(fd, &fds);
+        struct timeval tv = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+        select(fd + 1, &fds, NULL, NULL, &tv);
+    }
+
+    while (XPending(g_display))
+    {
+        XEvent event;
+        XNextEvent(g_display, &event);
+        if (g_backend->HandleEvent(event))
+            continue;
+        switch (event.type)
+        {
+        case Expose:
+        {
+            LayoutRect area = { event.xexpose.x, event.xexpose.y,
+                                event.xexpose.x + event.xexpose.width, event.xexpose.y + event.xexpose.height };
+            g_backend->Invalidate(area);
+            if (event.xexpose.count == 0)
+            {
+                for (int i = 0; i < g_slots.Count(); i++)
+                    DrawPicker(i);
+            }
+        }
+        break;
+        case ButtonPress:
+            HandleButton(event.xbutton);
+            break;
+        case KeyPress:
+            HandleKey(event.xkey);
+            break;
+        case ClientMessage:
+            if ((Atom)event.xclient.data.l[0] == g_wmDelete)
+                g_quit = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    uint64_t now = NowMillis();
+    bool sweep = now - g_lastSweep >= LIST_SWEEP_INTERVAL;
+    if (sweep)
+        g_lastSweep = now;
+    if (g_tracker.HasPending() || sweep)
+        ProcessWindowChanges(sweep);
+
+    if (g_backend->CaptureMode() && now - g_lastCapture >= CAPTURE_INTERVAL)
+    {
+        g_backend->RefreshCaptures();
+        g_lastCapture = now;
+    }
+
+    // 손상된 썸네일은 프레임 간격마다 한 번만 합성 (여러 손상이 하나로 합쳐짐)
+    if (g_backend->HasDirty() && now - g_lastCommit >= FRAME_INTERVAL)
+    {
+        g_backend->Commit();
+        g_lastCommit = now;
+    }
+}
+
+// 다음 할 일(합성/재열거)까지 남은 시간
+int NextTimeout()
+{
+    uint64_t now = NowMillis();
+    uint64_t due = g_lastSweep + LIST_SWEEP_INTERVAL;
+    if (g_backend->CaptureMode())
+        due = std::min<uint64_t>(due, g_lastCapture + CAPTURE_INTERVAL);
+    if (g_backend->HasDirty())
+        due = std::min<uint64_t>(due, g_lastCommit + FRAME_INTERVAL);
+    return due > now ? (int)(due - now) : 1;
+}
+
+//=============================================================================
+// 자체 시험 (--selftest)
+//=============================================================================
+struct SelfTest
+{
+    int failures;
+    SelfTest() : failures(0) {}
+    void Check(bool ok, const char* name)
+    {
+        printf("%s %s\n", ok ? "PASS" : "FAIL", name);
+        if (!ok)
+            failures++;
+    }
+};
+
+// 조건이 참이 될 때까지 이벤트를 처리 (최대 SELFTEST_TIMEOUT)
+template <class Predicate>
+bool PumpUntil(Predicate done)
+{
+    uint64_t deadline = NowMillis() + SELFTEST_TIMEOUT;
+    while (!done())
+    {
+        if (NowMillis() >= deadline)
+            return false;
+        RunOnce(10);
+    }
+    return true;
+}
+
+// 호스트 창 크기 변경 등으로 쌓인 노출/손상 처리가 끝나도록 잠시 이벤트를 처리한 뒤 합성을 마침
+void Settle()
+{
+    uint64_t until = NowMillis() + 200;
+    while (NowMillis() < until)
+        RunOnce(10);
+    g_backend->Commit();
+    g_backend->Flush();
+}
+
+// 호스트 창의 한 점이 기대한 색인지 (채널마다 허용 오차 8)
+bool PixelMatches(int x, int y, unsigned long rgb)
+{
+    XImage* image = XGetImage(g_display, g_host, x, y, 1, 1, AllPlanes, ZPixmap);
+    if (!image)
+        return false;
+    unsigned long pixel = XGetPixel(image, 0, 0);
+    XWindowAttributes attributes;
+    XGetWindowAttributes(g_display, g_host, &attributes);
+    unsigned long expected = MakePixel(attributes.visual, rgb);
+    XDestroyImage(image);
+    unsigned long masks[3] = { attributes.visual->red_mask, attributes.visual->green_mask, attributes.visual->blue_mask };
+    for (int c = 0; c < 3; c++)
+    {
+        long a = (long)(pixel & masks[c]), b = (long)(expected & masks[c]);
+        unsigned long unit = masks[c] & (~masks[c] + 1); // 채널 최하위 비트
+        if ((a > b ? a - b : b - a) > (long)(unit * 8))
+            return false;
+    }
+    return true;
+}
+
+bool SlotShows(int slot, unsigned long rgb)
+{
+    const LayoutRect& rc = g_layout.Slot(slot).thumbnail;
+    return PixelMatches((rc.left + rc.right) / 2, (rc.top + rc.bottom) / 2, rgb);
+}
+
+int RunSelfTest()
+{
+    SelfTest test;
+    Display* client = XOpenDisplay(DisplayString(g_display)); // 다른 프로그램 역할을 하는 두 번째 연결
+    if (!client)
+    {
+        printf("FAIL cannot open a second connection\n");
+        return 1;
+    }
+    const int count = 3;
+    const unsigned long colors[count] = { 0xFF0000, 0x00FF00, 0x0000FF };
+    Window windows[count];
+    Visual* visual = DefaultVisual(client, DefaultScreen(client));
+    for (int i = 0; i < count; i++)
+    {
+        windows[i] = XCreateSimpleWindow(client, DefaultRootWindow(client), 40 + i * 30, 300 + i * 30, 320, 240, 0, 0,
+                                         MakePixel(visual, colors[i]));
+        char name[64];
+        snprintf(name, sizeof(name), "viewer-selftest %d", i);
+        XStoreName(client, windows[i], name);
+        XMapWindow(client, windows[i]);
+    }
+    XSync(client, False);
+
+    // 1. 열거: 새 창이 목록에 나타남 (표시 이벤트 -> 재열거)
+    test.Check(PumpUntil([&]() {
+        for (int i = 0; i < count; i++)
+            if (!g_registry.Find(windows[i])) return false;
+        return true;
+    }), "enumerate");
+
+    // 2. 합성: 슬롯마다 대상 창의 색이 보임
+    if (g_slots.Count() < count)
+        SetSlotCount(count);
+    for (int i = 0; i < count; i++)
+        SelectWindow(i, windows[i]);
+    Settle();
+    bool composed = true;
+    for (int i = 0; i < count; i++)
+        composed = composed && SlotShows(i, colors[i]);
+    test.Check(composed, "composite");
+
+    // 3. 손상: 한 창의 내용만 바꾸면 그 슬롯만 다시 합성됨 (캡처 모드는 주기적으로 모든 슬롯을 다시 캡처하므로 반영만 확인)
+    uint64_t before[count];
+    for (int i = 0; i < count; i++)
+        before[i] = g_backend->PaintCount(g_slots.Hot(i).thumbnail);
+    XSetWindowBackground(client, windows[1], MakePixel(visual, 0xFFFF00));
+    XClearWindow(client, windows[1]);
+    XSync(client, False);
+    bool repainted = PumpUntil([&]() { return g_backend->PaintCount(g_slots.Hot(1).thumbnail) > before[1]; });
+    g_backend->Flush();
+    if (g_backend->CaptureMode())
+    {
+        test.Check(repainted && PumpUntil([&]() { return SlotShows(1, 0xFFFF00); }), "capture repaint");
+        // 내용이 그대로인 슬롯은 재캡처해도 축소/전송을 건너뜀
+        uint64_t changed, skipped;
+        g_backend->FrameCounts(g_slots.Hot(0).thumbnail, &changed, &skipped);
+        uint64_t skippedBefore = skipped;
+        uint64_t paintsBefore = g_backend->PaintCount(g_slots.Hot(0).thumbnail);
+        PumpUntil([&]() {
+            uint64_t c, s;
+            g_backend->FrameCounts(g_slots.Hot(0).thumbnail, &c, &s);
+            return s > skippedBefore;
+        });
+        g_backend->FrameCounts(g_slots.Hot(0).thumbnail, &changed, &skipped);
+        test.Check(skipped > skippedBefore && g_backend->PaintCount(g_slots.Hot(0).thumbnail) == paintsBefore,
+                   "capture skip unchanged");
+    }
+    else
+    {
+        test.Check(repainted && SlotShows(1, 0xFFFF00), "damage repaint");
+        test.Check(g_backend->PaintCount(g_slots.Hot(0).thumbnail) == before[0] &&
+                   g_backend->PaintCount(g_slots.Hot(2).thumbnail) == before[2], "damage only");
+    }
+
+    // 4. 제목 변경
+    XStoreName(client, windows[2], "viewer-selftest renamed");
+    XSync(client, False);
+    test.Check(PumpUntil([&]() {
+        const WindowRegistry::Entry* entry = g_registry.Find(windows[2]);
+        size_t length = 0;
+        const wchar_t* title = entry ? g_registry.Title(*entry, &length) : NULL;
+        return title && std::wstring(title, length) == L"viewer-selftest renamed";
+    }), "title change");
+
+    // 5. 크기 변경: 슬롯 너비가 원본 비율(160:240)을 따라감
+    XResizeWindow(client, windows[0], 160, 240);
+    XSync(client, False);
+    test.Check(PumpUntil([&]() {
+        const LayoutRect& rc = g_layout.Slot(0).thumbnail;
+        return rc.Height() > 0 && rc.Width() * 3 <= rc.Height() * 2 + 3;
+    }), "resize");
+
+    // 6. 파괴: 목록에서 빠지고 슬롯이 비워짐
+    XDestroyWindow(client, windows[2]);
+    XSync(client, False);
+    test.Check(PumpUntil([&]() { return !g_registry.Find(windows[2]) && g_slots.Hot(2).selected == 0; }), "destroy");
+
+    XCloseDisplay(client);
+    printf("damage events %llu, paints %llu\n",
+           (unsigned long long)g_backend->DamageEvents(), (unsigned long long)g_backend->Paints());
+    if (g_backend->CaptureMode())
+        printf("captures %llu, %.1f us/capture\n", (unsigned long long)g_backend->Captures(),
+               g_backend->Captures() ? (double)g_backend->CaptureMicros() / g_backend->Captures() : 0.0);
+    for (int i = 0; g_backend->CaptureMode() && i < g_slots.Count(); i++)
+    {
+        uint64_t changed, skipped;
+        g_backend->FrameCounts(g_slots.Hot(i).thumbnail, &changed, &skipped);
+        printf("slot %d: changed %llu, skipped %llu\n", i + 1, (unsigned long long)changed, (unsigned long long)skipped);
+    }
+    printf("%s (%d failed)\n", test.failures ? "FAILED" : "OK", test.failures);
+    return test.failures ? 1 : 0;
+}
+
+//=============================================================================
+// main
+//=============================================================================
+int main(int argc, char** argv)
+{
+    const char* displayName = NULL;
+    int slots = NUM_SEGMENTS_DEFAULT;
+    int previewHeight = PREVIEW_HEIGHT;
+    bool selfTest = false;
+    bool captureOnly = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--display") && i + 1 < argc) displayName = argv[++i];
+        else if (!strcmp(argv[i], "--slots") && i + 1 < argc) slots = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--height") && i + 1 < argc) previewHeight = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--grid")) g_gridLayout = true;
+        else if (!strcmp(argv[i], "--capture")) captureOnly = true;
+        else if (!strcmp(argv[i], "--selftest")) selfTest = true;
+        else
+        {
+            fprintf(stderr, "usage: x11viewer [--display NAME] [--slots N] [--height N] [--grid] [--capture] [--selftest]\n");
+            return 2;
+        }
+    }
+    if (slots < 1) slots = 1;
+    if (previewHeight < 16) previewHeight = 16;
+
+    setlocale(LC_ALL, "");
+    g_display = XOpenDisplay(displayName);
+    if (!g_display)
+    {
+        fprintf(stderr, "cannot open display %s\n", XDisplayName(displayName));
+        return 1;
+    }
+
+    int screen = DefaultScreen(g_display);
+    g_host = XCreateSimpleWindow(g_display, DefaultRootWindow(g_display), 0, 0, 1, 1, 0,
+                                 BlackPixel(g_display, screen), BlackPixel(g_display, screen));
+    XStoreName(g_display, g_host, "MultiWindowViewer");
+    XSelectInput(g_display, g_host, ExposureMask | ButtonPressMask | KeyPressMask);
+    g_wmDelete = XInternAtom(g_display, "WM_DELETE_WINDOW", False);
+    g_activeWindow = XInternAtom(g_display, "_NET_ACTIVE_WINDOW", False);
+    XSetWMProtocols(g_display, g_host, &g_wmDelete, 1);
+    g_gc = XCreateGC(g_display, g_host, 0, NULL);
+    g_pickerBackground = MakePixel(DefaultVisual(g_display, screen), PICKER_BACKGROUND);
+    g_pickerText = MakePixel(DefaultVisual(g_display, screen), PICKER_TEXT);
+    if (XSupportsLocale())
+    {
+        char** missing = NULL;
+        int missingCount = 0;
+        char* defaultString = NULL;
+        g_fontSet = XCreateFontSet(g_display, "-*-*-medium-r-normal-*-14-*-*-*-*-*-*-*,*",
+                                   &missing, &missingCount, &defaultString);
+        if (missing)
+            XFreeStringList(missing);
+    }
+
+    // 백엔드는 디스플레이를 닫기 전에 해제해야 하므로 힙에 둠
+    g_backend = new X11PreviewBackend(g_display, g_host);
+    std::string error;
+    if (!g_backend->Initialize(&error, captureOnly))
+    {
+        fprintf(stderr, "%s\n", error.c_str());
+        delete g_backend;
+        XCloseDisplay(g_display);
+        return 1;
+    }
+    if (g_backend->CaptureMode())
+        fprintf(stderr, "%s: using capture fallback (%s)\n", error.c_str(), SimdLevelName(DetectSimdLevel()));
+    g_backend->Start(&g_tracker);
+
+    g_layout.SetPickerHeight(PICKER_HEIGHT);
+    g_layout.SetPreviewHeight(previewHeight);
+    g_layout.SetDefaultAspect(PREVIEW_ASPECT_RATIO_NUMERATOR, PREVIEW_ASPECT_RATIO_DENOMINATOR);
+    UpdateGridArea();
+    g_slots.Resize(slots);
+    UpdatePreviewLayout();
+    XMapWindow(g_display, g_host);
+
+    // 첫 열거 후 빈 슬롯을 목록 순서대로 채움 (winview의 슬롯 연결 복원에 해당)
+    g_lastSweep = NowMillis();
+    ProcessWindowChanges(true);
+    if (!selfTest)
+    {
+        for (int i = 0, next = 0; i < g_slots.Count() && next < (int)g_registry.Size(); i++)
+            g_slots.Hot(i).selected = g_registry.At(next++).id;
+        UpdatePreviewLayout();
+    }
+
+    int result = 0;
+    if (selfTest)
+    {
+        result = RunSelfTest();
+    }
+    else
+    {
+        while (!g_quit)
+            RunOnce(NextTimeout());
+    }
+
+    for (int i = 0; i < g_slots.Count(); i++)
+        ReleaseThumbnail(i);
+    delete g_backend; // 이벤트 구독 해제, 리디렉션 해제
+    g_backend = NULL;
+    if (g_fontSet)
+        XFreeFontSet(g_display, g_fontSet);
+    XFreeGC(g_display, g_gc);
+    XDestroyWindow(g_display, g_host);
+    XCloseDisplay(g_display);
+    return result;
+}